@@ -13,6 +13,7 @@
 #include <utility>
 
 #include "cast/common/certificate/cast_crl.h"
+#include "cast/common/certificate/device_cert_verification_cache.h"
 #include "cast/common/public/parsed_certificate.h"
 #include "cast/common/public/trust_store.h"
 #include "util/osp_logging.h"
@@ -66,12 +67,25 @@ Error VerifyDeviceCert(const std::vector<std::string>& der_certs,
                        CastDeviceCertPolicy* policy,
                        const CastCRL* crl,
                        CRLPolicy crl_policy,
-                       TrustStore* trust_store) {
+                       TrustStore* trust_store,
+                       DeviceCertVerificationCache* cache) {
   // Fail early if CRL is required but not provided.
   if (!crl && crl_policy == CRLPolicy::kCrlRequired) {
     return Error::Code::kErrCrlInvalid;
   }
 
+  // Only a CRL that is actually checked affects the result.
+  const CastCRL* checked_crl =
+      (crl_policy == CRLPolicy::kCrlRequired) ? crl : nullptr;
+  std::string cache_key;
+  if (cache && !der_certs.empty()) {
+    cache_key = DeviceCertVerificationCache::ComputeKey(der_certs, checked_crl,
+                                                        crl_policy);
+    if (cache->Lookup(cache_key, der_certs, time, target_cert, policy)) {
+      return Error::Code::kNone;
+    }
+  }
+
   ErrorOr<TrustStore::CertificatePathResult> maybe_result_path =
       trust_store->FindCertificatePath(der_certs, time);
   if (!maybe_result_path) {
@@ -90,6 +104,9 @@ Error VerifyDeviceCert(const std::vector<std::string>& der_certs,
   }
 
   *policy = GetAudioPolicy(raw_path);
+  if (!cache_key.empty()) {
+    cache->Insert(cache_key, raw_path, *policy, checked_crl);
+  }
   *target_cert = std::move(result_path[0]);
 
   return Error::Code::kNone;
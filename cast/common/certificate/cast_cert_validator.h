@@ -17,6 +17,7 @@ namespace openscreen {
 namespace cast {
 
 class CastCRL;
+class DeviceCertVerificationCache;
 class ParsedCertificate;
 class TrustStore;
 
@@ -59,6 +60,11 @@ enum class CRLPolicy {
 // * |trust_store| is a set of trusted certificates that may act as root CAs
 //   during chain verification.
 //
+// * |cache| is an optional cache of previous successful verifications made
+//   against |trust_store|.  If the same chain was already verified with the
+//   same CRL and |crl_policy|, and |time| is still within the validity of the
+//   verified path, path building and revocation checking are skipped.
+//
 // Outputs:
 //
 // Returns Error::Code::kNone on success.  Otherwise, the corresponding
@@ -77,7 +83,8 @@ enum class CRLPolicy {
     CastDeviceCertPolicy* policy,
     const CastCRL* crl,
     CRLPolicy crl_policy,
-    TrustStore* trust_store);
+    TrustStore* trust_store,
+    DeviceCertVerificationCache* cache = nullptr);
 
 }  // namespace cast
 }  // namespace openscreen
@@ -6,7 +6,11 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <tuple>
+#include <utility>
 
 #include "absl/strings/string_view.h"
 #include "cast/common/certificate/date_time.h"
@@ -90,6 +94,15 @@ bool VerifyCRL(const Crl& crl,
   return true;
 }
 
+// Copies |hash| into |spki_hash| if it has the size of a SHA-256 hash.
+bool ToSpkiHash(const std::string& hash, CastCRL::SpkiHash* spki_hash) {
+  if (hash.size() != spki_hash->size()) {
+    return false;
+  }
+  std::copy(hash.begin(), hash.end(), spki_hash->begin());
+  return true;
+}
+
 }  // namespace
 
 CastCRL::CastCRL(const TbsCrl& tbs_crl, const DateTime& overall_not_after) {
@@ -102,19 +115,59 @@ CastCRL::CastCRL(const TbsCrl& tbs_crl, const DateTime& overall_not_after) {
     not_after_ = overall_not_after;
   }
 
-  // Parse the revoked hashes.
+  ErrorOr<std::string> version_hash =
+      SHA256HashString(tbs_crl.SerializeAsString());
+  if (version_hash) {
+    version_hash_ = std::move(version_hash.value());
+  }
+
+  // Parse the revoked hashes.  Hashes of the wrong size can never match a
+  // SHA-256 SPKI hash, so they are dropped.
+  revoked_hashes_.reserve(tbs_crl.revoked_public_key_hashes_size());
   for (const auto& hash : tbs_crl.revoked_public_key_hashes()) {
-    revoked_hashes_.insert(hash);
+    SpkiHash spki_hash;
+    if (ToSpkiHash(hash, &spki_hash)) {
+      revoked_hashes_.push_back(spki_hash);
+    }
   }
+  std::sort(revoked_hashes_.begin(), revoked_hashes_.end());
+  revoked_hashes_.erase(
+      std::unique(revoked_hashes_.begin(), revoked_hashes_.end()),
+      revoked_hashes_.end());
 
   // Parse the revoked serial ranges.
+  std::vector<std::pair<SpkiHash, SerialNumberRange>> ranges;
+  ranges.reserve(tbs_crl.revoked_serial_number_ranges_size());
   for (const auto& range : tbs_crl.revoked_serial_number_ranges()) {
-    std::string issuer_hash = range.issuer_public_key_hash();
-
-    uint64_t first_serial_number = range.first_serial_number();
-    uint64_t last_serial_number = range.last_serial_number();
-    auto& serial_number_range = revoked_serial_numbers_[issuer_hash];
-    serial_number_range.push_back({first_serial_number, last_serial_number});
+    SpkiHash issuer_hash;
+    if (ToSpkiHash(range.issuer_public_key_hash(), &issuer_hash)) {
+      ranges.emplace_back(
+          issuer_hash, SerialNumberRange{range.first_serial_number(),
+                                         range.last_serial_number()});
+    }
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [](const std::pair<SpkiHash, SerialNumberRange>& a,
+               const std::pair<SpkiHash, SerialNumberRange>& b) {
+              return std::tie(a.first, a.second.first_serial) <
+                     std::tie(b.first, b.second.first_serial);
+            });
+  for (const auto& entry : ranges) {
+    if (revoked_serial_numbers_.empty() ||
+        revoked_serial_numbers_.back().issuer_hash != entry.first) {
+      revoked_serial_numbers_.push_back({entry.first, {}});
+    }
+    std::vector<SerialNumberRange>& issuer_ranges =
+        revoked_serial_numbers_.back().ranges;
+    const SerialNumberRange& range = entry.second;
+    if (!issuer_ranges.empty() &&
+        (issuer_ranges.back().last_serial == UINT64_MAX ||
+         range.first_serial <= issuer_ranges.back().last_serial + 1)) {
+      issuer_ranges.back().last_serial =
+          std::max(issuer_ranges.back().last_serial, range.last_serial);
+    } else {
+      issuer_ranges.push_back(range);
+    }
   }
 }
 
@@ -140,38 +193,59 @@ bool CastCRL::CheckRevocation(
       return false;
     }
 
-    ErrorOr<std::string> spki_hash = SHA256HashString(spki_tlv);
-    if (spki_hash.is_error() ||
-        (revoked_hashes_.find(spki_hash.value()) != revoked_hashes_.end())) {
+    SpkiHash spki_hash;
+    if (!SHA256HashString(spki_tlv, spki_hash.data()).ok() ||
+        IsHashRevoked(spki_hash)) {
       return false;
     }
 
     // Check if the subordinate certificate was revoked by serial number.
     if (subject_index > 0) {
-      const auto issuer_iter = revoked_serial_numbers_.find(spki_hash.value());
-      if (issuer_iter != revoked_serial_numbers_.end()) {
-        const auto& subordinate = trusted_chain[subject_index - 1];
-        uint64_t serial_number;
-
-        // Only Google generated device certificates will be revoked by range.
-        // These will always be less than 64 bits in length.
-        ErrorOr<uint64_t> maybe_serial = subordinate->GetSerialNumber();
-        if (!maybe_serial) {
-          continue;
-        }
-        serial_number = maybe_serial.value();
-        for (const auto& revoked_serial : issuer_iter->second) {
-          if (revoked_serial.first_serial <= serial_number &&
-              revoked_serial.last_serial >= serial_number) {
-            return false;
-          }
-        }
+      // Only Google generated device certificates will be revoked by range.
+      // These will always be less than 64 bits in length.
+      ErrorOr<uint64_t> maybe_serial =
+          trusted_chain[subject_index - 1]->GetSerialNumber();
+      if (maybe_serial &&
+          IsSerialNumberRevoked(spki_hash, maybe_serial.value())) {
+        return false;
       }
     }
   }
   return true;
 }
 
+bool CastCRL::IsHashRevoked(const SpkiHash& spki_hash) const {
+  return std::binary_search(revoked_hashes_.begin(), revoked_hashes_.end(),
+                            spki_hash);
+}
+
+bool CastCRL::IsSerialNumberRevoked(const SpkiHash& issuer_hash,
+                                    uint64_t serial_number) const {
+  const auto issuer_iter = std::lower_bound(
+      revoked_serial_numbers_.begin(), revoked_serial_numbers_.end(),
+      issuer_hash,
+      [](const IssuerSerialNumberRanges& ranges, const SpkiHash& hash) {
+        return ranges.issuer_hash < hash;
+      });
+  if (issuer_iter == revoked_serial_numbers_.end() ||
+      issuer_iter->issuer_hash != issuer_hash) {
+    return false;
+  }
+
+  // Find the last range starting at or before |serial_number|.  Ranges don't
+  // overlap, so it is the only one that can contain it.
+  const std::vector<SerialNumberRange>& ranges = issuer_iter->ranges;
+  const auto range_iter = std::upper_bound(
+      ranges.begin(), ranges.end(), serial_number,
+      [](uint64_t serial, const SerialNumberRange& range) {
+        return serial < range.first_serial;
+      });
+  if (range_iter == ranges.begin()) {
+    return false;
+  }
+  return serial_number <= std::prev(range_iter)->last_serial;
+}
+
 std::unique_ptr<CastCRL> ParseAndVerifyCRL(const std::string& crl_proto,
                                            const DateTime& time,
                                            TrustStore* trust_store) {
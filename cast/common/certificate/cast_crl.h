@@ -5,10 +5,12 @@
 #ifndef CAST_COMMON_CERTIFICATE_CAST_CRL_H_
 #define CAST_COMMON_CERTIFICATE_CAST_CRL_H_
 
+#include <openssl/sha.h>
+#include <stdint.h>
+
+#include <array>
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "cast/common/certificate/cast_cert_validator.h"
@@ -32,6 +34,9 @@ class TrustStore;
 // the binary in a protobuf message.
 class CastCRL {
  public:
+  // The SHA-256 hash of a SubjectPublicKeyInfo.
+  using SpkiHash = std::array<uint8_t, SHA256_DIGEST_LENGTH>;
+
   CastCRL(const TbsCrl& tbs_crl, const DateTime& overall_not_after);
   ~CastCRL();
 
@@ -47,28 +52,48 @@ class CastCRL {
   //
   // Output:
   // Returns true if no certificate in the chain was revoked.
+  //
+  // Each certificate's SPKI is hashed once and all lookups are binary searches
+  // over the tables built when the CRL was parsed.
   bool CheckRevocation(
       const std::vector<const ParsedCertificate*>& trusted_chain,
       const DateTime& time) const;
 
+  const DateTime& not_before() const { return not_before_; }
+  const DateTime& not_after() const { return not_after_; }
+
+  // The SHA-256 hash of the serialized TBS CRL, identifying this version of the
+  // CRL.
+  const std::string& version_hash() const { return version_hash_; }
+
  private:
   struct SerialNumberRange {
     uint64_t first_serial;
     uint64_t last_serial;
   };
 
+  struct IssuerSerialNumberRanges {
+    SpkiHash issuer_hash;
+
+    // Sorted by |first_serial|, with overlapping and adjacent ranges merged.
+    std::vector<SerialNumberRange> ranges;
+  };
+
+  bool IsHashRevoked(const SpkiHash& spki_hash) const;
+  bool IsSerialNumberRevoked(const SpkiHash& issuer_hash,
+                             uint64_t serial_number) const;
+
   DateTime not_before_;
   DateTime not_after_;
+  std::string version_hash_;
 
-  // Revoked public key hashes.
+  // Revoked public key hashes, sorted.
   // The values consist of the SHA256 hash of the SubjectPublicKeyInfo.
-  std::unordered_set<std::string> revoked_hashes_;
+  std::vector<SpkiHash> revoked_hashes_;
 
-  // Revoked serial number ranges indexed by issuer public key hash.
-  // The key is the SHA256 hash of issuer's SubjectPublicKeyInfo.
-  // The value is a list of revoked serial number ranges.
-  std::unordered_map<std::string, std::vector<SerialNumberRange>>
-      revoked_serial_numbers_;
+  // Revoked serial number ranges, sorted by the SHA256 hash of the issuer's
+  // SubjectPublicKeyInfo.
+  std::vector<IssuerSerialNumberRanges> revoked_serial_numbers_;
 
   OSP_DISALLOW_COPY_AND_ASSIGN(CastCRL);
 };
@@ -4,6 +4,12 @@
 
 #include "cast/common/certificate/cast_crl.h"
 
+#include <stdint.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "cast/common/certificate/cast_cert_validator.h"
 #include "cast/common/certificate/date_time.h"
 #include "cast/common/certificate/proto/test_suite.pb.h"
@@ -12,6 +18,7 @@
 #include "gtest/gtest.h"
 #include "platform/test/paths.h"
 #include "testing/util/read_file.h"
+#include "util/crypto/sha2.h"
 #include "util/osp_logging.h"
 
 namespace openscreen {
@@ -199,6 +206,103 @@ TEST(CastCertificateTest, TestSuite1) {
   RunTestSuite(GetSpecificTestDataPath() + "testsuite/testsuite1.pb");
 }
 
+// A certificate that only provides what CastCRL::CheckRevocation uses.
+class FakeParsedCertificate final : public ParsedCertificate {
+ public:
+  FakeParsedCertificate(std::string spki, uint64_t serial_number)
+      : spki_(std::move(spki)), serial_number_(serial_number) {}
+  ~FakeParsedCertificate() override = default;
+
+  ErrorOr<std::vector<uint8_t>> SerializeToDER(
+      int front_spacing) const override {
+    return Error::Code::kErrCertSerialize;
+  }
+  ErrorOr<DateTime> GetNotBeforeTime() const override {
+    return Error::Code::kErrCertsParse;
+  }
+  ErrorOr<DateTime> GetNotAfterTime() const override {
+    return Error::Code::kErrCertsParse;
+  }
+  std::string GetCommonName() const override { return std::string(); }
+  std::string GetSpkiTlv() const override { return spki_; }
+  ErrorOr<uint64_t> GetSerialNumber() const override { return serial_number_; }
+  bool VerifySignedData(DigestAlgorithm algorithm,
+                        const ByteView& data,
+                        const ByteView& signature) const override {
+    return false;
+  }
+  bool HasPolicyOid(const ByteView& oid) const override { return false; }
+  void SetNotBeforeTimeForTesting(time_t not_before) override {}
+  void SetNotAfterTimeForTesting(time_t not_after) override {}
+
+ private:
+  const std::string spki_;
+  const uint64_t serial_number_;
+};
+
+TEST(CastCRLTest, SerialNumberRangesAreMergedAndSearched) {
+  const std::string issuer_spki = "issuer";
+  const std::string issuer_hash = SHA256HashString(issuer_spki).value();
+
+  TbsCrl tbs_crl;
+  tbs_crl.set_not_before_seconds(0);
+  tbs_crl.set_not_after_seconds(2000000000);
+  auto add_range = [&](uint64_t first, uint64_t last) {
+    auto* range = tbs_crl.add_revoked_serial_number_ranges();
+    range->set_issuer_public_key_hash(issuer_hash);
+    range->set_first_serial_number(first);
+    range->set_last_serial_number(last);
+  };
+  add_range(40, 50);
+  add_range(10, 20);
+  add_range(15, 30);
+  add_range(31, 32);
+  add_range(UINT64_MAX - 1, UINT64_MAX);
+
+  DateTime not_after;
+  ASSERT_TRUE(DateTimeFromSeconds(2000000000, &not_after));
+  CastCRL crl(tbs_crl, not_after);
+  DateTime time;
+  ASSERT_TRUE(DateTimeFromSeconds(1000000000, &time));
+
+  FakeParsedCertificate issuer(issuer_spki, 1);
+  for (uint64_t serial :
+       std::vector<uint64_t>{10, 25, 32, 40, 50, UINT64_MAX}) {
+    FakeParsedCertificate subject("subject", serial);
+    EXPECT_FALSE(crl.CheckRevocation({&subject, &issuer}, time)) << serial;
+  }
+  for (uint64_t serial : std::vector<uint64_t>{0, 9, 33, 51, UINT64_MAX - 2}) {
+    FakeParsedCertificate subject("subject", serial);
+    EXPECT_TRUE(crl.CheckRevocation({&subject, &issuer}, time)) << serial;
+  }
+
+  // Ranges only apply to certificates issued by |issuer|.
+  FakeParsedCertificate other_issuer("other issuer", 1);
+  FakeParsedCertificate subject("subject", 10);
+  EXPECT_TRUE(crl.CheckRevocation({&subject, &other_issuer}, time));
+}
+
+TEST(CastCRLTest, RevokedPublicKeyHash) {
+  TbsCrl tbs_crl;
+  tbs_crl.set_not_before_seconds(0);
+  tbs_crl.set_not_after_seconds(2000000000);
+  tbs_crl.add_revoked_public_key_hashes(SHA256HashString("revoked").value());
+  tbs_crl.add_revoked_public_key_hashes("not a SHA-256 hash");
+
+  DateTime not_after;
+  ASSERT_TRUE(DateTimeFromSeconds(2000000000, &not_after));
+  CastCRL crl(tbs_crl, not_after);
+  DateTime time;
+  ASSERT_TRUE(DateTimeFromSeconds(1000000000, &time));
+
+  FakeParsedCertificate root("root", 1);
+  FakeParsedCertificate revoked("revoked", 2);
+  FakeParsedCertificate good("good", 3);
+  EXPECT_FALSE(crl.CheckRevocation({&revoked, &root}, time));
+  EXPECT_FALSE(crl.CheckRevocation({&good, &revoked}, time));
+  EXPECT_TRUE(crl.CheckRevocation({&good, &root}, time));
+}
+
 }  // namespace
 }  // namespace cast
 }  // namespace openscreen
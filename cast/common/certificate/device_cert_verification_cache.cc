@@ -0,0 +1,171 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/common/certificate/device_cert_verification_cache.h"
+
+#include <openssl/sha.h>
+
+#include <utility>
+
+#include "cast/common/certificate/cast_crl.h"
+#include "cast/common/certificate/date_time.h"
+#include "cast/common/public/parsed_certificate.h"
+#include "util/big_endian.h"
+#include "util/crypto/secure_hash.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace cast {
+namespace {
+
+void HashLengthPrefixed(SecureHash* hash, const std::string& value) {
+  uint8_t length[sizeof(uint32_t)];
+  WriteBigEndian<uint32_t>(static_cast<uint32_t>(value.size()), length);
+  hash->Update(length, sizeof(length));
+  hash->Update(value);
+}
+
+}  // namespace
+
+DeviceCertVerificationCache::DeviceCertVerificationCache(size_t max_entries)
+    : max_entries_(max_entries) {
+  OSP_DCHECK_GT(max_entries_, 0u);
+}
+
+DeviceCertVerificationCache::~DeviceCertVerificationCache() = default;
+
+// static
+std::string DeviceCertVerificationCache::ComputeKey(
+    const std::vector<std::string>& der_certs,
+    const CastCRL* crl,
+    CRLPolicy crl_policy) {
+  SecureHash hash(EVP_sha256());
+  const uint8_t policy_byte = static_cast<uint8_t>(crl_policy);
+  hash.Update(&policy_byte, sizeof(policy_byte));
+  HashLengthPrefixed(&hash, crl ? crl->version_hash() : std::string());
+  for (const std::string& der_cert : der_certs) {
+    HashLengthPrefixed(&hash, der_cert);
+  }
+
+  std::string key(SHA256_DIGEST_LENGTH, 0);
+  hash.Finish(&key[0]);
+  return key;
+}
+
+bool DeviceCertVerificationCache::Lookup(
+    const std::string& key,
+    const std::vector<std::string>& der_certs,
+    const DateTime& time,
+    std::unique_ptr<ParsedCertificate>* target_cert,
+    CastDeviceCertPolicy* policy) {
+  CastDeviceCertPolicy cached_policy;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      ++misses_;
+      return false;
+    }
+
+    const Entry& entry = *it->second;
+    if (time < entry.not_before || entry.not_after < time) {
+      lru_order_.erase(it->second);
+      entries_.erase(it);
+      ++misses_;
+      return false;
+    }
+    cached_policy = entry.policy;
+    lru_order_.splice(lru_order_.begin(), lru_order_, it->second);
+    ++hits_;
+  }
+
+  // The target certificate is parsed outside of the lock, so that concurrent
+  // hits don't serialize on it.
+  OSP_DCHECK(!der_certs.empty());
+  const std::string& target_der = der_certs[0];
+  ErrorOr<std::unique_ptr<ParsedCertificate>> parsed =
+      ParsedCertificate::ParseFromDER(
+          std::vector<uint8_t>(target_der.begin(), target_der.end()));
+  if (!parsed) {
+    return false;
+  }
+
+  *policy = cached_policy;
+  *target_cert = std::move(parsed.value());
+  return true;
+}
+
+void DeviceCertVerificationCache::Insert(
+    const std::string& key,
+    const std::vector<const ParsedCertificate*>& path,
+    CastDeviceCertPolicy policy,
+    const CastCRL* crl) {
+  if (path.empty()) {
+    return;
+  }
+
+  Entry entry{key, policy, {}, {}};
+  bool first = true;
+  for (const ParsedCertificate* cert : path) {
+    ErrorOr<DateTime> not_before = cert->GetNotBeforeTime();
+    ErrorOr<DateTime> not_after = cert->GetNotAfterTime();
+    if (!not_before || !not_after) {
+      return;
+    }
+    if (first || entry.not_before < not_before.value()) {
+      entry.not_before = not_before.value();
+    }
+    if (first || not_after.value() < entry.not_after) {
+      entry.not_after = not_after.value();
+    }
+    first = false;
+  }
+  if (crl) {
+    if (entry.not_before < crl->not_before()) {
+      entry.not_before = crl->not_before();
+    }
+    if (crl->not_after() < entry.not_after) {
+      entry.not_after = crl->not_after();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    *it->second = std::move(entry);
+    lru_order_.splice(lru_order_.begin(), lru_order_, it->second);
+    return;
+  }
+
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(lru_order_.back().key);
+    lru_order_.pop_back();
+  }
+  lru_order_.push_front(std::move(entry));
+  entries_.emplace(key, lru_order_.begin());
+}
+
+void DeviceCertVerificationCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_order_.clear();
+}
+
+size_t DeviceCertVerificationCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t DeviceCertVerificationCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t DeviceCertVerificationCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+}  // namespace cast
+}  // namespace openscreen
@@ -0,0 +1,109 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_COMMON_CERTIFICATE_DEVICE_CERT_VERIFICATION_CACHE_H_
+#define CAST_COMMON_CERTIFICATE_DEVICE_CERT_VERIFICATION_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "cast/common/certificate/cast_cert_validator.h"
+#include "cast/common/public/certificate_types.h"
+#include "platform/base/macros.h"
+
+namespace openscreen {
+namespace cast {
+
+class CastCRL;
+class ParsedCertificate;
+
+// A Least Recently Used cache of successful VerifyDeviceCert() results.
+//
+// Entries are keyed by the SHA-256 of the DER certificate chain, the CRL policy
+// and the version of the CRL used for revocation checking, so a reconnecting
+// device that presents the same chain skips path building and revocation
+// checking entirely.  Each entry is only valid between the latest notBefore and
+// the earliest notAfter of the verified path (and of the CRL, if one was
+// checked), and is dropped once a lookup falls outside of that window.
+//
+// Only successful verifications are cached.  A cache must only ever be used
+// with a single TrustStore, since the trust store is not part of the key.  This
+// class is thread-safe, so a cache may be shared by verifications running on
+// several threads.
+class DeviceCertVerificationCache {
+ public:
+  static constexpr size_t kDefaultMaxEntries = 64;
+
+  explicit DeviceCertVerificationCache(
+      size_t max_entries = kDefaultMaxEntries);
+  ~DeviceCertVerificationCache();
+
+  // Computes the key used to look up the verification result of |der_certs|.
+  static std::string ComputeKey(const std::vector<std::string>& der_certs,
+                                const CastCRL* crl,
+                                CRLPolicy crl_policy);
+
+  // Looks up |key| at |time|.  On a hit, |target_cert| is re-parsed from
+  // |der_certs[0]| (ParsedCertificate cannot be copied) and |policy| is set to
+  // the cached policy.  Returns true on a hit, false otherwise.
+  bool Lookup(const std::string& key,
+              const std::vector<std::string>& der_certs,
+              const DateTime& time,
+              std::unique_ptr<ParsedCertificate>* target_cert,
+              CastDeviceCertPolicy* policy);
+
+  // Records the result of a successful verification of the chain identified
+  // by |key|.  |path| is the verified path as returned by the trust store and
+  // |crl| is the CRL that was checked, if any.
+  void Insert(const std::string& key,
+              const std::vector<const ParsedCertificate*>& path,
+              CastDeviceCertPolicy policy,
+              const CastCRL* crl);
+
+  void Clear();
+
+  size_t size() const;
+  uint64_t hits() const;
+  uint64_t misses() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    CastDeviceCertPolicy policy;
+
+    // The window during which every certificate of the verified path (and the
+    // checked CRL) is valid.
+    DateTime not_before;
+    DateTime not_after;
+  };
+
+  using LruList = std::list<Entry>;
+
+  const size_t max_entries_;
+
+  mutable std::mutex mutex_;
+
+  // Most recently used entries appear at the front of the list.
+  LruList lru_order_ ABSL_GUARDED_BY(mutex_);
+  std::unordered_map<std::string, LruList::iterator> entries_
+      ABSL_GUARDED_BY(mutex_);
+
+  uint64_t hits_ ABSL_GUARDED_BY(mutex_) = 0;
+  uint64_t misses_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  OSP_DISALLOW_COPY_AND_ASSIGN(DeviceCertVerificationCache);
+};
+
+}  // namespace cast
+}  // namespace openscreen
+
+#endif  // CAST_COMMON_CERTIFICATE_DEVICE_CERT_VERIFICATION_CACHE_H_
@@ -0,0 +1,163 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/common/certificate/device_cert_verification_cache.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cast/common/certificate/cast_cert_validator.h"
+#include "cast/common/public/parsed_certificate.h"
+#include "cast/common/public/trust_store.h"
+#include "gtest/gtest.h"
+#include "platform/test/paths.h"
+#include "util/crypto/pem_helpers.h"
+
+namespace openscreen {
+namespace cast {
+namespace {
+
+// Wraps the built-in Cast trust store and counts how often path building was
+// actually performed.
+class CountingTrustStore final : public TrustStore {
+ public:
+  CountingTrustStore() : trust_store_(CastTrustStore::Create()) {}
+  ~CountingTrustStore() override = default;
+
+  ErrorOr<CertificatePathResult> FindCertificatePath(
+      const std::vector<std::string>& der_certs,
+      const DateTime& time) override {
+    ++path_count_;
+    return trust_store_->FindCertificatePath(der_certs, time);
+  }
+
+  int path_count() const { return path_count_; }
+
+ private:
+  std::unique_ptr<TrustStore> trust_store_;
+  int path_count_ = 0;
+};
+
+DateTime CreateDate(int year, int month, int day) {
+  DateTime time = {};
+  time.year = year;
+  time.month = month;
+  time.day = day;
+  return time;
+}
+
+std::vector<std::string> ReadTestChain(const std::string& file_name) {
+  return ReadCertificatesFromPemFile(GetTestDataPath() +
+                                     "/cast/common/certificate/certificates/" +
+                                     file_name);
+}
+
+Error Verify(const std::vector<std::string>& certs,
+             const DateTime& time,
+             TrustStore* trust_store,
+             DeviceCertVerificationCache* cache,
+             std::unique_ptr<ParsedCertificate>* target_cert,
+             CastDeviceCertPolicy* policy) {
+  return VerifyDeviceCert(certs, time, target_cert, policy, nullptr,
+                          CRLPolicy::kCrlOptional, trust_store, cache);
+}
+
+}  // namespace
+
+TEST(DeviceCertVerificationCacheTest, HitSkipsPathBuilding) {
+  const std::vector<std::string> certs = ReadTestChain("chromecast_gen2.pem");
+  ASSERT_FALSE(certs.empty());
+  CountingTrustStore trust_store;
+  DeviceCertVerificationCache cache;
+
+  std::unique_ptr<ParsedCertificate> target_cert;
+  CastDeviceCertPolicy policy = CastDeviceCertPolicy::kAudioOnly;
+  ASSERT_TRUE(Verify(certs, CreateDate(2016, 4, 1), &trust_store, &cache,
+                     &target_cert, &policy)
+                  .ok());
+  EXPECT_EQ(1, trust_store.path_count());
+  EXPECT_EQ(0u, cache.hits());
+  EXPECT_EQ(1u, cache.misses());
+  EXPECT_EQ(1u, cache.size());
+
+  target_cert.reset();
+  policy = CastDeviceCertPolicy::kAudioOnly;
+  ASSERT_TRUE(Verify(certs, CreateDate(2016, 5, 1), &trust_store, &cache,
+                     &target_cert, &policy)
+                  .ok());
+  EXPECT_EQ(1, trust_store.path_count());
+  EXPECT_EQ(1u, cache.hits());
+  EXPECT_EQ(1u, cache.misses());
+  ASSERT_TRUE(target_cert);
+  EXPECT_EQ("3ZZAK6 FA8FCA3F0D35", target_cert->GetCommonName());
+  EXPECT_EQ(CastDeviceCertPolicy::kUnrestricted, policy);
+}
+
+TEST(DeviceCertVerificationCacheTest, ExpiredEntryIsNotUsed) {
+  const std::vector<std::string> certs = ReadTestChain("chromecast_gen2.pem");
+  ASSERT_FALSE(certs.empty());
+  CountingTrustStore trust_store;
+  DeviceCertVerificationCache cache;
+
+  std::unique_ptr<ParsedCertificate> target_cert;
+  CastDeviceCertPolicy policy;
+  ASSERT_TRUE(Verify(certs, CreateDate(2016, 4, 1), &trust_store, &cache,
+                     &target_cert, &policy)
+                  .ok());
+
+  // Outside of the validity of the chain, the cached result must not be used
+  // and full verification must fail as before.
+  EXPECT_EQ(Error::Code::kErrCertsDateInvalid,
+            Verify(certs, CreateDate(2037, 3, 1), &trust_store, &cache,
+                   &target_cert, &policy)
+                .code());
+  EXPECT_EQ(2, trust_store.path_count());
+  EXPECT_EQ(0u, cache.hits());
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(DeviceCertVerificationCacheTest, KeyDependsOnChainAndPolicy) {
+  const std::vector<std::string> gen2 = ReadTestChain("chromecast_gen2.pem");
+  const std::vector<std::string> vizio = ReadTestChain("vizio.pem");
+  ASSERT_FALSE(gen2.empty());
+  ASSERT_FALSE(vizio.empty());
+
+  const std::string key = DeviceCertVerificationCache::ComputeKey(
+      gen2, nullptr, CRLPolicy::kCrlOptional);
+  EXPECT_EQ(key, DeviceCertVerificationCache::ComputeKey(
+                     gen2, nullptr, CRLPolicy::kCrlOptional));
+  EXPECT_NE(key, DeviceCertVerificationCache::ComputeKey(
+                     vizio, nullptr, CRLPolicy::kCrlOptional));
+  EXPECT_NE(key, DeviceCertVerificationCache::ComputeKey(
+                     gen2, nullptr, CRLPolicy::kCrlRequired));
+}
+
+TEST(DeviceCertVerificationCacheTest, EvictsLeastRecentlyUsed) {
+  const std::vector<std::string> gen2 = ReadTestChain("chromecast_gen2.pem");
+  const std::vector<std::string> vizio = ReadTestChain("vizio.pem");
+  CountingTrustStore trust_store;
+  DeviceCertVerificationCache cache(1);
+  const DateTime time = CreateDate(2016, 4, 1);
+
+  std::unique_ptr<ParsedCertificate> target_cert;
+  CastDeviceCertPolicy policy;
+  ASSERT_TRUE(
+      Verify(gen2, time, &trust_store, &cache, &target_cert, &policy).ok());
+  ASSERT_TRUE(
+      Verify(vizio, time, &trust_store, &cache, &target_cert, &policy).ok());
+  EXPECT_EQ(1u, cache.size());
+
+  ASSERT_TRUE(
+      Verify(gen2, time, &trust_store, &cache, &target_cert, &policy).ok());
+  EXPECT_EQ(3, trust_store.path_count());
+  EXPECT_EQ(0u, cache.hits());
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+}
+
+}  // namespace cast
+}  // namespace openscreen
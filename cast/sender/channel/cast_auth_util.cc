@@ -262,7 +262,8 @@ ErrorOr<CastDeviceCertPolicy> VerifyCredentialsImpl(
     TrustStore* cast_trust_store,
     TrustStore* crl_trust_store,
     const DateTime& verification_time,
-    bool enforce_sha256_checking);
+    bool enforce_sha256_checking,
+    DeviceCertVerificationCache* cert_cache);
 
 ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReplyImpl(
     const CastMessage& challenge_reply,
@@ -271,7 +272,8 @@ ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReplyImpl(
     const CRLPolicy& crl_policy,
     TrustStore* cast_trust_store,
     TrustStore* crl_trust_store,
-    const DateTime& verification_time) {
+    const DateTime& verification_time,
+    DeviceCertVerificationCache* cert_cache) {
   DeviceAuthMessage auth_message;
   Error result = ParseAuthMessage(challenge_reply, &auth_message);
   if (!result.ok()) {
@@ -303,7 +305,7 @@ ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReplyImpl(
 
   return VerifyCredentialsImpl(response, nonce_plus_peer_cert_der.value(),
                                crl_policy, cast_trust_store, crl_trust_store,
-                               verification_time, false);
+                               verification_time, false, cert_cache);
 }
 
 ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReply(
@@ -311,13 +313,14 @@ ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReply(
     const ParsedCertificate& peer_cert,
     const AuthContext& auth_context,
     TrustStore* cast_trust_store,
-    TrustStore* crl_trust_store) {
+    TrustStore* crl_trust_store,
+    DeviceCertVerificationCache* cert_cache) {
   DateTime now = {};
   OSP_CHECK(DateTimeFromSeconds(GetWallTimeSinceUnixEpoch().count(), &now));
   CRLPolicy policy = CRLPolicy::kCrlOptional;
   return AuthenticateChallengeReplyImpl(challenge_reply, peer_cert,
                                         auth_context, policy, cast_trust_store,
-                                        crl_trust_store, now);
+                                        crl_trust_store, now, cert_cache);
 }
 
 ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReplyForTest(
@@ -330,7 +333,7 @@ ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReplyForTest(
     const DateTime& verification_time) {
   return AuthenticateChallengeReplyImpl(
       challenge_reply, peer_cert, auth_context, crl_policy, cast_trust_store,
-      crl_trust_store, verification_time);
+      crl_trust_store, verification_time, nullptr);
 }
 
 // This function does the following
@@ -357,7 +360,8 @@ ErrorOr<CastDeviceCertPolicy> VerifyCredentialsImpl(
     TrustStore* cast_trust_store,
     TrustStore* crl_trust_store,
     const DateTime& verification_time,
-    bool enforce_sha256_checking) {
+    bool enforce_sha256_checking,
+    DeviceCertVerificationCache* cert_cache) {
   if (response.signature().empty() && !signature_input.empty()) {
     return Error(Error::Code::kCastV2SignatureEmpty, "Signature is empty.");
   }
@@ -378,9 +382,9 @@ ErrorOr<CastDeviceCertPolicy> VerifyCredentialsImpl(
   // Perform certificate verification.
   CastDeviceCertPolicy device_policy;
   std::unique_ptr<ParsedCertificate> target_cert;
-  Error verify_result =
-      VerifyDeviceCert(cert_chain, verification_time, &target_cert,
-                       &device_policy, crl.get(), crl_policy, cast_trust_store);
+  Error verify_result = VerifyDeviceCert(
+      cert_chain, verification_time, &target_cert, &device_policy, crl.get(),
+      crl_policy, cast_trust_store, cert_cache);
 
   // Handle and report errors.
   Error result = MapToOpenscreenError(verify_result,
@@ -413,14 +417,15 @@ ErrorOr<CastDeviceCertPolicy> VerifyCredentials(
     TrustStore* cast_trust_store,
     TrustStore* crl_trust_store,
     bool enforce_revocation_checking,
-    bool enforce_sha256_checking) {
+    bool enforce_sha256_checking,
+    DeviceCertVerificationCache* cert_cache) {
   DateTime now = {};
   OSP_CHECK(DateTimeFromSeconds(GetWallTimeSinceUnixEpoch().count(), &now));
   CRLPolicy policy = (enforce_revocation_checking) ? CRLPolicy::kCrlRequired
                                                    : CRLPolicy::kCrlOptional;
   return VerifyCredentialsImpl(response, signature_input, policy,
                                cast_trust_store, crl_trust_store, now,
-                               enforce_sha256_checking);
+                               enforce_sha256_checking, cert_cache);
 }
 
 ErrorOr<CastDeviceCertPolicy> VerifyCredentialsForTest(
@@ -431,9 +436,9 @@ ErrorOr<CastDeviceCertPolicy> VerifyCredentialsForTest(
     TrustStore* crl_trust_store,
     const DateTime& verification_time,
     bool enforce_sha256_checking) {
-  return VerifyCredentialsImpl(response, signature_input, crl_policy,
-                               cast_trust_store, crl_trust_store,
-                               verification_time, enforce_sha256_checking);
+  return VerifyCredentialsImpl(
+      response, signature_input, crl_policy, cast_trust_store, crl_trust_store,
+      verification_time, enforce_sha256_checking, nullptr);
 }
 
 }  // namespace cast
@@ -24,6 +24,7 @@ namespace cast {
 
 enum class CRLPolicy;
 struct DateTime;
+class DeviceCertVerificationCache;
 class TrustStore;
 class ParsedCertificate;
 
@@ -55,12 +56,16 @@ class AuthContext {
 // Authenticates the given |challenge_reply|:
 // 1. Signature contained in the reply is valid.
 // 2. certificate used to sign is rooted to a trusted CA.
+//
+// If |cert_cache| is provided, it is used to skip re-verifying device
+// certificate chains that were already verified against |cast_trust_store|.
 ErrorOr<CastDeviceCertPolicy> AuthenticateChallengeReply(
     const ::cast::channel::CastMessage& challenge_reply,
     const ParsedCertificate& peer_cert,
     const AuthContext& auth_context,
     TrustStore* cast_trust_store,
-    TrustStore* crl_trust_store);
+    TrustStore* crl_trust_store,
+    DeviceCertVerificationCache* cert_cache = nullptr);
 
 // Exposed for testing only.
 //
@@ -88,7 +93,8 @@ ErrorOr<CastDeviceCertPolicy> VerifyCredentials(
     TrustStore* cast_trust_store,
     TrustStore* crl_trust_store,
     bool enforce_revocation_checking = false,
-    bool enforce_sha256_checking = false);
+    bool enforce_sha256_checking = false,
+    DeviceCertVerificationCache* cert_cache = nullptr);
 
 // Exposed for testing only.
 //
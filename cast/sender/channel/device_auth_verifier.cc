@@ -0,0 +1,134 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/sender/channel/device_auth_verifier.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "cast/common/public/parsed_certificate.h"
+#include "cast/sender/channel/cast_auth_util.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace cast {
+
+DeviceAuthVerifier::DeviceAuthVerifier(TaskRunner* task_runner,
+                                       TrustStore* cast_trust_store,
+                                       TrustStore* crl_trust_store,
+                                       DeviceCertVerificationCache* cert_cache,
+                                       int num_threads,
+                                       size_t max_queue_size)
+    : task_runner_(task_runner),
+      cast_trust_store_(cast_trust_store),
+      crl_trust_store_(crl_trust_store),
+      cert_cache_(cert_cache),
+      max_queue_size_(max_queue_size) {
+  OSP_DCHECK(task_runner_);
+  OSP_DCHECK(cast_trust_store_);
+  OSP_DCHECK(crl_trust_store_);
+  OSP_DCHECK_GT(max_queue_size_, 0u);
+
+  if (num_threads <= 0) {
+    num_threads =
+        std::min(std::max<int>(std::thread::hardware_concurrency(), 1), 4);
+  }
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this] { ProcessRequestsUntilTimeToQuit(); });
+  }
+}
+
+DeviceAuthVerifier::~DeviceAuthVerifier() {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    time_to_quit_ = true;
+    cv_.notify_all();
+  }
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void DeviceAuthVerifier::Authenticate(
+    ::cast::channel::CastMessage challenge_reply,
+    std::unique_ptr<ParsedCertificate> peer_cert,
+    std::unique_ptr<AuthContext> auth_context,
+    Callback callback) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+  OSP_DCHECK(peer_cert);
+  OSP_DCHECK(auth_context);
+
+  auto request = std::make_unique<Request>(
+      Request{std::move(challenge_reply), std::move(peer_cert),
+              std::move(auth_context), std::move(callback), Clock::now()});
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (queue_.size() < max_queue_size_) {
+      queue_.push(std::move(request));
+      metrics_.queue_depth = queue_.size();
+      metrics_.max_queue_depth =
+          std::max(metrics_.max_queue_depth, metrics_.queue_depth);
+      cv_.notify_one();
+      return;
+    }
+    ++metrics_.rejected;
+  }
+
+  task_runner_->PostTask([weak_this = weak_factory_.GetWeakPtr(),
+                          callback = std::move(request->callback)] {
+    if (weak_this) {
+      callback(Error(Error::Code::kAgain,
+                     "Too many pending device auth verifications"));
+    }
+  });
+}
+
+DeviceAuthVerifier::Metrics DeviceAuthVerifier::GetMetrics() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+void DeviceAuthVerifier::ProcessRequestsUntilTimeToQuit() {
+  for (;;) {
+    std::unique_ptr<Request> request;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return time_to_quit_ || !queue_.empty(); });
+      if (time_to_quit_) {
+        break;
+      }
+      request = std::move(queue_.front());
+      queue_.pop();
+      metrics_.queue_depth = queue_.size();
+    }
+
+    ErrorOr<CastDeviceCertPolicy> result = AuthenticateChallengeReply(
+        request->challenge_reply, *request->peer_cert, *request->auth_context,
+        cast_trust_store_, crl_trust_store_, cert_cache_);
+
+    // Clock::now() is being called directly, instead of using a
+    // dependency-injected "now function," since actual wall time is being
+    // measured.
+    const Clock::duration latency = Clock::now() - request->enqueue_time;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++metrics_.completed;
+      metrics_.total_latency += latency;
+      metrics_.max_latency = std::max(metrics_.max_latency, latency);
+    }
+
+    task_runner_->PostTask([weak_this = weak_factory_.GetWeakPtr(),
+                            callback = std::move(request->callback),
+                            result = std::move(result)]() mutable {
+      if (weak_this) {
+        callback(std::move(result));
+      }
+    });
+  }
+}
+
+}  // namespace cast
+}  // namespace openscreen
@@ -0,0 +1,119 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CAST_SENDER_CHANNEL_DEVICE_AUTH_VERIFIER_H_
+#define CAST_SENDER_CHANNEL_DEVICE_AUTH_VERIFIER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "cast/common/certificate/cast_cert_validator.h"
+#include "cast/common/channel/proto/cast_channel.pb.h"
+#include "platform/api/task_runner.h"
+#include "platform/api/time.h"
+#include "platform/base/error.h"
+#include "util/weak_ptr.h"
+
+namespace openscreen {
+namespace cast {
+
+class AuthContext;
+class DeviceCertVerificationCache;
+class ParsedCertificate;
+class TrustStore;
+
+// Runs AuthenticateChallengeReply(), i.e. device certificate chain verification
+// and the auth response signature check, on a bounded pool of worker threads.
+// Results are posted back to the TaskRunner that owns this object, so a burst
+// of reconnects doesn't block other work on that TaskRunner.
+class DeviceAuthVerifier {
+ public:
+  using Callback = std::function<void(ErrorOr<CastDeviceCertPolicy>)>;
+
+  struct Metrics {
+    // Number of requests waiting for a worker thread, now and at most.
+    size_t queue_depth = 0;
+    size_t max_queue_depth = 0;
+
+    // Number of requests completed, and rejected because the queue was full.
+    uint64_t completed = 0;
+    uint64_t rejected = 0;
+
+    // Time from Authenticate() until the verification finished, including the
+    // time spent in the queue.
+    Clock::duration total_latency{};
+    Clock::duration max_latency{};
+  };
+
+  static constexpr size_t kDefaultMaxQueueSize = 64;
+
+  // |task_runner|, the trust stores and |cert_cache| must outlive |this|.  The
+  // trust stores are used from all of the worker threads concurrently, and
+  // |cert_cache| may be nullptr.  If |num_threads| is zero, a default based on
+  // the number of available cores is used.
+  DeviceAuthVerifier(TaskRunner* task_runner,
+                     TrustStore* cast_trust_store,
+                     TrustStore* crl_trust_store,
+                     DeviceCertVerificationCache* cert_cache,
+                     int num_threads = 0,
+                     size_t max_queue_size = kDefaultMaxQueueSize);
+  ~DeviceAuthVerifier();
+
+  // Authenticates |challenge_reply| against |peer_cert| and |auth_context| on a
+  // worker thread, then runs |callback| on the TaskRunner.  If too many
+  // requests are already queued, |callback| is run with kAgain instead.
+  // |callback| is never run after |this| is destroyed.
+  void Authenticate(::cast::channel::CastMessage challenge_reply,
+                    std::unique_ptr<ParsedCertificate> peer_cert,
+                    std::unique_ptr<AuthContext> auth_context,
+                    Callback callback);
+
+  Metrics GetMetrics() const;
+
+ private:
+  struct Request {
+    ::cast::channel::CastMessage challenge_reply;
+    std::unique_ptr<ParsedCertificate> peer_cert;
+    std::unique_ptr<AuthContext> auth_context;
+    Callback callback;
+    Clock::time_point enqueue_time;
+  };
+
+  // The procedure for each worker thread, which loops processing requests from
+  // |queue_| until it's time to end the thread.
+  void ProcessRequestsUntilTimeToQuit();
+
+  TaskRunner* const task_runner_;
+  TrustStore* const cast_trust_store_;
+  TrustStore* const crl_trust_store_;
+  DeviceCertVerificationCache* const cert_cache_;
+  const size_t max_queue_size_;
+
+  // Guards the members shared by the TaskRunner and the worker threads.
+  mutable std::mutex mutex_;
+
+  // Used by the worker threads to sleep until more work is available.
+  std::condition_variable cv_ ABSL_GUARDED_BY(mutex_);
+  bool time_to_quit_ ABSL_GUARDED_BY(mutex_) = false;
+  std::queue<std::unique_ptr<Request>> queue_ ABSL_GUARDED_BY(mutex_);
+  Metrics metrics_ ABSL_GUARDED_BY(mutex_);
+
+  std::vector<std::thread> threads_;
+
+  WeakPtrFactory<DeviceAuthVerifier> weak_factory_{this};
+};
+
+}  // namespace cast
+}  // namespace openscreen
+
+#endif  // CAST_SENDER_CHANNEL_DEVICE_AUTH_VERIFIER_H_
@@ -0,0 +1,108 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/sender/channel/device_auth_verifier.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cast/common/public/parsed_certificate.h"
+#include "cast/common/public/trust_store.h"
+#include "cast/sender/channel/cast_auth_util.h"
+#include "cast/sender/testing/test_helpers.h"
+#include "gtest/gtest.h"
+#include "platform/test/paths.h"
+#include "util/crypto/pem_helpers.h"
+
+namespace openscreen {
+namespace cast {
+namespace {
+
+using ::cast::channel::CastMessage;
+
+std::unique_ptr<ParsedCertificate> ReadPeerCert() {
+  const std::vector<std::string> certs = ReadCertificatesFromPemFile(
+      GetTestDataPath() +
+      "/cast/common/certificate/certificates/test_tls_cert.pem");
+  OSP_CHECK(!certs.empty());
+  return std::move(ParsedCertificate::ParseFromDER(std::vector<uint8_t>(
+                                                       certs[0].begin(),
+                                                       certs[0].end()))
+                       .value());
+}
+
+// A challenge reply with a string payload, which fails authentication before
+// any certificate is verified.
+CastMessage CreateInvalidChallengeReply() {
+  CastMessage message;
+  message.set_payload_type(::cast::channel::CastMessage_PayloadType_STRING);
+  message.set_payload_utf8("not an auth message");
+  return message;
+}
+
+class DeviceAuthVerifierTest : public ::testing::Test {
+ protected:
+  ThreadSafeTaskRunner task_runner_;
+  std::unique_ptr<TrustStore> cast_trust_store_ = CastTrustStore::Create();
+  std::unique_ptr<TrustStore> crl_trust_store_ = CastCRLTrustStore::Create();
+};
+
+}  // namespace
+
+TEST_F(DeviceAuthVerifierTest, PostsResultsToTaskRunner) {
+  DeviceAuthVerifier verifier(&task_runner_, cast_trust_store_.get(),
+                              crl_trust_store_.get(), nullptr, 2);
+
+  constexpr int kNumRequests = 10;
+  std::vector<Error::Code> results;
+  for (int i = 0; i < kNumRequests; ++i) {
+    verifier.Authenticate(
+        CreateInvalidChallengeReply(), ReadPeerCert(),
+        std::make_unique<AuthContext>(AuthContext::Create()),
+        [this, &results](ErrorOr<CastDeviceCertPolicy> result) {
+          EXPECT_TRUE(task_runner_.IsRunningOnTaskRunner());
+          results.push_back(result.error().code());
+        });
+  }
+
+  task_runner_.WaitForAndRunTasks(kNumRequests);
+  ASSERT_EQ(static_cast<size_t>(kNumRequests), results.size());
+  for (Error::Code code : results) {
+    EXPECT_EQ(Error::Code::kCastV2WrongPayloadType, code);
+  }
+
+  const DeviceAuthVerifier::Metrics metrics = verifier.GetMetrics();
+  EXPECT_EQ(0u, metrics.queue_depth);
+  EXPECT_GE(metrics.max_queue_depth, 1u);
+  EXPECT_EQ(static_cast<uint64_t>(kNumRequests), metrics.completed);
+  EXPECT_EQ(0u, metrics.rejected);
+  EXPECT_GE(metrics.total_latency, metrics.max_latency);
+}
+
+TEST_F(DeviceAuthVerifierTest, DropsResultsAfterDestruction) {
+  auto verifier = std::make_unique<DeviceAuthVerifier>(
+      &task_runner_, cast_trust_store_.get(), crl_trust_store_.get(), nullptr,
+      1);
+
+  bool called = false;
+  verifier->Authenticate(CreateInvalidChallengeReply(), ReadPeerCert(),
+                         std::make_unique<AuthContext>(AuthContext::Create()),
+                         [&called](ErrorOr<CastDeviceCertPolicy> result) {
+                           called = true;
+                         });
+
+  // Wait for the result to be posted, then destroy the verifier before it runs.
+  while (verifier->GetMetrics().completed == 0) {
+    std::this_thread::yield();
+  }
+  verifier.reset();
+  task_runner_.WaitForAndRunTasks(1);
+  EXPECT_FALSE(called);
+}
+
+}  // namespace cast
+}  // namespace openscreen
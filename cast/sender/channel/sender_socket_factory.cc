@@ -4,9 +4,11 @@
 
 #include "cast/sender/public/sender_socket_factory.h"
 
+#include "cast/common/certificate/device_cert_verification_cache.h"
 #include "cast/common/channel/proto/cast_channel.pb.h"
 #include "cast/common/public/trust_store.h"
 #include "cast/sender/channel/cast_auth_util.h"
+#include "cast/sender/channel/device_auth_verifier.h"
 #include "cast/sender/channel/message_util.h"
 #include "platform/base/tls_connect_options.h"
 #include "util/crypto/certificate_utils.h"
@@ -44,7 +46,8 @@ SenderSocketFactory::SenderSocketFactory(
     : client_(client),
       task_runner_(task_runner),
       cast_trust_store_(std::move(cast_trust_store)),
-      crl_trust_store_(std::move(crl_trust_store)) {
+      crl_trust_store_(std::move(crl_trust_store)),
+      cert_cache_(std::make_unique<DeviceCertVerificationCache>()) {
   OSP_DCHECK(client);
   OSP_DCHECK(task_runner);
   OSP_DCHECK(cast_trust_store_);
@@ -60,6 +63,13 @@ void SenderSocketFactory::set_factory(TlsConnectionFactory* factory) {
   factory_ = factory;
 }
 
+void SenderSocketFactory::EnableAsyncAuthentication(int num_threads) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+  auth_verifier_ = std::make_unique<DeviceAuthVerifier>(
+      task_runner_, cast_trust_store_.get(), crl_trust_store_.get(),
+      cert_cache_.get(), num_threads);
+}
+
 void SenderSocketFactory::Connect(const IPEndpoint& endpoint,
                                   DeviceMediaPolicy media_policy,
                                   CastSocket::Client* client) {
@@ -69,7 +79,9 @@ void SenderSocketFactory::Connect(const IPEndpoint& endpoint,
   if (it == pending_connections_.end()) {
     pending_connections_.emplace_back(
         PendingConnection{endpoint, media_policy, client});
-    factory_->Connect(endpoint, TlsConnectOptions{true});
+    TlsConnectOptions options{true};
+    options.enable_session_resumption = true;
+    factory_->Connect(endpoint, options);
   }
 }
 
@@ -146,12 +158,16 @@ SenderSocketFactory::FindPendingConnection(const IPEndpoint& endpoint) {
                       });
 }
 
+std::vector<std::unique_ptr<SenderSocketFactory::PendingAuth>>::iterator
+SenderSocketFactory::FindPendingAuth(int socket_id) {
+  return std::find_if(pending_auth_.begin(), pending_auth_.end(),
+                      [socket_id](const std::unique_ptr<PendingAuth>& pending) {
+                        return pending->socket->socket_id() == socket_id;
+                      });
+}
+
 void SenderSocketFactory::OnError(CastSocket* socket, Error error) {
-  auto it = std::find_if(pending_auth_.begin(), pending_auth_.end(),
-                         [id = socket->socket_id()](
-                             const std::unique_ptr<PendingAuth>& pending_auth) {
-                           return pending_auth->socket->socket_id() == id;
-                         });
+  auto it = FindPendingAuth(socket->socket_id());
   if (it == pending_auth_.end()) {
     OSP_DLOG_ERROR << "Got error for unknown pending socket";
     return;
@@ -162,27 +178,57 @@ void SenderSocketFactory::OnError(CastSocket* socket, Error error) {
 }
 
 void SenderSocketFactory::OnMessage(CastSocket* socket, CastMessage message) {
-  auto it = std::find_if(pending_auth_.begin(), pending_auth_.end(),
-                         [id = socket->socket_id()](
-                             const std::unique_ptr<PendingAuth>& pending_auth) {
-                           return pending_auth->socket->socket_id() == id;
-                         });
+  auto it = FindPendingAuth(socket->socket_id());
   if (it == pending_auth_.end()) {
     OSP_DLOG_ERROR << "Got message for unknown pending socket";
     return;
   }
+  if ((*it)->auth_in_progress) {
+    OSP_DLOG_WARN << "Got message for socket still being authenticated";
+    return;
+  }
 
-  std::unique_ptr<PendingAuth> pending = std::move(*it);
-  pending_auth_.erase(it);
   if (!IsAuthMessage(message)) {
+    std::unique_ptr<PendingAuth> pending = std::move(*it);
+    pending_auth_.erase(it);
     client_->OnError(this, pending->endpoint,
                      Error::Code::kCastV2AuthenticationError);
     return;
   }
 
+  if (auth_verifier_) {
+    // |pending| stays in |pending_auth_| while the reply is verified, so that
+    // socket errors in the meantime are still reported.  It is completed only
+    // if it's still there when the result comes back.
+    PendingAuth& pending = **it;
+    pending.auth_in_progress = true;
+    auth_verifier_->Authenticate(
+        std::move(message), std::move(pending.peer_cert),
+        std::move(pending.auth_context),
+        [this, socket_id = socket->socket_id()](
+            ErrorOr<CastDeviceCertPolicy> policy_or_error) {
+          auto it = FindPendingAuth(socket_id);
+          if (it == pending_auth_.end()) {
+            return;
+          }
+          std::unique_ptr<PendingAuth> pending = std::move(*it);
+          pending_auth_.erase(it);
+          OnAuthenticated(std::move(pending), std::move(policy_or_error));
+        });
+    return;
+  }
+
+  std::unique_ptr<PendingAuth> pending = std::move(*it);
+  pending_auth_.erase(it);
   ErrorOr<CastDeviceCertPolicy> policy_or_error = AuthenticateChallengeReply(
       message, *pending->peer_cert, *pending->auth_context,
-      cast_trust_store_.get(), crl_trust_store_.get());
+      cast_trust_store_.get(), crl_trust_store_.get(), cert_cache_.get());
+  OnAuthenticated(std::move(pending), std::move(policy_or_error));
+}
+
+void SenderSocketFactory::OnAuthenticated(
+    std::unique_ptr<PendingAuth> pending,
+    ErrorOr<CastDeviceCertPolicy> policy_or_error) {
   if (policy_or_error.is_error()) {
     OSP_DLOG_WARN << "Authentication failed for " << pending->endpoint
                   << " with error: " << policy_or_error.error();
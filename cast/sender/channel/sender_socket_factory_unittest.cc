@@ -0,0 +1,221 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cast/sender/public/sender_socket_factory.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cast/common/channel/message_util.h"
+#include "cast/common/channel/testing/fake_cast_socket.h"
+#include "cast/common/channel/testing/mock_socket_error_handler.h"
+#include "cast/common/channel/virtual_connection_router.h"
+#include "cast/common/public/trust_store.h"
+#include "cast/receiver/channel/device_auth_namespace_handler.h"
+#include "cast/receiver/channel/static_credentials.h"
+#include "cast/sender/testing/test_helpers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/api/tls_connection_factory.h"
+#include "platform/base/tls_connect_options.h"
+#include "platform/base/tls_listen_options.h"
+#include "platform/test/mock_tls_connection.h"
+
+namespace openscreen {
+namespace cast {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+class MockTlsConnectionFactory final : public TlsConnectionFactory {
+ public:
+  ~MockTlsConnectionFactory() override = default;
+
+  MOCK_METHOD(void,
+              Connect,
+              (const IPEndpoint& remote_address,
+               const TlsConnectOptions& options),
+              (override));
+  MOCK_METHOD(void,
+              SetListenCredentials,
+              (const TlsCredentials& credentials),
+              (override));
+  MOCK_METHOD(void,
+              Listen,
+              (const IPEndpoint& local_address,
+               const TlsListenOptions& options),
+              (override));
+};
+
+class MockSenderSocketFactoryClient final
+    : public SenderSocketFactory::Client {
+ public:
+  ~MockSenderSocketFactoryClient() override = default;
+
+  MOCK_METHOD(void,
+              OnConnected,
+              (SenderSocketFactory * factory,
+               const IPEndpoint& endpoint,
+               std::unique_ptr<CastSocket> socket),
+              (override));
+  MOCK_METHOD(void,
+              OnError,
+              (SenderSocketFactory * factory,
+               const IPEndpoint& endpoint,
+               Error error),
+              (override));
+};
+
+const IPEndpoint kLocalEndpoint{{10, 0, 1, 7}, 1234};
+const IPEndpoint kDeviceEndpoint{{10, 0, 1, 9}, 8009};
+
+// Connects SenderSocketFactory to a simulated device, whose
+// DeviceAuthNamespaceHandler answers the auth challenge with |credentials_|.
+class SenderSocketFactoryTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    credentials_ =
+        std::move(GenerateCredentialsForTesting("Device ID").value());
+    auth_handler_ = std::make_unique<DeviceAuthNamespaceHandler>(
+        credentials_.provider.get());
+    router_.AddHandlerForLocalId(kPlatformReceiverId, auth_handler_.get());
+
+    auto device_connection = std::make_unique<NiceMock<MockTlsConnection>>(
+        kDeviceEndpoint, kLocalEndpoint);
+    device_connection_ = device_connection.get();
+    router_.TakeSocket(&mock_error_handler_,
+                       std::make_unique<CastSocket>(
+                           std::move(device_connection), &mock_device_client_));
+
+    factory_ = std::make_unique<SenderSocketFactory>(
+        &mock_client_, &task_runner_,
+        TrustStore::CreateInstanceForTest(credentials_.root_cert_der),
+        CastCRLTrustStore::Create());
+    factory_->set_factory(&mock_tls_factory_);
+  }
+
+  void TearDown() override {
+    socket_.reset();
+    factory_.reset();
+    task_runner_.RunTasksUntilIdle();
+  }
+
+ protected:
+  // Starts a connection to the device and completes the TLS connection with
+  // |peer_cert|.  The device answers the auth challenge right away, so the
+  // factory has the challenge reply when this returns.
+  void ConnectWithPeerCert(const std::vector<uint8_t>& peer_cert) {
+    EXPECT_CALL(mock_tls_factory_, Connect(kDeviceEndpoint, _));
+    factory_->Connect(kDeviceEndpoint,
+                      SenderSocketFactory::DeviceMediaPolicy::kNone,
+                      &mock_socket_client_);
+
+    auto connection = std::make_unique<NiceMock<MockTlsConnection>>(
+        kLocalEndpoint, kDeviceEndpoint);
+    MockTlsConnection* sender_connection = connection.get();
+    ON_CALL(*sender_connection, Send(_, _))
+        .WillByDefault(Invoke([this](const void* data, size_t len) {
+          device_connection_->OnRead(std::vector<uint8_t>(
+              reinterpret_cast<const uint8_t*>(data),
+              reinterpret_cast<const uint8_t*>(data) + len));
+          return true;
+        }));
+    ON_CALL(*device_connection_, Send(_, _))
+        .WillByDefault(
+            Invoke([sender_connection](const void* data, size_t len) {
+              sender_connection->OnRead(std::vector<uint8_t>(
+                  reinterpret_cast<const uint8_t*>(data),
+                  reinterpret_cast<const uint8_t*>(data) + len));
+              return true;
+            }));
+
+    factory_->OnConnected(&mock_tls_factory_, peer_cert, std::move(connection));
+  }
+
+  ThreadSafeTaskRunner task_runner_;
+  GeneratedCredentials credentials_;
+
+  // The simulated device.
+  VirtualConnectionRouter router_;
+  std::unique_ptr<DeviceAuthNamespaceHandler> auth_handler_;
+  MockSocketErrorHandler mock_error_handler_;
+  MockCastSocketClient mock_device_client_;
+  NiceMock<MockTlsConnection>* device_connection_ = nullptr;
+
+  MockTlsConnectionFactory mock_tls_factory_;
+  MockSenderSocketFactoryClient mock_client_;
+  MockCastSocketClient mock_socket_client_;
+  std::unique_ptr<SenderSocketFactory> factory_;
+  std::unique_ptr<CastSocket> socket_;
+};
+
+}  // namespace
+
+TEST_F(SenderSocketFactoryTest, AuthenticatesSynchronouslyByDefault) {
+  EXPECT_CALL(mock_client_, OnConnected(factory_.get(), kDeviceEndpoint, _))
+      .WillOnce(Invoke([this](SenderSocketFactory* factory,
+                              const IPEndpoint& endpoint,
+                              std::unique_ptr<CastSocket> socket) {
+        socket_ = std::move(socket);
+      }));
+  EXPECT_CALL(mock_client_, OnError(_, _, _)).Times(0);
+  ConnectWithPeerCert(credentials_.tls_credentials.der_x509_cert);
+  ASSERT_TRUE(socket_);
+  EXPECT_FALSE(socket_->audio_only());
+}
+
+TEST_F(SenderSocketFactoryTest, AsyncAuthenticationSucceedsOnTaskRunner) {
+  factory_->EnableAsyncAuthentication(2);
+  ConnectWithPeerCert(credentials_.tls_credentials.der_x509_cert);
+
+  bool connected = false;
+  EXPECT_CALL(mock_client_, OnConnected(factory_.get(), kDeviceEndpoint, _))
+      .WillOnce(Invoke([this, &connected](SenderSocketFactory* factory,
+                                          const IPEndpoint& endpoint,
+                                          std::unique_ptr<CastSocket> socket) {
+        EXPECT_TRUE(task_runner_.IsRunningOnTaskRunner());
+        connected = true;
+        socket_ = std::move(socket);
+      }));
+  EXPECT_CALL(mock_client_, OnError(_, _, _)).Times(0);
+
+  // The result is only delivered by a task posted from the worker thread.
+  EXPECT_FALSE(connected);
+  task_runner_.WaitForAndRunTasks(1);
+  EXPECT_TRUE(connected);
+  ASSERT_TRUE(socket_);
+  EXPECT_FALSE(socket_->audio_only());
+}
+
+TEST_F(SenderSocketFactoryTest, AsyncAuthenticationFailsOnTaskRunner) {
+  factory_->EnableAsyncAuthentication(2);
+
+  // The device signs the challenge for its own TLS certificate, so the reply
+  // doesn't authenticate a connection presenting a different one.
+  ErrorOr<GeneratedCredentials> other_credentials =
+      GenerateCredentialsForTesting("Other Device ID");
+  ASSERT_TRUE(other_credentials);
+  ConnectWithPeerCert(other_credentials.value().tls_credentials.der_x509_cert);
+
+  bool failed = false;
+  EXPECT_CALL(mock_client_, OnConnected(_, _, _)).Times(0);
+  EXPECT_CALL(mock_client_, OnError(factory_.get(), kDeviceEndpoint, _))
+      .WillOnce(Invoke([this, &failed](SenderSocketFactory* factory,
+                                       const IPEndpoint& endpoint,
+                                       Error error) {
+        EXPECT_TRUE(task_runner_.IsRunningOnTaskRunner());
+        EXPECT_FALSE(error.ok());
+        failed = true;
+      }));
+
+  EXPECT_FALSE(failed);
+  task_runner_.WaitForAndRunTasks(1);
+  EXPECT_TRUE(failed);
+}
+
+}  // namespace cast
+}  // namespace openscreen
@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 
+#include "cast/common/certificate/cast_cert_validator.h"
 #include "cast/common/public/cast_socket.h"
 #include "cast/common/public/parsed_certificate.h"
 #include "platform/api/serial_delete_ptr.h"
@@ -21,6 +22,8 @@ namespace openscreen {
 namespace cast {
 
 class AuthContext;
+class DeviceAuthVerifier;
+class DeviceCertVerificationCache;
 class TrustStore;
 
 class SenderSocketFactory final : public TlsConnectionFactory::Client,
@@ -57,6 +60,11 @@ class SenderSocketFactory final : public TlsConnectionFactory::Client,
   // |factory| cannot be nullptr and must outlive |this|.
   void set_factory(TlsConnectionFactory* factory);
 
+  // Moves device authentication off of |task_runner| and onto a pool of
+  // |num_threads| worker threads (or a default number, if zero), so that many
+  // simultaneous connections don't block other work on |task_runner|.
+  void EnableAsyncAuthentication(int num_threads = 0);
+
   // Begins connecting to a Cast device at |endpoint|.  If a successful
   // connection is made, including device authentication, the new CastSocket
   // will be passed to |client_|'s OnConnected method.  The new CastSocket will
@@ -93,6 +101,9 @@ class SenderSocketFactory final : public TlsConnectionFactory::Client,
     CastSocket::Client* client;
     std::unique_ptr<AuthContext> auth_context;
     std::unique_ptr<ParsedCertificate> peer_cert;
+
+    // Set while the challenge reply is being verified asynchronously.
+    bool auth_in_progress = false;
   };
 
   friend bool operator<(const std::unique_ptr<PendingAuth>& a, int b);
@@ -100,6 +111,13 @@ class SenderSocketFactory final : public TlsConnectionFactory::Client,
 
   std::vector<PendingConnection>::iterator FindPendingConnection(
       const IPEndpoint& endpoint);
+  std::vector<std::unique_ptr<PendingAuth>>::iterator FindPendingAuth(
+      int socket_id);
+
+  // Completes the connection of |pending| once its challenge reply was
+  // authenticated.
+  void OnAuthenticated(std::unique_ptr<PendingAuth> pending,
+                       ErrorOr<CastDeviceCertPolicy> policy_or_error);
 
   // CastSocket::Client overrides.
   void OnError(CastSocket* socket, Error error) override;
@@ -115,6 +133,13 @@ class SenderSocketFactory final : public TlsConnectionFactory::Client,
   // Trust stores for use with AuthenticateChallengeReply.
   std::unique_ptr<TrustStore> cast_trust_store_;
   std::unique_ptr<TrustStore> crl_trust_store_;
+
+  // Caches device certificate chains verified against |cast_trust_store_|, so
+  // that reconnecting to the same devices doesn't repeat path building.
+  std::unique_ptr<DeviceCertVerificationCache> cert_cache_;
+
+  // Only set if EnableAsyncAuthentication() was called.
+  std::unique_ptr<DeviceAuthVerifier> auth_verifier_;
 };
 
 }  // namespace cast
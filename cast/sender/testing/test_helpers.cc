@@ -4,6 +4,8 @@
 
 #include "cast/sender/testing/test_helpers.h"
 
+#include <utility>
+
 #include "cast/common/channel/message_util.h"
 #include "cast/receiver/channel/message_util.h"
 #include "cast/sender/channel/message_util.h"
@@ -83,5 +85,53 @@ CastMessage CreateAppUnavailableResponseChecked(int request_id,
   return std::move(message.value());
 }
 
+ThreadSafeTaskRunner::ThreadSafeTaskRunner()
+    : thread_id_(std::this_thread::get_id()) {}
+
+ThreadSafeTaskRunner::~ThreadSafeTaskRunner() = default;
+
+void ThreadSafeTaskRunner::PostPackagedTask(Task task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  tasks_.push_back(std::move(task));
+  cv_.notify_one();
+}
+
+void ThreadSafeTaskRunner::PostPackagedTaskWithDelay(Task task,
+                                                     Clock::duration delay) {
+  PostPackagedTask(std::move(task));
+}
+
+bool ThreadSafeTaskRunner::IsRunningOnTaskRunner() {
+  return std::this_thread::get_id() == thread_id_;
+}
+
+void ThreadSafeTaskRunner::WaitForAndRunTasks(size_t count) {
+  std::vector<Task> tasks;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, count] { return tasks_.size() >= count; });
+    tasks.swap(tasks_);
+  }
+  for (Task& task : tasks) {
+    task();
+  }
+}
+
+void ThreadSafeTaskRunner::RunTasksUntilIdle() {
+  while (true) {
+    std::vector<Task> tasks;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      tasks.swap(tasks_);
+    }
+    if (tasks.empty()) {
+      return;
+    }
+    for (Task& task : tasks) {
+      task();
+    }
+  }
+}
+
 }  // namespace cast
 }  // namespace openscreen
@@ -5,10 +5,15 @@
 #ifndef CAST_SENDER_TESTING_TEST_HELPERS_H_
 #define CAST_SENDER_TESTING_TEST_HELPERS_H_
 
+#include <condition_variable>
 #include <cstdint>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "cast/sender/channel/message_util.h"
+#include "platform/api/task_runner.h"
 
 namespace cast {
 namespace channel {
@@ -37,6 +42,32 @@ void VerifyAppAvailabilityRequest(const ::cast::channel::CastMessage& message,
     const std::string& sender_id,
     const std::string& app_id);
 
+// A TaskRunner that accepts tasks from any thread, but only runs them when the
+// test thread asks it to.  Used to test code that posts results back from
+// worker threads.
+class ThreadSafeTaskRunner final : public TaskRunner {
+ public:
+  ThreadSafeTaskRunner();
+  ~ThreadSafeTaskRunner() override;
+
+  // TaskRunner overrides.
+  void PostPackagedTask(Task task) override;
+  void PostPackagedTaskWithDelay(Task task, Clock::duration delay) override;
+  bool IsRunningOnTaskRunner() override;
+
+  // Waits until at least |count| tasks were posted, then runs them.
+  void WaitForAndRunTasks(size_t count);
+
+  // Runs the posted tasks, and any tasks they post, until none are left.
+  void RunTasksUntilIdle();
+
+ private:
+  const std::thread::id thread_id_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Task> tasks_;
+};
+
 }  // namespace cast
 }  // namespace openscreen
 
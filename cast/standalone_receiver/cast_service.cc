@@ -26,7 +26,8 @@ constexpr uint16_t kDefaultCastServicePort = 8010;
 constexpr int kCastUniqueIdLength = 6;
 
 constexpr int kDefaultMaxBacklogSize = 64;
-const TlsListenOptions kDefaultListenOptions{kDefaultMaxBacklogSize};
+const TlsListenOptions kDefaultListenOptions{kDefaultMaxBacklogSize,
+                                             /*enable_session_tickets=*/true};
 
 IPEndpoint DetermineEndpoint(const InterfaceInfo& interface) {
   const IPAddress address = interface.GetIpAddressV4()
@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "platform/base/error.h"
@@ -114,12 +115,7 @@ EnumNameTable<AspectRatioConstraint, 2> kAspectRatioConstraintNames{
     {{kScalingReceiver, AspectRatioConstraint::kVariable},
      {kScalingSender, AspectRatioConstraint::kFixed}}};
 
-Json::Value AspectRatioConstraintToJson(AspectRatioConstraint aspect_ratio) {
-  return Json::Value(GetEnumName(kAspectRatioConstraintNames, aspect_ratio)
-                         .value(kScalingSender));
-}
-
-bool TryParseAspectRatioConstraint(const Json::Value& value,
+bool TryParseAspectRatioConstraint(const json::Scalar& value,
                                    AspectRatioConstraint* out) {
   std::string aspect_ratio;
   if (!json::TryParseString(value, &aspect_ratio)) {
@@ -135,36 +131,259 @@ bool TryParseAspectRatioConstraint(const Json::Value& value,
   return true;
 }
 
-template <typename T>
-Json::Value PrimitiveVectorToJson(const std::vector<T>& vec) {
-  Json::Value array(Json::ValueType::arrayValue);
-  array.resize(vec.size());
+void WritePrimitive(int value, json::StreamingWriter* writer) {
+  writer->Int(value);
+}
+
+void WritePrimitive(Ssrc value, json::StreamingWriter* writer) {
+  writer->Uint(value);
+}
+
+void WritePrimitive(const std::string& value, json::StreamingWriter* writer) {
+  writer->String(value);
+}
 
-  for (Json::Value::ArrayIndex i = 0; i < vec.size(); ++i) {
-    array[i] = Json::Value(vec[i]);
+template <typename T>
+void WritePrimitiveVector(const std::vector<T>& vec,
+                          json::StreamingWriter* writer) {
+  writer->BeginArray();
+  for (const T& value : vec) {
+    WritePrimitive(value, writer);
   }
+  writer->EndArray();
+}
 
-  return array;
+// A member that is itself parsed by T::TryParse(), as soon as it is read.
+template <typename T>
+struct ParsedMember {
+  // Whether the member is missing (or null).
+  bool is_null = true;
+  bool is_valid = false;
+  T value = {};
+};
+
+template <typename T>
+void ParseMember(json::StreamingReader* reader, ParsedMember<T>* out) {
+  out->is_null = reader->PeekNull();
+  if (out->is_null) {
+    reader->SkipValue();
+    return;
+  }
+  out->is_valid = T::TryParse(reader, &out->value);
 }
 
 template <typename T>
-bool ParseOptional(const Json::Value& value, absl::optional<T>* out) {
+bool ParseOptional(const ParsedMember<T>& member, absl::optional<T>* out) {
   // It's fine if the value is empty.
-  if (!value) {
+  if (member.is_null) {
     return true;
   }
-  T tentative_out;
-  if (!T::TryParse(value, &tentative_out)) {
+  if (!member.is_valid) {
+    return false;
+  }
+  *out = member.value;
+  return true;
+}
+
+struct AudioConstraintsFields {
+  json::Scalar max_sample_rate;
+  json::Scalar max_channels;
+  json::Scalar max_bit_rate;
+  json::Scalar max_delay;
+  json::Scalar min_bit_rate;
+};
+
+constexpr json::FieldBinding<AudioConstraintsFields>
+    kAudioConstraintsBindings[] = {
+        {kMaxSampleRate, &AudioConstraintsFields::max_sample_rate},
+        {kMaxChannels, &AudioConstraintsFields::max_channels},
+        {kMaxBitRate, &AudioConstraintsFields::max_bit_rate},
+        {kMaxDelay, &AudioConstraintsFields::max_delay},
+        {kMinBitRate, &AudioConstraintsFields::min_bit_rate}};
+
+bool ParseAudioConstraints(const AudioConstraintsFields& fields,
+                           AudioConstraints* out) {
+  if (!json::TryParseInt(fields.max_sample_rate, &(out->max_sample_rate)) ||
+      !json::TryParseInt(fields.max_channels, &(out->max_channels)) ||
+      !json::TryParseInt(fields.max_bit_rate, &(out->max_bit_rate))) {
+    return false;
+  }
+
+  std::chrono::milliseconds max_delay;
+  if (json::TryParseMilliseconds(fields.max_delay, &max_delay)) {
+    out->max_delay = max_delay;
+  }
+
+  if (!json::TryParseInt(fields.min_bit_rate, &(out->min_bit_rate))) {
+    out->min_bit_rate = kDefaultAudioMinBitRate;
+  }
+  return out->IsValid();
+}
+
+struct VideoConstraintsFields {
+  json::Scalar max_bit_rate;
+  json::Scalar max_delay;
+  json::Scalar max_pixels_per_second;
+  json::Scalar min_bit_rate;
+  ParsedMember<Dimensions> max_dimensions;
+  ParsedMember<Dimensions> min_resolution;
+};
+
+constexpr json::FieldBinding<VideoConstraintsFields>
+    kVideoConstraintsBindings[] = {
+        {kMaxBitRate, &VideoConstraintsFields::max_bit_rate},
+        {kMaxDelay, &VideoConstraintsFields::max_delay},
+        {kMaxPixelsPerSecond, &VideoConstraintsFields::max_pixels_per_second},
+        {kMinBitRate, &VideoConstraintsFields::min_bit_rate}};
+
+bool ParseVideoConstraints(const VideoConstraintsFields& fields,
+                           VideoConstraints* out) {
+  if (!fields.max_dimensions.is_valid ||
+      !json::TryParseInt(fields.max_bit_rate, &(out->max_bit_rate)) ||
+      !ParseOptional(fields.min_resolution, &(out->min_resolution))) {
+    return false;
+  }
+  out->max_dimensions = fields.max_dimensions.value;
+
+  std::chrono::milliseconds max_delay;
+  if (json::TryParseMilliseconds(fields.max_delay, &max_delay)) {
+    out->max_delay = max_delay;
+  }
+
+  double max_pixels_per_second;
+  if (json::TryParseDouble(fields.max_pixels_per_second,
+                           &max_pixels_per_second)) {
+    out->max_pixels_per_second = max_pixels_per_second;
+  }
+
+  if (!json::TryParseInt(fields.min_bit_rate, &(out->min_bit_rate))) {
+    out->min_bit_rate = kDefaultVideoMinBitRate;
+  }
+  return out->IsValid();
+}
+
+struct ConstraintsFields {
+  ParsedMember<AudioConstraints> audio;
+  ParsedMember<VideoConstraints> video;
+};
+
+bool ParseConstraints(const ConstraintsFields& fields, Constraints* out) {
+  if (!fields.audio.is_valid || !fields.video.is_valid) {
+    return false;
+  }
+  out->audio = fields.audio.value;
+  out->video = fields.video.value;
+  return out->IsValid();
+}
+
+struct DisplayDescriptionFields {
+  json::Scalar aspect_ratio;
+  json::Scalar scaling;
+  ParsedMember<Dimensions> dimensions;
+};
+
+constexpr json::FieldBinding<DisplayDescriptionFields>
+    kDisplayDescriptionBindings[] = {
+        {kAspectRatio, &DisplayDescriptionFields::aspect_ratio},
+        {kScaling, &DisplayDescriptionFields::scaling}};
+
+bool ParseDisplayDescription(const DisplayDescriptionFields& fields,
+                             DisplayDescription* out) {
+  if (!ParseOptional(fields.dimensions, &(out->dimensions))) {
+    return false;
+  }
+  if (!fields.aspect_ratio.is_null()) {
+    AspectRatio aspect_ratio;
+    if (!AspectRatio::TryParse(fields.aspect_ratio, &aspect_ratio)) {
+      return false;
+    }
+    out->aspect_ratio = aspect_ratio;
+  }
+
+  AspectRatioConstraint constraint;
+  if (TryParseAspectRatioConstraint(fields.scaling, &constraint)) {
+    out->aspect_ratio_constraint =
+        absl::optional<AspectRatioConstraint>(std::move(constraint));
+  } else {
+    out->aspect_ratio_constraint = absl::nullopt;
+  }
+
+  return out->IsValid();
+}
+
+struct AnswerFields {
+  json::Scalar udp_port;
+  bool has_send_indexes = false;
+  std::vector<int> send_indexes;
+  bool has_ssrcs = false;
+  std::vector<Ssrc> ssrcs;
+  ParsedMember<Constraints> constraints;
+  ParsedMember<DisplayDescription> display;
+  std::vector<int> receiver_rtcp_event_log;
+  std::vector<int> receiver_rtcp_dscp;
+  std::vector<std::string> rtp_extensions;
+};
+
+constexpr json::FieldBinding<AnswerFields> kAnswerBindings[] = {
+    {kUdpPort, &AnswerFields::udp_port}};
+
+// Reads the members of an answer that aren't scalars.  These functions set
+// arrays to empty if not present, so we can ignore the return value for
+// optional values.
+bool ReadAnswerMember(absl::string_view key,
+                      json::StreamingReader* reader,
+                      AnswerFields* out) {
+  if (key == kSendIndexes) {
+    out->has_send_indexes =
+        json::TryParseIntArray(reader, &(out->send_indexes));
+  } else if (key == kSsrcs) {
+    out->has_ssrcs = json::TryParseUintArray(reader, &(out->ssrcs));
+  } else if (key == kConstraints) {
+    ParseMember(reader, &(out->constraints));
+  } else if (key == kDisplay) {
+    ParseMember(reader, &(out->display));
+  } else if (key == kReceiverRtcpEventLog) {
+    json::TryParseIntArray(reader, &(out->receiver_rtcp_event_log));
+  } else if (key == kReceiverRtcpDscp) {
+    json::TryParseIntArray(reader, &(out->receiver_rtcp_dscp));
+  } else if (key == kRtpExtensions) {
+    json::TryParseStringArray(reader, &(out->rtp_extensions));
+  } else {
     return false;
   }
-  *out = tentative_out;
   return true;
 }
 
+bool ParseAnswer(AnswerFields fields, Answer* out) {
+  if (!json::TryParseInt(fields.udp_port, &(out->udp_port)) ||
+      !fields.has_send_indexes || !fields.has_ssrcs ||
+      !ParseOptional(fields.constraints, &(out->constraints)) ||
+      !ParseOptional(fields.display, &(out->display))) {
+    return false;
+  }
+  out->send_indexes = std::move(fields.send_indexes);
+  out->ssrcs = std::move(fields.ssrcs);
+  out->receiver_rtcp_event_log = std::move(fields.receiver_rtcp_event_log);
+  out->receiver_rtcp_dscp = std::move(fields.receiver_rtcp_dscp);
+  out->rtp_extensions = std::move(fields.rtp_extensions);
+
+  return out->IsValid();
+}
+
 }  // namespace
 
 // static
 bool AspectRatio::TryParse(const Json::Value& value, AspectRatio* out) {
+  return TryParse(json::Scalar::FromValue(value), out);
+}
+
+// static
+bool AspectRatio::TryParse(json::StreamingReader* reader, AspectRatio* out) {
+  return TryParse(reader->ReadScalar(), out);
+}
+
+// static
+bool AspectRatio::TryParse(const json::Scalar& value, AspectRatio* out) {
   std::string parsed_value;
   if (!json::TryParseString(value, &parsed_value)) {
     return false;
@@ -190,34 +409,40 @@ bool AspectRatio::IsValid() const {
 // static
 bool AudioConstraints::TryParse(const Json::Value& root,
                                 AudioConstraints* out) {
-  if (!json::TryParseInt(root[kMaxSampleRate], &(out->max_sample_rate)) ||
-      !json::TryParseInt(root[kMaxChannels], &(out->max_channels)) ||
-      !json::TryParseInt(root[kMaxBitRate], &(out->max_bit_rate))) {
-    return false;
-  }
-
-  std::chrono::milliseconds max_delay;
-  if (json::TryParseMilliseconds(root[kMaxDelay], &max_delay)) {
-    out->max_delay = max_delay;
-  }
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
 
-  if (!json::TryParseInt(root[kMinBitRate], &(out->min_bit_rate))) {
-    out->min_bit_rate = kDefaultAudioMinBitRate;
-  }
-  return out->IsValid();
+// static
+bool AudioConstraints::TryParse(json::StreamingReader* reader,
+                                AudioConstraints* out) {
+  AudioConstraintsFields fields;
+  return json::BindFields(reader, kAudioConstraintsBindings, &fields) &&
+         ParseAudioConstraints(fields, out);
 }
 
 Json::Value AudioConstraints::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void AudioConstraints::WriteJson(json::StreamingWriter* writer) const {
   OSP_DCHECK(IsValid());
-  Json::Value root;
-  root[kMaxSampleRate] = max_sample_rate;
-  root[kMaxChannels] = max_channels;
-  root[kMinBitRate] = min_bit_rate;
-  root[kMaxBitRate] = max_bit_rate;
+  writer->BeginObject();
+  writer->Key(kMaxSampleRate);
+  writer->Int(max_sample_rate);
+  writer->Key(kMaxChannels);
+  writer->Int(max_channels);
+  writer->Key(kMinBitRate);
+  writer->Int(min_bit_rate);
+  writer->Key(kMaxBitRate);
+  writer->Int(max_bit_rate);
   if (max_delay.has_value()) {
-    root[kMaxDelay] = Json::Value::Int64(max_delay->count());
+    writer->Key(kMaxDelay);
+    writer->Int(max_delay->count());
   }
-  return root;
+  writer->EndObject();
 }
 
 bool AudioConstraints::IsValid() const {
@@ -228,27 +453,27 @@ bool AudioConstraints::IsValid() const {
 // static
 bool VideoConstraints::TryParse(const Json::Value& root,
                                 VideoConstraints* out) {
-  if (!Dimensions::TryParse(root[kMaxDimensions], &(out->max_dimensions)) ||
-      !json::TryParseInt(root[kMaxBitRate], &(out->max_bit_rate)) ||
-      !ParseOptional<Dimensions>(root[kMinResolution],
-                                 &(out->min_resolution))) {
-    return false;
-  }
-
-  std::chrono::milliseconds max_delay;
-  if (json::TryParseMilliseconds(root[kMaxDelay], &max_delay)) {
-    out->max_delay = max_delay;
-  }
-
-  double max_pixels_per_second;
-  if (json::TryParseDouble(root[kMaxPixelsPerSecond], &max_pixels_per_second)) {
-    out->max_pixels_per_second = max_pixels_per_second;
-  }
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
 
-  if (!json::TryParseInt(root[kMinBitRate], &(out->min_bit_rate))) {
-    out->min_bit_rate = kDefaultVideoMinBitRate;
-  }
-  return out->IsValid();
+// static
+bool VideoConstraints::TryParse(json::StreamingReader* reader,
+                                VideoConstraints* out) {
+  VideoConstraintsFields fields;
+  const bool is_object = json::BindFields(
+      reader, kVideoConstraintsBindings, &fields, [&](absl::string_view key) {
+        if (key == kMaxDimensions) {
+          ParseMember(reader, &fields.max_dimensions);
+        } else if (key == kMinResolution) {
+          ParseMember(reader, &fields.min_resolution);
+        } else {
+          return false;
+        }
+        return true;
+      });
+  return is_object && ParseVideoConstraints(fields, out);
 }
 
 bool VideoConstraints::IsValid() const {
@@ -261,32 +486,58 @@ bool VideoConstraints::IsValid() const {
 }
 
 Json::Value VideoConstraints::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void VideoConstraints::WriteJson(json::StreamingWriter* writer) const {
   OSP_DCHECK(IsValid());
-  Json::Value root;
-  root[kMaxDimensions] = max_dimensions.ToJson();
-  root[kMinBitRate] = min_bit_rate;
-  root[kMaxBitRate] = max_bit_rate;
+  writer->BeginObject();
+  writer->Key(kMaxDimensions);
+  max_dimensions.WriteJson(writer);
+  writer->Key(kMinBitRate);
+  writer->Int(min_bit_rate);
+  writer->Key(kMaxBitRate);
+  writer->Int(max_bit_rate);
   if (max_pixels_per_second.has_value()) {
-    root[kMaxPixelsPerSecond] = max_pixels_per_second.value();
+    writer->Key(kMaxPixelsPerSecond);
+    writer->Double(max_pixels_per_second.value());
   }
-
   if (min_resolution.has_value()) {
-    root[kMinResolution] = min_resolution->ToJson();
+    writer->Key(kMinResolution);
+    min_resolution->WriteJson(writer);
   }
-
   if (max_delay.has_value()) {
-    root[kMaxDelay] = Json::Value::Int64(max_delay->count());
+    writer->Key(kMaxDelay);
+    writer->Int(max_delay->count());
   }
-  return root;
+  writer->EndObject();
 }
 
 // static
 bool Constraints::TryParse(const Json::Value& root, Constraints* out) {
-  if (!AudioConstraints::TryParse(root[kAudio], &(out->audio)) ||
-      !VideoConstraints::TryParse(root[kVideo], &(out->video))) {
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
+
+// static
+bool Constraints::TryParse(json::StreamingReader* reader, Constraints* out) {
+  ConstraintsFields fields;
+  if (!reader->BeginObject()) {
     return false;
   }
-  return out->IsValid();
+  absl::string_view key;
+  while (reader->NextKey(&key)) {
+    if (key == kAudio) {
+      ParseMember(reader, &fields.audio);
+    } else if (key == kVideo) {
+      ParseMember(reader, &fields.video);
+    } else {
+      reader->SkipValue();
+    }
+  }
+  return reader->ok() && ParseConstraints(fields, out);
 }
 
 bool Constraints::IsValid() const {
@@ -294,30 +545,42 @@ bool Constraints::IsValid() const {
 }
 
 Json::Value Constraints::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void Constraints::WriteJson(json::StreamingWriter* writer) const {
   OSP_DCHECK(IsValid());
-  Json::Value root;
-  root[kAudio] = audio.ToJson();
-  root[kVideo] = video.ToJson();
-  return root;
+  writer->BeginObject();
+  writer->Key(kAudio);
+  audio.WriteJson(writer);
+  writer->Key(kVideo);
+  video.WriteJson(writer);
+  writer->EndObject();
 }
 
 // static
 bool DisplayDescription::TryParse(const Json::Value& root,
                                   DisplayDescription* out) {
-  if (!ParseOptional<Dimensions>(root[kDimensions], &(out->dimensions)) ||
-      !ParseOptional<AspectRatio>(root[kAspectRatio], &(out->aspect_ratio))) {
-    return false;
-  }
-
-  AspectRatioConstraint constraint;
-  if (TryParseAspectRatioConstraint(root[kScaling], &constraint)) {
-    out->aspect_ratio_constraint =
-        absl::optional<AspectRatioConstraint>(std::move(constraint));
-  } else {
-    out->aspect_ratio_constraint = absl::nullopt;
-  }
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
 
-  return out->IsValid();
+// static
+bool DisplayDescription::TryParse(json::StreamingReader* reader,
+                                  DisplayDescription* out) {
+  DisplayDescriptionFields fields;
+  const bool is_object =
+      json::BindFields(reader, kDisplayDescriptionBindings, &fields,
+                       [&](absl::string_view key) {
+                         if (key != kDimensions) {
+                           return false;
+                         }
+                         ParseMember(reader, &fields.dimensions);
+                         return true;
+                       });
+  return is_object && ParseDisplayDescription(fields, out);
 }
 
 bool DisplayDescription::IsValid() const {
@@ -343,39 +606,46 @@ bool DisplayDescription::IsValid() const {
 }
 
 Json::Value DisplayDescription::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void DisplayDescription::WriteJson(json::StreamingWriter* writer) const {
   OSP_DCHECK(IsValid());
-  Json::Value root;
+  writer->BeginObject();
   if (aspect_ratio.has_value()) {
-    root[kAspectRatio] = absl::StrCat(
-        aspect_ratio->width, kAspectRatioDelimiter, aspect_ratio->height);
+    writer->Key(kAspectRatio);
+    writer->String(absl::StrCat(aspect_ratio->width, kAspectRatioDelimiter,
+                                aspect_ratio->height));
   }
   if (dimensions.has_value()) {
-    root[kDimensions] = dimensions->ToJson();
+    writer->Key(kDimensions);
+    dimensions->WriteJson(writer);
   }
   if (aspect_ratio_constraint.has_value()) {
-    root[kScaling] =
-        AspectRatioConstraintToJson(aspect_ratio_constraint.value());
+    writer->Key(kScaling);
+    writer->String(GetEnumName(kAspectRatioConstraintNames,
+                               aspect_ratio_constraint.value())
+                       .value(kScalingSender));
   }
-  return root;
+  writer->EndObject();
 }
 
+// static
 bool Answer::TryParse(const Json::Value& root, Answer* out) {
-  if (!json::TryParseInt(root[kUdpPort], &(out->udp_port)) ||
-      !json::TryParseIntArray(root[kSendIndexes], &(out->send_indexes)) ||
-      !json::TryParseUintArray(root[kSsrcs], &(out->ssrcs)) ||
-      !ParseOptional<Constraints>(root[kConstraints], &(out->constraints)) ||
-      !ParseOptional<DisplayDescription>(root[kDisplay], &(out->display))) {
-    return false;
-  }
-
-  // These function set to empty array if not present, so we can ignore
-  // the return value for optional values.
-  json::TryParseIntArray(root[kReceiverRtcpEventLog],
-                         &(out->receiver_rtcp_event_log));
-  json::TryParseIntArray(root[kReceiverRtcpDscp], &(out->receiver_rtcp_dscp));
-  json::TryParseStringArray(root[kRtpExtensions], &(out->rtp_extensions));
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
 
-  return out->IsValid();
+// static
+bool Answer::TryParse(json::StreamingReader* reader, Answer* out) {
+  AnswerFields fields;
+  const bool is_object = json::BindFields(
+      reader, kAnswerBindings, &fields, [&](absl::string_view key) {
+        return ReadAnswerMember(key, reader, &fields);
+      });
+  return is_object && ParseAnswer(std::move(fields), out);
 }
 
 bool Answer::IsValid() const {
@@ -400,30 +670,42 @@ bool Answer::IsValid() const {
 }
 
 Json::Value Answer::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void Answer::WriteJson(json::StreamingWriter* writer) const {
   OSP_DCHECK(IsValid());
-  Json::Value root;
+  writer->BeginObject();
   if (constraints.has_value()) {
-    root[kConstraints] = constraints->ToJson();
+    writer->Key(kConstraints);
+    constraints->WriteJson(writer);
   }
   if (display.has_value()) {
-    root[kDisplay] = display->ToJson();
-  }
-  root[kUdpPort] = udp_port;
-  root[kSendIndexes] = PrimitiveVectorToJson(send_indexes);
-  root[kSsrcs] = PrimitiveVectorToJson(ssrcs);
+    writer->Key(kDisplay);
+    display->WriteJson(writer);
+  }
+  writer->Key(kUdpPort);
+  writer->Int(udp_port);
+  writer->Key(kSendIndexes);
+  WritePrimitiveVector(send_indexes, writer);
+  writer->Key(kSsrcs);
+  WritePrimitiveVector(ssrcs, writer);
   // Some sender do not handle empty array properly, so we omit these fields
   // if they are empty.
   if (!receiver_rtcp_event_log.empty()) {
-    root[kReceiverRtcpEventLog] =
-        PrimitiveVectorToJson(receiver_rtcp_event_log);
+    writer->Key(kReceiverRtcpEventLog);
+    WritePrimitiveVector(receiver_rtcp_event_log, writer);
   }
   if (!receiver_rtcp_dscp.empty()) {
-    root[kReceiverRtcpDscp] = PrimitiveVectorToJson(receiver_rtcp_dscp);
+    writer->Key(kReceiverRtcpDscp);
+    WritePrimitiveVector(receiver_rtcp_dscp, writer);
   }
   if (!rtp_extensions.empty()) {
-    root[kRtpExtensions] = PrimitiveVectorToJson(rtp_extensions);
+    writer->Key(kRtpExtensions);
+    WritePrimitiveVector(rtp_extensions, writer);
   }
-  return root;
+  writer->EndObject();
 }
 
 }  // namespace cast
@@ -19,6 +19,9 @@
 #include "cast/streaming/ssrc.h"
 #include "json/value.h"
 #include "platform/base/error.h"
+#include "util/json/json_scalar.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
 #include "util/simple_fraction.h"
 
 namespace openscreen {
@@ -31,13 +34,19 @@ namespace cast {
 // definitions, the following method definitions are shared:
 // (1) TryParse. Shall return a boolean indicating whether the out
 //     parameter is in a valid state after checking bounds and restrictions.
+//     Each struct is parsed from the next value of a json::StreamingReader,
+//     and the Json::Value version parses its value the same way.
 // (2) ToJson. Should return a proper JSON object. Assumes that IsValid()
 //     has been called already, OSP_DCHECKs if not IsValid().
-// (3) IsValid. Used by both TryParse and ToJson to ensure that the
+// (3) WriteJson. Writes the JSON returned by ToJson, with a
+//     json::StreamingWriter.
+// (4) IsValid. Used by both TryParse and ToJson to ensure that the
 //     object is in a good state.
 struct AudioConstraints {
   static bool TryParse(const Json::Value& value, AudioConstraints* out);
+  static bool TryParse(json::StreamingReader* reader, AudioConstraints* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   int max_sample_rate = 0;
@@ -49,7 +58,9 @@ struct AudioConstraints {
 
 struct VideoConstraints {
   static bool TryParse(const Json::Value& value, VideoConstraints* out);
+  static bool TryParse(json::StreamingReader* reader, VideoConstraints* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   absl::optional<double> max_pixels_per_second = {};
@@ -62,7 +73,9 @@ struct VideoConstraints {
 
 struct Constraints {
   static bool TryParse(const Json::Value& value, Constraints* out);
+  static bool TryParse(json::StreamingReader* reader, Constraints* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   AudioConstraints audio;
@@ -76,6 +89,8 @@ enum class AspectRatioConstraint : uint8_t { kVariable = 0, kFixed };
 
 struct AspectRatio {
   static bool TryParse(const Json::Value& value, AspectRatio* out);
+  static bool TryParse(json::StreamingReader* reader, AspectRatio* out);
+  static bool TryParse(const json::Scalar& value, AspectRatio* out);
   bool IsValid() const;
 
   bool operator==(const AspectRatio& other) const {
@@ -88,7 +103,9 @@ struct AspectRatio {
 
 struct DisplayDescription {
   static bool TryParse(const Json::Value& value, DisplayDescription* out);
+  static bool TryParse(json::StreamingReader* reader, DisplayDescription* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   // May exceed, be the same, or less than those mentioned in the
@@ -100,7 +117,9 @@ struct DisplayDescription {
 
 struct Answer {
   static bool TryParse(const Json::Value& value, Answer* out);
+  static bool TryParse(json::StreamingReader* reader, Answer* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   int udp_port = 0;
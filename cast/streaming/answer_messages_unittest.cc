@@ -5,6 +5,7 @@
 #include "cast/streaming/answer_messages.h"
 
 #include <chrono>
+#include <string>
 #include <utility>
 
 #include "gmock/gmock.h"
@@ -158,6 +159,12 @@ void ExpectFailureOnParse(absl::string_view raw_json) {
   Answer answer;
   EXPECT_FALSE(Answer::TryParse(std::move(root.value()), &answer));
   EXPECT_FALSE(answer.IsValid());
+
+  json::StreamingReader reader;
+  reader.Reset(raw_json);
+  Answer streamed_answer;
+  EXPECT_FALSE(Answer::TryParse(&reader, &streamed_answer));
+  EXPECT_TRUE(reader.Finish().ok());
 }
 
 // Functions that use ASSERT_* must return void, so we use an out parameter
@@ -170,6 +177,15 @@ void ExpectSuccessOnParse(absl::string_view raw_json, Answer* out = nullptr) {
   Answer answer;
   ASSERT_TRUE(Answer::TryParse(std::move(root.value()), &answer));
   EXPECT_TRUE(answer.IsValid());
+
+  // The streaming parser must give the same answer.
+  json::StreamingReader reader;
+  reader.Reset(raw_json);
+  Answer streamed_answer;
+  ASSERT_TRUE(Answer::TryParse(&reader, &streamed_answer));
+  EXPECT_TRUE(reader.Finish().ok());
+  EXPECT_EQ(answer.ToJson(), streamed_answer.ToJson());
+
   if (out) {
     *out = std::move(answer);
   }
@@ -190,8 +206,8 @@ TEST(AnswerMessagesTest, ProperlyPopulatedAnswerSerializesProperly) {
 
   Json::Value ssrcs = std::move(root["ssrcs"]);
   EXPECT_EQ(ssrcs.type(), Json::ValueType::arrayValue);
-  EXPECT_EQ(ssrcs[0], 123u);
-  EXPECT_EQ(ssrcs[1], 456u);
+  EXPECT_EQ(ssrcs[0].asUInt(), 123u);
+  EXPECT_EQ(ssrcs[1].asUInt(), 456u);
 
   Json::Value constraints = std::move(root["constraints"]);
   Json::Value audio = std::move(constraints["audio"]);
@@ -250,6 +266,22 @@ TEST(AnswerMessagesTest, ProperlyPopulatedAnswerSerializesProperly) {
   EXPECT_EQ(rtp_extensions[1], "bar");
 }
 
+TEST(AnswerMessagesTest, WriteJsonMatchesToJson) {
+  std::string written;
+  json::StreamingWriter writer(&written);
+  kValidAnswer.WriteJson(&writer);
+  EXPECT_TRUE(writer.is_complete());
+
+  const ErrorOr<std::string> stringified =
+      json::Stringify(kValidAnswer.ToJson());
+  ASSERT_TRUE(stringified.is_value());
+  const ErrorOr<Json::Value> expected = json::Parse(stringified.value());
+  const ErrorOr<Json::Value> actual = json::Parse(written);
+  ASSERT_TRUE(expected.is_value());
+  ASSERT_TRUE(actual.is_value()) << actual.error();
+  EXPECT_EQ(expected.value(), actual.value());
+}
+
 TEST(AnswerMessagesTest, EmptyArraysOmitted) {
   Answer missing_event_log = kValidAnswer;
   missing_event_log.receiver_rtcp_event_log.clear();
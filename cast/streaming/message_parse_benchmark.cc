@@ -0,0 +1,135 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures reading and writing session messages with json::StreamingReader and
+// json::StreamingWriter, against just building (or serializing) a Json::Value
+// tree of the same message, which is the least that a tree-based parser (or
+// writer) has to do.
+
+#include <stdio.h>
+
+#include <string>
+#include <utility>
+
+#include "cast/streaming/offer_messages.h"
+#include "cast/streaming/sender_message.h"
+#include "util/json/json_serialization.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
+#include "util/micro_benchmark.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace cast {
+namespace {
+
+constexpr int kNumAudioStreams = 4;
+constexpr int kNumVideoStreams = 16;
+constexpr int kNumResolutions = 8;
+
+Stream MakeStream(int index, Stream::Type type) {
+  Stream stream;
+  stream.index = index;
+  stream.type = type;
+  stream.channels = type == Stream::Type::kAudioSource ? 2 : 1;
+  stream.rtp_payload_type = type == Stream::Type::kAudioSource
+                                ? RtpPayloadType::kAudioOpus
+                                : RtpPayloadType::kVideoVp8;
+  stream.ssrc = 1000 + index;
+  stream.target_delay = std::chrono::milliseconds(400);
+  stream.aes_key.fill(0x5a);
+  stream.aes_iv_mask.fill(0xa5);
+  stream.receiver_rtcp_event_log = true;
+  stream.receiver_rtcp_dscp = "46";
+  stream.rtp_timebase = type == Stream::Type::kAudioSource ? 48000 : 90000;
+  return stream;
+}
+
+// A large offer, as sent by senders that support many codec configurations.
+SenderMessage MakeOfferMessage() {
+  Offer offer;
+  offer.cast_mode = CastMode::kMirroring;
+  int index = 0;
+  for (int i = 0; i < kNumAudioStreams; ++i) {
+    AudioStream audio;
+    audio.stream = MakeStream(index++, Stream::Type::kAudioSource);
+    audio.codec = AudioCodec::kOpus;
+    audio.bit_rate = 124000;
+    offer.audio_streams.push_back(std::move(audio));
+  }
+  for (int i = 0; i < kNumVideoStreams; ++i) {
+    VideoStream video;
+    video.stream = MakeStream(index++, Stream::Type::kVideoSource);
+    video.codec = VideoCodec::kVp8;
+    video.max_frame_rate = SimpleFraction{60000, 1001};
+    video.max_bit_rate = 10000000;
+    video.protection = "aes128-ctr";
+    video.profile = "main";
+    video.level = "4";
+    for (int r = 0; r < kNumResolutions; ++r) {
+      video.resolutions.push_back(Resolution{1920 - 160 * r, 1080 - 90 * r});
+    }
+    video.error_recovery_mode = "castv2";
+    offer.video_streams.push_back(std::move(video));
+  }
+
+  SenderMessage message;
+  message.type = SenderMessage::Type::kOffer;
+  message.sequence_number = 42;
+  message.valid = true;
+  message.body = std::move(offer);
+  return message;
+}
+
+void RunBenchmarks() {
+  const SenderMessage message = MakeOfferMessage();
+  ErrorOr<Json::Value> message_json = message.ToJson();
+  OSP_CHECK(message_json.is_value());
+  ErrorOr<std::string> document = json::Stringify(message_json.value());
+  OSP_CHECK(document.is_value());
+  const std::string& text = document.value();
+  printf("OFFER message: %zu bytes\n", text.size());
+
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Parse: json::Parse into a Json::Value", text.size(), [&text] {
+        ErrorOr<Json::Value> root = json::Parse(text);
+        OSP_CHECK(root.is_value());
+        DoNotOptimize(root);
+      }));
+
+  json::StreamingReader reader;
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Parse: SenderMessage::Parse(StreamingReader)", text.size(),
+      [&text, &reader] {
+        reader.Reset(text);
+        ErrorOr<SenderMessage> parsed = SenderMessage::Parse(&reader);
+        OSP_CHECK(parsed.is_value());
+        DoNotOptimize(parsed);
+      }));
+
+  const Json::Value& root = message_json.value();
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Write: json::Stringify of a Json::Value", text.size(), [&root] {
+        ErrorOr<std::string> out = json::Stringify(root);
+        DoNotOptimize(out);
+      }));
+
+  std::string buffer;
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Write: WriteJson(StreamingWriter)", text.size(), [&message, &buffer] {
+        buffer.clear();
+        json::StreamingWriter writer(&buffer);
+        message.WriteJson(&writer);
+        DoNotOptimize(buffer);
+      }));
+}
+
+}  // namespace
+}  // namespace cast
+}  // namespace openscreen
+
+int main(int argc, char** argv) {
+  openscreen::cast::RunBenchmarks();
+  return 0;
+}
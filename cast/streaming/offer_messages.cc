@@ -13,6 +13,7 @@
 
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "cast/streaming/constants.h"
 #include "platform/base/error.h"
@@ -28,10 +29,12 @@ namespace cast {
 
 namespace {
 
+constexpr char kCastMode[] = "castMode";
 constexpr char kSupportedStreams[] = "supportedStreams";
 constexpr char kAudioSourceType[] = "audio_source";
 constexpr char kVideoSourceType[] = "video_source";
 constexpr char kStreamType[] = "type";
+constexpr char kResolutions[] = "resolutions";
 
 bool CodecParameterIsValid(VideoCodec codec,
                            const std::string& codec_parameter) {
@@ -75,7 +78,7 @@ bool CodecParameterIsValid(AudioCodec codec,
 EnumNameTable<CastMode, 2> kCastModeNames{
     {{"mirroring", CastMode::kMirroring}, {"remoting", CastMode::kRemoting}}};
 
-bool TryParseRtpPayloadType(const Json::Value& value, RtpPayloadType* out) {
+bool TryParseRtpPayloadType(const json::Scalar& value, RtpPayloadType* out) {
   int t;
   if (!json::TryParseInt(value, &t)) {
     return false;
@@ -90,7 +93,7 @@ bool TryParseRtpPayloadType(const Json::Value& value, RtpPayloadType* out) {
   return true;
 }
 
-bool TryParseRtpTimebase(const Json::Value& value, int* out) {
+bool TryParseRtpTimebase(const json::Scalar& value, int* out) {
   std::string raw_timebase;
   if (!json::TryParseString(value, &raw_timebase)) {
     return false;
@@ -112,7 +115,7 @@ bool TryParseRtpTimebase(const Json::Value& value, int* out) {
 constexpr int kHexDigitsPerByte = 2;
 constexpr int kAesBytesSize = 16;
 constexpr int kAesStringLength = kAesBytesSize * kHexDigitsPerByte;
-bool TryParseAesHexBytes(const Json::Value& value,
+bool TryParseAesHexBytes(const json::Scalar& value,
                          std::array<uint8_t, kAesBytesSize>* out) {
   std::string hex_string;
   if (!json::TryParseString(value, &hex_string)) {
@@ -149,44 +152,93 @@ absl::string_view ToString(Stream::Type type) {
   }
 }
 
-bool TryParseResolutions(const Json::Value& value,
+bool TryParseResolutions(json::StreamingReader* reader,
                          std::vector<Resolution>* out) {
-  out->clear();
-
-  // Some legacy senders don't provide resolutions, so just return empty.
-  if (!value.isArray() || value.empty()) {
-    return false;
-  }
+  return json::TryParseArray<Resolution>(
+      reader,
+      [](json::StreamingReader* r, Resolution* resolution) {
+        return Resolution::TryParse(r, resolution);
+      },
+      out);
+}
 
-  for (Json::ArrayIndex i = 0; i < value.size(); ++i) {
-    Resolution resolution;
-    if (!Resolution::TryParse(value[i], &resolution)) {
-      out->clear();
+// The members of an audio or video stream, as read by a json::StreamingReader.
+struct StreamFields {
+  // Common to all streams.
+  json::Scalar type;
+  json::Scalar index;
+  json::Scalar ssrc;
+  json::Scalar rtp_payload_type;
+  json::Scalar time_base;
+  json::Scalar channels;
+  json::Scalar aes_key;
+  json::Scalar aes_iv_mask;
+  json::Scalar target_delay;
+  json::Scalar receiver_rtcp_event_log;
+  json::Scalar receiver_rtcp_dscp;
+  json::Scalar codec_parameter;
+  json::Scalar codec_name;
+
+  // Audio only.
+  json::Scalar bit_rate;
+
+  // Video only.
+  json::Scalar max_frame_rate;
+  json::Scalar max_bit_rate;
+  json::Scalar profile;
+  json::Scalar protection;
+  json::Scalar level;
+  json::Scalar error_recovery_mode;
+  std::vector<Resolution> resolutions;
+};
+
+constexpr json::FieldBinding<StreamFields> kStreamBindings[] = {
+    {kStreamType, &StreamFields::type},
+    {"index", &StreamFields::index},
+    {"ssrc", &StreamFields::ssrc},
+    {"rtpPayloadType", &StreamFields::rtp_payload_type},
+    {"timeBase", &StreamFields::time_base},
+    {"channels", &StreamFields::channels},
+    {"aesKey", &StreamFields::aes_key},
+    {"aesIvMask", &StreamFields::aes_iv_mask},
+    {"targetDelay", &StreamFields::target_delay},
+    {"receiverRtcpEventLog", &StreamFields::receiver_rtcp_event_log},
+    {"receiverRtcpDscp", &StreamFields::receiver_rtcp_dscp},
+    {"codecParameter", &StreamFields::codec_parameter},
+    {kCodecName, &StreamFields::codec_name},
+    {"bitRate", &StreamFields::bit_rate},
+    {"maxFrameRate", &StreamFields::max_frame_rate},
+    {"maxBitRate", &StreamFields::max_bit_rate},
+    {"profile", &StreamFields::profile},
+    {"protection", &StreamFields::protection},
+    {"level", &StreamFields::level},
+    {"errorRecoveryMode", &StreamFields::error_recovery_mode}};
+
+void ReadStreamFields(json::StreamingReader* reader, StreamFields* out) {
+  json::BindFields(reader, kStreamBindings, out, [&](absl::string_view key) {
+    if (key != kResolutions) {
       return false;
     }
-    out->push_back(std::move(resolution));
-  }
-
-  return true;
+    TryParseResolutions(reader, &out->resolutions);
+    return true;
+  });
 }
 
-}  // namespace
-
-Error Stream::TryParse(const Json::Value& value,
-                       Stream::Type type,
-                       Stream* out) {
+Error ParseStream(const StreamFields& fields,
+                  Stream::Type type,
+                  Stream* out) {
   out->type = type;
 
-  if (!json::TryParseInt(value["index"], &out->index) ||
-      !json::TryParseUint(value["ssrc"], &out->ssrc) ||
-      !TryParseRtpPayloadType(value["rtpPayloadType"],
+  if (!json::TryParseInt(fields.index, &out->index) ||
+      !json::TryParseUint(fields.ssrc, &out->ssrc) ||
+      !TryParseRtpPayloadType(fields.rtp_payload_type,
                               &out->rtp_payload_type) ||
-      !TryParseRtpTimebase(value["timeBase"], &out->rtp_timebase)) {
+      !TryParseRtpTimebase(fields.time_base, &out->rtp_timebase)) {
     return Error(Error::Code::kJsonParseError,
                  "Offer stream has missing or invalid mandatory field");
   }
 
-  if (!json::TryParseInt(value["channels"], &out->channels)) {
+  if (!json::TryParseInt(fields.channels, &out->channels)) {
     out->channels = out->type == Stream::Type::kAudioSource
                         ? kDefaultNumAudioChannels
                         : kDefaultNumVideoChannels;
@@ -194,8 +246,8 @@ Error Stream::TryParse(const Json::Value& value,
     return Error(Error::Code::kJsonParseError, "Invalid channel count");
   }
 
-  if (!TryParseAesHexBytes(value["aesKey"], &out->aes_key) ||
-      !TryParseAesHexBytes(value["aesIvMask"], &out->aes_iv_mask)) {
+  if (!TryParseAesHexBytes(fields.aes_key, &out->aes_key) ||
+      !TryParseAesHexBytes(fields.aes_iv_mask, &out->aes_iv_mask)) {
     return Error(Error::Code::kUnencryptedOffer,
                  "Offer stream must have both a valid aesKey and aesIvMask");
   }
@@ -207,62 +259,32 @@ Error Stream::TryParse(const Json::Value& value,
 
   out->target_delay = kDefaultTargetPlayoutDelay;
   int target_delay;
-  if (json::TryParseInt(value["targetDelay"], &target_delay)) {
+  if (json::TryParseInt(fields.target_delay, &target_delay)) {
     auto d = std::chrono::milliseconds(target_delay);
     if (kMinTargetPlayoutDelay <= d && d <= kMaxTargetPlayoutDelay) {
       out->target_delay = d;
     }
   }
 
-  json::TryParseBool(value["receiverRtcpEventLog"],
+  json::TryParseBool(fields.receiver_rtcp_event_log,
                      &out->receiver_rtcp_event_log);
-  json::TryParseString(value["receiverRtcpDscp"], &out->receiver_rtcp_dscp);
-  json::TryParseString(value["codecParameter"], &out->codec_parameter);
+  json::TryParseString(fields.receiver_rtcp_dscp, &out->receiver_rtcp_dscp);
+  json::TryParseString(fields.codec_parameter, &out->codec_parameter);
 
   return Error::None();
 }
 
-Json::Value Stream::ToJson() const {
-  OSP_DCHECK(IsValid());
-
-  Json::Value root;
-  root["index"] = index;
-  root["type"] = std::string(ToString(type));
-  root["channels"] = channels;
-  root["rtpPayloadType"] = static_cast<int>(rtp_payload_type);
-  // rtpProfile is technically required by the spec, although it is always set
-  // to cast. We set it here to be compliant with all spec implementers.
-  root["rtpProfile"] = "cast";
-  static_assert(sizeof(ssrc) <= sizeof(Json::UInt),
-                "this code assumes Ssrc fits in a Json::UInt");
-  root["ssrc"] = static_cast<Json::UInt>(ssrc);
-  root["targetDelay"] = static_cast<int>(target_delay.count());
-  root["aesKey"] = HexEncode(aes_key.data(), aes_key.size());
-  root["aesIvMask"] = HexEncode(aes_iv_mask.data(), aes_iv_mask.size());
-  root["receiverRtcpEventLog"] = receiver_rtcp_event_log;
-  root["receiverRtcpDscp"] = receiver_rtcp_dscp;
-  root["timeBase"] = "1/" + std::to_string(rtp_timebase);
-  root["codecParameter"] = codec_parameter;
-  return root;
-}
-
-bool Stream::IsValid() const {
-  return channels >= 1 && index >= 0 && target_delay.count() > 0 &&
-         target_delay.count() <= std::numeric_limits<int>::max() &&
-         rtp_timebase >= 1;
-}
-
-Error AudioStream::TryParse(const Json::Value& value, AudioStream* out) {
+Error ParseAudioStream(const StreamFields& fields, AudioStream* out) {
   Error error =
-      Stream::TryParse(value, Stream::Type::kAudioSource, &out->stream);
+      ParseStream(fields, Stream::Type::kAudioSource, &out->stream);
   if (!error.ok()) {
     return error;
   }
 
   std::string codec_name;
-  if (!json::TryParseInt(value["bitRate"], &out->bit_rate) ||
+  if (!json::TryParseInt(fields.bit_rate, &out->bit_rate) ||
       out->bit_rate < 0 ||
-      !json::TryParseString(value[kCodecName], &codec_name)) {
+      !json::TryParseString(fields.codec_name, &codec_name)) {
     return Error(Error::Code::kJsonParseError, "Invalid audio stream field");
   }
   ErrorOr<AudioCodec> codec = StringToAudioCodec(codec_name);
@@ -280,28 +302,15 @@ Error AudioStream::TryParse(const Json::Value& value, AudioStream* out) {
   return Error::None();
 }
 
-Json::Value AudioStream::ToJson() const {
-  OSP_DCHECK(IsValid());
-
-  Json::Value out = stream.ToJson();
-  out[kCodecName] = CodecToString(codec);
-  out["bitRate"] = bit_rate;
-  return out;
-}
-
-bool AudioStream::IsValid() const {
-  return bit_rate >= 0 && stream.IsValid();
-}
-
-Error VideoStream::TryParse(const Json::Value& value, VideoStream* out) {
+Error ParseVideoStream(const StreamFields& fields, VideoStream* out) {
   Error error =
-      Stream::TryParse(value, Stream::Type::kVideoSource, &out->stream);
+      ParseStream(fields, Stream::Type::kVideoSource, &out->stream);
   if (!error.ok()) {
     return error;
   }
 
   std::string codec_name;
-  if (!json::TryParseString(value[kCodecName], &codec_name)) {
+  if (!json::TryParseString(fields.codec_name, &codec_name)) {
     return Error(Error::Code::kJsonParseError, "Video stream missing codec");
   }
   ErrorOr<VideoCodec> codec = StringToVideoCodec(codec_name);
@@ -319,80 +328,58 @@ Error VideoStream::TryParse(const Json::Value& value, VideoStream* out) {
 
   out->max_frame_rate = SimpleFraction{kDefaultMaxFrameRate, 1};
   std::string raw_max_frame_rate;
-  if (json::TryParseString(value["maxFrameRate"], &raw_max_frame_rate)) {
+  if (json::TryParseString(fields.max_frame_rate, &raw_max_frame_rate)) {
     auto parsed = SimpleFraction::FromString(raw_max_frame_rate);
     if (parsed.is_value() && parsed.value().is_positive()) {
       out->max_frame_rate = parsed.value();
     }
   }
 
-  TryParseResolutions(value["resolutions"], &out->resolutions);
-  json::TryParseString(value["profile"], &out->profile);
-  json::TryParseString(value["protection"], &out->protection);
-  json::TryParseString(value["level"], &out->level);
-  json::TryParseString(value["errorRecoveryMode"], &out->error_recovery_mode);
-  if (!json::TryParseInt(value["maxBitRate"], &out->max_bit_rate)) {
+  out->resolutions = fields.resolutions;
+  json::TryParseString(fields.profile, &out->profile);
+  json::TryParseString(fields.protection, &out->protection);
+  json::TryParseString(fields.level, &out->level);
+  json::TryParseString(fields.error_recovery_mode, &out->error_recovery_mode);
+  if (!json::TryParseInt(fields.max_bit_rate, &out->max_bit_rate)) {
     out->max_bit_rate = 4 << 20;
   }
 
   return Error::None();
 }
 
-Json::Value VideoStream::ToJson() const {
-  OSP_DCHECK(IsValid());
-
-  Json::Value out = stream.ToJson();
-  out["codecName"] = CodecToString(codec);
-  out["maxFrameRate"] = max_frame_rate.ToString();
-  out["maxBitRate"] = max_bit_rate;
-  out["protection"] = protection;
-  out["profile"] = profile;
-  out["level"] = level;
-  out["errorRecoveryMode"] = error_recovery_mode;
-
-  Json::Value rs;
-  for (auto resolution : resolutions) {
-    rs.append(resolution.ToJson());
-  }
-  out["resolutions"] = std::move(rs);
-  return out;
-}
-
-bool VideoStream::IsValid() const {
-  return max_bit_rate > 0 && max_frame_rate.is_positive();
-}
-
-// static
-Error Offer::TryParse(const Json::Value& root, Offer* out) {
-  if (!root.isObject()) {
-    return Error(Error::Code::kJsonParseError, "null offer");
-  }
-  const ErrorOr<CastMode> cast_mode =
-      GetEnum(kCastModeNames, root["castMode"].asString());
-  Json::Value supported_streams = root[kSupportedStreams];
-  if (!supported_streams.isArray()) {
+// The members of an offer, as read by a json::StreamingReader.
+struct OfferFields {
+  json::Scalar cast_mode;
+  bool has_supported_streams = false;
+  std::vector<StreamFields> supported_streams;
+};
+
+Error ParseOffer(const OfferFields& fields, Offer* out) {
+  std::string cast_mode_name;
+  json::TryParseString(fields.cast_mode, &cast_mode_name);
+  const ErrorOr<CastMode> cast_mode = GetEnum(kCastModeNames, cast_mode_name);
+  if (!fields.has_supported_streams) {
     return Error(Error::Code::kJsonParseError, "supported streams in offer");
   }
 
   std::vector<AudioStream> audio_streams;
   std::vector<VideoStream> video_streams;
-  for (Json::ArrayIndex i = 0; i < supported_streams.size(); ++i) {
-    const Json::Value& fields = supported_streams[i];
+  for (const StreamFields& stream_fields : fields.supported_streams) {
     std::string type;
-    if (!json::TryParseString(fields[kStreamType], &type)) {
+    if (!json::TryParseString(stream_fields.type, &type)) {
       return Error(Error::Code::kJsonParseError, "Missing stream type");
     }
 
     Error error;
     if (type == kAudioSourceType) {
       AudioStream stream;
-      error = AudioStream::TryParse(fields, &stream);
+      error = ParseAudioStream(stream_fields, &stream);
       if (error.ok()) {
         audio_streams.push_back(std::move(stream));
       }
     } else if (type == kVideoSourceType) {
       VideoStream stream;
-      error = VideoStream::TryParse(fields, &stream);
+      error = ParseVideoStream(stream_fields, &stream);
       if (error.ok()) {
         video_streams.push_back(std::move(stream));
       }
@@ -413,21 +400,202 @@ Error Offer::TryParse(const Json::Value& root, Offer* out) {
   return Error::None();
 }
 
-Json::Value Offer::ToJson() const {
+void WriteStreamMembers(const Stream& stream, json::StreamingWriter* writer) {
+  OSP_DCHECK(stream.IsValid());
+  writer->Key("index");
+  writer->Int(stream.index);
+  writer->Key(kStreamType);
+  writer->String(ToString(stream.type));
+  writer->Key("channels");
+  writer->Int(stream.channels);
+  writer->Key("rtpPayloadType");
+  writer->Int(static_cast<int>(stream.rtp_payload_type));
+  // rtpProfile is technically required by the spec, although it is always set
+  // to cast. We set it here to be compliant with all spec implementers.
+  writer->Key("rtpProfile");
+  writer->String("cast");
+  writer->Key("ssrc");
+  writer->Uint(stream.ssrc);
+  writer->Key("targetDelay");
+  writer->Int(stream.target_delay.count());
+  writer->Key("aesKey");
+  writer->String(HexEncode(stream.aes_key.data(), stream.aes_key.size()));
+  writer->Key("aesIvMask");
+  writer->String(
+      HexEncode(stream.aes_iv_mask.data(), stream.aes_iv_mask.size()));
+  writer->Key("receiverRtcpEventLog");
+  writer->Bool(stream.receiver_rtcp_event_log);
+  writer->Key("receiverRtcpDscp");
+  writer->String(stream.receiver_rtcp_dscp);
+  writer->Key("timeBase");
+  writer->String(absl::StrCat("1/", stream.rtp_timebase));
+  writer->Key("codecParameter");
+  writer->String(stream.codec_parameter);
+}
+
+}  // namespace
+
+Error Stream::TryParse(const Json::Value& value,
+                       Stream::Type type,
+                       Stream* out) {
+  return json::ReadFromValue(value, [type, out](json::StreamingReader* reader) {
+    StreamFields fields;
+    ReadStreamFields(reader, &fields);
+    return ParseStream(fields, type, out);
+  });
+}
+
+Json::Value Stream::ToJson() const {
+  return json::WriteToValue([this](json::StreamingWriter* writer) {
+    writer->BeginObject();
+    WriteStreamMembers(*this, writer);
+    writer->EndObject();
+  });
+}
+
+bool Stream::IsValid() const {
+  return channels >= 1 && index >= 0 && target_delay.count() > 0 &&
+         target_delay.count() <= std::numeric_limits<int>::max() &&
+         rtp_timebase >= 1;
+}
+
+Error AudioStream::TryParse(const Json::Value& value, AudioStream* out) {
+  return json::ReadFromValue(value, [out](json::StreamingReader* reader) {
+    StreamFields fields;
+    ReadStreamFields(reader, &fields);
+    return ParseAudioStream(fields, out);
+  });
+}
+
+Json::Value AudioStream::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void AudioStream::WriteJson(json::StreamingWriter* writer) const {
   OSP_DCHECK(IsValid());
-  Json::Value root;
-  root["castMode"] = GetEnumName(kCastModeNames, cast_mode).value();
-  Json::Value streams;
-  for (auto& stream : audio_streams) {
-    streams.append(stream.ToJson());
+
+  writer->BeginObject();
+  WriteStreamMembers(stream, writer);
+  writer->Key(kCodecName);
+  writer->String(CodecToString(codec));
+  writer->Key("bitRate");
+  writer->Int(bit_rate);
+  writer->EndObject();
+}
+
+bool AudioStream::IsValid() const {
+  return bit_rate >= 0 && stream.IsValid();
+}
+
+Error VideoStream::TryParse(const Json::Value& value, VideoStream* out) {
+  return json::ReadFromValue(value, [out](json::StreamingReader* reader) {
+    StreamFields fields;
+    ReadStreamFields(reader, &fields);
+    return ParseVideoStream(fields, out);
+  });
+}
+
+Json::Value VideoStream::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void VideoStream::WriteJson(json::StreamingWriter* writer) const {
+  OSP_DCHECK(IsValid());
+
+  writer->BeginObject();
+  WriteStreamMembers(stream, writer);
+  writer->Key(kCodecName);
+  writer->String(CodecToString(codec));
+  writer->Key("maxFrameRate");
+  writer->String(max_frame_rate.ToString());
+  writer->Key("maxBitRate");
+  writer->Int(max_bit_rate);
+  writer->Key("protection");
+  writer->String(protection);
+  writer->Key("profile");
+  writer->String(profile);
+  writer->Key("level");
+  writer->String(level);
+  writer->Key("errorRecoveryMode");
+  writer->String(error_recovery_mode);
+  writer->Key(kResolutions);
+  // An empty list of resolutions is written as null, as senders always have.
+  if (resolutions.empty()) {
+    writer->Null();
+  } else {
+    writer->BeginArray();
+    for (const Resolution& resolution : resolutions) {
+      resolution.WriteJson(writer);
+    }
+    writer->EndArray();
   }
+  writer->EndObject();
+}
 
-  for (auto& stream : video_streams) {
-    streams.append(stream.ToJson());
+bool VideoStream::IsValid() const {
+  return max_bit_rate > 0 && max_frame_rate.is_positive();
+}
+
+// static
+Error Offer::TryParse(const Json::Value& root, Offer* out) {
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
+
+// static
+Error Offer::TryParse(json::StreamingReader* reader, Offer* out) {
+  if (!reader->BeginObject()) {
+    return reader->ok() ? Error(Error::Code::kJsonParseError, "null offer")
+                        : reader->Finish();
+  }
+
+  OfferFields fields;
+  absl::string_view key;
+  while (reader->NextKey(&key)) {
+    if (key == kCastMode) {
+      fields.cast_mode = reader->ReadScalar();
+    } else if (key == kSupportedStreams) {
+      fields.has_supported_streams = reader->BeginArray();
+      if (fields.has_supported_streams) {
+        while (reader->NextElement()) {
+          fields.supported_streams.emplace_back();
+          ReadStreamFields(reader, &fields.supported_streams.back());
+        }
+      }
+    } else {
+      reader->SkipValue();
+    }
   }
 
-  root[kSupportedStreams] = std::move(streams);
-  return root;
+  if (!reader->ok()) {
+    return reader->Finish();
+  }
+  return ParseOffer(fields, out);
+}
+
+Json::Value Offer::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void Offer::WriteJson(json::StreamingWriter* writer) const {
+  OSP_DCHECK(IsValid());
+  writer->BeginObject();
+  writer->Key(kCastMode);
+  writer->String(GetEnumName(kCastModeNames, cast_mode).value());
+  writer->Key(kSupportedStreams);
+  writer->BeginArray();
+  for (const AudioStream& stream : audio_streams) {
+    stream.WriteJson(writer);
+  }
+  for (const VideoStream& stream : video_streams) {
+    stream.WriteJson(writer);
+  }
+  writer->EndArray();
+  writer->EndObject();
 }
 
 bool Offer::IsValid() const {
@@ -17,6 +17,8 @@
 #include "cast/streaming/session_config.h"
 #include "json/value.h"
 #include "platform/base/error.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
 #include "util/simple_fraction.h"
 
 // This file contains the implementation of the Cast V2 Mirroring Control
@@ -77,6 +79,7 @@ struct Stream {
 struct AudioStream {
   static Error TryParse(const Json::Value& root, AudioStream* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   Stream stream;
@@ -88,6 +91,7 @@ struct AudioStream {
 struct VideoStream {
   static Error TryParse(const Json::Value& root, VideoStream* out);
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   bool IsValid() const;
 
   Stream stream;
@@ -102,7 +106,14 @@ struct VideoStream {
 };
 
 struct Offer {
+  // Reads the next value of |reader| as an offer, without building a tree of
+  // the message first.  The Json::Value version reads |root| the same way.
+  static Error TryParse(json::StreamingReader* reader, Offer* out);
   static Error TryParse(const Json::Value& root, Offer* out);
+
+  // Writes the message directly into |writer|'s buffer.  ToJson() returns
+  // what WriteJson() writes, as a Json::Value.
+  void WriteJson(json::StreamingWriter* writer) const;
   Json::Value ToJson() const;
   bool IsValid() const;
 
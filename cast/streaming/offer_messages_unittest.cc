@@ -5,6 +5,7 @@
 #include "cast/streaming/offer_messages.h"
 
 #include <limits>
+#include <string>
 #include <utility>
 
 #include "cast/streaming/rtp_defines.h"
@@ -113,6 +114,14 @@ void ExpectFailureOnParse(
   if (expected) {
     EXPECT_EQ(expected, error.code());
   }
+
+  // The streaming parser must fail the same way.
+  json::StreamingReader reader;
+  reader.Reset(body);
+  Offer streamed_offer;
+  Error streamed_error = Offer::TryParse(&reader, &streamed_offer);
+  EXPECT_EQ(error.code(), streamed_error.code()) << streamed_error;
+  EXPECT_TRUE(reader.Finish().ok());
 }
 
 void ExpectEqualsValidOffer(const Offer& offer) {
@@ -581,6 +590,42 @@ TEST(OfferTest, ParseAndToJsonResultsInSameOffer) {
   ExpectEqualsValidOffer(reparsed_offer);
 }
 
+TEST(OfferTest, CanParseValidOfferWithStreamingReader) {
+  json::StreamingReader reader;
+  reader.Reset(kValidOffer);
+  Offer offer;
+  EXPECT_TRUE(Offer::TryParse(&reader, &offer).ok());
+  EXPECT_TRUE(reader.Finish().ok());
+
+  ExpectEqualsValidOffer(offer);
+}
+
+TEST(OfferTest, WriteJsonMatchesToJson) {
+  ErrorOr<Json::Value> root = json::Parse(kValidOffer);
+  ASSERT_TRUE(root.is_value());
+  Offer offer;
+  EXPECT_TRUE(Offer::TryParse(std::move(root.value()), &offer).ok());
+
+  std::string written;
+  json::StreamingWriter writer(&written);
+  offer.WriteJson(&writer);
+  EXPECT_TRUE(writer.is_complete());
+
+  const ErrorOr<std::string> stringified = json::Stringify(offer.ToJson());
+  ASSERT_TRUE(stringified.is_value());
+  const ErrorOr<Json::Value> expected = json::Parse(stringified.value());
+  const ErrorOr<Json::Value> actual = json::Parse(written);
+  ASSERT_TRUE(expected.is_value());
+  ASSERT_TRUE(actual.is_value()) << actual.error();
+  EXPECT_EQ(expected.value(), actual.value());
+
+  json::StreamingReader reader;
+  reader.Reset(written);
+  Offer reparsed_offer;
+  EXPECT_TRUE(Offer::TryParse(&reader, &reparsed_offer).ok());
+  ExpectEqualsValidOffer(reparsed_offer);
+}
+
 // We don't want to enforce that a given offer must have both audio and
 // video, so we don't assert on either.
 TEST(OfferTest, IsValidWithMissingStreams) {
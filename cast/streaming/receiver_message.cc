@@ -24,6 +24,9 @@ namespace cast {
 
 namespace {
 
+constexpr char kRemoting[] = "remoting";
+constexpr char kMediaCapabilities[] = "mediaCaps";
+
 EnumNameTable<ReceiverMessage::Type, 3> kMessageTypeNames{
     {{kMessageTypeAnswer, ReceiverMessage::Type::kAnswer},
      {"CAPABILITIES_RESPONSE", ReceiverMessage::Type::kCapabilitiesResponse},
@@ -41,9 +44,9 @@ EnumNameTable<MediaCapability, 10> kMediaCapabilityNames{
      {"hevc", MediaCapability::kHevc},
      {"av1", MediaCapability::kAv1}}};
 
-ReceiverMessage::Type GetMessageType(const Json::Value& root) {
+ReceiverMessage::Type GetMessageType(const json::Scalar& value) {
   std::string type;
-  if (!json::TryParseString(root[kMessageType], &type)) {
+  if (!json::TryParseString(value, &type)) {
     return ReceiverMessage::Type::kUnknown;
   }
 
@@ -53,7 +56,7 @@ ReceiverMessage::Type GetMessageType(const Json::Value& root) {
   return parsed.value(ReceiverMessage::Type::kUnknown);
 }
 
-bool TryParseCapability(const Json::Value& value, MediaCapability* out) {
+bool TryParseCapability(const json::Scalar& value, MediaCapability* out) {
   std::string c;
   if (!json::TryParseString(value, &c)) {
     return false;
@@ -68,6 +71,131 @@ bool TryParseCapability(const Json::Value& value, MediaCapability* out) {
   return true;
 }
 
+struct ErrorFields {
+  json::Scalar code;
+  json::Scalar description;
+};
+
+constexpr json::FieldBinding<ErrorFields> kErrorBindings[] = {
+    {kErrorCode, &ErrorFields::code},
+    {kErrorDescription, &ErrorFields::description}};
+
+ErrorOr<ReceiverError> ParseReceiverError(const ErrorFields& fields) {
+  int code;
+  std::string description;
+  if (!json::TryParseInt(fields.code, &code) ||
+      !json::TryParseString(fields.description, &description)) {
+    return Error::Code::kJsonParseError;
+  }
+
+  return ReceiverError(code, description);
+}
+
+struct CapabilityFields {
+  json::Scalar remoting;
+  bool has_media_capabilities = false;
+  std::vector<MediaCapability> media_capabilities;
+};
+
+constexpr json::FieldBinding<CapabilityFields> kCapabilityBindings[] = {
+    {kRemoting, &CapabilityFields::remoting}};
+
+ErrorOr<ReceiverCapability> ParseReceiverCapability(CapabilityFields fields) {
+  int remoting_version;
+  if (!json::TryParseInt(fields.remoting, &remoting_version)) {
+    remoting_version = ReceiverCapability::kRemotingVersionUnknown;
+  }
+
+  if (!fields.has_media_capabilities) {
+    return Error(Error::Code::kJsonParseError,
+                 "Failed to parse media capabilities");
+  }
+
+  return ReceiverCapability{remoting_version,
+                            std::move(fields.media_capabilities)};
+}
+
+// The members of a message, as read by a json::StreamingReader.
+struct MessageFields {
+  json::Scalar type;
+  json::Scalar sequence_number;
+  json::Scalar result;
+  json::Scalar rpc;
+
+  // Bodies, which are parsed as soon as they are read.
+  absl::optional<ErrorOr<ReceiverError>> error;
+  absl::optional<Answer> answer;
+  absl::optional<ErrorOr<ReceiverCapability>> capabilities;
+};
+
+constexpr json::FieldBinding<MessageFields> kMessageBindings[] = {
+    {kMessageType, &MessageFields::type},
+    {kSequenceNumber, &MessageFields::sequence_number},
+    {kResult, &MessageFields::result},
+    {kRpcMessageBody, &MessageFields::rpc}};
+
+ReceiverMessage ParseMessage(MessageFields fields) {
+  ReceiverMessage message;
+  std::string result;
+  if (!json::TryParseString(fields.result, &result)) {
+    result = kResultError;
+  }
+
+  message.type = GetMessageType(fields.type);
+  message.valid =
+      (result == kResultOk || message.type == ReceiverMessage::Type::kRpc);
+
+  if (message.type != ReceiverMessage::Type::kRpc) {
+    if (!json::TryParseInt(fields.sequence_number,
+                           &(message.sequence_number))) {
+      message.sequence_number = -1;
+    }
+
+    // Sequence numbers must be non-negative.
+    if (message.sequence_number < 0) {
+      message.valid = false;
+    }
+  }
+
+  if (!message.valid) {
+    if (fields.error && fields.error->is_value()) {
+      message.body = std::move(fields.error->value());
+    }
+    return message;
+  }
+
+  switch (message.type) {
+    case ReceiverMessage::Type::kAnswer: {
+      if (fields.answer) {
+        message.body = std::move(fields.answer.value());
+        message.valid = true;
+      }
+    } break;
+
+    case ReceiverMessage::Type::kCapabilitiesResponse: {
+      if (fields.capabilities && fields.capabilities->is_value()) {
+        message.body = std::move(fields.capabilities->value());
+        message.valid = true;
+      }
+    } break;
+
+    case ReceiverMessage::Type::kRpc: {
+      std::string encoded_rpc;
+      std::vector<uint8_t> rpc;
+      if (json::TryParseString(fields.rpc, &encoded_rpc) &&
+          base64::Decode(encoded_rpc, &rpc)) {
+        message.body = std::move(rpc);
+        message.valid = true;
+      }
+    } break;
+
+    default:
+      break;
+  }
+
+  return message;
+}
+
 }  // namespace
 
 ReceiverError::ReceiverError(int code, absl::string_view description)
@@ -100,23 +228,31 @@ ErrorOr<ReceiverError> ReceiverError::Parse(const Json::Value& value) {
                  "Empty JSON in receiver error parsing");
   }
 
-  int code;
-  std::string description;
-  if (!json::TryParseInt(value[kErrorCode], &code) ||
-      !json::TryParseString(value[kErrorDescription], &description)) {
-    return Error::Code::kJsonParseError;
-  }
+  return json::ReadFromValue(
+      value, [](json::StreamingReader* reader) { return Parse(reader); });
+}
 
-  return ReceiverError(code, description);
+// static
+ErrorOr<ReceiverError> ReceiverError::Parse(json::StreamingReader* reader) {
+  ErrorFields fields;
+  json::BindFields(reader, kErrorBindings, &fields);
+  return ParseReceiverError(fields);
 }
 
 Json::Value ReceiverError::ToJson() const {
-  Json::Value root;
-  root[kErrorCode] = openscreen_code ? static_cast<int>(*openscreen_code) +
-                                           kOpenscreenErrorOffset
-                                     : code;
-  root[kErrorDescription] = description;
-  return root;
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void ReceiverError::WriteJson(json::StreamingWriter* writer) const {
+  writer->BeginObject();
+  writer->Key(kErrorCode);
+  writer->Int(openscreen_code
+                  ? static_cast<int>(*openscreen_code) + kOpenscreenErrorOffset
+                  : code);
+  writer->Key(kErrorDescription);
+  writer->String(description);
+  writer->EndObject();
 }
 
 Error ReceiverError::ToError() const {
@@ -137,148 +273,144 @@ ErrorOr<ReceiverCapability> ReceiverCapability::Parse(
                  "Empty JSON in capabilities parsing");
   }
 
-  int remoting_version;
-  if (!json::TryParseInt(value["remoting"], &remoting_version)) {
-    remoting_version = ReceiverCapability::kRemotingVersionUnknown;
-  }
-
-  std::vector<MediaCapability> capabilities;
-  if (!json::TryParseArray<MediaCapability>(
-          value["mediaCaps"], TryParseCapability, &capabilities)) {
-    return Error(Error::Code::kJsonParseError,
-                 "Failed to parse media capabilities");
-  }
+  return json::ReadFromValue(
+      value, [](json::StreamingReader* reader) { return Parse(reader); });
+}
 
-  return ReceiverCapability{remoting_version, std::move(capabilities)};
+// static
+ErrorOr<ReceiverCapability> ReceiverCapability::Parse(
+    json::StreamingReader* reader) {
+  CapabilityFields fields;
+  json::BindFields(
+      reader, kCapabilityBindings, &fields, [&](absl::string_view key) {
+        if (key != kMediaCapabilities) {
+          return false;
+        }
+        fields.has_media_capabilities = json::TryParseArray<MediaCapability>(
+            reader,
+            [](json::StreamingReader* r, MediaCapability* capability) {
+              return TryParseCapability(r->ReadScalar(), capability);
+            },
+            &fields.media_capabilities);
+        return true;
+      });
+  return ParseReceiverCapability(std::move(fields));
 }
 
 Json::Value ReceiverCapability::ToJson() const {
-  Json::Value root;
-  root["remoting"] = remoting_version;
-  Json::Value capabilities(Json::ValueType::arrayValue);
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void ReceiverCapability::WriteJson(json::StreamingWriter* writer) const {
+  writer->BeginObject();
+  writer->Key(kRemoting);
+  writer->Int(remoting_version);
+  writer->Key(kMediaCapabilities);
+  writer->BeginArray();
   for (const auto& capability : media_capabilities) {
-    capabilities.append(GetEnumName(kMediaCapabilityNames, capability).value());
+    writer->String(GetEnumName(kMediaCapabilityNames, capability).value());
   }
-  root["mediaCaps"] = std::move(capabilities);
-  return root;
+  writer->EndArray();
+  writer->EndObject();
 }
 
 // static
 ErrorOr<ReceiverMessage> ReceiverMessage::Parse(const Json::Value& value) {
-  ReceiverMessage message;
   if (!value) {
     return Error(Error::Code::kJsonParseError, "Invalid message body");
   }
 
-  std::string result;
-  if (!json::TryParseString(value[kResult], &result)) {
-    result = kResultError;
-  }
-
-  message.type = GetMessageType(value);
-  message.valid =
-      (result == kResultOk || message.type == ReceiverMessage::Type::kRpc);
-
-  if (message.type != ReceiverMessage::Type::kRpc) {
-    if (!json::TryParseInt(value[kSequenceNumber],
-                           &(message.sequence_number))) {
-      message.sequence_number = -1;
-    }
-
-    // Sequence numbers must be non-negative.
-    if (message.sequence_number < 0) {
-      message.valid = false;
-    }
-  }
+  return json::ReadFromValue(
+      value, [](json::StreamingReader* reader) { return Parse(reader); });
+}
 
-  if (!message.valid) {
-    ErrorOr<ReceiverError> error =
-        ReceiverError::Parse(value[kErrorMessageBody]);
-    if (error.is_value()) {
-      message.body = std::move(error.value());
-    }
-    return message;
+// static
+ErrorOr<ReceiverMessage> ReceiverMessage::Parse(json::StreamingReader* reader) {
+  // The type of the message may come after its body, so any body is parsed
+  // when read, and only used if it matches the type.
+  MessageFields fields;
+  const bool is_object = json::BindFields(
+      reader, kMessageBindings, &fields, [&](absl::string_view key) {
+        if (key == kErrorMessageBody) {
+          fields.error = ReceiverError::Parse(reader);
+        } else if (key == kAnswerMessageBody) {
+          Answer answer;
+          if (Answer::TryParse(reader, &answer)) {
+            fields.answer = std::move(answer);
+          }
+        } else if (key == kCapabilitiesMessageBody) {
+          fields.capabilities = ReceiverCapability::Parse(reader);
+        } else {
+          return false;
+        }
+        return true;
+      });
+
+  Error error = reader->Finish();
+  if (!error.ok()) {
+    return error;
   }
-
-  switch (message.type) {
-    case Type::kAnswer: {
-      Answer answer;
-      if (openscreen::cast::Answer::TryParse(value[kAnswerMessageBody],
-                                             &answer)) {
-        message.body = std::move(answer);
-        message.valid = true;
-      }
-    } break;
-
-    case Type::kCapabilitiesResponse: {
-      ErrorOr<ReceiverCapability> capability =
-          ReceiverCapability::Parse(value[kCapabilitiesMessageBody]);
-      if (capability.is_value()) {
-        message.body = std::move(capability.value());
-        message.valid = true;
-      }
-    } break;
-
-    case Type::kRpc: {
-      std::string encoded_rpc;
-      std::vector<uint8_t> rpc;
-      if (json::TryParseString(value[kRpcMessageBody], &encoded_rpc) &&
-          base64::Decode(encoded_rpc, &rpc)) {
-        message.body = std::move(rpc);
-        message.valid = true;
-      }
-    } break;
-
-    default:
-      break;
+  if (!is_object) {
+    return Error(Error::Code::kJsonParseError, "Message must be an object");
   }
-
-  return message;
+  return ParseMessage(std::move(fields));
 }
 
 ErrorOr<Json::Value> ReceiverMessage::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void ReceiverMessage::WriteJson(json::StreamingWriter* writer) const {
   OSP_CHECK(type != ReceiverMessage::Type::kUnknown)
       << "Trying to send an unknown message is a developer error";
 
-  Json::Value root;
-  root[kMessageType] = GetEnumName(kMessageTypeNames, type).value();
+  writer->BeginObject();
+  writer->Key(kMessageType);
+  writer->String(GetEnumName(kMessageTypeNames, type).value());
   if (sequence_number >= 0) {
-    root[kSequenceNumber] = sequence_number;
+    writer->Key(kSequenceNumber);
+    writer->Int(sequence_number);
   }
 
   switch (type) {
     case ReceiverMessage::Type::kAnswer:
+      writer->Key(kResult);
       if (valid) {
-        root[kResult] = kResultOk;
-        root[kAnswerMessageBody] = absl::get<Answer>(body).ToJson();
+        writer->String(kResultOk);
+        writer->Key(kAnswerMessageBody);
+        absl::get<Answer>(body).WriteJson(writer);
       } else {
-        root[kResult] = kResultError;
-        root[kErrorMessageBody] = absl::get<ReceiverError>(body).ToJson();
+        writer->String(kResultError);
+        writer->Key(kErrorMessageBody);
+        absl::get<ReceiverError>(body).WriteJson(writer);
       }
       break;
 
     case ReceiverMessage::Type::kCapabilitiesResponse:
+      writer->Key(kResult);
       if (valid) {
-        root[kResult] = kResultOk;
-        root[kCapabilitiesMessageBody] =
-            absl::get<ReceiverCapability>(body).ToJson();
+        writer->String(kResultOk);
+        writer->Key(kCapabilitiesMessageBody);
+        absl::get<ReceiverCapability>(body).WriteJson(writer);
       } else {
-        root[kResult] = kResultError;
-        root[kErrorMessageBody] = absl::get<ReceiverError>(body).ToJson();
+        writer->String(kResultError);
+        writer->Key(kErrorMessageBody);
+        absl::get<ReceiverError>(body).WriteJson(writer);
       }
       break;
 
     // NOTE: RPC messages do NOT have a result field.
     case ReceiverMessage::Type::kRpc:
-      root[kRpcMessageBody] =
-          base64::Encode(absl::get<std::vector<uint8_t>>(body));
+      writer->Key(kRpcMessageBody);
+      writer->String(base64::Encode(absl::get<std::vector<uint8_t>>(body)));
       break;
 
     default:
       OSP_NOTREACHED();
   }
-
-  return root;
+  writer->EndObject();
 }
 
 }  // namespace cast
@@ -13,6 +13,8 @@
 #include "absl/types/variant.h"
 #include "cast/streaming/answer_messages.h"
 #include "json/value.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
 #include "util/osp_logging.h"
 
 namespace openscreen {
@@ -35,7 +37,9 @@ struct ReceiverCapability {
   static constexpr int kRemotingVersionUnknown = -1;
 
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   static ErrorOr<ReceiverCapability> Parse(const Json::Value& value);
+  static ErrorOr<ReceiverCapability> Parse(json::StreamingReader* reader);
 
   // The remoting version that the receiver uses.
   int remoting_version = kRemotingVersionUnknown;
@@ -58,7 +62,9 @@ struct ReceiverError {
   ~ReceiverError();
 
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
   static ErrorOr<ReceiverError> Parse(const Json::Value& value);
+  static ErrorOr<ReceiverError> Parse(json::StreamingReader* reader);
   Error ToError() const;
 
   // All Open Screen errors are offset by a fixed value to avoid overlapping
@@ -92,7 +98,15 @@ struct ReceiverMessage {
     kRpc,
   };
 
+  // Reads a whole message with |reader|, which must have just been Reset() to
+  // the message's document.  The Json::Value version reads |value| the same
+  // way.
+  static ErrorOr<ReceiverMessage> Parse(json::StreamingReader* reader);
   static ErrorOr<ReceiverMessage> Parse(const Json::Value& value);
+
+  // Writes the message directly into |writer|'s buffer.  ToJson() returns
+  // what WriteJson() writes, as a Json::Value.
+  void WriteJson(json::StreamingWriter* writer) const;
   ErrorOr<Json::Value> ToJson() const;
 
   Type type = Type::kUnknown;
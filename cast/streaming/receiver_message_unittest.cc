@@ -4,6 +4,8 @@
 
 #include "cast/streaming/receiver_message.h"
 
+#include <string>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "util/json/json_serialization.h"
@@ -47,5 +49,61 @@ TEST(ReceiverMessageTest, ReceiverErrorToError) {
             ReceiverError(1234, "message two").ToError());
 }
 
+TEST(ReceiverMessageTest, StreamingParseMatchesJsonValueParse) {
+  // The body of each message comes before its type.
+  const char* const kMessages[] = {
+      R"({"answer": {"udpPort": 1234, "sendIndexes": [1], "ssrcs": [2]},
+          "result": "ok", "seqNum": 3, "type": "ANSWER"})",
+      R"({"capabilities": {"remoting": 2, "mediaCaps": ["video", "vp9"]},
+          "result": "ok", "seqNum": 4, "type": "CAPABILITIES_RESPONSE"})",
+      R"({"error": {"code": 10001, "description": "bad offer"},
+          "result": "error", "seqNum": 5, "type": "ANSWER"})",
+      R"({"rpc": "AQID", "type": "RPC"})",
+      R"({"answer": {"udpPort": 1234}, "result": "ok", "seqNum": 6,
+          "type": "ANSWER"})",
+      R"({"type": "UNKNOWN_TYPE"})",
+  };
+
+  json::StreamingReader reader;
+  for (const char* raw_message : kMessages) {
+    const ErrorOr<Json::Value> root = json::Parse(raw_message);
+    ASSERT_TRUE(root.is_value());
+    const ErrorOr<ReceiverMessage> expected =
+        ReceiverMessage::Parse(root.value());
+    ASSERT_TRUE(expected.is_value());
+
+    reader.Reset(raw_message);
+    const ErrorOr<ReceiverMessage> actual = ReceiverMessage::Parse(&reader);
+    ASSERT_TRUE(actual.is_value()) << actual.error();
+    EXPECT_EQ(expected.value().type, actual.value().type) << raw_message;
+    EXPECT_EQ(expected.value().sequence_number,
+              actual.value().sequence_number);
+    EXPECT_EQ(expected.value().valid, actual.value().valid) << raw_message;
+    EXPECT_EQ(expected.value().body.index(), actual.value().body.index())
+        << raw_message;
+    if (!absl::holds_alternative<absl::monostate>(actual.value().body)) {
+      const ErrorOr<Json::Value> expected_json = expected.value().ToJson();
+      std::string written;
+      json::StreamingWriter writer(&written);
+      actual.value().WriteJson(&writer);
+      const ErrorOr<Json::Value> actual_json = json::Parse(written);
+      ASSERT_TRUE(actual_json.is_value());
+      EXPECT_EQ(json::Stringify(expected_json.value()).value(),
+                json::Stringify(actual_json.value()).value());
+    }
+  }
+}
+
+TEST(ReceiverMessageTest, StreamingParseReportsSyntaxErrors) {
+  json::StreamingReader reader;
+  reader.Reset(R"({"type": "ANSWER", "seqNum": })");
+  EXPECT_EQ(Error::Code::kJsonParseError,
+            ReceiverMessage::Parse(&reader).error().code());
+
+  reader.Reset(R"(["ANSWER"])");
+  EXPECT_EQ(Error::Code::kJsonParseError,
+            ReceiverMessage::Parse(&reader).error().code());
+}
+
 }  // namespace cast
 }  // namespace openscreen
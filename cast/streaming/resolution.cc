@@ -39,27 +39,70 @@ bool FrameRateEquals(double a, double b) {
   return std::abs(a - b) < kEpsilonForFrameRateComparisons;
 }
 
-}  // namespace
+struct DimensionsFields {
+  json::Scalar width;
+  json::Scalar height;
+  json::Scalar frame_rate;
+};
+
+constexpr json::FieldBinding<DimensionsFields> kResolutionBindings[] = {
+    {kWidth, &DimensionsFields::width},
+    {kHeight, &DimensionsFields::height}};
+
+constexpr json::FieldBinding<DimensionsFields> kDimensionsBindings[] = {
+    {kWidth, &DimensionsFields::width},
+    {kHeight, &DimensionsFields::height},
+    {kFrameRate, &DimensionsFields::frame_rate}};
+
+bool ParseResolution(const DimensionsFields& fields, Resolution* out) {
+  if (!json::TryParseInt(fields.width, &(out->width)) ||
+      !json::TryParseInt(fields.height, &(out->height))) {
+    return false;
+  }
+  return out->IsValid();
+}
 
-bool Resolution::TryParse(const Json::Value& root, Resolution* out) {
-  if (!json::TryParseInt(root[kWidth], &(out->width)) ||
-      !json::TryParseInt(root[kHeight], &(out->height))) {
+bool ParseDimensions(const DimensionsFields& fields, Dimensions* out) {
+  if (!json::TryParseInt(fields.width, &(out->width)) ||
+      !json::TryParseInt(fields.height, &(out->height)) ||
+      !(fields.frame_rate.is_null() ||
+        json::TryParseSimpleFraction(fields.frame_rate, &(out->frame_rate)))) {
     return false;
   }
   return out->IsValid();
 }
 
+}  // namespace
+
+bool Resolution::TryParse(const Json::Value& root, Resolution* out) {
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
+
+bool Resolution::TryParse(json::StreamingReader* reader, Resolution* out) {
+  DimensionsFields fields;
+  return json::BindFields(reader, kResolutionBindings, &fields) &&
+         ParseResolution(fields, out);
+}
+
 bool Resolution::IsValid() const {
   return width > 0 && height > 0;
 }
 
 Json::Value Resolution::ToJson() const {
-  OSP_DCHECK(IsValid());
-  Json::Value root;
-  root[kWidth] = width;
-  root[kHeight] = height;
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
 
-  return root;
+void Resolution::WriteJson(json::StreamingWriter* writer) const {
+  OSP_DCHECK(IsValid());
+  writer->BeginObject();
+  writer->Key(kWidth);
+  writer->Int(width);
+  writer->Key(kHeight);
+  writer->Int(height);
+  writer->EndObject();
 }
 
 bool Resolution::operator==(const Resolution& other) const {
@@ -75,13 +118,15 @@ bool Resolution::IsSupersetOf(const Resolution& other) const {
 }
 
 bool Dimensions::TryParse(const Json::Value& root, Dimensions* out) {
-  if (!json::TryParseInt(root[kWidth], &(out->width)) ||
-      !json::TryParseInt(root[kHeight], &(out->height)) ||
-      !(root[kFrameRate].isNull() ||
-        json::TryParseSimpleFraction(root[kFrameRate], &(out->frame_rate)))) {
-    return false;
-  }
-  return out->IsValid();
+  return json::ReadFromValue(root, [out](json::StreamingReader* reader) {
+    return TryParse(reader, out);
+  });
+}
+
+bool Dimensions::TryParse(json::StreamingReader* reader, Dimensions* out) {
+  DimensionsFields fields;
+  return json::BindFields(reader, kDimensionsBindings, &fields) &&
+         ParseDimensions(fields, out);
 }
 
 bool Dimensions::IsValid() const {
@@ -89,13 +134,20 @@ bool Dimensions::IsValid() const {
 }
 
 Json::Value Dimensions::ToJson() const {
-  OSP_DCHECK(IsValid());
-  Json::Value root;
-  root[kWidth] = width;
-  root[kHeight] = height;
-  root[kFrameRate] = frame_rate.ToString();
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
 
-  return root;
+void Dimensions::WriteJson(json::StreamingWriter* writer) const {
+  OSP_DCHECK(IsValid());
+  writer->BeginObject();
+  writer->Key(kWidth);
+  writer->Int(width);
+  writer->Key(kHeight);
+  writer->Int(height);
+  writer->Key(kFrameRate);
+  writer->String(frame_rate.ToString());
+  writer->EndObject();
 }
 
 bool Dimensions::operator==(const Dimensions& other) const {
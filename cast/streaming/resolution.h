@@ -12,6 +12,8 @@
 
 #include "absl/types/optional.h"
 #include "json/value.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
 #include "util/simple_fraction.h"
 
 namespace openscreen {
@@ -20,8 +22,10 @@ namespace cast {
 // A resolution in pixels.
 struct Resolution {
   static bool TryParse(const Json::Value& value, Resolution* out);
+  static bool TryParse(json::StreamingReader* reader, Resolution* out);
   bool IsValid() const;
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
 
   // Returns true if both |width| and |height| of this instance are greater than
   // or equal to that of |other|.
@@ -38,8 +42,10 @@ struct Resolution {
 // A resolution in pixels and a frame rate.
 struct Dimensions {
   static bool TryParse(const Json::Value& value, Dimensions* out);
+  static bool TryParse(json::StreamingReader* reader, Dimensions* out);
   bool IsValid() const;
   Json::Value ToJson() const;
+  void WriteJson(json::StreamingWriter* writer) const;
 
   // Returns true if all properties of this instance are greater than or equal
   // to those of |other|.
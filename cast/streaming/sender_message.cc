@@ -23,9 +23,9 @@ EnumNameTable<SenderMessage::Type, 3> kMessageTypeNames{
      {"GET_CAPABILITIES", SenderMessage::Type::kGetCapabilities},
      {"RPC", SenderMessage::Type::kRpc}}};
 
-SenderMessage::Type GetMessageType(const Json::Value& root) {
+SenderMessage::Type GetMessageType(const json::Scalar& value) {
   std::string type;
-  if (!json::TryParseString(root[kMessageType], &type)) {
+  if (!json::TryParseString(value, &type)) {
     return SenderMessage::Type::kUnknown;
   }
 
@@ -35,40 +35,49 @@ SenderMessage::Type GetMessageType(const Json::Value& root) {
   return parsed.value(SenderMessage::Type::kUnknown);
 }
 
-}  // namespace
+// The members of a message, as read by a json::StreamingReader.
+struct MessageFields {
+  json::Scalar type;
+  json::Scalar sequence_number;
+  json::Scalar rpc;
 
-// static
-ErrorOr<SenderMessage> SenderMessage::Parse(const Json::Value& value) {
-  if (!value) {
-    return Error(Error::Code::kParameterInvalid, "Empty JSON");
-  }
+  // The body of an offer, which is parsed as soon as it is read.
+  Error offer_error = Error(Error::Code::kJsonParseError, "null offer");
+  Offer offer;
+};
+
+constexpr json::FieldBinding<MessageFields> kMessageBindings[] = {
+    {kMessageType, &MessageFields::type},
+    {kSequenceNumber, &MessageFields::sequence_number},
+    {kRpcMessageBody, &MessageFields::rpc}};
 
+SenderMessage ParseMessage(MessageFields fields) {
   SenderMessage message;
-  if (!json::TryParseInt(value[kSequenceNumber], &(message.sequence_number))) {
+  if (!json::TryParseInt(fields.sequence_number,
+                         &(message.sequence_number))) {
     message.sequence_number = -1;
   }
 
-  message.type = GetMessageType(value);
+  message.type = GetMessageType(fields.type);
   switch (message.type) {
-    case Type::kOffer: {
-      Offer offer;
-      if (Offer::TryParse(value[kOfferMessageBody], &offer).ok()) {
-        message.body = std::move(offer);
+    case SenderMessage::Type::kOffer: {
+      if (fields.offer_error.ok()) {
+        message.body = std::move(fields.offer);
         message.valid = true;
       }
     } break;
 
-    case Type::kRpc: {
+    case SenderMessage::Type::kRpc: {
       std::string rpc_body;
       std::vector<uint8_t> rpc;
-      if (json::TryParseString(value[kRpcMessageBody], &rpc_body) &&
+      if (json::TryParseString(fields.rpc, &rpc_body) &&
           base64::Decode(rpc_body, &rpc)) {
         message.body = rpc;
         message.valid = true;
       }
     } break;
 
-    case Type::kGetCapabilities:
+    case SenderMessage::Type::kGetCapabilities:
       message.valid = true;
       break;
 
@@ -79,25 +88,68 @@ ErrorOr<SenderMessage> SenderMessage::Parse(const Json::Value& value) {
   return message;
 }
 
+}  // namespace
+
+// static
+ErrorOr<SenderMessage> SenderMessage::Parse(const Json::Value& value) {
+  if (!value) {
+    return Error(Error::Code::kParameterInvalid, "Empty JSON");
+  }
+
+  return json::ReadFromValue(
+      value, [](json::StreamingReader* reader) { return Parse(reader); });
+}
+
+// static
+ErrorOr<SenderMessage> SenderMessage::Parse(json::StreamingReader* reader) {
+  // The type of the message may come after its body, so an offer body is
+  // always parsed, and only used if this turns out to be an offer.
+  MessageFields fields;
+  const bool is_object = json::BindFields(
+      reader, kMessageBindings, &fields, [&](absl::string_view key) {
+        if (key != kOfferMessageBody) {
+          return false;
+        }
+        fields.offer_error = Offer::TryParse(reader, &fields.offer);
+        return true;
+      });
+
+  Error error = reader->Finish();
+  if (!error.ok()) {
+    return error;
+  }
+  if (!is_object) {
+    return Error(Error::Code::kJsonParseError, "Message must be an object");
+  }
+  return ParseMessage(std::move(fields));
+}
+
 ErrorOr<Json::Value> SenderMessage::ToJson() const {
+  return json::WriteToValue(
+      [this](json::StreamingWriter* writer) { WriteJson(writer); });
+}
+
+void SenderMessage::WriteJson(json::StreamingWriter* writer) const {
   OSP_CHECK(type != SenderMessage::Type::kUnknown)
       << "Trying to send an unknown message is a developer error";
 
-  Json::Value root;
-  ErrorOr<const char*> message_type = GetEnumName(kMessageTypeNames, type);
-  root[kMessageType] = message_type.value();
+  writer->BeginObject();
+  writer->Key(kMessageType);
+  writer->String(GetEnumName(kMessageTypeNames, type).value());
   if (sequence_number >= 0) {
-    root[kSequenceNumber] = sequence_number;
+    writer->Key(kSequenceNumber);
+    writer->Int(sequence_number);
   }
 
   switch (type) {
     case SenderMessage::Type::kOffer:
-      root[kOfferMessageBody] = absl::get<Offer>(body).ToJson();
+      writer->Key(kOfferMessageBody);
+      absl::get<Offer>(body).WriteJson(writer);
       break;
 
     case SenderMessage::Type::kRpc:
-      root[kRpcMessageBody] =
-          base64::Encode(absl::get<std::vector<uint8_t>>(body));
+      writer->Key(kRpcMessageBody);
+      writer->String(base64::Encode(absl::get<std::vector<uint8_t>>(body)));
       break;
 
     case SenderMessage::Type::kGetCapabilities:
@@ -106,7 +158,7 @@ ErrorOr<Json::Value> SenderMessage::ToJson() const {
     default:
       OSP_NOTREACHED();
   }
-  return root;
+  writer->EndObject();
 }
 
 }  // namespace cast
@@ -13,6 +13,8 @@
 #include "cast/streaming/offer_messages.h"
 #include "json/value.h"
 #include "platform/base/error.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
 #include "util/osp_logging.h"
 
 namespace openscreen {
@@ -35,7 +37,15 @@ struct SenderMessage {
     kRpc,
   };
 
+  // Reads a whole message with |reader|, which must have just been Reset() to
+  // the message's document.  The Json::Value version reads |value| the same
+  // way.
+  static ErrorOr<SenderMessage> Parse(json::StreamingReader* reader);
   static ErrorOr<SenderMessage> Parse(const Json::Value& value);
+
+  // Writes the message directly into |writer|'s buffer.  ToJson() returns
+  // what WriteJson() writes, as a Json::Value.
+  void WriteJson(json::StreamingWriter* writer) const;
   ErrorOr<Json::Value> ToJson() const;
 
   Type type = Type::kUnknown;
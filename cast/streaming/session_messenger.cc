@@ -9,7 +9,7 @@
 #include "cast/common/public/message_port.h"
 #include "cast/streaming/message_fields.h"
 #include "util/json/json_helpers.h"
-#include "util/json/json_serialization.h"
+#include "util/json/streaming_json_writer.h"
 #include "util/osp_logging.h"
 
 namespace openscreen {
@@ -66,20 +66,22 @@ SessionMessenger::~SessionMessenger() {
 
 Error SessionMessenger::SendMessage(const std::string& destination_id,
                                     const std::string& namespace_,
-                                    const Json::Value& message_root) {
+                                    const std::string& message_body) {
   OSP_DCHECK(namespace_ == kCastRemotingNamespace ||
              namespace_ == kCastWebrtcNamespace);
-  auto body_or_error = json::Stringify(message_root);
-  if (body_or_error.is_error()) {
-    return std::move(body_or_error.error());
-  }
+  OSP_DCHECK(!message_body.empty());
   OSP_VLOG << "Sending message: DESTINATION[" << destination_id
            << "], NAMESPACE[" << namespace_ << "], BODY:\n"
-           << body_or_error.value();
-  message_port_->PostMessage(destination_id, namespace_, body_or_error.value());
+           << message_body;
+  message_port_->PostMessage(destination_id, namespace_, message_body);
   return Error::None();
 }
 
+std::string* SessionMessenger::ResetSendBuffer() {
+  send_buffer_.clear();
+  return &send_buffer_;
+}
+
 void SessionMessenger::ReportError(Error error) {
   error_callback_(std::move(error));
 }
@@ -110,10 +112,11 @@ Error SenderSessionMessenger::SendOutboundMessage(SenderMessage message) {
                               ? kCastRemotingNamespace
                               : kCastWebrtcNamespace;
 
-  ErrorOr<Json::Value> jsonified = message.ToJson();
-  OSP_CHECK(jsonified.is_value()) << "Tried to send an invalid message";
-  return SessionMessenger::SendMessage(receiver_id_, namespace_,
-                                       jsonified.value());
+  std::string* const body = ResetSendBuffer();
+  json::StreamingWriter writer(body);
+  message.WriteJson(&writer);
+  OSP_CHECK(writer.is_complete()) << "Tried to send an invalid message";
+  return SessionMessenger::SendMessage(receiver_id_, namespace_, *body);
 }
 
 Error SenderSessionMessenger::SendRpcMessage(
@@ -169,20 +172,14 @@ void SenderSessionMessenger::OnMessage(const std::string& source_id,
     return;
   }
 
-  ErrorOr<Json::Value> message_body = json::Parse(message);
-  if (!message_body) {
-    ReportError(message_body.error());
-    OSP_DLOG_WARN << "Received an invalid message: " << message;
-    return;
-  }
-
   // If the message is valid JSON and we don't understand it, there are two
   // options: (1) it's an unknown type, or (2) the receiver filled out the
   // message incorrectly. In the first case we can drop it, it's likely just
   // unsupported. In the second case we might need it, so worth warning the
   // client.
+  message_reader()->Reset(message);
   ErrorOr<ReceiverMessage> receiver_message =
-      ReceiverMessage::Parse(message_body.value());
+      ReceiverMessage::Parse(message_reader());
   if (receiver_message.is_error()) {
     ReportError(receiver_message.error());
     OSP_DLOG_WARN << "Received an invalid receiver message: "
@@ -242,10 +239,11 @@ Error ReceiverSessionMessenger::SendMessage(const std::string& source_id,
                               ? kCastRemotingNamespace
                               : kCastWebrtcNamespace;
 
-  ErrorOr<Json::Value> message_json = message.ToJson();
-  OSP_CHECK(message_json.is_value()) << "Tried to send an invalid message";
-  return SessionMessenger::SendMessage(source_id, namespace_,
-                                       message_json.value());
+  std::string* const body = ResetSendBuffer();
+  json::StreamingWriter writer(body);
+  message.WriteJson(&writer);
+  OSP_CHECK(writer.is_complete()) << "Tried to send an invalid message";
+  return SessionMessenger::SendMessage(source_id, namespace_, *body);
 }
 
 void ReceiverSessionMessenger::OnMessage(const std::string& source_id,
@@ -259,20 +257,14 @@ void ReceiverSessionMessenger::OnMessage(const std::string& source_id,
   }
 
   // If the message is bad JSON, the sender is in a funky state so we
-  // report an error.
-  ErrorOr<Json::Value> message_body = json::Parse(message);
-  if (message_body.is_error()) {
-    ReportError(message_body.error());
-    return;
-  }
-
-  // If the message is valid JSON and we don't understand it, there are two
-  // options: (1) it's an unknown type, or (2) the sender filled out the message
-  // incorrectly. In the first case we can drop it, it's likely just
-  // unsupported. In the second case we might need it, so worth warning the
-  // client.
+  // report an error. If the message is valid JSON and we don't understand it,
+  // there are two options: (1) it's an unknown type, or (2) the sender filled
+  // out the message incorrectly. In the first case we can drop it, it's likely
+  // just unsupported. In the second case we might need it, so worth warning
+  // the client.
+  message_reader()->Reset(message);
   ErrorOr<SenderMessage> sender_message =
-      SenderMessage::Parse(message_body.value());
+      SenderMessage::Parse(message_reader());
   if (sender_message.is_error()) {
     ReportError(sender_message.error());
     OSP_DLOG_WARN << "Received an invalid sender message: "
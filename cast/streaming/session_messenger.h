@@ -20,6 +20,7 @@
 #include "json/value.h"
 #include "platform/api/task_runner.h"
 #include "util/flat_map.h"
+#include "util/json/streaming_json_reader.h"
 #include "util/weak_ptr.h"
 
 namespace openscreen {
@@ -40,7 +41,14 @@ class SessionMessenger : public MessagePort::Client {
   // Barebones message sending method shared by both children.
   [[nodiscard]] Error SendMessage(const std::string& destination_id,
                                   const std::string& namespace_,
-                                  const Json::Value& message_root);
+                                  const std::string& message_body);
+
+  // Returns an empty buffer to write an outgoing message into.  The buffer is
+  // reused, so it keeps its capacity from earlier messages.
+  std::string* ResetSendBuffer();
+
+  // Used to parse incoming messages, reusing its buffers between messages.
+  json::StreamingReader* message_reader() { return &message_reader_; }
 
   // Used to report errors in subclasses.
   void ReportError(Error error);
@@ -51,6 +59,9 @@ class SessionMessenger : public MessagePort::Client {
   MessagePort* const message_port_;
   const std::string source_id_;
   ErrorCallback error_callback_;
+
+  std::string send_buffer_;
+  json::StreamingReader message_reader_;
 };
 
 // Message port interface designed to handle sending messages to and
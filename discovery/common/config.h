@@ -5,6 +5,7 @@
 #ifndef DISCOVERY_COMMON_CONFIG_H_
 #define DISCOVERY_COMMON_CONFIG_H_
 
+#include <string>
 #include <vector>
 
 #include "platform/base/interface_info.h"
@@ -81,6 +82,18 @@ struct Config {
   // Sets the querier to ignore all NSEC negative response records received as
   // responses to outgoing queries.
   bool ignore_nsec_responses = false;
+
+  // If set, the querier's cache for each interface is saved to a file at this
+  // path, suffixed with the interface name, every
+  // |querier_cache_snapshot_period_seconds| and when the mDNS service shuts
+  // down. The saved records are loaded when the mDNS service starts, and are
+  // reported to queries until the network confirms or replaces them, so that
+  // known services are rediscovered without waiting for responses.
+  std::string querier_cache_snapshot_path;
+
+  // Number of seconds between cache snapshots. If zero or negative, the cache
+  // is only saved when the mDNS service shuts down.
+  int querier_cache_snapshot_period_seconds = 60;
 };
 
 }  // namespace discovery
@@ -4,6 +4,7 @@
 
 #include "discovery/dnssd/impl/dns_data_graph.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "discovery/dnssd/impl/conversion_layer.h"
@@ -42,6 +43,13 @@ ErrorOr<DnsSdInstanceEndpoint> CreateEndpoint(
       network_interface, std::move(endpoints));
 }
 
+// Returns whether |a| and |b| are endpoints of the same service instance.
+bool IsSameInstance(const DnsSdInstanceEndpoint& a,
+                    const DnsSdInstanceEndpoint& b) {
+  return a.instance_id() == b.instance_id() &&
+         a.service_id() == b.service_id() && a.domain_id() == b.domain_id();
+}
+
 class DnsDataGraphImpl : public DnsDataGraph {
  public:
   using DnsDataGraph::DomainChangeCallback;
@@ -72,6 +80,8 @@ class DnsDataGraphImpl : public DnsDataGraph {
                               DomainChangeCallback on_start_tracking,
                               DomainChangeCallback on_stop_tracking) override;
 
+  EndpointChanges TakeEndpointChanges() override;
+
   size_t GetTrackedDomainCount() const override { return nodes_.size(); }
 
   bool IsTracked(const DomainName& name) const override {
@@ -118,6 +128,13 @@ class DnsDataGraphImpl : public DnsDataGraph {
     const std::vector<Node*>& children() const { return children_; }
     const std::vector<MdnsRecord>& records() const { return records_; }
 
+    std::vector<ErrorOr<DnsSdInstanceEndpoint>>& endpoints() {
+      return endpoints_;
+    }
+
+    bool is_dirty() const { return is_dirty_; }
+    void set_dirty(bool is_dirty) { is_dirty_ = is_dirty; }
+
    private:
     // Adds or removes an edge in |graph_|.
     // NOTE: The same edge may be added multiple times, and one call to remove
@@ -145,6 +162,13 @@ class DnsDataGraphImpl : public DnsDataGraph {
     // Nodes containing records pointed to by the records in this node.
     std::vector<Node*> children_;
 
+    // The endpoints created for this node by the last call to
+    // TakeEndpointChanges() after it was marked dirty.
+    std::vector<ErrorOr<DnsSdInstanceEndpoint>> endpoints_;
+
+    // Whether this node is in |graph_->dirty_nodes_|.
+    bool is_dirty_ = false;
+
     // Graph containing this node.
     DnsDataGraphImpl* graph_;
   };
@@ -192,6 +216,16 @@ class DnsDataGraphImpl : public DnsDataGraph {
   std::vector<ErrorOr<DnsSdInstanceEndpoint>> CalculatePtrRecordEndpoints(
       Node* node) const;
 
+  // Marks |node| as one whose endpoints may have changed.
+  void MarkDirty(Node* node);
+
+  // Called when |node| is deleted due to a record change or StopTracking().
+  void OnNodeDeleted(Node* node);
+
+  // Creates the endpoints of |node| again, and adds how they differ from the
+  // ones created before to |changes|.
+  void UpdateEndpoints(Node* node, EndpointChanges* changes);
+
   // Denotes whether the dtor for this instance has been called. This is
   // required for validation of Node instance functionality. See the
   // implementation of DnsDataGraph::Node::~Node() for more details.
@@ -201,6 +235,13 @@ class DnsDataGraphImpl : public DnsDataGraph {
   // name.
   std::map<DomainName, std::unique_ptr<Node>> nodes_;
 
+  // Nodes whose endpoints may have changed since the last call to
+  // TakeEndpointChanges().
+  std::vector<Node*> dirty_nodes_;
+
+  // Endpoints of nodes deleted since the last call to TakeEndpointChanges().
+  std::vector<DnsSdInstanceEndpoint> deleted_endpoints_;
+
   const NetworkInterfaceIndex network_interface_;
 
   // The methods to be called when a domain name either starts or stops being
@@ -232,6 +273,7 @@ DnsDataGraphImpl::Node::~Node() {
       RemoveChild(child);
     }
 
+    graph_->OnNodeDeleted(this);
     OSP_DCHECK(graph_->on_node_deletion_);
     graph_->on_node_deletion_(name_);
   }
@@ -240,6 +282,7 @@ DnsDataGraphImpl::Node::~Node() {
 Error DnsDataGraphImpl::Node::ApplyDataRecordChange(MdnsRecord record,
                                                     RecordChangedEvent event) {
   OSP_DCHECK(record.name() == name_);
+  const DnsType type = record.dns_type();
 
   // The child domain to which the changed record points, or none. This is only
   // applicable for PTR and SRV records, and is empty in all other cases.
@@ -294,6 +337,17 @@ Error DnsDataGraphImpl::Node::ApplyDataRecordChange(MdnsRecord record,
     ApplyChildChange(std::move(child_name), event);
   }
 
+  // Mark the SRV and TXT domains whose endpoints this change may affect. PTR
+  // records aren't part of any endpoint, and a domain which is no longer
+  // pointed to by any PTR record is deleted rather than marked.
+  if (type == DnsType::kSRV || type == DnsType::kTXT) {
+    graph_->MarkDirty(this);
+  } else if (type == DnsType::kA || type == DnsType::kAAAA) {
+    for (Node* parent : parents_) {
+      graph_->MarkDirty(parent);
+    }
+  }
+
   return Error::None();
 }
 
@@ -401,9 +455,14 @@ void DnsDataGraphImpl::StopTracking(const DomainName& domain,
   auto it = nodes_.find(domain);
   OSP_CHECK(it != nodes_.end());
   OSP_DCHECK(it->second->parents().empty());
+
+  // Endpoints which are no longer tracked aren't reported as deleted.
+  const size_t deleted_count = deleted_endpoints_.size();
   it->second.reset();
   const size_t erased_count = nodes_.erase(domain);
   OSP_DCHECK(erased_count);
+  deleted_endpoints_.erase(deleted_endpoints_.begin() + deleted_count,
+                           deleted_endpoints_.end());
 }
 
 Error DnsDataGraphImpl::ApplyDataRecordChange(
@@ -427,6 +486,18 @@ Error DnsDataGraphImpl::ApplyDataRecordChange(
   return result;
 }
 
+DnsDataGraph::EndpointChanges DnsDataGraphImpl::TakeEndpointChanges() {
+  EndpointChanges changes;
+  changes.deleted = std::move(deleted_endpoints_);
+  deleted_endpoints_.clear();
+  for (Node* node : dirty_nodes_) {
+    node->set_dirty(false);
+    UpdateEndpoints(node, &changes);
+  }
+  dirty_nodes_.clear();
+  return changes;
+}
+
 std::vector<ErrorOr<DnsSdInstanceEndpoint>> DnsDataGraphImpl::CreateEndpoints(
     DomainGroup domain_group,
     const DomainName& name) const {
@@ -555,8 +626,84 @@ DnsDataGraphImpl::CalculatePtrRecordEndpoints(Node* node) const {
   return endpoints;
 }
 
+void DnsDataGraphImpl::MarkDirty(Node* node) {
+  if (!node->is_dirty()) {
+    node->set_dirty(true);
+    dirty_nodes_.push_back(node);
+  }
+}
+
+void DnsDataGraphImpl::OnNodeDeleted(Node* node) {
+  if (node->is_dirty()) {
+    dirty_nodes_.erase(
+        std::find(dirty_nodes_.begin(), dirty_nodes_.end(), node));
+  }
+  for (ErrorOr<DnsSdInstanceEndpoint>& endpoint : node->endpoints()) {
+    if (endpoint.is_value()) {
+      deleted_endpoints_.push_back(std::move(endpoint.value()));
+    }
+  }
+}
+
+void DnsDataGraphImpl::UpdateEndpoints(Node* node, EndpointChanges* changes) {
+  std::vector<ErrorOr<DnsSdInstanceEndpoint>> endpoints =
+      CreateEndpoints(DomainGroup::kSrvAndTxt, node->name());
+  const std::vector<ErrorOr<DnsSdInstanceEndpoint>>& old_endpoints =
+      node->endpoints();
+
+  // NOTE: A node has at most one SRV record, so each of these vectors holds no
+  // more than one element in practice.
+  for (const ErrorOr<DnsSdInstanceEndpoint>& endpoint : endpoints) {
+    if (endpoint.is_error()) {
+      if (!Contains(old_endpoints, endpoint)) {
+        changes->errors.push_back(endpoint.error());
+      }
+      continue;
+    }
+
+    const auto it = std::find_if(
+        old_endpoints.begin(), old_endpoints.end(),
+        [&endpoint](const ErrorOr<DnsSdInstanceEndpoint>& old_endpoint) {
+          return old_endpoint.is_value() &&
+                 IsSameInstance(old_endpoint.value(), endpoint.value());
+        });
+    if (it == old_endpoints.end()) {
+      changes->created.push_back(endpoint.value());
+    } else if (!(it->value() == endpoint.value())) {
+      changes->updated.push_back(endpoint.value());
+    }
+  }
+
+  for (const ErrorOr<DnsSdInstanceEndpoint>& old_endpoint : old_endpoints) {
+    if (old_endpoint.is_error()) {
+      continue;
+    }
+    const bool is_still_present = ContainsIf(
+        endpoints,
+        [&old_endpoint](const ErrorOr<DnsSdInstanceEndpoint>& endpoint) {
+          return endpoint.is_value() &&
+                 IsSameInstance(endpoint.value(), old_endpoint.value());
+        });
+    if (!is_still_present) {
+      changes->deleted.push_back(old_endpoint.value());
+    }
+  }
+
+  node->endpoints() = std::move(endpoints);
+}
+
 }  // namespace
 
+DnsDataGraph::EndpointChanges::EndpointChanges() = default;
+
+DnsDataGraph::EndpointChanges::EndpointChanges(
+    EndpointChanges&& other) noexcept = default;
+
+DnsDataGraph::EndpointChanges::~EndpointChanges() = default;
+
+DnsDataGraph::EndpointChanges& DnsDataGraph::EndpointChanges::operator=(
+    EndpointChanges&& other) = default;
+
 DnsDataGraph::~DnsDataGraph() = default;
 
 // static
@@ -88,6 +88,23 @@ class DnsDataGraph {
   // Callback to use when a domain change occurs.
   using DomainChangeCallback = std::function<void(DomainName)>;
 
+  // Changes to the DnsSdInstanceEndpoints described by the graph.
+  struct EndpointChanges {
+    EndpointChanges();
+    EndpointChanges(EndpointChanges&& other) noexcept;
+    ~EndpointChanges();
+
+    EndpointChanges& operator=(EndpointChanges&& other);
+
+    std::vector<DnsSdInstanceEndpoint> created;
+    std::vector<DnsSdInstanceEndpoint> updated;
+    std::vector<DnsSdInstanceEndpoint> deleted;
+
+    // Errors which occurred while creating endpoints, other than those which
+    // had already occurred for the same endpoint before the changes.
+    std::vector<Error> errors;
+  };
+
   virtual ~DnsDataGraph();
 
   // Manually starts or stops tracking the provided domain. These methods should
@@ -120,6 +137,15 @@ class DnsDataGraph {
       DomainChangeCallback on_start_tracking,
       DomainChangeCallback on_stop_tracking) = 0;
 
+  // Returns the changes to endpoints caused by the record changes applied
+  // since the last call. The graph keeps the endpoints it last created for each
+  // SRV and TXT domain, and marks the domains reachable from each changed
+  // record; only the endpoints of those domains are created again and compared
+  // against the previous ones. Endpoints of domains which stop being tracked
+  // due to a record change are reported as deleted, while those of domains
+  // removed by StopTracking() are not.
+  virtual EndpointChanges TakeEndpointChanges() = 0;
+
   virtual size_t GetTrackedDomainCount() const = 0;
 
   // Returns whether the provided domain is tracked or not. This may either be
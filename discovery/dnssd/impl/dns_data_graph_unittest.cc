@@ -478,5 +478,147 @@ TEST_F(DnsDataGraphTests, FailedConversionOnlyFailsSingleEndpointCreation) {
   ExpectDomainEqual(endpoint, primary_domain_);
 }
 
+TEST_F(DnsDataGraphTests, EndpointChangesOnlyForAffectedInstances) {
+  auto ptr = GetFakePtrRecord(primary_domain_);
+  auto srv = GetFakeSrvRecord(primary_domain_, tertiary_domain_);
+  auto txt = GetFakeTxtRecord(primary_domain_);
+  auto ptr2 = GetFakePtrRecord(secondary_domain_);
+  auto srv2 = GetFakeSrvRecord(secondary_domain_, tertiary_domain_);
+  auto txt2 = GetFakeTxtRecord(secondary_domain_);
+  auto a = GetFakeARecord(tertiary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreationWithCallback(srv, tertiary_domain_);
+  TriggerRecordCreation(txt);
+  TriggerRecordCreationWithCallback(ptr2, secondary_domain_);
+  TriggerRecordCreation(srv2);
+  TriggerRecordCreation(txt2);
+  TriggerRecordCreation(a);
+
+  DnsDataGraph::EndpointChanges changes = graph_->TakeEndpointChanges();
+  ASSERT_EQ(changes.created.size(), size_t{2});
+  EXPECT_TRUE(changes.updated.empty());
+  EXPECT_TRUE(changes.deleted.empty());
+  EXPECT_TRUE(changes.errors.empty());
+
+  // Nothing changed since the last call.
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  EXPECT_TRUE(changes.updated.empty());
+
+  // A TXT change only affects its own instance.
+  const MdnsRecord new_txt(primary_domain_, DnsType::kTXT, DnsClass::kIN,
+                           RecordType::kUnique, std::chrono::seconds(0),
+                           MakeTxtRecord({"key=other_value"}));
+  EXPECT_TRUE(
+      ApplyDataRecordChange(new_txt, RecordChangedEvent::kUpdated).ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  ASSERT_EQ(changes.updated.size(), size_t{1});
+  ExpectDomainEqual(changes.updated[0], primary_domain_);
+  EXPECT_TRUE(changes.deleted.empty());
+
+  // An address change affects every instance pointing to it.
+  const MdnsRecord new_a(tertiary_domain_, DnsType::kA, DnsClass::kIN,
+                         RecordType::kUnique, std::chrono::seconds(0),
+                         ARecordRdata(IPAddress(192, 168, 1, 2)));
+  EXPECT_TRUE(ApplyDataRecordChange(new_a, RecordChangedEvent::kUpdated).ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  ASSERT_EQ(changes.updated.size(), size_t{2});
+  EXPECT_EQ(GetAddressV4(changes.updated[0]), IPAddress(192, 168, 1, 2));
+  EXPECT_EQ(GetAddressV4(changes.updated[1]), IPAddress(192, 168, 1, 2));
+  EXPECT_TRUE(changes.deleted.empty());
+
+  // Removing the only address deletes both endpoints.
+  EXPECT_TRUE(ApplyDataRecordChange(new_a, RecordChangedEvent::kExpired).ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  EXPECT_TRUE(changes.updated.empty());
+  EXPECT_EQ(changes.deleted.size(), size_t{2});
+}
+
+TEST_F(DnsDataGraphTests, EndpointChangesIncludeDeletedDomains) {
+  auto ptr = GetFakePtrRecord(primary_domain_);
+  auto srv = GetFakeSrvRecord(primary_domain_, secondary_domain_);
+  auto txt = GetFakeTxtRecord(primary_domain_);
+  auto a = GetFakeARecord(secondary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreationWithCallback(srv, secondary_domain_);
+  TriggerRecordCreation(txt);
+  TriggerRecordCreation(a);
+  ASSERT_EQ(graph_->TakeEndpointChanges().created.size(), size_t{1});
+
+  EXPECT_CALL(callbacks_, OnStopTracking(primary_domain_));
+  EXPECT_CALL(callbacks_, OnStopTracking(secondary_domain_));
+  EXPECT_TRUE(ApplyDataRecordChange(ptr, RecordChangedEvent::kExpired).ok());
+  testing::Mock::VerifyAndClearExpectations(&callbacks_);
+
+  DnsDataGraph::EndpointChanges changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  EXPECT_TRUE(changes.updated.empty());
+  ASSERT_EQ(changes.deleted.size(), size_t{1});
+  ExpectDomainEqual(changes.deleted[0], primary_domain_);
+}
+
+TEST_F(DnsDataGraphTests, EndpointChangesExcludeStoppedTracking) {
+  auto ptr = GetFakePtrRecord(primary_domain_);
+  auto srv = GetFakeSrvRecord(primary_domain_, secondary_domain_);
+  auto txt = GetFakeTxtRecord(primary_domain_);
+  auto a = GetFakeARecord(secondary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreationWithCallback(srv, secondary_domain_);
+  TriggerRecordCreation(txt);
+  TriggerRecordCreation(a);
+  ASSERT_EQ(graph_->TakeEndpointChanges().created.size(), size_t{1});
+
+  EXPECT_CALL(callbacks_, OnStopTracking(ptr_domain_));
+  EXPECT_CALL(callbacks_, OnStopTracking(primary_domain_));
+  EXPECT_CALL(callbacks_, OnStopTracking(secondary_domain_));
+  StopTracking(ptr_domain_);
+  testing::Mock::VerifyAndClearExpectations(&callbacks_);
+
+  DnsDataGraph::EndpointChanges changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  EXPECT_TRUE(changes.updated.empty());
+  EXPECT_TRUE(changes.deleted.empty());
+}
+
+TEST_F(DnsDataGraphTests, EndpointChangesOnlyIncludeNewErrors) {
+  auto ptr = GetFakePtrRecord(primary_domain_);
+  auto srv = GetFakeSrvRecord(primary_domain_, secondary_domain_);
+  auto txt = MdnsRecord(primary_domain_, DnsType::kTXT, DnsClass::kIN,
+                        RecordType::kUnique, std::chrono::seconds(0),
+                        MakeTxtRecord({"=bad_txt_record"}));
+  auto a = GetFakeARecord(secondary_domain_);
+
+  TriggerRecordCreationWithCallback(ptr, primary_domain_);
+  TriggerRecordCreationWithCallback(srv, secondary_domain_);
+  TriggerRecordCreation(txt);
+  TriggerRecordCreation(a);
+
+  DnsDataGraph::EndpointChanges changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  EXPECT_EQ(changes.errors.size(), size_t{1});
+
+  // The same error occurs again after an unrelated change, so isn't reported.
+  EXPECT_TRUE(ApplyDataRecordChange(GetFakeAAAARecord(secondary_domain_),
+                                    RecordChangedEvent::kCreated)
+                  .ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_TRUE(changes.created.empty());
+  EXPECT_TRUE(changes.errors.empty());
+
+  // Fixing the TXT record creates the endpoint.
+  EXPECT_TRUE(ApplyDataRecordChange(GetFakeTxtRecord(primary_domain_),
+                                    RecordChangedEvent::kUpdated)
+                  .ok());
+  changes = graph_->TakeEndpointChanges();
+  EXPECT_EQ(changes.created.size(), size_t{1});
+  EXPECT_TRUE(changes.errors.empty());
+}
+
 }  // namespace discovery
 }  // namespace openscreen
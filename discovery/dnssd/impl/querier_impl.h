@@ -65,6 +65,10 @@ class QuerierImpl : public DnsSdQuerier, public MdnsRecordChangedCallback {
                              std::vector<DnsSdInstanceEndpoint> updated,
                              std::vector<DnsSdInstanceEndpoint> deleted);
 
+  // Returns the callbacks for the service of |endpoint|.
+  std::vector<Callback*> GetCallbacks(
+      const DnsSdInstanceEndpoint& endpoint) const;
+
   // Graph of underlying mDNS Record and their associations with each-other.
   std::unique_ptr<DnsDataGraph> graph_;
 
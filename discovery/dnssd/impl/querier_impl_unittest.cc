@@ -77,6 +77,8 @@ class MockDnsDataGraph : public DnsDataGraph {
                      DomainChangeCallback,
                      DomainChangeCallback));
 
+  MOCK_METHOD0(TakeEndpointChanges, EndpointChanges());
+
   MOCK_CONST_METHOD0(GetTrackedDomainCount, size_t());
 
   MOCK_CONST_METHOD1(IsTracked, bool(const DomainName&));
@@ -457,112 +459,39 @@ TEST_F(DnsSdQuerierImplTest, HardRefresh) {
 // should be validated against for safety, or should only occur when either a
 // bad actor or a misbehaving publisher is present on the network. To simplify
 // these tests, the DnsDataGraph object will be mocked.
-TEST_F(DnsSdQuerierImplTest, ErrorsOnlyAfterChangesAreLogged) {
-  MockDnsDataGraph& mock_graph = querier->GetMockedGraph();
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> before_changes{};
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
-  after_changes.emplace_back(Error::Code::kItemNotFound);
-  after_changes.emplace_back(Error::Code::kItemNotFound);
-  after_changes.emplace_back(Error::Code::kItemAlreadyExists);
-
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
-  EXPECT_CALL(querier->reporting_client(), OnRecoverableError(_)).Times(3);
-
-  // Call to apply record changes. The specifics are unimportant.
-  EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
-      .WillOnce(Return(Error::None()));
-
-  // Call with any record. The mocks make the specifics unimportant.
-  querier->OnRecordChanged(GetFakePtrRecord(name),
-                           RecordChangedEvent::kCreated);
-}
-
-TEST_F(DnsSdQuerierImplTest, ErrorsOnlyBeforeChangesNotLogged) {
+TEST_F(DnsSdQuerierImplTest, ErrorsFromEndpointChangesAreLogged) {
   MockDnsDataGraph& mock_graph = querier->GetMockedGraph();
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> before_changes{};
-  before_changes.emplace_back(Error::Code::kItemNotFound);
-  before_changes.emplace_back(Error::Code::kItemNotFound);
-  before_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
-
-  // Calls before and after applying record changes.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  DnsDataGraph::EndpointChanges changes;
+  changes.errors.emplace_back(Error::Code::kItemNotFound);
+  changes.errors.emplace_back(Error::Code::kItemNotFound);
+  changes.errors.emplace_back(Error::Code::kItemAlreadyExists);
 
   // Call to apply record changes. The specifics are unimportant.
   EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
       .WillOnce(Return(Error::None()));
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(std::move(changes))));
+  EXPECT_CALL(querier->reporting_client(), OnRecoverableError(_)).Times(3);
 
   // Call with any record. The mocks make the specifics unimportant.
   querier->OnRecordChanged(GetFakePtrRecord(name),
                            RecordChangedEvent::kCreated);
 }
 
-TEST_F(DnsSdQuerierImplTest, ErrorsBeforeAndAfterChangesNotLogged) {
+TEST_F(DnsSdQuerierImplTest, EndpointChangesNotTakenWhenApplyingChangeFails) {
   MockDnsDataGraph& mock_graph = querier->GetMockedGraph();
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> before_changes{};
-  before_changes.emplace_back(Error::Code::kItemNotFound);
-  before_changes.emplace_back(Error::Code::kItemNotFound);
-  before_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
-  after_changes.emplace_back(Error::Code::kItemNotFound);
-  after_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  after_changes.emplace_back(Error::Code::kItemNotFound);
-
-  // Calls before and after applying record changes.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
-
-  // Call to apply record changes. The specifics are unimportant.
   EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
-      .WillOnce(Return(Error::None()));
-
-  // Call with any record. The mocks make the specifics unimportant.
-  querier->OnRecordChanged(GetFakePtrRecord(name),
-                           RecordChangedEvent::kCreated);
-}
-
-TEST_F(DnsSdQuerierImplTest, OrderOfErrorsDoesNotAffectResults) {
-  MockDnsDataGraph& mock_graph = querier->GetMockedGraph();
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> before_changes{};
-  before_changes.emplace_back(Error::Code::kIndexOutOfBounds);
-  before_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  before_changes.emplace_back(Error::Code::kOperationCancelled);
-  before_changes.emplace_back(Error::Code::kItemNotFound);
-  before_changes.emplace_back(Error::Code::kOperationInProgress);
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
-  after_changes.emplace_back(Error::Code::kOperationInProgress);
-  after_changes.emplace_back(Error::Code::kUnknownError);
-  after_changes.emplace_back(Error::Code::kItemNotFound);
-  after_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  after_changes.emplace_back(Error::Code::kOperationCancelled);
-
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+      .WillOnce(Return(Error::Code::kItemNotFound));
   EXPECT_CALL(querier->reporting_client(), OnRecoverableError(_)).Times(1);
 
-  // Call to apply record changes. The specifics are unimportant.
-  EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
-      .WillOnce(Return(Error::None()));
-
-  // Call with any record. The mocks make the specifics unimportant.
   querier->OnRecordChanged(GetFakePtrRecord(name),
-                           RecordChangedEvent::kCreated);
+                           RecordChangedEvent::kExpired);
 }
 
-TEST_F(DnsSdQuerierImplTest, ResultsWithMultipleAddressRecordsHandled) {
+TEST_F(DnsSdQuerierImplTest, EndpointChangesDispatchedByService) {
   IPEndpoint endpointa{{192, 168, 86, 23}, 80};
   IPEndpoint endpointb{{1, 2, 3, 4, 5, 6, 7, 8}, 80};
   IPEndpoint endpointc{{192, 168, 0, 1}, 80};
-  IPEndpoint endpointd{{192, 168, 0, 2}, 80};
-  IPEndpoint endpointe{{192, 168, 0, 3}, 80};
 
   DnsSdInstanceEndpoint instance1("instance1", "_service._udp", "local", {},
                                   kNetworkInterface, {endpointa, endpointb});
@@ -570,86 +499,31 @@ TEST_F(DnsSdQuerierImplTest, ResultsWithMultipleAddressRecordsHandled) {
                                   kNetworkInterface, {endpointa, endpointb});
   DnsSdInstanceEndpoint instance3("instance3", "_service._udp", "local", {},
                                   kNetworkInterface, {endpointc});
-  DnsSdInstanceEndpoint instance4("instance1", "_service3._udp", "local", {},
-                                  kNetworkInterface, {endpointd, endpointe});
-  DnsSdInstanceEndpoint instance5("instance1", "_service3._udp", "local", {},
-                                  kNetworkInterface, {endpointe});
+  DnsSdInstanceEndpoint instance4("instance4", "_service._udp", "local", {},
+                                  kNetworkInterface, {endpointa});
 
   MockDnsDataGraph& mock_graph = querier->GetMockedGraph();
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> before_changes{};
-  before_changes.emplace_back(instance4);
-  before_changes.emplace_back(instance2);
-  before_changes.emplace_back(instance3);
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
-  after_changes.emplace_back(instance5);
-  after_changes.emplace_back(instance3);
-  after_changes.emplace_back(instance1);
-
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
-  EXPECT_CALL(callback, OnEndpointCreated(instance1));
-  EXPECT_CALL(callback, OnEndpointUpdated(instance5));
-  EXPECT_CALL(callback, OnEndpointDeleted(instance2));
+  DnsDataGraph::EndpointChanges changes;
+  changes.created.push_back(instance2);
+  changes.created.push_back(instance1);
+  changes.updated.push_back(instance3);
+  changes.deleted.push_back(instance4);
+  changes.errors.emplace_back(Error::Code::kUnknownError);
 
   // Call to apply record changes. The specifics are unimportant.
   EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
       .WillOnce(Return(Error::None()));
-
-  // Call with any record. The mocks make the specifics unimportant.
-  querier->OnRecordChanged(GetFakePtrRecord(name),
-                           RecordChangedEvent::kCreated);
-}
-
-TEST_F(DnsSdQuerierImplTest, MixOfErrorsAndSuccessesHandledCorrectly) {
-  DnsSdInstanceEndpoint instance1("instance1", "_service._udp", "local", {},
-                                  kNetworkInterface, {{{192, 168, 2, 24}, 80}});
-  DnsSdInstanceEndpoint instance2("instance2", "_service2._udp", "local", {},
-                                  kNetworkInterface, {{{192, 168, 17, 2}, 80}});
-  DnsSdInstanceEndpoint instance3("instance3", "_service._udp", "local", {},
-                                  kNetworkInterface, {{{127, 0, 0, 1}, 80}});
-  DnsSdInstanceEndpoint instance4("instance1", "_service3._udp", "local", {},
-                                  kNetworkInterface, {{{127, 0, 0, 1}, 80}});
-  DnsSdInstanceEndpoint instance5("instance1", "_service3._udp", "local", {},
-                                  kNetworkInterface,
-                                  {{{127, 0, 0, 1}, 80}, {{127, 0, 0, 2}, 80}});
-
-  MockDnsDataGraph& mock_graph = querier->GetMockedGraph();
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> before_changes{};
-  before_changes.emplace_back(Error::Code::kIndexOutOfBounds);
-  before_changes.emplace_back(instance2);
-  before_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  before_changes.emplace_back(Error::Code::kOperationCancelled);
-  before_changes.emplace_back(instance1);
-  before_changes.emplace_back(Error::Code::kItemNotFound);
-  before_changes.emplace_back(Error::Code::kOperationInProgress);
-  before_changes.emplace_back(instance4);
-  std::vector<ErrorOr<DnsSdInstanceEndpoint>> after_changes{};
-  after_changes.emplace_back(instance1);
-  after_changes.emplace_back(Error::Code::kOperationInProgress);
-  after_changes.emplace_back(Error::Code::kUnknownError);
-  after_changes.emplace_back(Error::Code::kItemNotFound);
-  after_changes.emplace_back(Error::Code::kItemAlreadyExists);
-  after_changes.emplace_back(instance3);
-  after_changes.emplace_back(instance5);
-  after_changes.emplace_back(Error::Code::kOperationCancelled);
-
-  // Calls before and after applying record changes, then the error it logs.
-  EXPECT_CALL(mock_graph, CreateEndpoints(_, _))
-      .WillOnce(Return(ByMove(std::move(before_changes))))
-      .WillOnce(Return(ByMove(std::move(after_changes))));
+  EXPECT_CALL(mock_graph, TakeEndpointChanges())
+      .WillOnce(Return(ByMove(std::move(changes))));
   EXPECT_CALL(querier->reporting_client(), OnRecoverableError(_)).Times(1);
-  EXPECT_CALL(callback, OnEndpointCreated(instance3));
-  EXPECT_CALL(callback, OnEndpointUpdated(instance5));
-  EXPECT_CALL(callback, OnEndpointDeleted(instance2));
 
-  // Call to apply record changes. The specifics are unimportant.
-  EXPECT_CALL(mock_graph, ApplyDataRecordChange(_, _, _, _))
-      .WillOnce(Return(Error::None()));
+  // Only the endpoints of the queried service are reported.
+  EXPECT_CALL(callback, OnEndpointCreated(instance1));
+  EXPECT_CALL(callback, OnEndpointUpdated(instance3));
+  EXPECT_CALL(callback, OnEndpointDeleted(instance4));
 
   // Call with any record. The mocks make the specifics unimportant.
-  querier->OnRecordChanged(GetFakePtrRecord(name),
+  querier->OnRecordChanged(GetFakeARecord(name),
                            RecordChangedEvent::kCreated);
 }
 
@@ -8,6 +8,7 @@
 
 #include "discovery/common/config.h"
 #include "discovery/dnssd/impl/service_instance.h"
+#include "discovery/dnssd/impl/service_instance_proxy.h"
 #include "discovery/dnssd/public/dns_sd_instance.h"
 #include "discovery/mdns/public/mdns_service.h"
 #include "platform/api/serial_delete_ptr.h"
@@ -19,7 +20,7 @@ namespace discovery {
 namespace {
 
 void ForAllQueriers(
-    std::vector<std::unique_ptr<ServiceInstance>>* service_instances,
+    std::vector<std::unique_ptr<DnsSdService>>* service_instances,
     std::function<void(DnsSdQuerier*)> action) {
   for (auto& service_instance : *service_instances) {
     auto* querier = service_instance->GetQuerier();
@@ -30,7 +31,7 @@ void ForAllQueriers(
 }
 
 Error ForAllPublishers(
-    std::vector<std::unique_ptr<ServiceInstance>>* service_instances,
+    std::vector<std::unique_ptr<DnsSdService>>* service_instances,
     std::function<Error(DnsSdPublisher*)> action,
     const char* operation) {
   Error result = Error::None();
@@ -60,9 +61,23 @@ SerialDeletePtr<DnsSdService> CreateDnsSdService(
       new ServiceDispatcher(task_runner, reporting_client, config));
 }
 
-ServiceDispatcher::ServiceDispatcher(TaskRunner* task_runner,
-                                     ReportingClient* reporting_client,
-                                     const Config& config)
+// static
+SerialDeletePtr<DnsSdService> CreateDnsSdService(
+    TaskRunner* task_runner,
+    ReportingClient* reporting_client,
+    const Config& config,
+    InterfaceTaskRunnerProvider interface_task_runners) {
+  return SerialDeletePtr<DnsSdService>(
+      task_runner,
+      new ServiceDispatcher(task_runner, reporting_client, config,
+                            std::move(interface_task_runners)));
+}
+
+ServiceDispatcher::ServiceDispatcher(
+    TaskRunner* task_runner,
+    ReportingClient* reporting_client,
+    const Config& config,
+    InterfaceTaskRunnerProvider interface_task_runners)
     : task_runner_(task_runner),
       publisher_(config.enable_publication ? this : nullptr),
       querier_(config.enable_querying ? this : nullptr) {
@@ -71,8 +86,16 @@ ServiceDispatcher::ServiceDispatcher(TaskRunner* task_runner,
 
   service_instances_.reserve(config.network_info.size());
   for (const auto& network_info : config.network_info) {
-    service_instances_.push_back(std::make_unique<ServiceInstance>(
-        task_runner_, reporting_client, config, network_info));
+    TaskRunner* const instance_task_runner =
+        interface_task_runners ? interface_task_runners(network_info) : nullptr;
+    if (instance_task_runner && instance_task_runner != task_runner_) {
+      service_instances_.push_back(std::make_unique<ServiceInstanceProxy>(
+          task_runner_, instance_task_runner, reporting_client, config,
+          network_info));
+    } else {
+      service_instances_.push_back(std::make_unique<ServiceInstance>(
+          task_runner_, reporting_client, config, network_info));
+    }
   }
 }
 
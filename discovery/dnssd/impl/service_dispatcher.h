@@ -6,11 +6,14 @@
 #define DISCOVERY_DNSSD_IMPL_SERVICE_DISPATCHER_H_
 
 #include <memory>
+#include <vector>
 
 #include "discovery/dnssd/impl/querier_impl.h"
 #include "discovery/dnssd/impl/service_instance.h"
 #include "discovery/dnssd/public/dns_sd_querier.h"
 #include "discovery/dnssd/public/dns_sd_service.h"
+#include "discovery/public/dns_sd_service_factory.h"
+#include "platform/base/interface_info.h"
 
 namespace openscreen {
 
@@ -25,9 +28,13 @@ class ServiceDispatcher final : public DnsSdPublisher,
                                 public DnsSdQuerier,
                                 public DnsSdService {
  public:
+  // The mDNS stack for each interface runs on the TaskRunner returned for it by
+  // |interface_task_runners|, or on |task_runner| if it returns either that or
+  // nullptr, or is empty.
   ServiceDispatcher(TaskRunner* task_runner,
                     ReportingClient* reporting_client,
-                    const Config& config);
+                    const Config& config,
+                    InterfaceTaskRunnerProvider interface_task_runners = {});
   ~ServiceDispatcher() override;
 
   // DnsSdService overrides.
@@ -45,7 +52,9 @@ class ServiceDispatcher final : public DnsSdPublisher,
   Error UpdateRegistration(const DnsSdInstance& instance) override;
   ErrorOr<int> DeregisterAll(const std::string& service) override;
 
-  std::vector<std::unique_ptr<ServiceInstance>> service_instances_;
+  // Either ServiceInstances, or ServiceInstanceProxies for those running on
+  // another TaskRunner.
+  std::vector<std::unique_ptr<DnsSdService>> service_instances_;
 
   TaskRunner* const task_runner_;
 
@@ -0,0 +1,391 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/dnssd/impl/service_instance_proxy.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "discovery/dnssd/impl/service_instance.h"
+#include "discovery/dnssd/public/dns_sd_instance.h"
+#include "discovery/dnssd/public/dns_sd_instance_endpoint.h"
+#include "platform/api/task_runner.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+// Passed to the ServiceInstance in place of a query's Callback.
+class ServiceInstanceProxy::QueryRelay final : public DnsSdQuerier::Callback {
+ public:
+  QueryRelay(TaskRunner* task_runner,
+             WeakPtr<ServiceInstanceProxy> proxy,
+             QueryKey key,
+             uint64_t generation)
+      : task_runner_(task_runner),
+        proxy_(std::move(proxy)),
+        key_(std::move(key)),
+        generation_(generation) {}
+  ~QueryRelay() override = default;
+
+  uint64_t generation() const { return generation_; }
+
+  // DnsSdQuerier::Callback overrides.
+  void OnEndpointCreated(const DnsSdInstanceEndpoint& new_endpoint) override {
+    Relay(&Callback::OnEndpointCreated, new_endpoint);
+  }
+
+  void OnEndpointUpdated(
+      const DnsSdInstanceEndpoint& modified_endpoint) override {
+    Relay(&Callback::OnEndpointUpdated, modified_endpoint);
+  }
+
+  void OnEndpointDeleted(const DnsSdInstanceEndpoint& old_endpoint) override {
+    Relay(&Callback::OnEndpointDeleted, old_endpoint);
+  }
+
+ private:
+  void Relay(void (Callback::*method)(const DnsSdInstanceEndpoint&),
+             const DnsSdInstanceEndpoint& endpoint) {
+    task_runner_->PostTask(
+        [proxy = proxy_, key = key_, generation = generation_, method,
+         endpoint] {
+          if (proxy) {
+            proxy->OnEndpointChanged(key, generation, method, endpoint);
+          }
+        });
+  }
+
+  TaskRunner* const task_runner_;
+  const WeakPtr<ServiceInstanceProxy> proxy_;
+  const QueryKey key_;
+  const uint64_t generation_;
+};
+
+// Passed to the ServiceInstance in place of a registration's Client.
+class ServiceInstanceProxy::ClientRelay final : public DnsSdPublisher::Client {
+ public:
+  ClientRelay(TaskRunner* task_runner,
+              WeakPtr<ServiceInstanceProxy> proxy,
+              Client* client,
+              uint64_t generation)
+      : task_runner_(task_runner),
+        proxy_(std::move(proxy)),
+        client_(client),
+        generation_(generation) {}
+  ~ClientRelay() override = default;
+
+  uint64_t generation() const { return generation_; }
+
+  // DnsSdPublisher::Client overrides.
+  void OnEndpointClaimed(
+      const DnsSdInstance& requested_instance,
+      const DnsSdInstanceEndpoint& claimed_endpoint) override {
+    task_runner_->PostTask([proxy = proxy_, client = client_,
+                            generation = generation_, requested_instance,
+                            claimed_endpoint] {
+      if (proxy) {
+        proxy->OnEndpointClaimed(client, generation, requested_instance,
+                                 claimed_endpoint);
+      }
+    });
+  }
+
+ private:
+  TaskRunner* const task_runner_;
+  const WeakPtr<ServiceInstanceProxy> proxy_;
+  Client* const client_;
+  const uint64_t generation_;
+};
+
+// Passed to the ServiceInstance in place of the embedder's ReportingClient.
+class ServiceInstanceProxy::ReportingRelay final : public ReportingClient {
+ public:
+  ReportingRelay(TaskRunner* task_runner,
+                 WeakPtr<ServiceInstanceProxy> proxy,
+                 ReportingClient* reporting_client)
+      : task_runner_(task_runner),
+        proxy_(std::move(proxy)),
+        reporting_client_(reporting_client) {}
+  ~ReportingRelay() override = default;
+
+  // ReportingClient overrides.
+  void OnFatalError(Error error) override {
+    Relay(&ReportingClient::OnFatalError, std::move(error));
+  }
+
+  void OnRecoverableError(Error error) override {
+    Relay(&ReportingClient::OnRecoverableError, std::move(error));
+  }
+
+ private:
+  void Relay(void (ReportingClient::*method)(Error), Error error) {
+    task_runner_->PostTask(
+        [proxy = proxy_, reporting_client = reporting_client_, method,
+         error = std::move(error)]() mutable {
+          if (proxy) {
+            (reporting_client->*method)(std::move(error));
+          }
+        });
+  }
+
+  TaskRunner* const task_runner_;
+  const WeakPtr<ServiceInstanceProxy> proxy_;
+  ReportingClient* const reporting_client_;
+};
+
+ServiceInstanceProxy::ServiceInstanceProxy(TaskRunner* task_runner,
+                                           TaskRunner* instance_task_runner,
+                                           ReportingClient* reporting_client,
+                                           const Config& config,
+                                           const InterfaceInfo& network_info)
+    : ServiceInstanceProxy(
+          task_runner,
+          instance_task_runner,
+          reporting_client,
+          config,
+          [network_info](TaskRunner* task_runner,
+                         ReportingClient* reporting_client,
+                         const Config& config) {
+            return std::make_unique<ServiceInstance>(
+                task_runner, reporting_client, config, network_info);
+          }) {}
+
+ServiceInstanceProxy::ServiceInstanceProxy(TaskRunner* task_runner,
+                                           TaskRunner* instance_task_runner,
+                                           ReportingClient* reporting_client,
+                                           const Config& config,
+                                           ServiceFactory factory)
+    : task_runner_(task_runner),
+      instance_task_runner_(instance_task_runner),
+      reporting_client_(reporting_client),
+      instance_state_(std::make_unique<InstanceState>(config)),
+      publisher_(config.enable_publication ? this : nullptr),
+      querier_(config.enable_querying ? this : nullptr) {
+  OSP_DCHECK(task_runner_);
+  OSP_DCHECK(instance_task_runner_);
+  OSP_DCHECK(reporting_client_);
+  OSP_DCHECK(factory);
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  reporting_relay_ = std::make_unique<ReportingRelay>(
+      task_runner_, weak_factory_.GetWeakPtr(), reporting_client_);
+
+  // The ServiceInstance binds its sockets when created, so it must be created
+  // on the task runner which will handle their traffic. Tasks run in the order
+  // posted, so later calls find it there.
+  InstanceState* const state = instance_state_.get();
+  ReportingClient* const reporting_relay = reporting_relay_.get();
+  instance_task_runner_->PostTask([task_runner = instance_task_runner_, state,
+                                   reporting_relay,
+                                   factory = std::move(factory)] {
+    state->instance = factory(task_runner, reporting_relay, state->config);
+  });
+}
+
+ServiceInstanceProxy::~ServiceInstanceProxy() {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  // The relays may be used until the ServiceInstance is gone. Tasks they post
+  // after this point are dropped.
+  instance_task_runner_->PostTask(
+      [state = std::move(instance_state_),
+       reporting_relay = std::move(reporting_relay_),
+       queries = std::move(queries_),
+       clients = std::move(clients_)]() mutable { state->instance.reset(); });
+}
+
+// DnsSdQuerier overrides.
+void ServiceInstanceProxy::StartQuery(const std::string& service,
+                                      Callback* cb) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+  OSP_DCHECK(cb);
+
+  QueryKey key(service, cb);
+  if (queries_.find(key) != queries_.end()) {
+    return;
+  }
+
+  auto relay = std::make_unique<QueryRelay>(
+      task_runner_, weak_factory_.GetWeakPtr(), key, next_relay_generation_++);
+  DnsSdQuerier::Callback* const relay_ptr = relay.get();
+  queries_.emplace(std::move(key), std::move(relay));
+
+  PostToInstance([service, relay_ptr](DnsSdService* instance) {
+    instance->GetQuerier()->StartQuery(service, relay_ptr);
+  });
+}
+
+void ServiceInstanceProxy::StopQuery(const std::string& service,
+                                     Callback* cb) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  auto it = queries_.find(QueryKey(service, cb));
+  if (it == queries_.end()) {
+    return;
+  }
+
+  PostToInstance(
+      [service, relay = std::move(it->second)](DnsSdService* instance) {
+        instance->GetQuerier()->StopQuery(service, relay.get());
+      });
+  queries_.erase(it);
+}
+
+void ServiceInstanceProxy::ReinitializeQueries(const std::string& service) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  PostToInstance([service](DnsSdService* instance) {
+    instance->GetQuerier()->ReinitializeQueries(service);
+  });
+}
+
+// DnsSdPublisher overrides.
+Error ServiceInstanceProxy::Register(const DnsSdInstance& instance,
+                                     Client* client) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+  OSP_DCHECK(client);
+
+  InstanceKey key(instance);
+  const bool was_added = registrations_.emplace(key, client).second;
+
+  std::unique_ptr<ClientRelay>& relay = clients_[client];
+  if (!relay) {
+    relay = std::make_unique<ClientRelay>(task_runner_,
+                                          weak_factory_.GetWeakPtr(), client,
+                                          next_relay_generation_++);
+  }
+
+  PostToInstance([task_runner = task_runner_,
+                  proxy = weak_factory_.GetWeakPtr(), key = std::move(key),
+                  was_added, instance, relay_ptr = relay.get()](
+                     DnsSdService* service_instance) {
+    Error result =
+        service_instance->GetPublisher()->Register(instance, relay_ptr);
+    if (result.ok()) {
+      return;
+    }
+    task_runner->PostTask([proxy, key, was_added,
+                           result = std::move(result)]() mutable {
+      if (proxy) {
+        proxy->OnRegisterFailed(key, was_added, std::move(result));
+      }
+    });
+  });
+  return Error::None();
+}
+
+Error ServiceInstanceProxy::UpdateRegistration(const DnsSdInstance& instance) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  if (registrations_.find(InstanceKey(instance)) == registrations_.end()) {
+    return Error::Code::kParameterInvalid;
+  }
+
+  ReportingClient* const reporting_relay = reporting_relay_.get();
+  PostToInstance([reporting_relay,
+                  instance](DnsSdService* service_instance) {
+    Error result =
+        service_instance->GetPublisher()->UpdateRegistration(instance);
+    if (!result.ok()) {
+      reporting_relay->OnRecoverableError(std::move(result));
+    }
+  });
+  return Error::None();
+}
+
+ErrorOr<int> ServiceInstanceProxy::DeregisterAll(const std::string& service) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  int removed_count = 0;
+  for (auto it = registrations_.begin(); it != registrations_.end();) {
+    if (it->first.service_id() == service) {
+      it = registrations_.erase(it);
+      ++removed_count;
+    } else {
+      ++it;
+    }
+  }
+
+  // Clients without any remaining registrations are forgotten, but their
+  // relays are only deleted once the ServiceInstance has deregistered them.
+  std::vector<std::unique_ptr<ClientRelay>> unused_relays;
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    const bool is_used =
+        std::any_of(registrations_.begin(), registrations_.end(),
+                    [client = it->first](const auto& entry) {
+                      return entry.second == client;
+                    });
+    if (is_used) {
+      ++it;
+    } else {
+      unused_relays.push_back(std::move(it->second));
+      it = clients_.erase(it);
+    }
+  }
+
+  ReportingClient* const reporting_relay = reporting_relay_.get();
+  PostToInstance([reporting_relay, service,
+                  unused_relays = std::move(unused_relays)](
+                     DnsSdService* instance) {
+    ErrorOr<int> result = instance->GetPublisher()->DeregisterAll(service);
+    if (result.is_error()) {
+      reporting_relay->OnRecoverableError(std::move(result.error()));
+    }
+  });
+  return removed_count;
+}
+
+template <typename Task>
+void ServiceInstanceProxy::PostToInstance(Task task) {
+  instance_task_runner_->PostTask(
+      [state = instance_state_.get(), task = std::move(task)]() mutable {
+        OSP_DCHECK(state->instance);
+        task(state->instance.get());
+      });
+}
+
+void ServiceInstanceProxy::OnEndpointChanged(
+    const QueryKey& key,
+    uint64_t relay_generation,
+    void (Callback::*method)(const DnsSdInstanceEndpoint&),
+    const DnsSdInstanceEndpoint& endpoint) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  auto it = queries_.find(key);
+  if (it == queries_.end() || it->second->generation() != relay_generation) {
+    // The query was stopped after the change was posted.
+    return;
+  }
+  (key.second->*method)(endpoint);
+}
+
+void ServiceInstanceProxy::OnEndpointClaimed(
+    Client* client,
+    uint64_t relay_generation,
+    const DnsSdInstance& requested_instance,
+    const DnsSdInstanceEndpoint& claimed_endpoint) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  auto it = clients_.find(client);
+  if (it == clients_.end() || it->second->generation() != relay_generation) {
+    // The client was deregistered after the claim was posted.
+    return;
+  }
+  client->OnEndpointClaimed(requested_instance, claimed_endpoint);
+}
+
+void ServiceInstanceProxy::OnRegisterFailed(const InstanceKey& key,
+                                            bool was_added,
+                                            Error error) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  if (was_added) {
+    registrations_.erase(key);
+  }
+  reporting_client_->OnRecoverableError(std::move(error));
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,165 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_DNSSD_IMPL_SERVICE_INSTANCE_PROXY_H_
+#define DISCOVERY_DNSSD_IMPL_SERVICE_INSTANCE_PROXY_H_
+
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "discovery/common/config.h"
+#include "discovery/common/reporting_client.h"
+#include "discovery/dnssd/impl/instance_key.h"
+#include "discovery/dnssd/public/dns_sd_publisher.h"
+#include "discovery/dnssd/public/dns_sd_querier.h"
+#include "discovery/dnssd/public/dns_sd_service.h"
+#include "platform/base/interface_info.h"
+#include "util/weak_ptr.h"
+
+namespace openscreen {
+
+class TaskRunner;
+
+namespace discovery {
+
+// Runs the ServiceInstance for one network interface on its own TaskRunner, so
+// that mDNS traffic on that interface doesn't delay the handling of traffic on
+// any other.
+//
+// This class is called on |task_runner|, and posts each call to the
+// ServiceInstance on |instance_task_runner| without waiting for it. Callback
+// and Client calls, and errors reported by the instance, are posted back to
+// |task_runner|.
+//
+// Since publisher calls don't wait for the instance, they return before the
+// instance has handled them: any error it returns is reported to
+// |reporting_client| as a recoverable error instead. This class keeps track of
+// the instances registered through it, so that UpdateRegistration() can reject
+// unknown instances, and DeregisterAll() can return the number of instances
+// deregistered, right away.
+class ServiceInstanceProxy final : public DnsSdService,
+                                   public DnsSdQuerier,
+                                   public DnsSdPublisher {
+ public:
+  // Creates the service to which calls are forwarded. Called on the task
+  // runner passed to it, with a Config which outlives the service.
+  using ServiceFactory = std::function<std::unique_ptr<DnsSdService>(
+      TaskRunner* task_runner,
+      ReportingClient* reporting_client,
+      const Config& config)>;
+
+  // |task_runner|, |instance_task_runner|, and |reporting_client| must outlive
+  // this instance.
+  ServiceInstanceProxy(TaskRunner* task_runner,
+                       TaskRunner* instance_task_runner,
+                       ReportingClient* reporting_client,
+                       const Config& config,
+                       const InterfaceInfo& network_info);
+
+  // As above, but forwards calls to the service created by |factory| rather
+  // than to a ServiceInstance.
+  ServiceInstanceProxy(TaskRunner* task_runner,
+                       TaskRunner* instance_task_runner,
+                       ReportingClient* reporting_client,
+                       const Config& config,
+                       ServiceFactory factory);
+  ServiceInstanceProxy(const ServiceInstanceProxy& other) = delete;
+  ServiceInstanceProxy(ServiceInstanceProxy&& other) noexcept = delete;
+  ~ServiceInstanceProxy() override;
+
+  ServiceInstanceProxy& operator=(const ServiceInstanceProxy& other) = delete;
+  ServiceInstanceProxy& operator=(ServiceInstanceProxy&& other) = delete;
+
+  // DnsSdService overrides.
+  DnsSdQuerier* GetQuerier() override { return querier_; }
+  DnsSdPublisher* GetPublisher() override { return publisher_; }
+
+ private:
+  // A query, as started by StartQuery().
+  using QueryKey = std::pair<std::string, Callback*>;
+
+  class QueryRelay;
+  class ClientRelay;
+  class ReportingRelay;
+
+  // The service calls are forwarded to, with the Config it refers to.  Only
+  // used on |instance_task_runner_|, which creates and deletes the service.
+  struct InstanceState {
+    explicit InstanceState(const Config& config) : config(config) {}
+
+    const Config config;
+    std::unique_ptr<DnsSdService> instance;
+  };
+
+  // DnsSdQuerier overrides.
+  void StartQuery(const std::string& service, Callback* cb) override;
+  void StopQuery(const std::string& service, Callback* cb) override;
+  void ReinitializeQueries(const std::string& service) override;
+
+  // DnsSdPublisher overrides.
+  Error Register(const DnsSdInstance& instance, Client* client) override;
+  Error UpdateRegistration(const DnsSdInstance& instance) override;
+  ErrorOr<int> DeregisterAll(const std::string& service) override;
+
+  // Posts |task|, which takes the service, to |instance_task_runner_|.
+  template <typename Task>
+  void PostToInstance(Task task);
+
+  // Calls |method| on the callback for |key| with |endpoint|, unless the query
+  // was stopped since the relay of generation |relay_generation| posted the
+  // call.
+  void OnEndpointChanged(const QueryKey& key,
+                         uint64_t relay_generation,
+                         void (Callback::*method)(const DnsSdInstanceEndpoint&),
+                         const DnsSdInstanceEndpoint& endpoint);
+
+  // Tells |client| that its instance was claimed, unless it was deregistered
+  // since the relay of generation |relay_generation| posted the call.
+  void OnEndpointClaimed(Client* client,
+                         uint64_t relay_generation,
+                         const DnsSdInstance& requested_instance,
+                         const DnsSdInstanceEndpoint& claimed_endpoint);
+
+  // Reports that the ServiceInstance failed to register |key|, which is
+  // forgotten if |was_added| by that Register() call.
+  void OnRegisterFailed(const InstanceKey& key, bool was_added, Error error);
+
+  TaskRunner* const task_runner_;
+  TaskRunner* const instance_task_runner_;
+  ReportingClient* const reporting_client_;
+
+  // Deleted on |instance_task_runner_|, followed by the relays below.
+  std::unique_ptr<InstanceState> instance_state_;
+  std::unique_ptr<ReportingRelay> reporting_relay_;
+
+  // The relays passed to the ServiceInstance in place of each active query's
+  // Callback and each registered Client.
+  std::map<QueryKey, std::unique_ptr<QueryRelay>> queries_;
+  std::map<Client*, std::unique_ptr<ClientRelay>> clients_;
+
+  // The Client of each instance registered, and not since deregistered.
+  std::map<InstanceKey, Client*> registrations_;
+
+  // The generation given to the next relay created.  Calls a relay posts carry
+  // its generation rather than its address, since a new relay may be allocated
+  // where a deleted one was.
+  uint64_t next_relay_generation_ = 0;
+
+  // Pointers either to this instance or to nullptr depending whether the below
+  // types are supported.
+  DnsSdPublisher* const publisher_;
+  DnsSdQuerier* const querier_;
+
+  WeakPtrFactory<ServiceInstanceProxy> weak_factory_{this};
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_DNSSD_IMPL_SERVICE_INSTANCE_PROXY_H_
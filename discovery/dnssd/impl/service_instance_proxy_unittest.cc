@@ -0,0 +1,394 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/dnssd/impl/service_instance_proxy.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "discovery/common/config.h"
+#include "discovery/common/testing/mock_reporting_client.h"
+#include "discovery/dnssd/public/dns_sd_instance.h"
+#include "discovery/dnssd/public/dns_sd_instance_endpoint.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+using testing::StrictMock;
+
+class MockClient : public DnsSdPublisher::Client {
+ public:
+  MOCK_METHOD2(OnEndpointClaimed,
+               void(const DnsSdInstance&, const DnsSdInstanceEndpoint&));
+};
+
+class MockCallback : public DnsSdQuerier::Callback {
+ public:
+  MOCK_METHOD1(OnEndpointCreated, void(const DnsSdInstanceEndpoint&));
+  MOCK_METHOD1(OnEndpointUpdated, void(const DnsSdInstanceEndpoint&));
+  MOCK_METHOD1(OnEndpointDeleted, void(const DnsSdInstanceEndpoint&));
+};
+
+class MockQuerier : public DnsSdQuerier {
+ public:
+  MOCK_METHOD2(StartQuery, void(const std::string&, Callback*));
+  MOCK_METHOD2(StopQuery, void(const std::string&, Callback*));
+  MOCK_METHOD1(ReinitializeQueries, void(const std::string&));
+};
+
+class MockPublisher : public DnsSdPublisher {
+ public:
+  MOCK_METHOD2(Register, Error(const DnsSdInstance&, Client*));
+  MOCK_METHOD1(UpdateRegistration, Error(const DnsSdInstance&));
+  MOCK_METHOD1(DeregisterAll, ErrorOr<int>(const std::string&));
+};
+
+// Stands in for the ServiceInstance of one interface.
+class FakeService : public DnsSdService {
+ public:
+  explicit FakeService(TaskRunner* task_runner) : task_runner_(task_runner) {}
+  ~FakeService() override = default;
+
+  TaskRunner* task_runner() const { return task_runner_; }
+  StrictMock<MockQuerier>* querier() { return &querier_; }
+  StrictMock<MockPublisher>* publisher() { return &publisher_; }
+
+  // DnsSdService overrides.
+  DnsSdQuerier* GetQuerier() override { return &querier_; }
+  DnsSdPublisher* GetPublisher() override { return &publisher_; }
+
+ private:
+  TaskRunner* const task_runner_;
+  StrictMock<MockQuerier> querier_;
+  StrictMock<MockPublisher> publisher_;
+};
+
+const DnsSdInstance kInstance("instance", "_service._udp", "domain", {}, 80);
+const DnsSdInstance kInstance2("instance2", "_service._udp", "domain", {}, 80);
+const DnsSdInstance kOtherInstance("instance", "_other._udp", "domain", {}, 80);
+const DnsSdInstanceEndpoint kEndpoint(kInstance,
+                                      NetworkInterfaceIndex{1},
+                                      IPEndpoint{{192, 168, 0, 1}, 80});
+const DnsSdInstanceEndpoint kEndpoint2(kInstance2,
+                                       NetworkInterfaceIndex{1},
+                                       IPEndpoint{{192, 168, 0, 2}, 80});
+
+class ServiceInstanceProxyTest : public testing::Test {
+ public:
+  ServiceInstanceProxyTest() {
+    proxy_ = CreateProxy(&instance_task_runner_, &service_);
+    proxy2_ = CreateProxy(&instance_task_runner2_, &service2_);
+  }
+
+  ~ServiceInstanceProxyTest() override {
+    proxy_.reset();
+    proxy2_.reset();
+    RunTasksUntilIdle();
+  }
+
+ protected:
+  // Creates a proxy forwarding calls to a FakeService on |instance_task_runner|
+  // once the task creating it has run, and sets |service| to that service.
+  std::unique_ptr<ServiceInstanceProxy> CreateProxy(
+      FakeTaskRunner* instance_task_runner,
+      FakeService** service) {
+    return std::make_unique<ServiceInstanceProxy>(
+        &task_runner_, instance_task_runner, &reporting_client_, config_,
+        [service](TaskRunner* task_runner, ReportingClient* reporting_client,
+                  const Config& config) {
+          auto fake_service = std::make_unique<FakeService>(task_runner);
+          *service = fake_service.get();
+          return fake_service;
+        });
+  }
+
+  // Runs the tasks creating the services.
+  void CreateServices() {
+    instance_task_runner_.RunTasksUntilIdle();
+    instance_task_runner2_.RunTasksUntilIdle();
+    ASSERT_NE(service_, nullptr);
+    ASSERT_NE(service2_, nullptr);
+  }
+
+  void RunTasksUntilIdle() {
+    while (task_runner_.ready_task_count() > 0 ||
+           instance_task_runner_.ready_task_count() > 0 ||
+           instance_task_runner2_.ready_task_count() > 0) {
+      instance_task_runner_.RunTasksUntilIdle();
+      instance_task_runner2_.RunTasksUntilIdle();
+      task_runner_.RunTasksUntilIdle();
+    }
+  }
+
+  // Expects |instance| to be registered with |service|, and sets |relay| to the
+  // Client passed in place of the caller's.
+  void ExpectRegister(FakeService* service,
+                      const DnsSdInstance& instance,
+                      DnsSdPublisher::Client** relay) {
+    EXPECT_CALL(*service->publisher(), Register(instance, _))
+        .WillOnce(Invoke([relay](const DnsSdInstance& instance,
+                                 DnsSdPublisher::Client* client) {
+          *relay = client;
+          return Error::None();
+        }));
+  }
+
+  // Expects a query for |service| to be started on |service_instance|, and sets
+  // |relay| to the Callback passed in place of the caller's.
+  void ExpectStartQuery(FakeService* service_instance,
+                        const std::string& service,
+                        DnsSdQuerier::Callback** relay) {
+    EXPECT_CALL(*service_instance->querier(), StartQuery(service, _))
+        .WillOnce(Invoke(
+            [relay](const std::string& service, DnsSdQuerier::Callback* cb) {
+              *relay = cb;
+            }));
+  }
+
+  FakeClock clock_{Clock::now()};
+  FakeTaskRunner task_runner_{&clock_};
+  FakeTaskRunner instance_task_runner_{&clock_};
+  FakeTaskRunner instance_task_runner2_{&clock_};
+  StrictMock<MockReportingClient> reporting_client_;
+  Config config_;
+
+  FakeService* service_ = nullptr;
+  FakeService* service2_ = nullptr;
+  std::unique_ptr<ServiceInstanceProxy> proxy_;
+  std::unique_ptr<ServiceInstanceProxy> proxy2_;
+};
+
+}  // namespace
+
+TEST_F(ServiceInstanceProxyTest, CreatesServiceOnInstanceTaskRunner) {
+  ASSERT_NE(proxy_->GetQuerier(), nullptr);
+  ASSERT_NE(proxy_->GetPublisher(), nullptr);
+  EXPECT_EQ(service_, nullptr);
+
+  instance_task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(service_, nullptr);
+  EXPECT_EQ(service_->task_runner(), &instance_task_runner_);
+  EXPECT_EQ(service2_, nullptr);
+}
+
+TEST_F(ServiceInstanceProxyTest, RegistersWithoutWaiting) {
+  CreateServices();
+  StrictMock<MockClient> client;
+  DnsSdPublisher::Client* relay = nullptr;
+  ExpectRegister(service_, kInstance, &relay);
+
+  EXPECT_TRUE(proxy_->GetPublisher()->Register(kInstance, &client).ok());
+  EXPECT_EQ(relay, nullptr);
+  instance_task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(relay, nullptr);
+  EXPECT_NE(relay, &client);
+
+  // Claims are relayed back to the client on the caller's task runner.
+  const DnsSdInstanceEndpoint endpoint(kInstance2, NetworkInterfaceIndex{1},
+                                       IPEndpoint{{192, 168, 0, 1}, 80});
+  relay->OnEndpointClaimed(kInstance, endpoint);
+  EXPECT_CALL(client, OnEndpointClaimed(kInstance, endpoint));
+  task_runner_.RunTasksUntilIdle();
+}
+
+TEST_F(ServiceInstanceProxyTest, RunsOnTheCallersTaskRunner) {
+  FakeService* service = nullptr;
+  auto proxy = CreateProxy(&task_runner_, &service);
+  task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(service, nullptr);
+
+  // Nothing waits for the posted calls, so they run once the caller returns.
+  StrictMock<MockClient> client;
+  DnsSdPublisher::Client* relay = nullptr;
+  ExpectRegister(service, kInstance, &relay);
+  EXPECT_TRUE(proxy->GetPublisher()->Register(kInstance, &client).ok());
+  EXPECT_EQ(relay, nullptr);
+  task_runner_.RunTasksUntilIdle();
+  EXPECT_NE(relay, nullptr);
+
+  EXPECT_CALL(*service->publisher(), UpdateRegistration(kInstance))
+      .WillOnce(Return(Error::None()));
+  EXPECT_TRUE(proxy->GetPublisher()->UpdateRegistration(kInstance).ok());
+  task_runner_.RunTasksUntilIdle();
+
+  proxy.reset();
+  task_runner_.RunTasksUntilIdle();
+}
+
+TEST_F(ServiceInstanceProxyTest, ReportsRegistrationErrorsAsynchronously) {
+  CreateServices();
+  StrictMock<MockClient> client;
+  EXPECT_CALL(*service_->publisher(), Register(kInstance, _))
+      .WillOnce(Return(Error::Code::kItemAlreadyExists));
+
+  EXPECT_TRUE(proxy_->GetPublisher()->Register(kInstance, &client).ok());
+  EXPECT_CALL(reporting_client_, OnRecoverableError(_))
+      .WillOnce(Invoke([](Error error) {
+        EXPECT_EQ(error.code(), Error::Code::kItemAlreadyExists);
+      }));
+  RunTasksUntilIdle();
+
+  // The failed registration is forgotten.
+  EXPECT_EQ(proxy_->GetPublisher()->UpdateRegistration(kInstance),
+            Error::Code::kParameterInvalid);
+  EXPECT_EQ(instance_task_runner_.ready_task_count(), 0);
+}
+
+TEST_F(ServiceInstanceProxyTest, UpdatesOnlyRegisteredInstances) {
+  CreateServices();
+  EXPECT_EQ(proxy_->GetPublisher()->UpdateRegistration(kInstance),
+            Error::Code::kParameterInvalid);
+  EXPECT_EQ(instance_task_runner_.ready_task_count(), 0);
+
+  StrictMock<MockClient> client;
+  DnsSdPublisher::Client* relay = nullptr;
+  ExpectRegister(service_, kInstance, &relay);
+  EXPECT_TRUE(proxy_->GetPublisher()->Register(kInstance, &client).ok());
+
+  // Only the interface on which the instance is registered accepts updates.
+  EXPECT_TRUE(proxy_->GetPublisher()->UpdateRegistration(kInstance).ok());
+  EXPECT_EQ(proxy2_->GetPublisher()->UpdateRegistration(kInstance),
+            Error::Code::kParameterInvalid);
+
+  EXPECT_CALL(*service_->publisher(), UpdateRegistration(kInstance))
+      .WillOnce(Return(Error::Code::kParameterInvalid));
+  EXPECT_CALL(reporting_client_, OnRecoverableError(_));
+  RunTasksUntilIdle();
+}
+
+TEST_F(ServiceInstanceProxyTest, DeregistersAllAcrossInterfaces) {
+  CreateServices();
+  StrictMock<MockClient> client;
+  StrictMock<MockClient> other_client;
+  DnsSdPublisher::Client* relay = nullptr;
+  DnsSdPublisher::Client* relay2 = nullptr;
+  DnsSdPublisher::Client* other_relay = nullptr;
+  DnsSdPublisher::Client* unused_relay = nullptr;
+  ExpectRegister(service_, kInstance, &relay);
+  ExpectRegister(service_, kInstance2, &unused_relay);
+  ExpectRegister(service_, kOtherInstance, &other_relay);
+  ExpectRegister(service2_, kInstance, &relay2);
+  ExpectRegister(service2_, kInstance2, &unused_relay);
+  for (ServiceInstanceProxy* proxy : {proxy_.get(), proxy2_.get()}) {
+    EXPECT_TRUE(proxy->GetPublisher()->Register(kInstance, &client).ok());
+    EXPECT_TRUE(proxy->GetPublisher()->Register(kInstance2, &client).ok());
+  }
+  EXPECT_TRUE(
+      proxy_->GetPublisher()->Register(kOtherInstance, &other_client).ok());
+  RunTasksUntilIdle();
+
+  // The counts are known without waiting for either interface.
+  EXPECT_EQ(proxy_->GetPublisher()->DeregisterAll("_service._udp").value(), 2);
+  EXPECT_EQ(proxy2_->GetPublisher()->DeregisterAll("_service._udp").value(), 2);
+  EXPECT_EQ(proxy2_->GetPublisher()->DeregisterAll("_service._udp").value(), 0);
+  EXPECT_EQ(proxy_->GetPublisher()->UpdateRegistration(kInstance),
+            Error::Code::kParameterInvalid);
+  EXPECT_TRUE(proxy_->GetPublisher()->UpdateRegistration(kOtherInstance).ok());
+
+  // Claims made before the services handle the calls are only relayed to
+  // clients with remaining registrations.
+  const DnsSdInstanceEndpoint endpoint(kInstance, NetworkInterfaceIndex{1},
+                                       IPEndpoint{{192, 168, 0, 1}, 80});
+  const DnsSdInstanceEndpoint other_endpoint(
+      kOtherInstance, NetworkInterfaceIndex{1},
+      IPEndpoint{{192, 168, 0, 1}, 80});
+  relay->OnEndpointClaimed(kInstance, endpoint);
+  relay2->OnEndpointClaimed(kInstance, endpoint);
+  other_relay->OnEndpointClaimed(kOtherInstance, other_endpoint);
+
+  EXPECT_CALL(*service_->publisher(), DeregisterAll("_service._udp"))
+      .WillOnce(Return(2));
+  EXPECT_CALL(*service_->publisher(), UpdateRegistration(kOtherInstance))
+      .WillOnce(Return(Error::None()));
+  EXPECT_CALL(*service2_->publisher(), DeregisterAll("_service._udp"))
+      .WillOnce(Return(2))
+      .WillOnce(Return(0));
+  EXPECT_CALL(other_client, OnEndpointClaimed(kOtherInstance, other_endpoint));
+  RunTasksUntilIdle();
+}
+
+TEST_F(ServiceInstanceProxyTest, RelaysEndpointsOnTheCallersTaskRunner) {
+  CreateServices();
+  StrictMock<MockCallback> callback;
+  DnsSdQuerier::Callback* relay = nullptr;
+  ExpectStartQuery(service_, "_service._udp", &relay);
+  proxy_->GetQuerier()->StartQuery("_service._udp", &callback);
+  EXPECT_EQ(relay, nullptr);
+  instance_task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(relay, nullptr);
+  EXPECT_NE(relay, &callback);
+
+  // Changes seen by the service are only passed to the callback once the
+  // caller's task runner runs.
+  instance_task_runner_.PostTask([relay] {
+    relay->OnEndpointCreated(kEndpoint);
+    relay->OnEndpointUpdated(kEndpoint);
+    relay->OnEndpointDeleted(kEndpoint);
+  });
+  instance_task_runner_.RunTasksUntilIdle();
+  instance_task_runner2_.RunTasksUntilIdle();
+  EXPECT_EQ(task_runner_.ready_task_count(), 3);
+
+  testing::InSequence sequence;
+  EXPECT_CALL(callback, OnEndpointCreated(kEndpoint));
+  EXPECT_CALL(callback, OnEndpointUpdated(kEndpoint));
+  EXPECT_CALL(callback, OnEndpointDeleted(kEndpoint));
+  task_runner_.RunTasksUntilIdle();
+}
+
+TEST_F(ServiceInstanceProxyTest, StopQueryDropsPendingEndpoints) {
+  CreateServices();
+  StrictMock<MockCallback> callback;
+  DnsSdQuerier::Callback* relay = nullptr;
+  ExpectStartQuery(service_, "_service._udp", &relay);
+  proxy_->GetQuerier()->StartQuery("_service._udp", &callback);
+  instance_task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(relay, nullptr);
+
+  relay->OnEndpointCreated(kEndpoint);
+  proxy_->GetQuerier()->StopQuery("_service._udp", &callback);
+  EXPECT_CALL(*service_->querier(), StopQuery("_service._udp", relay));
+  RunTasksUntilIdle();
+}
+
+TEST_F(ServiceInstanceProxyTest, RestartedQueryDropsOldEndpoints) {
+  CreateServices();
+  StrictMock<MockCallback> callback;
+  DnsSdQuerier::Callback* old_relay = nullptr;
+  ExpectStartQuery(service_, "_service._udp", &old_relay);
+  proxy_->GetQuerier()->StartQuery("_service._udp", &callback);
+  instance_task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(old_relay, nullptr);
+
+  // The old relay is deleted once the service stops its query, so the new
+  // relay may be allocated at the same address.
+  old_relay->OnEndpointCreated(kEndpoint);
+  proxy_->GetQuerier()->StopQuery("_service._udp", &callback);
+  EXPECT_CALL(*service_->querier(), StopQuery("_service._udp", old_relay));
+  instance_task_runner_.RunTasksUntilIdle();
+
+  DnsSdQuerier::Callback* new_relay = nullptr;
+  ExpectStartQuery(service_, "_service._udp", &new_relay);
+  proxy_->GetQuerier()->StartQuery("_service._udp", &callback);
+  instance_task_runner_.RunTasksUntilIdle();
+  ASSERT_NE(new_relay, nullptr);
+
+  // Only the change relayed for the new query reaches the callback.
+  new_relay->OnEndpointCreated(kEndpoint2);
+  EXPECT_EQ(task_runner_.ready_task_count(), 2);
+  EXPECT_CALL(callback, OnEndpointCreated(kEndpoint2));
+  task_runner_.RunTasksUntilIdle();
+}
+
+}  // namespace discovery
+}  // namespace openscreen
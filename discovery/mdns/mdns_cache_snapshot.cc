@@ -0,0 +1,138 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_cache_snapshot.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "discovery/common/config.h"
+#include "discovery/mdns/mdns_reader.h"
+#include "discovery/mdns/mdns_writer.h"
+#include "util/big_endian.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+constexpr uint8_t kMagic[] = {'O', 'S', 'M', 'C'};
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + sizeof(kVersion) +
+                               sizeof(uint64_t);
+
+}  // namespace
+
+std::vector<uint8_t> WriteMdnsCacheSnapshot(
+    const std::vector<MdnsRecord>& records,
+    std::chrono::seconds wall_time) {
+  MdnsMessage message(0, MessageType::Response);
+  for (const MdnsRecord& record : records) {
+    if (record.dns_type() != DnsType::kNSEC) {
+      message.AddAnswer(record);
+    }
+  }
+
+  std::vector<uint8_t> snapshot(kHeaderSize + message.MaxWireSize());
+  BigEndianWriter header(snapshot.data(), kHeaderSize);
+  const bool header_written =
+      header.Write(kMagic, sizeof(kMagic)) && header.Write<uint8_t>(kVersion) &&
+      header.Write<uint64_t>(static_cast<uint64_t>(wall_time.count()));
+  OSP_DCHECK(header_written);
+
+  MdnsWriter writer(snapshot.data() + kHeaderSize,
+                    snapshot.size() - kHeaderSize);
+  const bool message_written = writer.Write(message);
+  OSP_DCHECK(message_written);
+  snapshot.resize(kHeaderSize + writer.offset());
+  return snapshot;
+}
+
+ErrorOr<std::vector<MdnsRecord>> ReadMdnsCacheSnapshot(
+    const Config& config,
+    absl::Span<const uint8_t> snapshot,
+    std::chrono::seconds wall_time) {
+  BigEndianReader header(snapshot.data(), snapshot.size());
+  uint8_t magic[sizeof(kMagic)];
+  uint8_t version;
+  uint64_t written_time;
+  if (!header.Read(sizeof(magic), magic) ||
+      !std::equal(magic, magic + sizeof(magic), kMagic) ||
+      !header.Read<uint8_t>(&version) || version != kVersion ||
+      !header.Read<uint64_t>(&written_time)) {
+    return Error(Error::Code::kParseError, "Invalid mDNS cache snapshot");
+  }
+
+  MdnsReader reader(config, snapshot.data() + kHeaderSize,
+                    snapshot.size() - kHeaderSize);
+  ErrorOr<MdnsMessage> message = reader.Read();
+  if (message.is_error()) {
+    return std::move(message.error());
+  }
+
+  // A wall clock which has gone backwards since the snapshot was taken is
+  // treated as no time having passed.
+  std::chrono::seconds elapsed(0);
+  if (wall_time.count() > 0 &&
+      static_cast<uint64_t>(wall_time.count()) > written_time) {
+    elapsed = wall_time - std::chrono::seconds(written_time);
+  }
+
+  std::vector<MdnsRecord> records;
+  for (const MdnsRecord& record : message.value().answers()) {
+    if (record.dns_type() == DnsType::kNSEC || record.ttl() <= elapsed) {
+      continue;
+    }
+    records.emplace_back(record.name(), record.dns_type(), record.dns_class(),
+                         record.record_type(), record.ttl() - elapsed,
+                         record.rdata());
+  }
+  return records;
+}
+
+Error SaveMdnsCacheSnapshot(const std::string& path,
+                            const std::vector<uint8_t>& snapshot) {
+  const std::string temporary_path = path + ".tmp";
+  FILE* file = fopen(temporary_path.c_str(), "wb");
+  if (file == nullptr) {
+    return Error(Error::Code::kIOFailure, "Unable to open " + temporary_path);
+  }
+  const bool written =
+      fwrite(snapshot.data(), 1, snapshot.size(), file) == snapshot.size();
+  const bool closed = fclose(file) == 0;
+  if (!written || !closed) {
+    remove(temporary_path.c_str());
+    return Error(Error::Code::kIOFailure, "Unable to write " + temporary_path);
+  }
+  if (rename(temporary_path.c_str(), path.c_str()) != 0) {
+    remove(temporary_path.c_str());
+    return Error(Error::Code::kIOFailure, "Unable to replace " + path);
+  }
+  return Error::None();
+}
+
+ErrorOr<std::vector<uint8_t>> LoadMdnsCacheSnapshot(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return Error(Error::Code::kFileLoadFailure, "Unable to open " + path);
+  }
+
+  std::vector<uint8_t> snapshot;
+  uint8_t buffer[4096];
+  size_t bytes_read;
+  while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    snapshot.insert(snapshot.end(), buffer, buffer + bytes_read);
+  }
+  const bool failed = ferror(file) != 0;
+  fclose(file);
+  if (failed) {
+    return Error(Error::Code::kFileLoadFailure, "Unable to read " + path);
+  }
+  return snapshot;
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,61 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_MDNS_CACHE_SNAPSHOT_H_
+#define DISCOVERY_MDNS_MDNS_CACHE_SNAPSHOT_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "discovery/mdns/mdns_records.h"
+#include "platform/base/error.h"
+
+namespace openscreen {
+namespace discovery {
+
+struct Config;
+
+// A cache snapshot holds the records cached by an MdnsQuerier, so that they
+// can be restored when the querier is next created.  The format is:
+//
+//   4 bytes: "OSMC"
+//   1 byte:  format version (1)
+//   8 bytes: big-endian seconds since the UNIX epoch when it was written
+//   the rest: an mDNS response message holding the records as answers, with
+//             TTLs counting from the time above
+//
+// Reusing the mDNS wire format keeps snapshots compact, since domain names are
+// compressed, and lets them be parsed with the same reader and checks as
+// records received from the network.
+
+// Serializes |records| to a snapshot taken at |wall_time|.  Negative response
+// (NSEC) records are skipped.
+std::vector<uint8_t> WriteMdnsCacheSnapshot(
+    const std::vector<MdnsRecord>& records,
+    std::chrono::seconds wall_time);
+
+// Parses a snapshot, returning its records with their TTLs reduced by the time
+// since it was written at |wall_time|.  Records which have expired since then
+// are dropped.
+ErrorOr<std::vector<MdnsRecord>> ReadMdnsCacheSnapshot(
+    const Config& config,
+    absl::Span<const uint8_t> snapshot,
+    std::chrono::seconds wall_time);
+
+// Writes |snapshot| to the file at |path|, replacing it atomically so that a
+// partially written snapshot is never read back.
+Error SaveMdnsCacheSnapshot(const std::string& path,
+                            const std::vector<uint8_t>& snapshot);
+
+// Reads the snapshot stored in the file at |path|.
+ErrorOr<std::vector<uint8_t>> LoadMdnsCacheSnapshot(const std::string& path);
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_MDNS_CACHE_SNAPSHOT_H_
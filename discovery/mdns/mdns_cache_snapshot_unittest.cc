@@ -0,0 +1,129 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_cache_snapshot.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "discovery/common/config.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+constexpr std::chrono::seconds kWallTime(1600000000);
+
+MdnsRecord CreateARecord(std::chrono::seconds ttl) {
+  return MdnsRecord(DomainName{"testing", "local"}, DnsType::kA, DnsClass::kIN,
+                    RecordType::kUnique, ttl,
+                    ARecordRdata(IPAddress{172, 0, 0, 1}));
+}
+
+MdnsRecord CreatePtrRecord(std::chrono::seconds ttl) {
+  return MdnsRecord(DomainName{"_service", "_udp", "local"}, DnsType::kPTR,
+                    DnsClass::kIN, RecordType::kShared, ttl,
+                    PtrRecordRdata(DomainName{"instance", "_service", "_udp",
+                                              "local"}));
+}
+
+}  // namespace
+
+TEST(MdnsCacheSnapshotTest, RoundTripsRecords) {
+  const std::vector<MdnsRecord> records = {
+      CreateARecord(std::chrono::seconds(120)),
+      CreatePtrRecord(std::chrono::seconds(4500))};
+
+  const std::vector<uint8_t> snapshot =
+      WriteMdnsCacheSnapshot(records, kWallTime);
+  ErrorOr<std::vector<MdnsRecord>> result =
+      ReadMdnsCacheSnapshot(Config{}, snapshot, kWallTime);
+  ASSERT_TRUE(result.is_value());
+  EXPECT_EQ(result.value(), records);
+}
+
+TEST(MdnsCacheSnapshotTest, ReducesTtlsByElapsedTime) {
+  const std::vector<MdnsRecord> records = {
+      CreateARecord(std::chrono::seconds(120)),
+      CreatePtrRecord(std::chrono::seconds(4500))};
+  const std::vector<uint8_t> snapshot =
+      WriteMdnsCacheSnapshot(records, kWallTime);
+
+  ErrorOr<std::vector<MdnsRecord>> result = ReadMdnsCacheSnapshot(
+      Config{}, snapshot, kWallTime + std::chrono::seconds(100));
+  ASSERT_TRUE(result.is_value());
+  ASSERT_EQ(result.value().size(), 2u);
+  EXPECT_EQ(result.value()[0].ttl(), std::chrono::seconds(20));
+  EXPECT_EQ(result.value()[1].ttl(), std::chrono::seconds(4400));
+
+  result = ReadMdnsCacheSnapshot(Config{}, snapshot,
+                                 kWallTime + std::chrono::seconds(120));
+  ASSERT_TRUE(result.is_value());
+  ASSERT_EQ(result.value().size(), 1u);
+  EXPECT_EQ(result.value()[0].dns_type(), DnsType::kPTR);
+
+  // A clock which has gone backwards leaves the TTLs unchanged.
+  result = ReadMdnsCacheSnapshot(Config{}, snapshot,
+                                 kWallTime - std::chrono::seconds(100));
+  ASSERT_TRUE(result.is_value());
+  EXPECT_EQ(result.value(), records);
+}
+
+TEST(MdnsCacheSnapshotTest, SkipsNegativeResponses) {
+  const MdnsRecord nsec(DomainName{"testing", "local"}, DnsType::kNSEC,
+                        DnsClass::kIN, RecordType::kUnique,
+                        std::chrono::seconds(120),
+                        NsecRecordRdata(DomainName{"testing", "local"},
+                                        DnsType::kAAAA));
+  const std::vector<uint8_t> snapshot = WriteMdnsCacheSnapshot(
+      {CreateARecord(std::chrono::seconds(120)), nsec}, kWallTime);
+
+  ErrorOr<std::vector<MdnsRecord>> result =
+      ReadMdnsCacheSnapshot(Config{}, snapshot, kWallTime);
+  ASSERT_TRUE(result.is_value());
+  ASSERT_EQ(result.value().size(), 1u);
+  EXPECT_EQ(result.value()[0].dns_type(), DnsType::kA);
+}
+
+TEST(MdnsCacheSnapshotTest, RejectsInvalidSnapshots) {
+  std::vector<uint8_t> snapshot = WriteMdnsCacheSnapshot(
+      {CreateARecord(std::chrono::seconds(120))}, kWallTime);
+
+  std::vector<uint8_t> bad_magic = snapshot;
+  bad_magic[0] = 'X';
+  EXPECT_TRUE(ReadMdnsCacheSnapshot(Config{}, bad_magic, kWallTime).is_error());
+
+  std::vector<uint8_t> bad_version = snapshot;
+  bad_version[4] = 2;
+  EXPECT_TRUE(
+      ReadMdnsCacheSnapshot(Config{}, bad_version, kWallTime).is_error());
+
+  std::vector<uint8_t> truncated = snapshot;
+  truncated.resize(snapshot.size() - 2);
+  EXPECT_TRUE(ReadMdnsCacheSnapshot(Config{}, truncated, kWallTime).is_error());
+
+  EXPECT_TRUE(ReadMdnsCacheSnapshot(Config{}, {}, kWallTime).is_error());
+}
+
+TEST(MdnsCacheSnapshotTest, SavesAndLoadsFiles) {
+  const std::string path =
+      ::testing::TempDir() + "mdns_cache_snapshot_unittest";
+  const std::vector<uint8_t> snapshot = WriteMdnsCacheSnapshot(
+      {CreateARecord(std::chrono::seconds(120))}, kWallTime);
+
+  ASSERT_TRUE(SaveMdnsCacheSnapshot(path, snapshot).ok());
+  ErrorOr<std::vector<uint8_t>> loaded = LoadMdnsCacheSnapshot(path);
+  ASSERT_TRUE(loaded.is_value());
+  EXPECT_EQ(loaded.value(), snapshot);
+
+  remove(path.c_str());
+  EXPECT_EQ(LoadMdnsCacheSnapshot(path).error().code(),
+            Error::Code::kFileLoadFailure);
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,127 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_encoded_record.h"
+
+#include <string>
+#include <utility>
+
+#include "discovery/mdns/mdns_writer.h"
+#include "util/big_endian.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+// Writes |name| without compression, and records where it was written.
+bool WriteName(const DomainName& name,
+               MdnsWriter* writer,
+               std::vector<MdnsEncodedRecord::Name>* names) {
+  if (name.empty()) {
+    return false;
+  }
+
+  const size_t offset = writer->offset();
+  for (const std::string& label : name.labels()) {
+    if (!writer->Write(MakeDirectLabel(label.size())) ||
+        !writer->Write(label.data(), label.size())) {
+      return false;
+    }
+  }
+  if (!writer->Write(kLabelTermination)) {
+    return false;
+  }
+
+  MdnsEncodedRecord::Name encoded_name;
+  encoded_name.offset = offset;
+  encoded_name.size = writer->offset() - offset;
+  encoded_name.hashes = MdnsWriter::GetCompressionHashes(name);
+  names->push_back(std::move(encoded_name));
+  return true;
+}
+
+// Writes the rdata of |record|, preceded by its length, recording the
+// positions of any names it holds.
+bool WriteRdata(const MdnsRecord& record,
+                MdnsWriter* writer,
+                std::vector<MdnsEncodedRecord::Name>* names) {
+  const Rdata& rdata = record.rdata();
+  if (absl::holds_alternative<OptRecordRdata>(rdata)) {
+    // OPT records are not supported for outgoing messages.
+    return false;
+  }
+
+  const auto* srv = absl::get_if<SrvRecordRdata>(&rdata);
+  const auto* ptr = absl::get_if<PtrRecordRdata>(&rdata);
+  const auto* nsec = absl::get_if<NsecRecordRdata>(&rdata);
+  if (!srv && !ptr && !nsec) {
+    // The rdata contains no names, so MdnsWriter won't compress it.
+    return absl::visit([writer](const auto& r) { return writer->Write(r); },
+                       rdata);
+  }
+
+  uint8_t* const length = writer->current();
+  if (!writer->Skip(sizeof(uint16_t))) {
+    return false;
+  }
+  bool written;
+  if (srv) {
+    written = writer->Write(srv->priority()) && writer->Write(srv->weight()) &&
+              writer->Write(srv->port()) &&
+              WriteName(srv->target(), writer, names);
+  } else if (ptr) {
+    written = WriteName(ptr->ptr_domain(), writer, names);
+  } else {
+    written = WriteName(nsec->next_domain_name(), writer, names) &&
+              writer->Write(nsec->encoded_types().data(),
+                            nsec->encoded_types().size());
+  }
+  if (!written) {
+    return false;
+  }
+
+  // Names are at most 255 bytes long, so the rdata length always fits.
+  WriteBigEndian<uint16_t>(writer->current() - length - sizeof(uint16_t),
+                           length);
+  return true;
+}
+
+}  // namespace
+
+// static
+constexpr size_t MdnsEncodedRecord::kFixedFieldsSize;
+
+// static
+std::shared_ptr<const MdnsEncodedRecord> MdnsEncodedRecord::Create(
+    const MdnsRecord& record) {
+  // NsecRecordRdata::MaxWireSize() doesn't count the rdata length field.
+  std::vector<uint8_t> buffer(record.MaxWireSize() + sizeof(uint16_t));
+  MdnsWriter writer(buffer.data(), buffer.size());
+  std::shared_ptr<MdnsEncodedRecord> encoded(new MdnsEncodedRecord());
+  if (!WriteName(record.name(), &writer, &encoded->names_) ||
+      !writer.Write(static_cast<uint16_t>(record.dns_type())) ||
+      !writer.Write(
+          MakeRecordClass(record.dns_class(), record.record_type())) ||
+      !writer.Write(static_cast<uint32_t>(record.ttl().count())) ||
+      !WriteRdata(record, &writer, &encoded->names_)) {
+    return nullptr;
+  }
+
+  buffer.resize(writer.offset());
+  encoded->bytes_ = std::move(buffer);
+  return encoded;
+}
+
+// static
+MdnsRecord MdnsEncodedRecord::Precompile(MdnsRecord record) {
+  record.set_encoded(Create(record));
+  return record;
+}
+
+MdnsEncodedRecord::MdnsEncodedRecord() = default;
+
+MdnsEncodedRecord::~MdnsEncodedRecord() = default;
+
+}  // namespace discovery
+}  // namespace openscreen
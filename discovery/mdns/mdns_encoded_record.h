@@ -0,0 +1,77 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_MDNS_ENCODED_RECORD_H_
+#define DISCOVERY_MDNS_MDNS_ENCODED_RECORD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "discovery/mdns/mdns_records.h"
+
+namespace openscreen {
+namespace discovery {
+
+// The wire format of an MdnsRecord, encoded once so that it can be written
+// into any number of messages without serializing the record again.
+//
+// Domain names can't be compressed ahead of time, since the names they would
+// point at depend on what else is in the message. So every name is encoded in
+// full, and its position is kept together with the hashes MdnsWriter uses to
+// find earlier occurrences of its suffixes. Writing the record is then a copy
+// of the fixed fields and rdata, with each name compressed against the message
+// using the precomputed hashes, and the TTL and rdata length patched in.
+//
+// Records which are published change rarely and are sent often, so
+// MdnsPublisher encodes each one when it's registered. See
+// MdnsRecord::encoded().
+class MdnsEncodedRecord {
+ public:
+  // The position of a domain name in the encoded record.
+  struct Name {
+    // Offset of the name's first label.
+    size_t offset;
+
+    // Encoded size of the name, including its terminating label.
+    size_t size;
+
+    // The compression dictionary hash of each suffix of the name, starting
+    // with the whole name. See MdnsWriter::GetCompressionHashes().
+    std::vector<uint64_t> hashes;
+  };
+
+  // Size of the TYPE, CLASS, TTL, and RDLENGTH fields which follow the record
+  // name.
+  static constexpr size_t kFixedFieldsSize = 10;
+
+  // Encodes |record|. Returns null if it can't be encoded.
+  static std::shared_ptr<const MdnsEncodedRecord> Create(
+      const MdnsRecord& record);
+
+  // Returns a copy of |record| which carries its encoded form.
+  static MdnsRecord Precompile(MdnsRecord record);
+
+  ~MdnsEncodedRecord();
+
+  const uint8_t* data() const { return bytes_.data(); }
+  size_t size() const { return bytes_.size(); }
+
+  // The names in the record, in order. The first is the record name, at
+  // offset zero; any others are part of the rdata.
+  const std::vector<Name>& names() const { return names_; }
+
+ private:
+  MdnsEncodedRecord();
+
+  std::vector<uint8_t> bytes_;
+  std::vector<Name> names_;
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_MDNS_ENCODED_RECORD_H_
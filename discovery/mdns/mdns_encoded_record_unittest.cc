@@ -0,0 +1,132 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_encoded_record.h"
+
+#include <vector>
+
+#include "discovery/mdns/mdns_writer.h"
+#include "discovery/mdns/testing/mdns_test_util.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+constexpr std::chrono::seconds kTtl{120};
+constexpr size_t kHeaderSize = 12;
+
+const DomainName kServiceName{"_service", "_tcp", "local"};
+const DomainName kInstanceName{"instance", "_service", "_tcp", "local"};
+const DomainName kHostName{"host", "local"};
+
+std::vector<MdnsRecord> GetServiceRecords() {
+  return {
+      MdnsRecord(kServiceName, DnsType::kPTR, DnsClass::kIN,
+                 RecordType::kShared, kTtl, PtrRecordRdata(kInstanceName)),
+      MdnsRecord(kInstanceName, DnsType::kSRV, DnsClass::kIN,
+                 RecordType::kUnique, kTtl,
+                 SrvRecordRdata(0, 0, 8009, kHostName)),
+      MdnsRecord(kInstanceName, DnsType::kTXT, DnsClass::kIN,
+                 RecordType::kUnique, kTtl, MakeTxtRecord({"foo=1", "bar=2"})),
+      MdnsRecord(kHostName, DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                 kTtl, ARecordRdata(IPAddress{192, 168, 0, 10})),
+      MdnsRecord(kHostName, DnsType::kAAAA, DnsClass::kIN, RecordType::kUnique,
+                 kTtl,
+                 AAAARecordRdata(IPAddress{0xfe80, 0, 0, 0, 0, 0, 0, 1})),
+      MdnsRecord(kHostName, DnsType::kNSEC, DnsClass::kIN, RecordType::kUnique,
+                 kTtl, NsecRecordRdata(kHostName, DnsType::kA, DnsType::kAAAA)),
+  };
+}
+
+std::vector<uint8_t> WriteMessage(const std::vector<MdnsRecord>& records) {
+  MdnsMessage message(1, MessageType::Response);
+  for (const MdnsRecord& record : records) {
+    message.AddAnswer(record);
+  }
+  std::vector<uint8_t> buffer(message.MaxWireSize());
+  MdnsWriter writer(buffer.data(), buffer.size());
+  EXPECT_TRUE(writer.Write(message));
+  buffer.resize(writer.offset());
+  return buffer;
+}
+
+}  // namespace
+
+TEST(MdnsEncodedRecordTest, EncodesRecordUncompressed) {
+  const MdnsRecord record(kInstanceName, DnsType::kSRV, DnsClass::kIN,
+                          RecordType::kUnique, kTtl,
+                          SrvRecordRdata(0, 0, 8009, kInstanceName));
+  const std::shared_ptr<const MdnsEncodedRecord> encoded =
+      MdnsEncodedRecord::Create(record);
+  ASSERT_TRUE(encoded);
+  EXPECT_EQ(encoded->size(), record.MaxWireSize());
+
+  ASSERT_EQ(encoded->names().size(), 2u);
+  const size_t name_size = kInstanceName.MaxWireSize();
+  EXPECT_EQ(encoded->names()[0].offset, 0u);
+  EXPECT_EQ(encoded->names()[0].size, name_size);
+  EXPECT_EQ(encoded->names()[0].hashes,
+            MdnsWriter::GetCompressionHashes(kInstanceName));
+  EXPECT_EQ(encoded->names()[1].offset,
+            name_size + MdnsEncodedRecord::kFixedFieldsSize + 6);
+  EXPECT_EQ(encoded->names()[1].size, name_size);
+}
+
+TEST(MdnsEncodedRecordTest, WritesSameBytesAsRecord) {
+  const std::vector<MdnsRecord> records = GetServiceRecords();
+  std::vector<MdnsRecord> precompiled;
+  for (const MdnsRecord& record : records) {
+    precompiled.push_back(MdnsEncodedRecord::Precompile(record));
+    ASSERT_TRUE(precompiled.back().encoded());
+    EXPECT_EQ(precompiled.back(), record);
+  }
+  EXPECT_EQ(WriteMessage(precompiled), WriteMessage(records));
+
+  // Mixing records with and without their encoded form should compress names
+  // against each other the same way.
+  std::vector<MdnsRecord> mixed = records;
+  for (size_t i = 0; i < mixed.size(); i += 2) {
+    mixed[i] = precompiled[i];
+  }
+  mixed.insert(mixed.end(), precompiled.begin(), precompiled.end());
+  std::vector<MdnsRecord> expected = records;
+  expected.insert(expected.end(), records.begin(), records.end());
+  EXPECT_EQ(WriteMessage(mixed), WriteMessage(expected));
+}
+
+TEST(MdnsEncodedRecordTest, WritesRecordTtl) {
+  const MdnsRecord record =
+      MdnsEncodedRecord::Precompile(GetServiceRecords()[1]);
+  MdnsRecord goodbye(record.name(), record.dns_type(), record.dns_class(),
+                     record.record_type(), std::chrono::seconds(0),
+                     record.rdata());
+  const std::vector<uint8_t> expected = WriteMessage({goodbye});
+  goodbye.set_encoded(record.encoded());
+  EXPECT_EQ(WriteMessage({goodbye}), expected);
+}
+
+TEST(MdnsEncodedRecordTest, WriteInsufficientBuffer) {
+  const MdnsRecord record =
+      MdnsEncodedRecord::Precompile(GetServiceRecords()[0]);
+  // The PTR record's rdata is compressed against its name.
+  const size_t record_size = WriteMessage({record}).size() - kHeaderSize;
+  for (size_t size = 0; size < record_size; ++size) {
+    std::vector<uint8_t> buffer(size);
+    MdnsWriter writer(buffer.data(), buffer.size());
+    EXPECT_FALSE(writer.Write(record));
+    EXPECT_EQ(writer.offset(), 0u);
+  }
+}
+
+TEST(MdnsEncodedRecordTest, FailsToEncodeOptRecord) {
+  const MdnsRecord record(DomainName{"opt"}, DnsType::kOPT, DnsClass::kIN,
+                          RecordType::kShared, kTtl, OptRecordRdata());
+  EXPECT_FALSE(MdnsEncodedRecord::Create(record));
+  EXPECT_FALSE(MdnsEncodedRecord::Precompile(record).encoded());
+}
+
+}  // namespace discovery
+}  // namespace openscreen
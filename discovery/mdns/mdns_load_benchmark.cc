@@ -0,0 +1,736 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Drives the mDNS querier and responder with synthesized traffic from a busy
+// network, and reports how they hold up under it: how fast received packets
+// are parsed and handled, how long queries for published services wait for an
+// answer, how many records and queries are being tracked, and how much memory
+// each cached record costs.
+//
+// The traffic is delivered through a FakeUdpSocket to the same objects that
+// MdnsServiceImpl creates for an interface. Time is simulated with a FakeClock,
+// so many minutes of traffic run in seconds; response latency is measured in
+// simulated time, and everything else in wall-clock time.
+//
+// Without arguments this runs a fixed workload, so that results can be
+// compared between builds. Run with --help to see how to change it.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "discovery/common/config.h"
+#include "discovery/common/reporting_client.h"
+#include "discovery/mdns/mdns_probe_manager.h"
+#include "discovery/mdns/mdns_publisher.h"
+#include "discovery/mdns/mdns_querier.h"
+#include "discovery/mdns/mdns_random.h"
+#include "discovery/mdns/mdns_reader.h"
+#include "discovery/mdns/mdns_receiver.h"
+#include "discovery/mdns/mdns_record_changed_callback.h"
+#include "discovery/mdns/mdns_records.h"
+#include "discovery/mdns/mdns_responder.h"
+#include "discovery/mdns/mdns_sender.h"
+#include "discovery/mdns/mdns_writer.h"
+#include "discovery/mdns/public/mdns_constants.h"
+#include "platform/base/udp_packet.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "platform/test/fake_udp_socket.h"
+#include "util/micro_benchmark.h"
+#include "util/osp_logging.h"
+
+namespace {
+
+// The number of bytes allocated with operator new which haven't been freed.
+std::atomic<int64_t> g_live_heap_bytes{0};
+
+// Each allocation is preceded by its size, so that it can be subtracted again
+// when the allocation is freed.
+constexpr size_t kAllocationHeaderSize = alignof(std::max_align_t);
+
+}  // namespace
+
+void* operator new(size_t size) {
+  void* const block = malloc(size + kAllocationHeaderSize);
+  if (!block) {
+    abort();
+  }
+  *static_cast<size_t*>(block) = size;
+  g_live_heap_bytes += size;
+  return static_cast<char*>(block) + kAllocationHeaderSize;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  if (!pointer) {
+    return;
+  }
+  char* const block = static_cast<char*>(pointer) - kAllocationHeaderSize;
+  g_live_heap_bytes -= *reinterpret_cast<size_t*>(block);
+  free(block);
+}
+
+void operator delete[](void* pointer) noexcept {
+  operator delete(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+  operator delete(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  operator delete(pointer);
+}
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+// Describes the network being simulated.
+struct LoadOptions {
+  // Services announced by other hosts, which are discovered by the querier.
+  int remote_services = 2000;
+
+  // The number of service types the remote services are spread across.
+  int remote_service_types = 8;
+
+  // Services published by this host, which the responder answers for.
+  int published_services = 16;
+
+  // Simulated length of the run.
+  int duration_seconds = 600;
+
+  // Per simulated second, the number of queries for published services and
+  // the number of announcements or goodbyes of remote services received.
+  double query_rate = 50;
+  double announce_rate = 100;
+
+  // TTL of the remote services' records.
+  int ttl_seconds = 120;
+
+  // Percentage of the announcements of a remote service which is live that
+  // are goodbyes instead.
+  int goodbye_percent = 10;
+
+  unsigned int seed = 1;
+};
+
+class NullReportingClient final : public ReportingClient {
+ public:
+  void OnFatalError(Error error) override {
+    OSP_LOG_FATAL << "Fatal error: " << error;
+  }
+  void OnRecoverableError(Error error) override {}
+};
+
+// Lets names be published without probing for them first.
+class ClaimingProbeManager final : public MdnsProbeManager {
+ public:
+  void Claim(DomainName domain) { claimed_.insert(std::move(domain)); }
+
+  bool IsDomainClaimed(const DomainName& domain) const override {
+    return claimed_.find(domain) != claimed_.end();
+  }
+  void RespondToProbeQuery(const MdnsMessage& message,
+                           const IPEndpoint& src) override {}
+
+ private:
+  std::set<DomainName> claimed_;
+};
+
+// Counts the messages sent, and passes each one to |observer| instead of
+// putting it on the network.
+class RecordingSender final : public MdnsSender {
+ public:
+  RecordingSender(UdpSocket* socket,
+                  std::function<void(const MdnsMessage&)> observer)
+      : MdnsSender(socket), observer_(std::move(observer)) {}
+
+  Error SendMulticast(const MdnsMessage& message) override {
+    return SendMessage(message, IPEndpoint{});
+  }
+
+  Error SendMessage(const MdnsMessage& message,
+                    const IPEndpoint& endpoint) override {
+    ++messages_sent_;
+    bytes_sent_ += message.MaxWireSize();
+    observer_(message);
+    return Error::None();
+  }
+
+  int messages_sent() const { return messages_sent_; }
+  size_t bytes_sent() const { return bytes_sent_; }
+
+ private:
+  std::function<void(const MdnsMessage&)> observer_;
+  int messages_sent_ = 0;
+  size_t bytes_sent_ = 0;
+};
+
+// Follows discovered services the way DNS-SD does: each instance found with a
+// PTR query is queried for its SRV and TXT records, and each host found in an
+// SRV record is queried for its address.
+class DiscoveryClient final : public MdnsRecordChangedCallback {
+ public:
+  std::vector<PendingQueryChange> OnRecordChanged(
+      const MdnsRecord& record,
+      RecordChangedEvent event) override {
+    ++events_;
+    DomainName target;
+    DnsType dns_type;
+    if (record.dns_type() == DnsType::kPTR) {
+      target = absl::get<PtrRecordRdata>(record.rdata()).ptr_domain();
+      dns_type = DnsType::kANY;
+    } else if (record.dns_type() == DnsType::kSRV) {
+      target = absl::get<SrvRecordRdata>(record.rdata()).target();
+      dns_type = DnsType::kA;
+    } else {
+      return {};
+    }
+
+    std::vector<PendingQueryChange> changes;
+    const auto query = std::make_pair(target, dns_type);
+    if (event == RecordChangedEvent::kCreated) {
+      if (queries_.insert(query).second) {
+        changes.push_back({std::move(target), dns_type, DnsClass::kANY, this,
+                           PendingQueryChange::kStartQuery});
+      }
+    } else if (event == RecordChangedEvent::kExpired) {
+      if (queries_.erase(query)) {
+        changes.push_back({std::move(target), dns_type, DnsClass::kANY, this,
+                           PendingQueryChange::kStopQuery});
+      }
+    }
+    return changes;
+  }
+
+  // The number of queries started by this client which are still running.
+  size_t active_queries() const { return queries_.size(); }
+
+  int events() const { return events_; }
+
+ private:
+  std::set<std::pair<DomainName, DnsType>> queries_;
+  int events_ = 0;
+};
+
+// Summarizes a set of samples.
+template <typename Duration>
+std::string Describe(std::vector<Duration> samples, const char* unit) {
+  if (samples.empty()) {
+    return "no samples";
+  }
+  std::sort(samples.begin(), samples.end());
+  const auto percentile = [&samples](int p) {
+    return samples[(samples.size() - 1) * p / 100].count();
+  };
+  std::string result;
+  for (int p : {50, 90, 99}) {
+    result += "p" + std::to_string(p) + " " + std::to_string(percentile(p)) +
+              " " + unit + ", ";
+  }
+  return result + "max " + std::to_string(samples.back().count()) + " " + unit;
+}
+
+std::vector<uint8_t> Serialize(const MdnsMessage& message) {
+  std::vector<uint8_t> buffer(message.MaxWireSize());
+  MdnsWriter writer(buffer.data(), buffer.size());
+  OSP_CHECK(writer.Write(message));
+  buffer.resize(writer.offset());
+  return buffer;
+}
+
+TxtRecordRdata MakeTxtRdata(const std::string& id) {
+  std::vector<TxtRecordRdata::Entry> entries;
+  for (const std::string& text :
+       {"id=" + id, std::string("fn=Load Test Device"), std::string("ve=05")}) {
+    entries.emplace_back(text.begin(), text.end());
+  }
+  ErrorOr<TxtRecordRdata> rdata = TxtRecordRdata::TryCreate(std::move(entries));
+  OSP_CHECK(rdata.is_value());
+  return std::move(rdata.value());
+}
+
+DomainName MakeServiceName(const std::string& prefix, int index) {
+  return DomainName{"_" + prefix + std::to_string(index), "_tcp", "local"};
+}
+
+// The PTR, SRV, TXT, and A records of a service instance.
+std::vector<MdnsRecord> MakeServiceRecords(const DomainName& service,
+                                           const std::string& label,
+                                           int host_index,
+                                           seconds ttl) {
+  std::vector<std::string> instance_labels{label};
+  instance_labels.insert(instance_labels.end(), service.labels().begin(),
+                         service.labels().end());
+  const DomainName instance(std::move(instance_labels));
+  const DomainName host{label, "local"};
+  const IPAddress address{10, static_cast<uint8_t>(host_index >> 16),
+                          static_cast<uint8_t>(host_index >> 8),
+                          static_cast<uint8_t>(host_index)};
+  std::vector<MdnsRecord> records;
+  records.emplace_back(service, DnsType::kPTR, DnsClass::kIN,
+                       RecordType::kShared, ttl, PtrRecordRdata(instance));
+  records.emplace_back(instance, DnsType::kSRV, DnsClass::kIN,
+                       RecordType::kUnique, ttl,
+                       SrvRecordRdata(0, 0, 8009, host));
+  records.emplace_back(instance, DnsType::kTXT, DnsClass::kIN,
+                       RecordType::kUnique, ttl, MakeTxtRdata(label));
+  records.emplace_back(host, DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                       ttl, ARecordRdata(address));
+  return records;
+}
+
+class LoadGenerator final : public UdpSocket::Client {
+ public:
+  explicit LoadGenerator(const LoadOptions& options)
+      : options_(options),
+        config_(MakeConfig(options)),
+        socket_(&task_runner_, this),
+        receiver_(config_),
+        sender_(&socket_,
+                [this](const MdnsMessage& message) { OnMessageSent(message); }),
+        publisher_(&sender_,
+                   &probe_manager_,
+                   &task_runner_,
+                   FakeClock::now,
+                   config_),
+        responder_(&publisher_,
+                   &probe_manager_,
+                   &sender_,
+                   &receiver_,
+                   &task_runner_,
+                   FakeClock::now,
+                   &random_,
+                   config_),
+        querier_(&sender_,
+                 &receiver_,
+                 &task_runner_,
+                 FakeClock::now,
+                 &random_,
+                 &reporting_client_,
+                 config_),
+        random_engine_(options.seed),
+        live_(options.remote_services, false) {
+    receiver_.Start();
+  }
+
+  ~LoadGenerator() override = default;
+
+  void Run() {
+    PublishServices();
+    CreateTraffic();
+    MeasureParsing();
+
+    // Discover every remote service, to measure how much memory the cache
+    // needs for each record. Each service is announced once for each step of
+    // discovery, since the instance and host names it holds are only queried
+    // for once the previous step has found them.
+    for (int i = 0; i < options_.remote_service_types; ++i) {
+      querier_.StartQuery(MakeServiceName("remote", i), DnsType::kPTR,
+                          DnsClass::kANY, &client_);
+    }
+    const int64_t heap_before = g_live_heap_bytes;
+    for (int step = 0; step < 3; ++step) {
+      for (int i = 0; i < options_.remote_services; ++i) {
+        Receive(announcements_[i], &response_handling_times_);
+        live_[i] = true;
+      }
+      clock_.Advance(seconds(1));
+    }
+    const int64_t heap_used = g_live_heap_bytes - heap_before;
+    const size_t cached_records = querier_.GetCachedRecords().size();
+    printf("Discovered %d remote services: %zu records cached, %zu queries, "
+           "%lld heap bytes per cached record\n",
+           options_.remote_services, cached_records, client_.active_queries(),
+           static_cast<long long>(heap_used) /
+               static_cast<long long>(std::max<size_t>(cached_records, 1)));
+
+    SimulateTraffic();
+    PrintResults();
+  }
+
+  // UdpSocket::Client overrides.
+  void OnError(UdpSocket* socket, Error error) override {
+    OSP_LOG_FATAL << "Socket error: " << error;
+  }
+  void OnSendError(UdpSocket* socket, Error error) override {
+    OSP_LOG_FATAL << "Socket send error: " << error;
+  }
+  void OnRead(UdpSocket* socket, ErrorOr<UdpPacket> packet) override {
+    receiver_.OnRead(socket, std::move(packet));
+  }
+  void OnBound(UdpSocket* socket) override {}
+
+ private:
+  static Config MakeConfig(const LoadOptions& options) {
+    Config config;
+    // Every record sent by the simulated network should fit in the cache.
+    config.querier_max_records_cached =
+        std::max(config.querier_max_records_cached,
+                 options.remote_services * 8);
+    return config;
+  }
+
+  void PublishServices() {
+    for (int i = 0; i < options_.published_services; ++i) {
+      const DomainName service = MakeServiceName("local", i);
+      const std::vector<MdnsRecord> records = MakeServiceRecords(
+          service, "Local-" + std::to_string(i), i, kPtrRecordTtl);
+      // Only the instance and host names are owned by this host.
+      for (const MdnsRecord& record : records) {
+        if (record.dns_type() != DnsType::kPTR) {
+          probe_manager_.Claim(record.name());
+        }
+      }
+      for (const MdnsRecord& record : records) {
+        OSP_CHECK(publisher_.RegisterRecord(record).ok());
+      }
+
+      MdnsMessage query(0, MessageType::Query);
+      query.AddQuestion(MdnsQuestion(service, DnsType::kPTR, DnsClass::kIN,
+                                     ResponseType::kMulticast));
+      queries_.push_back(Serialize(query));
+      published_types_.push_back(service);
+    }
+  }
+
+  void CreateTraffic() {
+    const seconds ttl(options_.ttl_seconds);
+    for (int i = 0; i < options_.remote_services; ++i) {
+      const DomainName service =
+          MakeServiceName("remote", i % options_.remote_service_types);
+      const std::string label = "Remote-" + std::to_string(i);
+      MdnsMessage announcement(0, MessageType::Response);
+      MdnsMessage goodbye(0, MessageType::Response);
+      for (const MdnsRecord& record :
+           MakeServiceRecords(service, label, i, ttl)) {
+        announcement.AddAnswer(record);
+        goodbye.AddAnswer(MdnsRecord(record.name(), record.dns_type(),
+                                     record.dns_class(), record.record_type(),
+                                     seconds(0), record.rdata()));
+      }
+      announcements_.push_back(Serialize(announcement));
+      goodbyes_.push_back(Serialize(goodbye));
+    }
+  }
+
+  // Measures how fast MdnsReceiver reads the simulated traffic, before any of
+  // it is handled.
+  void MeasureParsing() {
+    std::vector<const std::vector<uint8_t>*> packets;
+    size_t bytes = 0;
+    for (const auto* traffic : {&announcements_, &goodbyes_, &queries_}) {
+      for (const std::vector<uint8_t>& packet : *traffic) {
+        packets.push_back(&packet);
+        bytes += packet.size();
+      }
+    }
+    MdnsMessageView view;
+    const MicroBenchmarkResult result = RunMicroBenchmark(
+        "Parse all packets", bytes, [this, &packets, &view] {
+          for (const std::vector<uint8_t>* packet : packets) {
+            MdnsReader reader(config_, packet->data(), packet->size());
+            DoNotOptimize(reader.Read(&view));
+          }
+        });
+    PrintMicroBenchmarkResult(result);
+    printf("Parse rate: %.0f packets/s\n",
+           packets.size() * 1e9 / result.nanoseconds_per_iteration());
+  }
+
+  // Delivers announcements, goodbyes, and queries at random times, at the
+  // configured rates.
+  void SimulateTraffic() {
+    std::exponential_distribution<double> announce_interval(
+        options_.announce_rate);
+    std::exponential_distribution<double> query_interval(options_.query_rate);
+    std::uniform_int_distribution<int> remote_service(
+        0, options_.remote_services - 1);
+    std::uniform_int_distribution<int> published_service(
+        0, options_.published_services - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    const auto to_duration = [](double interval) {
+      return duration_cast<Clock::duration>(
+          std::chrono::duration<double>(interval));
+    };
+
+    const Clock::time_point start = FakeClock::now();
+    const Clock::time_point end = start + seconds(options_.duration_seconds);
+    Clock::time_point next_announcement =
+        start + to_duration(announce_interval(random_engine_));
+    Clock::time_point next_query =
+        start + to_duration(query_interval(random_engine_));
+    const steady_clock::time_point wall_start = steady_clock::now();
+    for (;;) {
+      const Clock::time_point next = std::min(next_announcement, next_query);
+      if (next >= end) {
+        break;
+      }
+      clock_.Advance(next - FakeClock::now());
+
+      if (next == next_announcement) {
+        const int i = remote_service(random_engine_);
+        if (live_[i] && percent(random_engine_) < options_.goodbye_percent) {
+          Receive(goodbyes_[i], &response_handling_times_);
+          live_[i] = false;
+          ++goodbyes_received_;
+        } else {
+          Receive(announcements_[i], &response_handling_times_);
+          live_[i] = true;
+          ++announcements_received_;
+        }
+        next_announcement += to_duration(announce_interval(random_engine_));
+      } else {
+        const int i = published_service(random_engine_);
+        pending_queries_[published_types_[i]].push_back(FakeClock::now());
+        Receive(queries_[i], &query_handling_times_);
+        ++queries_received_;
+        next_query += to_duration(query_interval(random_engine_));
+      }
+    }
+    clock_.Advance(end - FakeClock::now());
+    wall_time_ = steady_clock::now() - wall_start;
+  }
+
+  void Receive(const std::vector<uint8_t>& bytes,
+               std::vector<microseconds>* handling_times) {
+    UdpPacket packet(bytes.begin(), bytes.end());
+    packet.set_source(
+        IPEndpoint{IPAddress{10, 255, 0, 1}, kDefaultMulticastPort});
+    packet.set_destination(
+        IPEndpoint{kDefaultMulticastGroupIPv4, kDefaultMulticastPort});
+    const steady_clock::time_point start = steady_clock::now();
+    socket_.MockReceivePacket(std::move(packet));
+    handling_times->push_back(
+        duration_cast<microseconds>(steady_clock::now() - start));
+  }
+
+  // Records the latency of each query for a published service which |message|
+  // answers.
+  void OnMessageSent(const MdnsMessage& message) {
+    for (const MdnsRecord& answer : message.answers()) {
+      if (answer.dns_type() != DnsType::kPTR) {
+        continue;
+      }
+      auto it = pending_queries_.find(answer.name());
+      if (it == pending_queries_.end()) {
+        continue;
+      }
+      for (Clock::time_point received : it->second) {
+        response_latencies_.push_back(
+            duration_cast<milliseconds>(FakeClock::now() - received));
+      }
+      pending_queries_.erase(it);
+    }
+  }
+
+  void PrintResults() {
+    const double wall_seconds =
+        std::chrono::duration<double>(wall_time_).count();
+    const size_t packets_received =
+        query_handling_times_.size() + response_handling_times_.size();
+    printf("Simulated %d s in %.2f s: received %d announcements, %d goodbyes, "
+           "and %d queries; %.0f packets/s handled\n",
+           options_.duration_seconds, wall_seconds, announcements_received_,
+           goodbyes_received_, queries_received_,
+           packets_received / wall_seconds);
+    printf("Handling responses: %s\n",
+           Describe(response_handling_times_, "us").c_str());
+    printf("Handling queries: %s\n",
+           Describe(query_handling_times_, "us").c_str());
+
+    size_t unanswered = 0;
+    for (const auto& pending : pending_queries_) {
+      unanswered += pending.second.size();
+    }
+    printf("Response latency: %s; %zu queries unanswered\n",
+           Describe(response_latencies_, "ms").c_str(), unanswered);
+
+    const MdnsReceiver::Metrics& metrics = receiver_.metrics();
+    printf("Receiver: %llu messages processed, %llu filtered, %llu malformed\n",
+           static_cast<unsigned long long>(metrics.messages_processed),
+           static_cast<unsigned long long>(metrics.messages_filtered),
+           static_cast<unsigned long long>(metrics.messages_malformed));
+    printf("Querier: %zu records cached, %zu queries running, %d record "
+           "changes reported\n",
+           querier_.GetCachedRecords().size(), client_.active_queries(),
+           client_.events());
+    printf("Sent: %d messages, %zu bytes\n", sender_.messages_sent(),
+           sender_.bytes_sent());
+  }
+
+  const LoadOptions options_;
+  const Config config_;
+
+  FakeClock clock_{Clock::now()};
+  FakeTaskRunner task_runner_{&clock_};
+  FakeUdpSocket socket_;
+
+  NullReportingClient reporting_client_;
+  ClaimingProbeManager probe_manager_;
+  MdnsRandom random_;
+  MdnsReceiver receiver_;
+  RecordingSender sender_;
+  MdnsPublisher publisher_;
+  MdnsResponder responder_;
+  MdnsQuerier querier_;
+  DiscoveryClient client_;
+
+  std::default_random_engine random_engine_;
+
+  // Serialized messages, indexed by the service they are for.
+  std::vector<std::vector<uint8_t>> announcements_;
+  std::vector<std::vector<uint8_t>> goodbyes_;
+  std::vector<std::vector<uint8_t>> queries_;
+
+  // The published service types, indexed like |queries_|.
+  std::vector<DomainName> published_types_;
+
+  // Whether each remote service was last announced rather than said goodbye.
+  std::vector<bool> live_;
+
+  // When each unanswered query was received, by the service it asks for.
+  std::map<DomainName, std::vector<Clock::time_point>> pending_queries_;
+
+  std::vector<microseconds> response_handling_times_;
+  std::vector<microseconds> query_handling_times_;
+  std::vector<milliseconds> response_latencies_;
+  int announcements_received_ = 0;
+  int goodbyes_received_ = 0;
+  int queries_received_ = 0;
+  steady_clock::duration wall_time_{};
+};
+
+void LogUsage(const char* argv0) {
+  const LoadOptions defaults;
+  fprintf(stderr,
+          "usage: %s [options]\n\n"
+          "  --remote-services=N  Services announced by other hosts (%d).\n"
+          "  --remote-types=N     Service types they are spread across (%d).\n"
+          "  --published=N        Services published by this host (%d).\n"
+          "  --duration=SECONDS   Simulated length of the run (%d).\n"
+          "  --query-rate=N       Queries for published services per second "
+          "(%.0f).\n"
+          "  --announce-rate=N    Remote announcements per second (%.0f).\n"
+          "  --ttl=SECONDS        TTL of remote records (%d).\n"
+          "  --goodbye-percent=N  Share of announcements which are goodbyes "
+          "(%d).\n"
+          "  --seed=N             Seed for the simulated traffic (%u).\n",
+          argv0, defaults.remote_services, defaults.remote_service_types,
+          defaults.published_services, defaults.duration_seconds,
+          defaults.query_rate, defaults.announce_rate, defaults.ttl_seconds,
+          defaults.goodbye_percent, defaults.seed);
+}
+
+int LoadBenchmarkMain(int argc, char* argv[]) {
+  const struct option kArgumentOptions[] = {
+      {"remote-services", required_argument, nullptr, 'r'},
+      {"remote-types", required_argument, nullptr, 'y'},
+      {"published", required_argument, nullptr, 'p'},
+      {"duration", required_argument, nullptr, 'd'},
+      {"query-rate", required_argument, nullptr, 'q'},
+      {"announce-rate", required_argument, nullptr, 'a'},
+      {"ttl", required_argument, nullptr, 't'},
+      {"goodbye-percent", required_argument, nullptr, 'g'},
+      {"seed", required_argument, nullptr, 's'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}};
+
+  LoadOptions options;
+  int ch = -1;
+  while ((ch = getopt_long(argc, argv, "r:y:p:d:q:a:t:g:s:h", kArgumentOptions,
+                           nullptr)) != -1) {
+    switch (ch) {
+      case 'r':
+        options.remote_services = atoi(optarg);
+        break;
+      case 'y':
+        options.remote_service_types = atoi(optarg);
+        break;
+      case 'p':
+        options.published_services = atoi(optarg);
+        break;
+      case 'd':
+        options.duration_seconds = atoi(optarg);
+        break;
+      case 'q':
+        options.query_rate = atof(optarg);
+        break;
+      case 'a':
+        options.announce_rate = atof(optarg);
+        break;
+      case 't':
+        options.ttl_seconds = atoi(optarg);
+        break;
+      case 'g':
+        options.goodbye_percent = atoi(optarg);
+        break;
+      case 's':
+        options.seed = static_cast<unsigned int>(strtoul(optarg, nullptr, 10));
+        break;
+      default:
+        LogUsage(argv[0]);
+        return 1;
+    }
+  }
+  if (options.remote_services < 1 || options.remote_service_types < 1 ||
+      options.published_services < 1 || options.duration_seconds < 1 ||
+      options.query_rate <= 0 || options.announce_rate <= 0 ||
+      options.ttl_seconds < 1 || options.goodbye_percent < 0 ||
+      options.goodbye_percent > 100) {
+    LogUsage(argv[0]);
+    return 1;
+  }
+
+  LoadGenerator(options).Run();
+  return 0;
+}
+
+}  // namespace
+}  // namespace discovery
+}  // namespace openscreen
+
+int main(int argc, char* argv[]) {
+  return openscreen::discovery::LoadBenchmarkMain(argc, argv);
+}
@@ -0,0 +1,213 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_message_view.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/strings/ascii.h"
+#include "discovery/common/config.h"
+#include "discovery/mdns/mdns_reader.h"
+#include "util/big_endian.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+// Compares the same way as the label comparison used by DomainName.
+int CompareLabelIgnoreCase(absl::string_view x, const std::string& y) {
+  size_t i = 0;
+  for (; i < x.size(); i++) {
+    if (i == y.size()) {
+      return 1;
+    }
+    const char x_char = absl::ascii_tolower(x[i]);
+    const char y_char = absl::ascii_tolower(y[i]);
+    if (x_char < y_char) {
+      return -1;
+    } else if (y_char < x_char) {
+      return 1;
+    }
+  }
+  return i == y.size() ? 0 : -1;
+}
+
+}  // namespace
+
+DomainNameView::Iterator::Iterator(const uint8_t* message,
+                                   const uint8_t* position)
+    : message_(message) {
+  ResolvePointers(position);
+}
+
+absl::string_view DomainNameView::Iterator::operator*() const {
+  OSP_DCHECK(label_);
+  return absl::string_view(reinterpret_cast<const char*>(label_ + 1),
+                           GetDirectLabelLength(*label_));
+}
+
+DomainNameView::Iterator& DomainNameView::Iterator::operator++() {
+  OSP_DCHECK(label_);
+  ResolvePointers(label_ + 1 + GetDirectLabelLength(*label_));
+  return *this;
+}
+
+DomainNameView::Iterator DomainNameView::Iterator::operator++(int) {
+  Iterator result = *this;
+  ++*this;
+  return result;
+}
+
+void DomainNameView::Iterator::ResolvePointers(const uint8_t* position) {
+  // MdnsReader has already checked that the pointers stay within the message
+  // and do not loop.
+  while (IsPointerLabel(*position)) {
+    position =
+        message_ + GetPointerLabelOffset(ReadBigEndian<uint16_t>(position));
+  }
+  OSP_DCHECK(IsTerminationLabel(*position) || IsDirectLabel(*position));
+  label_ = IsTerminationLabel(*position) ? nullptr : position;
+}
+
+DomainNameView::Iterator DomainNameView::begin() const {
+  if (!name_) {
+    return end();
+  }
+  return Iterator(message_, name_);
+}
+
+DomainName DomainNameView::ToDomainName() const {
+  std::vector<std::string> labels;
+  for (absl::string_view label : *this) {
+    labels.emplace_back(label);
+  }
+  return DomainName(std::move(labels));
+}
+
+int DomainNameView::Compare(const DomainName& other) const {
+  Iterator it = begin();
+  for (const std::string& label : other.labels()) {
+    if (it == end()) {
+      return -1;
+    }
+    const int result = CompareLabelIgnoreCase(*it, label);
+    if (result != 0) {
+      return result;
+    }
+    ++it;
+  }
+  return it == end() ? 0 : 1;
+}
+
+bool operator==(const DomainNameView& lhs, const DomainName& rhs) {
+  return lhs.Compare(rhs) == 0;
+}
+
+bool operator!=(const DomainNameView& lhs, const DomainName& rhs) {
+  return lhs.Compare(rhs) != 0;
+}
+
+bool operator==(const DomainName& lhs, const DomainNameView& rhs) {
+  return rhs.Compare(lhs) == 0;
+}
+
+bool operator!=(const DomainName& lhs, const DomainNameView& rhs) {
+  return rhs.Compare(lhs) != 0;
+}
+
+bool operator<(const DomainNameView& lhs, const DomainName& rhs) {
+  return lhs.Compare(rhs) < 0;
+}
+
+bool operator<(const DomainName& lhs, const DomainNameView& rhs) {
+  return rhs.Compare(lhs) > 0;
+}
+
+ErrorOr<MdnsQuestion> MdnsQuestionView::ToOwned() const {
+  return MdnsQuestion::TryCreate(name_.ToDomainName(), dns_type_, dns_class_,
+                                 response_type_);
+}
+
+ErrorOr<MdnsRecord> MdnsRecordView::ToOwned(const Config& config) const {
+  // Read the record again from its start, with the full message available so
+  // that compression pointers in the record data can be followed.
+  MdnsReader reader(config, message_.data(), message_.size());
+  MdnsRecord record;
+  if (!reader.Skip(offset_) || !reader.Read(&record)) {
+    return Error::Code::kMdnsReadFailure;
+  }
+  return record;
+}
+
+MdnsMessageView::MdnsMessageView() = default;
+
+MdnsMessageView::MdnsMessageView(MdnsMessageView&& other) noexcept = default;
+
+MdnsMessageView& MdnsMessageView::operator=(MdnsMessageView&& other) noexcept =
+    default;
+
+MdnsMessageView::~MdnsMessageView() = default;
+
+ErrorOr<MdnsMessage> MdnsMessageView::ToOwned(const Config& config) const {
+  std::vector<MdnsQuestion> questions;
+  questions.reserve(questions_.size());
+  for (const MdnsQuestionView& view : questions_) {
+    ErrorOr<MdnsQuestion> question = view.ToOwned();
+    if (question.is_error()) {
+      return Error::Code::kMdnsReadFailure;
+    }
+    questions.push_back(std::move(question.value()));
+  }
+
+  std::vector<MdnsRecord> sections[3];
+  const absl::Span<const MdnsRecordView> views[3] = {
+      answers(), authority_records(), additional_records()};
+  for (int i = 0; i < 3; ++i) {
+    sections[i].reserve(views[i].size());
+    for (const MdnsRecordView& view : views[i]) {
+      ErrorOr<MdnsRecord> record = view.ToOwned(config);
+      if (record.is_error()) {
+        return std::move(record.error());
+      }
+      sections[i].push_back(std::move(record.value()));
+    }
+  }
+
+  ErrorOr<MdnsMessage> message = MdnsMessage::TryCreate(
+      id_, type_, std::move(questions), std::move(sections[0]),
+      std::move(sections[1]), std::move(sections[2]));
+  if (message.is_value() && is_truncated_) {
+    message.value().set_truncated();
+  }
+  return message;
+}
+
+absl::Span<const MdnsRecordView> MdnsMessageView::answers() const {
+  return absl::MakeConstSpan(records_).subspan(0, answer_count_);
+}
+
+absl::Span<const MdnsRecordView> MdnsMessageView::authority_records() const {
+  return absl::MakeConstSpan(records_).subspan(answer_count_,
+                                               authority_record_count_);
+}
+
+absl::Span<const MdnsRecordView> MdnsMessageView::additional_records() const {
+  return absl::MakeConstSpan(records_).subspan(answer_count_ +
+                                               authority_record_count_);
+}
+
+void MdnsMessageView::Clear() {
+  id_ = 0;
+  type_ = MessageType::Query;
+  is_truncated_ = false;
+  questions_.clear();
+  records_.clear();
+  answer_count_ = 0;
+  authority_record_count_ = 0;
+}
+
+}  // namespace discovery
+}  // namespace openscreen
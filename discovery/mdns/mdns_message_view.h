@@ -0,0 +1,196 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_MDNS_MESSAGE_VIEW_H_
+#define DISCOVERY_MDNS_MDNS_MESSAGE_VIEW_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <iterator>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "discovery/mdns/mdns_records.h"
+#include "discovery/mdns/public/mdns_constants.h"
+#include "platform/base/error.h"
+
+namespace openscreen {
+namespace discovery {
+
+struct Config;
+
+// The views below refer to a received mDNS message without copying any of it.
+// They are created by MdnsReader, which validates the message's structure and
+// domain names while reading them, and must not outlive the message's buffer.
+// Record data is only parsed when a record is copied with ToOwned().
+
+// A domain name inside a received message.  Its labels are read directly from
+// the message, following compression pointers as they are reached.
+class DomainNameView {
+ public:
+  // Iterates over the labels of the name.
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = absl::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const absl::string_view*;
+    using reference = absl::string_view;
+
+    Iterator() = default;
+
+    absl::string_view operator*() const;
+    Iterator& operator++();
+    Iterator operator++(int);
+
+    bool operator==(const Iterator& other) const {
+      return label_ == other.label_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class DomainNameView;
+
+    // |position| may point at a compression pointer or the termination byte,
+    // in which case it is resolved to the next direct label (or the end).
+    Iterator(const uint8_t* message, const uint8_t* position);
+
+    void ResolvePointers(const uint8_t* position);
+
+    const uint8_t* message_ = nullptr;
+
+    // The length byte of the current label, or nullptr at the end.
+    const uint8_t* label_ = nullptr;
+  };
+
+  DomainNameView() = default;
+
+  Iterator begin() const;
+  Iterator end() const { return Iterator(); }
+
+  bool IsRoot() const { return begin() == end(); }
+
+  // Copies the labels of this name.
+  DomainName ToDomainName() const;
+
+  // Compares this name to |other| the same way as DomainName's comparison
+  // operators do, ignoring case.
+  int Compare(const DomainName& other) const;
+
+ private:
+  friend class MdnsReader;
+
+  DomainNameView(const uint8_t* message, const uint8_t* name)
+      : message_(message), name_(name) {}
+
+  // The start of the message, which compression pointers are relative to.
+  const uint8_t* message_ = nullptr;
+
+  // The first byte of the encoded name.
+  const uint8_t* name_ = nullptr;
+};
+
+bool operator==(const DomainNameView& lhs, const DomainName& rhs);
+bool operator!=(const DomainNameView& lhs, const DomainName& rhs);
+bool operator==(const DomainName& lhs, const DomainNameView& rhs);
+bool operator!=(const DomainName& lhs, const DomainNameView& rhs);
+
+// These allow looking up DomainNameViews in ordered containers keyed by
+// DomainName that use a transparent comparator, such as std::less<>.
+bool operator<(const DomainNameView& lhs, const DomainName& rhs);
+bool operator<(const DomainName& lhs, const DomainNameView& rhs);
+
+class MdnsQuestionView {
+ public:
+  ErrorOr<MdnsQuestion> ToOwned() const;
+
+  const DomainNameView& name() const { return name_; }
+  DnsType dns_type() const { return dns_type_; }
+  DnsClass dns_class() const { return dns_class_; }
+  ResponseType response_type() const { return response_type_; }
+
+ private:
+  friend class MdnsReader;
+
+  DomainNameView name_;
+  DnsType dns_type_ = static_cast<DnsType>(0);
+  DnsClass dns_class_ = static_cast<DnsClass>(0);
+  ResponseType response_type_ = ResponseType::kMulticast;
+};
+
+class MdnsRecordView {
+ public:
+  // Parses the record's data and copies the record.  |config| is the same one
+  // that the record's message was read with.
+  ErrorOr<MdnsRecord> ToOwned(const Config& config) const;
+
+  const DomainNameView& name() const { return name_; }
+  DnsType dns_type() const { return dns_type_; }
+  DnsClass dns_class() const { return dns_class_; }
+  RecordType record_type() const { return record_type_; }
+  std::chrono::seconds ttl() const { return ttl_; }
+
+ private:
+  friend class MdnsReader;
+
+  absl::Span<const uint8_t> message_;
+
+  // Offset of the record within |message_|.
+  size_t offset_ = 0;
+
+  DomainNameView name_;
+  DnsType dns_type_ = static_cast<DnsType>(0);
+  DnsClass dns_class_ = static_cast<DnsClass>(0);
+  RecordType record_type_ = RecordType::kShared;
+  std::chrono::seconds ttl_{0};
+};
+
+// A received message.  An instance is meant to be reused for every message
+// received, so that after the first few messages reading one does not
+// allocate.
+class MdnsMessageView {
+ public:
+  MdnsMessageView();
+  MdnsMessageView(const MdnsMessageView& other) = delete;
+  MdnsMessageView(MdnsMessageView&& other) noexcept;
+  MdnsMessageView& operator=(const MdnsMessageView& other) = delete;
+  MdnsMessageView& operator=(MdnsMessageView&& other) noexcept;
+  ~MdnsMessageView();
+
+  // Copies the whole message.  This fails in the same cases as
+  // MdnsReader::Read() does for the same message.
+  ErrorOr<MdnsMessage> ToOwned(const Config& config) const;
+
+  uint16_t id() const { return id_; }
+  MessageType type() const { return type_; }
+  bool is_truncated() const { return is_truncated_; }
+  absl::Span<const MdnsQuestionView> questions() const { return questions_; }
+  absl::Span<const MdnsRecordView> answers() const;
+  absl::Span<const MdnsRecordView> authority_records() const;
+  absl::Span<const MdnsRecordView> additional_records() const;
+
+ private:
+  friend class MdnsReader;
+
+  // Empties the message, keeping the allocated storage.
+  void Clear();
+
+  uint16_t id_ = 0;
+  MessageType type_ = MessageType::Query;
+  bool is_truncated_ = false;
+  std::vector<MdnsQuestionView> questions_;
+
+  // The answers, authority records and additional records, in that order.
+  std::vector<MdnsRecordView> records_;
+  size_t answer_count_ = 0;
+  size_t authority_record_count_ = 0;
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_MDNS_MESSAGE_VIEW_H_
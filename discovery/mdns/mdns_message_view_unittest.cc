@@ -0,0 +1,237 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_message_view.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "discovery/common/config.h"
+#include "discovery/mdns/mdns_reader.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace discovery {
+
+namespace {
+
+// clang-format off
+constexpr uint8_t kResponseMessage[] = {
+    0x00, 0x01,  // ID = 1
+    0x84, 0x00,  // FLAGS = AA | RESPONSE
+    0x00, 0x00,  // Question count
+    0x00, 0x02,  // Answer count
+    0x00, 0x00,  // Authority count
+    0x00, 0x01,  // Additional count
+    // Answer 1
+    0x07, 'T', 'e', 's', 't', 'i', 'n', 'g',  // Byte: 12
+    0x05, 'l', 'o', 'c', 'a', 'l',            // Byte: 20
+    0x00,                                     // Byte: 26
+    0x00, 0x01,              // TYPE = A (1)
+    0x00, 0x01,              // CLASS = IN (1)
+    0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+    0x00, 0x04,              // RDLENGTH = 4 bytes
+    0xac, 0x00, 0x00, 0x01,  // 172.0.0.1
+    // Answer 2
+    0x07, 's', 'e', 'r', 'v', 'i', 'c', 'e',
+    0xc0, 0x14,              // Pointer to "local"
+    0x00, 0x0c,              // TYPE = PTR (12)
+    0x80, 0x01,              // CLASS = IN (1) | CACHE_FLUSH_BIT
+    0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+    0x00, 0x02,              // RDLENGTH = 2 bytes
+    0xc0, 0x0c,              // Pointer to "Testing.local"
+    // Additional 1
+    0xc0, 0x0c,              // Pointer to "Testing.local"
+    0x00, 0x01,              // TYPE = A (1)
+    0x00, 0x01,              // CLASS = IN (1)
+    0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+    0x00, 0x04,              // RDLENGTH = 4 bytes
+    0xac, 0x00, 0x00, 0x02,  // 172.0.0.2
+};
+// clang-format on
+
+}  // namespace
+
+TEST(MdnsMessageViewTest, ReadsMessageWithoutCopying) {
+  MdnsReader reader(Config{}, kResponseMessage, sizeof(kResponseMessage));
+  MdnsMessageView view;
+  ASSERT_TRUE(reader.Read(&view).ok());
+  EXPECT_EQ(reader.remaining(), UINT64_C(0));
+
+  EXPECT_EQ(view.id(), 1);
+  EXPECT_EQ(view.type(), MessageType::Response);
+  EXPECT_FALSE(view.is_truncated());
+  EXPECT_TRUE(view.questions().empty());
+  ASSERT_EQ(view.answers().size(), 2u);
+  EXPECT_TRUE(view.authority_records().empty());
+  ASSERT_EQ(view.additional_records().size(), 1u);
+
+  const MdnsRecordView& ptr = view.answers()[1];
+  EXPECT_EQ(ptr.name(), (DomainName{"service", "local"}));
+  EXPECT_EQ(ptr.dns_type(), DnsType::kPTR);
+  EXPECT_EQ(ptr.dns_class(), DnsClass::kIN);
+  EXPECT_EQ(ptr.record_type(), RecordType::kUnique);
+  EXPECT_EQ(ptr.ttl(), std::chrono::seconds(120));
+
+  // Labels refer to the message itself.
+  const absl::string_view first_label = *view.answers()[0].name().begin();
+  EXPECT_EQ(first_label, "Testing");
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(first_label.data()),
+            kResponseMessage + 13);
+  EXPECT_EQ(view.additional_records()[0].name(),
+            (DomainName{"testing", "local"}));
+}
+
+TEST(MdnsMessageViewTest, ToOwnedMatchesMdnsReader) {
+  MdnsReader view_reader(Config{}, kResponseMessage, sizeof(kResponseMessage));
+  MdnsMessageView view;
+  ASSERT_TRUE(view_reader.Read(&view).ok());
+
+  MdnsReader reader(Config{}, kResponseMessage, sizeof(kResponseMessage));
+  const ErrorOr<MdnsMessage> expected = reader.Read();
+  ASSERT_TRUE(expected.is_value());
+
+  const ErrorOr<MdnsMessage> owned = view.ToOwned(Config{});
+  ASSERT_TRUE(owned.is_value());
+  EXPECT_EQ(owned.value(), expected.value());
+
+  const ErrorOr<MdnsRecord> ptr = view.answers()[1].ToOwned(Config{});
+  ASSERT_TRUE(ptr.is_value());
+  EXPECT_EQ(ptr.value(), expected.value().answers()[1]);
+  EXPECT_EQ(absl::get<PtrRecordRdata>(ptr.value().rdata()).ptr_domain(),
+            (DomainName{"Testing", "local"}));
+}
+
+TEST(MdnsMessageViewTest, ComparesNamesLikeDomainName) {
+  MdnsReader reader(Config{}, kResponseMessage, sizeof(kResponseMessage));
+  MdnsMessageView view;
+  ASSERT_TRUE(reader.Read(&view).ok());
+  const DomainNameView& name = view.answers()[0].name();
+
+  const std::vector<DomainName> names = {
+      DomainName{"local"},
+      DomainName{"testing"},
+      DomainName{"TESTING", "LOCAL"},
+      DomainName{"testing", "local", "extra"},
+      DomainName{"testinga", "local"},
+      DomainName{"zzz"},
+  };
+  const DomainName copy = name.ToDomainName();
+  for (const DomainName& other : names) {
+    EXPECT_EQ(name == other, copy == other) << other;
+    EXPECT_EQ(name < other, copy < other) << other;
+    EXPECT_EQ(other < name, other < copy) << other;
+  }
+
+  std::multimap<DomainName, int, std::less<>> map;
+  map.emplace(DomainName{"testing", "local"}, 1);
+  map.emplace(DomainName{"other", "local"}, 2);
+  const auto it = map.find(name);
+  ASSERT_NE(it, map.end());
+  EXPECT_EQ(it->second, 1);
+  EXPECT_EQ(map.find(view.answers()[1].name()), map.end());
+}
+
+TEST(MdnsMessageViewTest, ParsesRecordDataOnlyWhenCopied) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+      0x00, 0x01,  // ID = 1
+      0x84, 0x00,  // FLAGS = AA | RESPONSE
+      0x00, 0x00,  // Question count
+      0x00, 0x01,  // Answer count
+      0x00, 0x00,  // Authority count
+      0x00, 0x00,  // Additional count
+      // Answer
+      0x07, 't', 'e', 's', 't', 'i', 'n', 'g',
+      0x05, 'l', 'o', 'c', 'a', 'l',
+      0x00,
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x03,              // RDLENGTH = 3 bytes, which is invalid for A
+      0xac, 0x00, 0x00,
+  };
+  // clang-format on
+
+  MdnsReader reader(Config{}, kMessage, sizeof(kMessage));
+  MdnsMessageView view;
+  ASSERT_TRUE(reader.Read(&view).ok());
+  ASSERT_EQ(view.answers().size(), 1u);
+  EXPECT_TRUE(view.answers()[0].ToOwned(Config{}).is_error());
+  EXPECT_TRUE(view.ToOwned(Config{}).is_error());
+
+  MdnsReader owned_reader(Config{}, kMessage, sizeof(kMessage));
+  EXPECT_TRUE(owned_reader.Read().is_error());
+}
+
+TEST(MdnsMessageViewTest, RejectsInvalidNames) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+      0x00, 0x01,  // ID = 1
+      0x84, 0x00,  // FLAGS = AA | RESPONSE
+      0x00, 0x00,  // Question count
+      0x00, 0x01,  // Answer count
+      0x00, 0x00,  // Authority count
+      0x00, 0x00,  // Additional count
+      // Answer
+      0x04, 'l', 'o', 'o', 'p',
+      0xc0, 0x0c,              // Pointer to itself
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x04,              // RDLENGTH = 4 bytes
+      0xac, 0x00, 0x00, 0x01,  // 172.0.0.1
+  };
+  // clang-format on
+
+  MdnsReader reader(Config{}, kMessage, sizeof(kMessage));
+  MdnsMessageView view;
+  EXPECT_EQ(reader.Read(&view).code(), Error::Code::kMdnsReadFailure);
+  EXPECT_EQ(reader.offset(), UINT64_C(0));
+  EXPECT_TRUE(view.answers().empty());
+}
+
+TEST(MdnsMessageViewTest, ReusesViewForNextMessage) {
+  // clang-format off
+  constexpr uint8_t kQueryMessage[] = {
+      0x00, 0x02,  // ID = 2
+      0x00, 0x00,  // FLAGS = None
+      0x00, 0x01,  // Question count
+      0x00, 0x00,  // Answer count
+      0x00, 0x00,  // Authority count
+      0x00, 0x00,  // Additional count
+      // Question
+      0x07, 't', 'e', 's', 't', 'i', 'n', 'g',
+      0x05, 'l', 'o', 'c', 'a', 'l',
+      0x00,
+      0x00, 0x01,  // TYPE = A (1)
+      0x80, 0x01,  // CLASS = IN (1) | UNICAST_BIT
+  };
+  // clang-format on
+
+  MdnsMessageView view;
+  MdnsReader response_reader(Config{}, kResponseMessage,
+                             sizeof(kResponseMessage));
+  ASSERT_TRUE(response_reader.Read(&view).ok());
+  MdnsReader query_reader(Config{}, kQueryMessage, sizeof(kQueryMessage));
+  ASSERT_TRUE(query_reader.Read(&view).ok());
+
+  EXPECT_EQ(view.id(), 2);
+  EXPECT_EQ(view.type(), MessageType::Query);
+  EXPECT_TRUE(view.answers().empty());
+  EXPECT_TRUE(view.additional_records().empty());
+  ASSERT_EQ(view.questions().size(), 1u);
+  EXPECT_EQ(view.questions()[0].response_type(), ResponseType::kUnicast);
+
+  const ErrorOr<MdnsQuestion> question = view.questions()[0].ToOwned();
+  ASSERT_TRUE(question.is_value());
+  EXPECT_EQ(question.value(),
+            MdnsQuestion(DomainName{"testing", "local"}, DnsType::kA,
+                         DnsClass::kIN, ResponseType::kUnicast));
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,109 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_name_filter.h"
+
+#include <string>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_records.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+// 64-bit FNV-1a.
+constexpr uint64_t kFnvOffsetBasis = UINT64_C(0xcbf29ce484222325);
+constexpr uint64_t kFnvPrime = UINT64_C(0x100000001b3);
+
+uint64_t HashByte(uint64_t hash, uint8_t byte) {
+  return (hash ^ byte) * kFnvPrime;
+}
+
+// Hashes the labels the same way whether they are stored in a DomainName or
+// read from a received message.  Each label is prefixed with its length, so
+// that names which only differ in where the labels are split don't collide.
+template <typename Labels>
+uint64_t HashLabels(const Labels& labels) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (absl::string_view label : labels) {
+    hash = HashByte(hash, static_cast<uint8_t>(label.size()));
+    for (char c : label) {
+      hash = HashByte(hash, static_cast<uint8_t>(absl::ascii_tolower(c)));
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+MdnsNameFilter::MdnsNameFilter() = default;
+
+MdnsNameFilter::~MdnsNameFilter() = default;
+
+void MdnsNameFilter::Add(const DomainName& name) {
+  const uint64_t hash = Hash(name);
+  Increment(FirstIndex(hash));
+  Increment(SecondIndex(hash));
+  size_++;
+}
+
+void MdnsNameFilter::Remove(const DomainName& name) {
+  OSP_DCHECK_GT(size_, 0u);
+  const uint64_t hash = Hash(name);
+  Decrement(FirstIndex(hash));
+  Decrement(SecondIndex(hash));
+  size_--;
+}
+
+bool MdnsNameFilter::MayContain(const DomainName& name) const {
+  return MayContainHash(Hash(name));
+}
+
+bool MdnsNameFilter::MayContain(const DomainNameView& name) const {
+  return MayContainHash(Hash(name));
+}
+
+bool MdnsNameFilter::MayContainHash(uint64_t hash) const {
+  return counters_[FirstIndex(hash)] != 0 && counters_[SecondIndex(hash)] != 0;
+}
+
+// static
+uint64_t MdnsNameFilter::Hash(const DomainName& name) {
+  return HashLabels(name.labels());
+}
+
+// static
+uint64_t MdnsNameFilter::Hash(const DomainNameView& name) {
+  return HashLabels(name);
+}
+
+// static
+size_t MdnsNameFilter::FirstIndex(uint64_t hash) {
+  return static_cast<size_t>(hash % kCounterCount);
+}
+
+// static
+size_t MdnsNameFilter::SecondIndex(uint64_t hash) {
+  return static_cast<size_t>((hash >> 32) % kCounterCount);
+}
+
+void MdnsNameFilter::Increment(size_t index) {
+  if (counters_[index] != kSaturatedCount) {
+    counters_[index]++;
+  }
+}
+
+void MdnsNameFilter::Decrement(size_t index) {
+  OSP_DCHECK_NE(counters_[index], 0);
+  if (counters_[index] != kSaturatedCount) {
+    counters_[index]--;
+  }
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,72 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_MDNS_NAME_FILTER_H_
+#define DISCOVERY_MDNS_MDNS_NAME_FILTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+namespace openscreen {
+namespace discovery {
+
+class DomainName;
+class DomainNameView;
+
+// A compact, approximate set of domain names, used by MdnsReceiver to drop
+// received messages which contain no names of interest before they are handed
+// to the rest of the mDNS stack.
+//
+// This is a counting Bloom filter: MayContain() always returns true for a name
+// which has been added more times than it has been removed, but may also
+// return true for names which have never been added.  Like DomainName, names
+// are compared ignoring case.
+class MdnsNameFilter {
+ public:
+  MdnsNameFilter();
+  ~MdnsNameFilter();
+
+  // Every call to Add() for a name must be matched by one call to Remove() for
+  // that name before the name stops matching.
+  void Add(const DomainName& name);
+  void Remove(const DomainName& name);
+
+  bool MayContain(const DomainName& name) const;
+  bool MayContain(const DomainNameView& name) const;
+
+  // Checks a name hashed with Hash() below, so that a name which is checked
+  // against several filters only needs to be hashed once.
+  bool MayContainHash(uint64_t hash) const;
+
+  // Returns the number of names which have been added and not removed.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  static uint64_t Hash(const DomainName& name);
+  static uint64_t Hash(const DomainNameView& name);
+
+ private:
+  static constexpr size_t kCounterCount = 2048;
+  static constexpr uint8_t kSaturatedCount = UINT8_MAX;
+
+  static size_t FirstIndex(uint64_t hash);
+  static size_t SecondIndex(uint64_t hash);
+
+  void Increment(size_t index);
+  void Decrement(size_t index);
+
+  // Each name is recorded in the two counters selected by its hash.  A counter
+  // which reaches kSaturatedCount is never decremented again, so that it
+  // cannot wrongly reach zero while names which map to it are still present.
+  std::array<uint8_t, kCounterCount> counters_{};
+
+  size_t size_ = 0;
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_MDNS_NAME_FILTER_H_
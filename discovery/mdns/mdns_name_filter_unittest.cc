@@ -0,0 +1,109 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_name_filter.h"
+
+#include <string>
+
+#include "discovery/common/config.h"
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_reader.h"
+#include "discovery/mdns/mdns_records.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace discovery {
+
+TEST(MdnsNameFilterTest, ContainsAddedNames) {
+  MdnsNameFilter filter;
+  EXPECT_TRUE(filter.empty());
+  EXPECT_FALSE(filter.MayContain(DomainName{"testing", "local"}));
+
+  filter.Add(DomainName{"testing", "local"});
+  filter.Add(DomainName{"_googlecast", "_tcp", "local"});
+  EXPECT_EQ(filter.size(), 2u);
+  EXPECT_TRUE(filter.MayContain(DomainName{"testing", "local"}));
+  EXPECT_TRUE(filter.MayContain(DomainName{"TESTING", "Local"}));
+  EXPECT_TRUE(filter.MayContain(DomainName{"_googlecast", "_tcp", "local"}));
+}
+
+TEST(MdnsNameFilterTest, RemovesNamesOnceAllCopiesAreRemoved) {
+  const DomainName name{"testing", "local"};
+  MdnsNameFilter filter;
+  filter.Add(name);
+  filter.Add(name);
+
+  filter.Remove(name);
+  EXPECT_TRUE(filter.MayContain(name));
+  filter.Remove(name);
+  EXPECT_FALSE(filter.MayContain(name));
+  EXPECT_TRUE(filter.empty());
+}
+
+TEST(MdnsNameFilterTest, HashesDependOnLabelBoundaries) {
+  EXPECT_NE(MdnsNameFilter::Hash(DomainName{"ab", "c"}),
+            MdnsNameFilter::Hash(DomainName{"a", "bc"}));
+  EXPECT_EQ(MdnsNameFilter::Hash(DomainName{"ab", "c"}),
+            MdnsNameFilter::Hash(DomainName{"AB", "C"}));
+}
+
+TEST(MdnsNameFilterTest, RejectsMostOtherNames) {
+  MdnsNameFilter filter;
+  for (int i = 0; i < 64; ++i) {
+    filter.Add(DomainName{"instance" + std::to_string(i), "local"});
+  }
+
+  int false_positives = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (filter.MayContain(DomainName{"other" + std::to_string(i), "local"})) {
+      false_positives++;
+    }
+  }
+  // With 64 names the expected false positive rate is below 0.5%.
+  EXPECT_LT(false_positives, 25);
+}
+
+TEST(MdnsNameFilterTest, MatchesNamesInReceivedMessages) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+      0x00, 0x01,  // ID = 1
+      0x84, 0x00,  // FLAGS = AA | RESPONSE
+      0x00, 0x00,  // Question count
+      0x00, 0x02,  // Answer count
+      0x00, 0x00,  // Authority count
+      0x00, 0x00,  // Additional count
+      // Answer 1
+      0x07, 'T', 'e', 's', 't', 'i', 'n', 'g',
+      0x05, 'l', 'o', 'c', 'a', 'l',
+      0x00,
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x04,              // RDLENGTH = 4 bytes
+      0xac, 0x00, 0x00, 0x01,  // 172.0.0.1
+      // Answer 2
+      0x05, 'o', 't', 'h', 'e', 'r',
+      0xc0, 0x14,              // Pointer to "local"
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x04,              // RDLENGTH = 4 bytes
+      0xac, 0x00, 0x00, 0x02,  // 172.0.0.2
+  };
+  // clang-format on
+
+  MdnsReader reader(Config{}, kMessage, sizeof(kMessage));
+  MdnsMessageView message;
+  ASSERT_TRUE(reader.Read(&message).ok());
+  ASSERT_EQ(message.answers().size(), 2u);
+
+  MdnsNameFilter filter;
+  filter.Add(DomainName{"testing", "local"});
+  EXPECT_TRUE(filter.MayContain(message.answers()[0].name()));
+  EXPECT_EQ(MdnsNameFilter::Hash(message.answers()[1].name()),
+            MdnsNameFilter::Hash(DomainName{"other", "local"}));
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,92 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_name_table.h"
+
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_name_filter.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+
+MdnsNameTable::MdnsNameTable() = default;
+
+MdnsNameTable::~MdnsNameTable() = default;
+
+template <typename Name>
+absl::optional<MdnsNameTable::Id> MdnsNameTable::FindWithHash(
+    const Name& name,
+    uint64_t hash) const {
+  const auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (name == entries_[it->second].name) {
+      return it->second;
+    }
+  }
+  return absl::nullopt;
+}
+
+MdnsNameTable::Id MdnsNameTable::Intern(const DomainName& name) {
+  const uint64_t hash = MdnsNameFilter::Hash(name);
+  const absl::optional<Id> existing = FindWithHash(name, hash);
+  if (existing.has_value()) {
+    entries_[existing.value()].references++;
+    return existing.value();
+  }
+
+  Id id;
+  if (free_ids_.empty()) {
+    id = static_cast<Id>(entries_.size());
+    entries_.emplace_back();
+  } else {
+    id = free_ids_.back();
+    free_ids_.pop_back();
+  }
+
+  Entry& entry = entries_[id];
+  entry.name = name;
+  entry.hash = hash;
+  entry.references = 1;
+  index_.emplace(hash, id);
+  return id;
+}
+
+void MdnsNameTable::Release(Id id) {
+  OSP_DCHECK_LT(id, entries_.size());
+  Entry& entry = entries_[id];
+  OSP_DCHECK_GT(entry.references, 0);
+  if (--entry.references > 0) {
+    return;
+  }
+
+  const auto range = index_.equal_range(entry.hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == id) {
+      index_.erase(it);
+      break;
+    }
+  }
+  entry.name = DomainName();
+  free_ids_.push_back(id);
+}
+
+absl::optional<MdnsNameTable::Id> MdnsNameTable::Find(
+    const DomainName& name) const {
+  return FindWithHash(name, MdnsNameFilter::Hash(name));
+}
+
+absl::optional<MdnsNameTable::Id> MdnsNameTable::Find(
+    const DomainNameView& name) const {
+  return FindWithHash(name, MdnsNameFilter::Hash(name));
+}
+
+const DomainName& MdnsNameTable::GetName(Id id) const {
+  OSP_DCHECK_LT(id, entries_.size());
+  OSP_DCHECK_GT(entries_[id].references, 0);
+  return entries_[id].name;
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,102 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_MDNS_NAME_TABLE_H_
+#define DISCOVERY_MDNS_MDNS_NAME_TABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "discovery/mdns/mdns_records.h"
+#include "platform/base/macros.h"
+
+namespace openscreen {
+namespace discovery {
+
+class DomainNameView;
+
+// Interns domain names, assigning each distinct name (ignoring case, as
+// DomainName comparisons do) a small integer ID.  Containers which are keyed
+// by domain name can then be hash maps keyed by ID, so that looking up a name
+// costs one hash of the name and one comparison, instead of a comparison with
+// every name along a path through an ordered map.
+//
+// Names are reference counted: every call to Intern() takes a reference,
+// which is dropped by Release().  A name's ID is stable while it is
+// referenced, and may be reused for a different name once it no longer is.
+class MdnsNameTable {
+ public:
+  using Id = uint32_t;
+
+  MdnsNameTable();
+  ~MdnsNameTable();
+
+  OSP_DISALLOW_COPY_AND_ASSIGN(MdnsNameTable);
+
+  // Returns the ID of |name|, adding it to the table if needed, and takes a
+  // reference to it.
+  Id Intern(const DomainName& name);
+
+  // Drops a reference taken by Intern().
+  void Release(Id id);
+
+  // Returns the ID of |name| if it's in the table.
+  absl::optional<Id> Find(const DomainName& name) const;
+  absl::optional<Id> Find(const DomainNameView& name) const;
+
+  // Returns the name with ID |id|, as it was first interned.
+  const DomainName& GetName(Id id) const;
+
+  // Returns the number of distinct names in the table.
+  size_t size() const { return index_.size(); }
+
+  // Returns the elements of |map|, a hash map keyed by IDs from this table,
+  // whose key is the ID of |name|.
+  template <typename Map, typename Name>
+  std::pair<typename Map::iterator, typename Map::iterator> EqualRange(
+      Map* map,
+      const Name& name) const {
+    const absl::optional<Id> id = Find(name);
+    if (!id.has_value()) {
+      return std::make_pair(map->end(), map->end());
+    }
+    return map->equal_range(id.value());
+  }
+
+  // Returns the element of |map|, a hash map keyed by IDs from this table,
+  // whose key is the ID of |name|, or map->end() if there isn't one.
+  template <typename Map, typename Name>
+  typename Map::iterator FindIn(Map* map, const Name& name) const {
+    const absl::optional<Id> id = Find(name);
+    return id.has_value() ? map->find(id.value()) : map->end();
+  }
+
+ private:
+  struct Entry {
+    DomainName name;
+    uint64_t hash = 0;
+    int references = 0;
+  };
+
+  template <typename Name>
+  absl::optional<Id> FindWithHash(const Name& name, uint64_t hash) const;
+
+  // Indexed by ID. Entries without references are unused, and their IDs are
+  // held in |free_ids_|.
+  std::vector<Entry> entries_;
+  std::vector<Id> free_ids_;
+
+  // Maps the hash of each name in use to its ID.
+  std::unordered_multimap<uint64_t, Id> index_;
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_MDNS_NAME_TABLE_H_
@@ -0,0 +1,120 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_name_table.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "discovery/common/config.h"
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_reader.h"
+#include "gtest/gtest.h"
+
+namespace openscreen {
+namespace discovery {
+
+TEST(MdnsNameTableTest, InternsNamesIgnoringCase) {
+  MdnsNameTable table;
+  const MdnsNameTable::Id id = table.Intern(DomainName{"Testing", "local"});
+  EXPECT_EQ(table.Intern(DomainName{"testing", "LOCAL"}), id);
+  EXPECT_NE(table.Intern(DomainName{"other", "local"}), id);
+  EXPECT_EQ(table.size(), 2u);
+
+  EXPECT_EQ(table.Find(DomainName{"TESTING", "local"}), id);
+  EXPECT_FALSE(table.Find(DomainName{"testing"}).has_value());
+  EXPECT_EQ(table.GetName(id).labels()[0], "Testing");
+}
+
+TEST(MdnsNameTableTest, ReleasesNamesWithoutReferences) {
+  const DomainName name{"testing", "local"};
+  MdnsNameTable table;
+  const MdnsNameTable::Id id = table.Intern(name);
+  table.Intern(name);
+
+  table.Release(id);
+  EXPECT_EQ(table.Find(name), id);
+  table.Release(id);
+  EXPECT_FALSE(table.Find(name).has_value());
+  EXPECT_EQ(table.size(), 0u);
+
+  // The ID is reused for the next name.
+  EXPECT_EQ(table.Intern(DomainName{"other", "local"}), id);
+  EXPECT_EQ(table.GetName(id), (DomainName{"other", "local"}));
+}
+
+TEST(MdnsNameTableTest, HandlesManyNames) {
+  MdnsNameTable table;
+  for (int i = 0; i < 1000; ++i) {
+    table.Intern(DomainName{"instance" + std::to_string(i), "local"});
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    const absl::optional<MdnsNameTable::Id> id =
+        table.Find(DomainName{"instance" + std::to_string(i), "local"});
+    ASSERT_TRUE(id.has_value());
+    table.Release(id.value());
+  }
+
+  EXPECT_EQ(table.size(), 500u);
+  for (int i = 0; i < 1000; ++i) {
+    const DomainName name{"instance" + std::to_string(i), "local"};
+    const absl::optional<MdnsNameTable::Id> id = table.Find(name);
+    ASSERT_EQ(id.has_value(), i % 2 == 1) << name;
+    if (id.has_value()) {
+      EXPECT_EQ(table.GetName(id.value()), name);
+    }
+  }
+}
+
+TEST(MdnsNameTableTest, FindsEntriesInMapsKeyedById) {
+  MdnsNameTable table;
+  std::unordered_multimap<MdnsNameTable::Id, int> map;
+  map.emplace(table.Intern(DomainName{"testing", "local"}), 1);
+  map.emplace(table.Intern(DomainName{"testing", "local"}), 2);
+  map.emplace(table.Intern(DomainName{"other", "local"}), 3);
+
+  auto range = table.EqualRange(&map, DomainName{"TESTING", "local"});
+  EXPECT_EQ(std::distance(range.first, range.second), 2);
+  range = table.EqualRange(&map, DomainName{"missing", "local"});
+  EXPECT_EQ(range.first, map.end());
+  EXPECT_EQ(range.second, map.end());
+
+  EXPECT_EQ(table.FindIn(&map, DomainName{"other", "local"})->second, 3);
+  EXPECT_EQ(table.FindIn(&map, DomainName{"missing", "local"}), map.end());
+}
+
+TEST(MdnsNameTableTest, FindsNamesInReceivedMessages) {
+  // clang-format off
+  constexpr uint8_t kMessage[] = {
+      0x00, 0x01,  // ID = 1
+      0x84, 0x00,  // FLAGS = AA | RESPONSE
+      0x00, 0x00,  // Question count
+      0x00, 0x01,  // Answer count
+      0x00, 0x00,  // Authority count
+      0x00, 0x00,  // Additional count
+      // Answer
+      0x07, 'T', 'e', 's', 't', 'i', 'n', 'g',
+      0x05, 'l', 'o', 'c', 'a', 'l',
+      0x00,
+      0x00, 0x01,              // TYPE = A (1)
+      0x00, 0x01,              // CLASS = IN (1)
+      0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+      0x00, 0x04,              // RDLENGTH = 4 bytes
+      0xac, 0x00, 0x00, 0x01,  // 172.0.0.1
+  };
+  // clang-format on
+
+  MdnsReader reader(Config{}, kMessage, sizeof(kMessage));
+  MdnsMessageView message;
+  ASSERT_TRUE(reader.Read(&message).ok());
+  ASSERT_EQ(message.answers().size(), 1u);
+
+  MdnsNameTable table;
+  EXPECT_FALSE(table.Find(message.answers()[0].name()).has_value());
+  const MdnsNameTable::Id id = table.Intern(DomainName{"testing", "local"});
+  EXPECT_EQ(table.Find(message.answers()[0].name()), id);
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -46,6 +46,7 @@ MdnsProbeImpl::MdnsProbeImpl(MdnsSender* sender,
   OSP_DCHECK(task_runner_);
   OSP_DCHECK(observer_);
 
+  name_filter_.Add(this->target_name());
   receiver_->AddResponseCallback(this);
   alarm_.ScheduleFromNow([this]() { ProbeOnce(); },
                          random_delay_->GetInitialProbeDelay());
@@ -96,11 +97,15 @@ void MdnsProbeImpl::Postpone(std::chrono::seconds delay) {
   alarm_.ScheduleFromNow([this]() { ProbeOnce(); }, Clock::to_duration(delay));
 }
 
-void MdnsProbeImpl::OnMessageReceived(const MdnsMessage& message) {
+const MdnsNameFilter* MdnsProbeImpl::GetNameFilter() const {
+  return &name_filter_;
+}
+
+void MdnsProbeImpl::OnMessageReceived(const MdnsMessageView& message) {
   OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
   OSP_DCHECK(message.type() == MessageType::Response);
 
-  for (const auto& record : message.answers()) {
+  for (const MdnsRecordView& record : message.answers()) {
     if (record.name() == target_name()) {
       Stop();
       observer_->OnProbeFailure(this);
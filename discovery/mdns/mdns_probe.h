@@ -105,7 +105,8 @@ class MdnsProbeImpl : public MdnsProbe {
   void Stop();
 
   // MdnsReceiver::ResponseClient overrides.
-  void OnMessageReceived(const MdnsMessage& message) override;
+  void OnMessageReceived(const MdnsMessageView& message) override;
+  const MdnsNameFilter* GetNameFilter() const override;
 
   MdnsRandom* const random_delay_;
   TaskRunner* const task_runner_;
@@ -119,6 +120,9 @@ class MdnsProbeImpl : public MdnsProbe {
   MdnsReceiver* const receiver_;
   Observer* const observer_;
 
+  // Holds only the target name, the only name this probe listens for.
+  MdnsNameFilter name_filter_;
+
   int successful_probe_queries_ = 0;
   bool is_running_ = true;
 };
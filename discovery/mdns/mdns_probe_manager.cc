@@ -38,6 +38,10 @@ DomainName CreateRetryDomainName(const DomainName& name, int attempt) {
 
 MdnsProbeManager::~MdnsProbeManager() = default;
 
+const MdnsNameFilter* MdnsProbeManager::GetNameFilter() const {
+  return nullptr;
+}
+
 MdnsProbeManagerImpl::MdnsProbeManagerImpl(MdnsSender* sender,
                                            MdnsReceiver* receiver,
                                            MdnsRandom* random_delay,
@@ -73,6 +77,7 @@ Error MdnsProbeManagerImpl::StartProbe(MdnsDomainConfirmedProvider* callback,
 
   // Begin a new probe.
   auto probe = CreateProbe(requested_name, std::move(address));
+  name_filter_.Add(probe->target_name());
   ongoing_probes_.emplace_back(std::move(probe), std::move(requested_name),
                                callback);
   return Error::None();
@@ -84,6 +89,7 @@ Error MdnsProbeManagerImpl::StopProbe(const DomainName& requested_name) {
     return Error::Code::kItemNotFound;
   }
 
+  name_filter_.Remove(it->probe->target_name());
   ongoing_probes_.erase(it);
   return Error::None();
 }
@@ -92,6 +98,10 @@ bool MdnsProbeManagerImpl::IsDomainClaimed(const DomainName& domain) const {
   return FindCompletedProbe(domain) != completed_probes_.end();
 }
 
+const MdnsNameFilter* MdnsProbeManagerImpl::GetNameFilter() const {
+  return &name_filter_;
+}
+
 void MdnsProbeManagerImpl::RespondToProbeQuery(const MdnsMessage& message,
                                                const IPEndpoint& src) {
   OSP_DCHECK(!message.questions().empty());
@@ -209,11 +219,14 @@ void MdnsProbeManagerImpl::OnProbeFailure(MdnsProbe* probe) {
   if (completed_it != completed_probes_.end()) {
     DomainName requested_name = std::move(ongoing_it->requested_name);
     MdnsDomainConfirmedProvider* callback = ongoing_it->callback;
+    name_filter_.Remove(ongoing_it->probe->target_name());
     ongoing_probes_.erase(ongoing_it);
     callback->OnDomainFound(requested_name, (*completed_it)->target_name());
   } else {
     std::unique_ptr<MdnsProbe> new_probe =
         CreateProbe(std::move(new_name), ongoing_it->probe->address());
+    name_filter_.Remove(ongoing_it->probe->target_name());
+    name_filter_.Add(new_probe->target_name());
     ongoing_it->probe = std::move(new_probe);
   }
 }
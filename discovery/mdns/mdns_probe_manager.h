@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "discovery/mdns/mdns_domain_confirmed_provider.h"
+#include "discovery/mdns/mdns_name_filter.h"
 #include "discovery/mdns/mdns_probe.h"
 #include "discovery/mdns/mdns_records.h"
 #include "platform/base/error.h"
@@ -46,6 +47,10 @@ class MdnsProbeManager {
   // the response message may be sent as a unicast response.
   virtual void RespondToProbeQuery(const MdnsMessage& message,
                                    const IPEndpoint& src) = 0;
+
+  // Returns a filter holding every domain name which has been claimed or is
+  // being probed for, or nullptr if no such filter is maintained.
+  virtual const MdnsNameFilter* GetNameFilter() const;
 };
 
 // This class is responsible for managing all ongoing probes for claiming domain
@@ -87,6 +92,7 @@ class MdnsProbeManagerImpl : public MdnsProbe::Observer,
   bool IsDomainClaimed(const DomainName& domain) const override;
   void RespondToProbeQuery(const MdnsMessage& message,
                            const IPEndpoint& src) override;
+  const MdnsNameFilter* GetNameFilter() const override;
 
  private:
   friend class TestMdnsProbeManager;
@@ -143,6 +149,10 @@ class MdnsProbeManagerImpl : public MdnsProbe::Observer,
   // The set of all currently ongoing probes. This set is expected to remain
   // small.
   std::vector<OngoingProbe> ongoing_probes_;
+
+  // Holds the target name of every probe in |completed_probes_| and
+  // |ongoing_probes_|.
+  MdnsNameFilter name_filter_;
 };
 
 }  // namespace discovery
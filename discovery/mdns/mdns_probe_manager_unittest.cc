@@ -46,7 +46,7 @@ class MockMdnsProbe : public MdnsProbe {
       : MdnsProbe(std::move(target_name), std::move(address)) {}
 
   MOCK_METHOD1(Postpone, void(std::chrono::seconds));
-  MOCK_METHOD1(OnMessageReceived, void(const MdnsMessage&));
+  MOCK_METHOD1(OnMessageReceived, void(const MdnsMessageView&));
 };
 
 class TestMdnsProbeManager : public MdnsProbeManagerImpl {
@@ -5,13 +5,16 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "discovery/common/config.h"
 #include "discovery/mdns/mdns_probe_manager.h"
 #include "discovery/mdns/mdns_querier.h"
 #include "discovery/mdns/mdns_random.h"
+#include "discovery/mdns/mdns_reader.h"
 #include "discovery/mdns/mdns_receiver.h"
 #include "discovery/mdns/mdns_sender.h"
+#include "discovery/mdns/mdns_writer.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/test/fake_clock.h"
@@ -71,7 +74,13 @@ class MdnsProbeTests : public testing::Test {
   }
 
   void OnMessageReceived(const MdnsMessage& message) {
-    probe_->OnMessageReceived(message);
+    std::vector<uint8_t> buffer(message.MaxWireSize());
+    MdnsWriter writer(buffer.data(), buffer.size());
+    ASSERT_TRUE(writer.Write(message));
+    MdnsReader reader(config_, buffer.data(), writer.offset());
+    MdnsMessageView view;
+    ASSERT_TRUE(reader.Read(&view).ok());
+    probe_->OnMessageReceived(view);
   }
 
   Config config_;
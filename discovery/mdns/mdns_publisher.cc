@@ -8,6 +8,7 @@
 #include <cmath>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/mdns_encoded_record.h"
 #include "discovery/mdns/mdns_probe_manager.h"
 #include "discovery/mdns/mdns_records.h"
 #include "discovery/mdns/mdns_sender.h"
@@ -38,8 +39,11 @@ inline MdnsRecord CreateGoodbyeRecord(const MdnsRecord& record) {
   if (record.ttl() == kGoodbyeTtl) {
     return record;
   }
-  return MdnsRecord(record.name(), record.dns_type(), record.dns_class(),
-                    record.record_type(), kGoodbyeTtl, record.rdata());
+  MdnsRecord goodbye(record.name(), record.dns_type(), record.dns_class(),
+                     record.record_type(), kGoodbyeTtl, record.rdata());
+  // MdnsWriter writes the TTL separately, so the encoded form can be shared.
+  goodbye.set_encoded(record.encoded());
+  return goodbye;
 }
 
 }  // namespace
@@ -80,7 +84,12 @@ Error MdnsPublisher::RegisterRecord(const MdnsRecord& record) {
   }
 
   const DomainName& name = record.name();
-  auto it = records_.emplace(name, std::vector<RecordAnnouncerPtr>{}).first;
+  auto it = names_.FindIn(&records_, name);
+  if (it == records_.end()) {
+    const MdnsNameTable::Id id = names_.Intern(name);
+    it = records_.emplace(id, std::vector<RecordAnnouncerPtr>()).first;
+    name_filter_.Add(name);
+  }
   for (const RecordAnnouncerPtr& publisher : it->second) {
     if (publisher->record() == record) {
       return Error::Code::kItemAlreadyExists;
@@ -89,7 +98,9 @@ Error MdnsPublisher::RegisterRecord(const MdnsRecord& record) {
 
   OSP_DVLOG << "Registering record of type '" << record.dns_type() << "'";
 
-  it->second.push_back(CreateAnnouncer(record));
+  // Published records are sent far more often than they change, so encode
+  // each one up front.
+  it->second.push_back(CreateAnnouncer(MdnsEncodedRecord::Precompile(record)));
 
   return Error::None();
 }
@@ -166,7 +177,7 @@ std::vector<MdnsRecord::ConstRef> MdnsPublisher::GetRecords(
   OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
 
   std::vector<MdnsRecord::ConstRef> records;
-  auto it = records_.find(name);
+  auto it = names_.FindIn(&records_, name);
   if (it != records_.end()) {
     for (const RecordAnnouncerPtr& announcer : it->second) {
       OSP_DCHECK(announcer.get());
@@ -182,6 +193,10 @@ std::vector<MdnsRecord::ConstRef> MdnsPublisher::GetRecords(
   return records;
 }
 
+const MdnsNameFilter* MdnsPublisher::GetNameFilter() const {
+  return &name_filter_;
+}
+
 std::vector<MdnsRecord::ConstRef> MdnsPublisher::GetPtrRecords(DnsClass clazz) {
   std::vector<MdnsRecord::ConstRef> records;
 
@@ -211,7 +226,7 @@ Error MdnsPublisher::RemoveRecord(const MdnsRecord& record,
   const DomainName& name = record.name();
 
   // Check for the domain and fail if it's not found.
-  const auto it = records_.find(name);
+  const auto it = names_.FindIn(&records_, name);
   if (it == records_.end()) {
     return Error::Code::kItemNotFound;
   }
@@ -231,6 +246,8 @@ Error MdnsPublisher::RemoveRecord(const MdnsRecord& record,
 
   it->second.erase(records_it);
   if (it->second.empty()) {
+    name_filter_.Remove(name);
+    names_.Release(it->first);
     records_.erase(it);
   }
 
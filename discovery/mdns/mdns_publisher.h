@@ -5,12 +5,14 @@
 #ifndef DISCOVERY_MDNS_MDNS_PUBLISHER_H_
 #define DISCOVERY_MDNS_MDNS_PUBLISHER_H_
 
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "discovery/mdns/mdns_name_filter.h"
+#include "discovery/mdns/mdns_name_table.h"
 #include "discovery/mdns/mdns_records.h"
 #include "discovery/mdns/mdns_responder.h"
 #include "util/alarm.h"
@@ -176,6 +178,7 @@ class MdnsPublisher : public MdnsResponder::RecordHandler {
                                                DnsType type,
                                                DnsClass clazz) override;
   std::vector<MdnsRecord::ConstRef> GetPtrRecords(DnsClass clazz) override;
+  const MdnsNameFilter* GetNameFilter() const override;
 
   MdnsSender* const sender_;
   MdnsProbeManager* const ownership_manager_;
@@ -192,12 +195,21 @@ class MdnsPublisher : public MdnsResponder::RecordHandler {
   // The queue for announce and goodbye records to be sent periodically.
   std::vector<MdnsRecord> records_to_send_;
 
-  // Stores mDNS records that have been published. The keys here are domain
-  // names for valid mDNS Records, and the values are the RecordAnnouncer
-  // entities associated with all published MdnsRecords for the keyed domain.
-  // These are responsible for publishing a specific MdnsRecord, announcing it
-  // when its created and sending a goodbye record when it's deleted.
-  std::map<DomainName, std::vector<RecordAnnouncerPtr>> records_;
+  // Holds the names of the keys of |records_|.
+  MdnsNameFilter name_filter_;
+
+  // Interns the names of the keys of |records_|, each of which holds one
+  // reference to its name.
+  MdnsNameTable names_;
+
+  // Stores mDNS records that have been published. The keys here are the IDs in
+  // |names_| of domain names for valid mDNS Records, and the values are the
+  // RecordAnnouncer entities associated with all published MdnsRecords for the
+  // keyed domain. These are responsible for publishing a specific MdnsRecord,
+  // announcing it when its created and sending a goodbye record when it's
+  // deleted.
+  std::unordered_map<MdnsNameTable::Id, std::vector<RecordAnnouncerPtr>>
+      records_;
 };
 
 }  // namespace discovery
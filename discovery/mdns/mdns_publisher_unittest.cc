@@ -57,7 +57,7 @@ class MdnsPublisherTesting : public MdnsPublisher {
   using MdnsPublisher::MdnsPublisher;
 
   bool IsNonPtrRecordPresent(const DomainName& name) {
-    auto it = records_.find(name);
+    auto it = names_.FindIn(&records_, name);
     if (it == records_.end()) {
       return false;
     }
@@ -246,7 +246,7 @@ MdnsQuerier::RecordTrackerLruCache::Find(const DomainName& name,
                                          DnsType dns_type,
                                          DnsClass dns_class) {
   std::vector<RecordTrackerConstRef> results;
-  auto pair = records_.equal_range(name);
+  auto pair = querier_->names_.EqualRange(&records_, name);
   for (auto it = pair.first; it != pair.second; it++) {
     const MdnsRecordTracker& tracker = *it->second;
     if ((dns_type == DnsType::kANY || dns_type == tracker.dns_type()) &&
@@ -258,12 +258,20 @@ MdnsQuerier::RecordTrackerLruCache::Find(const DomainName& name,
   return results;
 }
 
+bool MdnsQuerier::RecordTrackerLruCache::HasRecordsFor(
+    const DomainNameView& name) const {
+  const absl::optional<MdnsNameTable::Id> id = querier_->names_.Find(name);
+  return id.has_value() && records_.find(id.value()) != records_.end();
+}
+
 int MdnsQuerier::RecordTrackerLruCache::Erase(const DomainName& domain,
                                               TrackerApplicableCheck check) {
-  auto pair = records_.equal_range(domain);
+  auto pair = querier_->names_.EqualRange(&records_, domain);
   int count = 0;
   for (RecordMap::iterator it = pair.first; it != pair.second;) {
     if (check(*it->second)) {
+      querier_->name_filter_.Remove(domain);
+      querier_->names_.Release(it->first);
       lru_order_.erase(it->second);
       it = records_.erase(it);
       count++;
@@ -278,7 +286,7 @@ int MdnsQuerier::RecordTrackerLruCache::Erase(const DomainName& domain,
 int MdnsQuerier::RecordTrackerLruCache::ExpireSoon(
     const DomainName& domain,
     TrackerApplicableCheck check) {
-  auto pair = records_.equal_range(domain);
+  auto pair = querier_->names_.EqualRange(&records_, domain);
   int count = 0;
   for (RecordMap::iterator it = pair.first; it != pair.second; it++) {
     if (check(*it->second)) {
@@ -300,7 +308,7 @@ int MdnsQuerier::RecordTrackerLruCache::Update(
     const MdnsRecord& record,
     TrackerApplicableCheck check,
     TrackerChangeCallback on_rdata_update) {
-  auto pair = records_.equal_range(record.name());
+  auto pair = querier_->names_.EqualRange(&records_, record.name());
   int count = 0;
   for (RecordMap::iterator it = pair.first; it != pair.second; it++) {
     if (check(*it->second)) {
@@ -329,7 +337,23 @@ int MdnsQuerier::RecordTrackerLruCache::Update(
   return count;
 }
 
-const MdnsRecordTracker& MdnsQuerier::RecordTrackerLruCache::StartTracking(
+std::vector<MdnsRecord> MdnsQuerier::RecordTrackerLruCache::GetRecords()
+    const {
+  std::vector<MdnsRecord> records;
+  records.reserve(lru_order_.size());
+  for (const MdnsRecordTracker& tracker : lru_order_) {
+    const std::chrono::seconds ttl = tracker.GetRemainingTtl();
+    if (tracker.is_negative_response() || ttl == std::chrono::seconds(0)) {
+      continue;
+    }
+    records.emplace_back(tracker.name(), tracker.dns_type(),
+                         tracker.dns_class(), tracker.record_type(), ttl,
+                         tracker.rdata());
+  }
+  return records;
+}
+
+MdnsRecordTracker& MdnsQuerier::RecordTrackerLruCache::StartTracking(
     MdnsRecord record,
     DnsType dns_type) {
   auto expiration_callback = [this](const MdnsRecordTracker* tracker,
@@ -345,11 +369,12 @@ const MdnsRecordTracker& MdnsQuerier::RecordTrackerLruCache::StartTracking(
     lru_order_.back().ExpireNow();
   }
 
-  auto name = record.name();
+  const MdnsNameTable::Id name = querier_->names_.Intern(record.name());
+  querier_->name_filter_.Add(record.name());
   lru_order_.emplace_front(std::move(record), dns_type, sender_, task_runner_,
                            now_function_, random_delay_,
                            std::move(expiration_callback));
-  records_.emplace(std::move(name), lru_order_.begin());
+  records_.emplace(name, lru_order_.begin());
 
   return lru_order_.front();
 }
@@ -380,6 +405,7 @@ MdnsQuerier::MdnsQuerier(MdnsSender* sender,
       random_delay_(random_delay),
       reporting_client_(reporting_client),
       config_(std::move(config)),
+      query_aggregator_(sender_, task_runner_, now_function_),
       records_(this,
                sender_,
                random_delay_,
@@ -414,7 +440,7 @@ void MdnsQuerier::StartQuery(const DomainName& name,
   OSP_DCHECK(CanBeQueried(dns_type));
 
   // Add a new callback if haven't seen it before
-  auto callbacks_it = callbacks_.equal_range(name);
+  auto callbacks_it = names_.EqualRange(&callbacks_, name);
   for (auto entry = callbacks_it.first; entry != callbacks_it.second; ++entry) {
     const CallbackInfo& callback_info = entry->second;
     if (dns_type == callback_info.dns_type &&
@@ -424,7 +450,8 @@ void MdnsQuerier::StartQuery(const DomainName& name,
       return;
     }
   }
-  callbacks_.emplace(name, CallbackInfo{callback, dns_type, dns_class});
+  callbacks_.emplace(names_.Intern(name),
+                     CallbackInfo{callback, dns_type, dns_class});
 
   // Notify the new callback with previously cached records.
   // NOTE: In the future, could allow callers to fetch cached records after
@@ -445,7 +472,7 @@ void MdnsQuerier::StartQuery(const DomainName& name,
   }
 
   // Add a new question if haven't seen it before
-  auto questions_it = questions_.equal_range(name);
+  auto questions_it = names_.EqualRange(&questions_, name);
   const bool is_question_already_tracked =
       std::find_if(questions_it.first, questions_it.second,
                    [dns_type, dns_class](const auto& entry) {
@@ -476,12 +503,13 @@ void MdnsQuerier::StopQuery(const DomainName& name,
 
   // Find and remove the callback.
   int callbacks_for_key = 0;
-  auto callbacks_it = callbacks_.equal_range(name);
+  auto callbacks_it = names_.EqualRange(&callbacks_, name);
   for (auto entry = callbacks_it.first; entry != callbacks_it.second;) {
     const CallbackInfo& callback_info = entry->second;
     if (dns_type == callback_info.dns_type &&
         dns_class == callback_info.dns_class) {
       if (callback == callback_info.callback) {
+        names_.Release(entry->first);
         entry = callbacks_.erase(entry);
       } else {
         ++callbacks_for_key;
@@ -497,11 +525,13 @@ void MdnsQuerier::StopQuery(const DomainName& name,
   }
 
   // Find and delete a question that does not have any associated callbacks
-  auto questions_it = questions_.equal_range(name);
+  auto questions_it = names_.EqualRange(&questions_, name);
   for (auto entry = questions_it.first; entry != questions_it.second; ++entry) {
     const MdnsQuestion& tracked_question = entry->second->question();
     if (dns_type == tracked_question.dns_type() &&
         dns_class == tracked_question.dns_class()) {
+      name_filter_.Remove(name);
+      names_.Release(entry->first);
       questions_.erase(entry);
       return;
     }
@@ -513,14 +543,20 @@ void MdnsQuerier::ReinitializeQueries(const DomainName& name) {
 
   // Get the ongoing queries and their callbacks.
   std::vector<CallbackInfo> callbacks;
-  auto its = callbacks_.equal_range(name);
-  for (auto it = its.first; it != its.second; it++) {
+  auto its = names_.EqualRange(&callbacks_, name);
+  for (auto it = its.first; it != its.second;) {
     callbacks.push_back(std::move(it->second));
+    names_.Release(it->first);
+    it = callbacks_.erase(it);
   }
-  callbacks_.erase(name);
 
   // Remove all known questions and answers.
-  questions_.erase(name);
+  auto questions_it = names_.EqualRange(&questions_, name);
+  for (auto it = questions_it.first; it != questions_it.second;) {
+    name_filter_.Remove(name);
+    names_.Release(it->first);
+    it = questions_.erase(it);
+  }
   records_.Erase(name, [](const MdnsRecordTracker& tracker) { return true; });
 
   // Restart the queries.
@@ -529,7 +565,43 @@ void MdnsQuerier::ReinitializeQueries(const DomainName& name) {
   }
 }
 
-void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
+std::vector<MdnsRecord> MdnsQuerier::GetCachedRecords() const {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+  return records_.GetRecords();
+}
+
+void MdnsQuerier::RestoreCachedRecords(std::vector<MdnsRecord> records) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  // Records are given most recently updated first, so add them in reverse to
+  // keep the same LRU order.
+  for (auto it = records.rbegin(); it != records.rend(); ++it) {
+    const MdnsRecord& record = *it;
+    if (!CanBeProcessed(record.dns_type()) ||
+        record.dns_type() == DnsType::kNSEC ||
+        record.ttl() == std::chrono::seconds(0)) {
+      continue;
+    }
+
+    const std::vector<RecordTrackerLruCache::RecordTrackerConstRef> trackers =
+        records_.Find(record.name(), record.dns_type(), record.dns_class());
+    const bool is_cached =
+        std::any_of(trackers.begin(), trackers.end(),
+                    [&record](const MdnsRecordTracker& tracker) {
+                      return record.record_type() == RecordType::kUnique ||
+                             tracker.rdata() == record.rdata();
+                    });
+    if (!is_cached) {
+      AddRecord(record, record.dns_type()).MarkTentative();
+    }
+  }
+}
+
+const MdnsNameFilter* MdnsQuerier::GetNameFilter() const {
+  return &name_filter_;
+}
+
+void MdnsQuerier::OnMessageReceived(const MdnsMessageView& message) {
   OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
   OSP_DCHECK(message.type() == MessageType::Response);
 
@@ -542,9 +614,17 @@ void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
 
   // Add any records that are relevant for this querier.
   bool found_relevant_records = false;
-  for (const MdnsRecord& record : message.answers()) {
-    if (ShouldAnswerRecordBeProcessed(record)) {
-      records_to_process.push_back(record);
+  for (const MdnsRecordView& view : message.answers()) {
+    if (!IsNameTracked(view.name())) {
+      continue;
+    }
+    ErrorOr<MdnsRecord> record = view.ToOwned(config_);
+    if (record.is_error()) {
+      OSP_DVLOG << "\tDropping malformed mDNS record...";
+      continue;
+    }
+    if (ShouldAnswerRecordBeProcessed(record.value())) {
+      records_to_process.push_back(std::move(record.value()));
       found_relevant_records = true;
     }
   }
@@ -552,9 +632,18 @@ void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
   // If any of the message's answers are relevant, add all additional records.
   // Else, since the message has already been received and parsed, use any
   // individual records relevant to this querier to update the cache.
-  for (const MdnsRecord& record : message.additional_records()) {
-    if (found_relevant_records || ShouldAnswerRecordBeProcessed(record)) {
-      records_to_process.push_back(record);
+  for (const MdnsRecordView& view : message.additional_records()) {
+    if (!found_relevant_records && !IsNameTracked(view.name())) {
+      continue;
+    }
+    ErrorOr<MdnsRecord> record = view.ToOwned(config_);
+    if (record.is_error()) {
+      OSP_DVLOG << "\tDropping malformed mDNS record...";
+      continue;
+    }
+    if (found_relevant_records ||
+        ShouldAnswerRecordBeProcessed(record.value())) {
+      records_to_process.push_back(std::move(record.value()));
     }
   }
 
@@ -572,9 +661,18 @@ void MdnsQuerier::OnMessageReceived(const MdnsMessage& message) {
   // TODO(crbug.com/openscreen/83): Check authority records.
 }
 
+bool MdnsQuerier::IsNameTracked(const DomainNameView& name) const {
+  if (!name_filter_.MayContain(name)) {
+    return false;
+  }
+  const absl::optional<MdnsNameTable::Id> id = names_.Find(name);
+  return (id.has_value() && questions_.find(id.value()) != questions_.end()) ||
+         records_.HasRecordsFor(name);
+}
+
 bool MdnsQuerier::ShouldAnswerRecordBeProcessed(const MdnsRecord& answer) {
   // First, accept the record if it's associated with an ongoing question.
-  const auto questions_range = questions_.equal_range(answer.name());
+  const auto questions_range = names_.EqualRange(&questions_, answer.name());
   const auto it = std::find_if(
       questions_range.first, questions_range.second,
       [&answer](const auto& pair) {
@@ -799,7 +897,7 @@ void MdnsQuerier::ProcessCallbacks(const MdnsRecord& record,
   OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
 
   std::vector<PendingQueryChange> pending_changes;
-  auto callbacks_it = callbacks_.equal_range(record.name());
+  auto callbacks_it = names_.EqualRange(&callbacks_, record.name());
   for (auto entry = callbacks_it.first; entry != callbacks_it.second; ++entry) {
     const CallbackInfo& callback_info = entry->second;
     if ((callback_info.dns_type == DnsType::kANY ||
@@ -818,9 +916,12 @@ void MdnsQuerier::ProcessCallbacks(const MdnsRecord& record,
 
 void MdnsQuerier::AddQuestion(const MdnsQuestion& question) {
   auto question_tracker = std::make_unique<MdnsQuestionTracker>(
-      question, sender_, task_runner_, now_function_, random_delay_, config_);
+      question, sender_, task_runner_, now_function_, random_delay_, config_,
+      MdnsQuestionTracker::QueryType::kContinuous, &query_aggregator_);
   MdnsQuestionTracker* ptr = question_tracker.get();
-  questions_.emplace(question.name(), std::move(question_tracker));
+  questions_.emplace(names_.Intern(question.name()),
+                     std::move(question_tracker));
+  name_filter_.Add(question.name());
 
   // Let all records associated with this question know that there is a new
   // query that can be used for their refresh.
@@ -833,13 +934,14 @@ void MdnsQuerier::AddQuestion(const MdnsQuestion& question) {
   }
 }
 
-void MdnsQuerier::AddRecord(const MdnsRecord& record, DnsType type) {
+MdnsRecordTracker& MdnsQuerier::AddRecord(const MdnsRecord& record,
+                                          DnsType type) {
   // Add the new record.
-  const auto& tracker = records_.StartTracking(record, type);
+  MdnsRecordTracker& tracker = records_.StartTracking(record, type);
 
   // Let all questions associated with this record know that there is a new
   // record that answers them (for known answer suppression).
-  auto query_it = questions_.equal_range(record.name());
+  auto query_it = names_.EqualRange(&questions_, record.name());
   for (auto entry = query_it.first; entry != query_it.second; ++entry) {
     const MdnsQuestion& query = entry->second->question();
     const bool is_relevant_type =
@@ -852,6 +954,8 @@ void MdnsQuerier::AddRecord(const MdnsRecord& record, DnsType type) {
       entry->second->AddAssociatedRecord(&tracker);
     }
   }
+
+  return tracker;
 }
 
 void MdnsQuerier::ApplyPendingChanges(
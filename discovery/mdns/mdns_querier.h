@@ -5,12 +5,17 @@
 #ifndef DISCOVERY_MDNS_MDNS_QUERIER_H_
 #define DISCOVERY_MDNS_MDNS_QUERIER_H_
 
+#include <functional>
 #include <list>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_name_filter.h"
+#include "discovery/mdns/mdns_name_table.h"
+#include "discovery/mdns/mdns_query_aggregator.h"
 #include "discovery/mdns/mdns_receiver.h"
 #include "discovery/mdns/mdns_record_changed_callback.h"
 #include "discovery/mdns/mdns_records.h"
@@ -69,6 +74,17 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
   // received query results are discarded.
   void ReinitializeQueries(const DomainName& name);
 
+  // Returns the records in the cache, most recently updated first, with their
+  // TTLs set to the time left until they expire. Negative responses are not
+  // included.
+  std::vector<MdnsRecord> GetCachedRecords() const;
+
+  // Adds |records|, as returned by GetCachedRecords(), to the cache as
+  // tentative records, so that queries started before the network has been
+  // queried are answered from them straight away. Records which are already
+  // cached are ignored.
+  void RestoreCachedRecords(std::vector<MdnsRecord> records);
+
  private:
   struct CallbackInfo {
     MdnsRecordChangedCallback* const callback;
@@ -101,6 +117,13 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
                                             DnsType dns_type,
                                             DnsClass dns_class);
 
+    // Returns whether any trackers are associated with |name|.
+    bool HasRecordsFor(const DomainNameView& name) const;
+
+    // Returns the records of all trackers which aren't negative responses,
+    // most recently updated first, with their remaining TTLs.
+    std::vector<MdnsRecord> GetRecords() const;
+
     // Calls ExpireSoon on all record trackers in the provided domain which
     // match the provided applicability check. Returns the number of trackers
     // marked for expiry.
@@ -120,13 +143,14 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
 
     // Creates a record tracker of the given type associated with the provided
     // record.
-    const MdnsRecordTracker& StartTracking(MdnsRecord record, DnsType type);
+    MdnsRecordTracker& StartTracking(MdnsRecord record, DnsType type);
 
     size_t size() { return records_.size(); }
 
    private:
     using LruList = std::list<MdnsRecordTracker>;
-    using RecordMap = std::multimap<DomainName, LruList::iterator>;
+    using RecordMap =
+        std::unordered_multimap<MdnsNameTable::Id, LruList::iterator>;
 
     void MoveToBeginning(RecordMap::iterator iterator);
     void MoveToEnd(RecordMap::iterator iterator);
@@ -145,10 +169,10 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
     LruList lru_order_;
 
     // A collection of active known record trackers, each is identified by
-    // domain name, DNS record type, and DNS record class. Multimap key is
-    // domain name only to allow easy support for wildcard processing for DNS
-    // record type and class and allow storing shared records that differ only
-    // in RDATA.
+    // domain name, DNS record type, and DNS record class. Multimap key is the
+    // ID of the domain name in the querier's |names_| only to allow easy
+    // support for wildcard processing for DNS record type and class and allow
+    // storing shared records that differ only in RDATA.
     //
     // MdnsRecordTracker instances are stored as unique_ptr so they are not
     // moved around in memory when the collection is modified. This allows
@@ -160,7 +184,8 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
   friend class MdnsQuerierTest;
 
   // MdnsReceiver::ResponseClient overrides.
-  void OnMessageReceived(const MdnsMessage& message) override;
+  void OnMessageReceived(const MdnsMessageView& message) override;
+  const MdnsNameFilter* GetNameFilter() const override;
 
   // Expires the record tracker provided. This callback is passed to owned
   // MdnsRecordTracker instances in |records_|.
@@ -171,6 +196,10 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
   // or dropped.
   bool ShouldAnswerRecordBeProcessed(const MdnsRecord& answer);
 
+  // Returns whether any question or record with |name| is tracked. Records
+  // with other names can't be processed, so are dropped without being copied.
+  bool IsNameTracked(const DomainNameView& name) const;
+
   // Processes any record update, calling into the below methods as needed.
   // NOTE: All records of type OPT are dropped, as they should not be cached per
   // RFC6891.
@@ -201,7 +230,7 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
   void AddQuestion(const MdnsQuestion& question);
 
   // Begins tracking the provided record.
-  void AddRecord(const MdnsRecord& record, DnsType type);
+  MdnsRecordTracker& AddRecord(const MdnsRecord& record, DnsType type);
 
   // Applies the supplied pending changes.
   void ApplyPendingChanges(std::vector<PendingQueryChange> pending_changes);
@@ -214,24 +243,38 @@ class MdnsQuerier : public MdnsReceiver::ResponseClient {
   ReportingClient* reporting_client_;
   Config config_;
 
+  // Holds the name of every entry in |questions_| and |records_|, so that
+  // responses which don't mention any of them are dropped by MdnsReceiver.
+  MdnsNameFilter name_filter_;
+
+  // Batches the queries of all trackers in |questions_|, so that queries
+  // which become due together share messages.
+  MdnsQueryAggregator query_aggregator_;
+
+  // Interns the keys of |questions_|, |records_| and |callbacks_|. Each entry
+  // in those holds a reference to its name.
+  MdnsNameTable names_;
+
   // A collection of active question trackers, each is uniquely identified by
-  // domain name, DNS record type, and DNS record class. Multimap key is domain
-  // name only to allow easy support for wildcard processing for DNS record type
-  // and class. MdnsQuestionTracker instances are stored as unique_ptr so they
-  // are not moved around in memory when the collection is modified. This allows
-  // passing a pointer to MdnsQuestionTracker to a task running on the
-  // TaskRunner.
-  std::multimap<DomainName, std::unique_ptr<MdnsQuestionTracker>> questions_;
+  // domain name, DNS record type, and DNS record class. Multimap key is the ID
+  // of the domain name only to allow easy support for wildcard processing for
+  // DNS record type and class. MdnsQuestionTracker instances are stored as
+  // unique_ptr so they are not moved around in memory when the collection is
+  // modified. This allows passing a pointer to MdnsQuestionTracker to a task
+  // running on the TaskRunner.
+  std::unordered_multimap<MdnsNameTable::Id,
+                          std::unique_ptr<MdnsQuestionTracker>>
+      questions_;
 
   // Set of records tracked by this querier.
   RecordTrackerLruCache records_;
 
   // A collection of callbacks passed to StartQuery method. Each is identified
   // by domain name, DNS record type, and DNS record class, but there can be
-  // more than one callback for a particular query. Multimap key is domain name
-  // only to allow easy matching of records against callbacks that have wildcard
-  // DNS class and/or DNS type.
-  std::multimap<DomainName, CallbackInfo> callbacks_;
+  // more than one callback for a particular query. Multimap key is the ID of
+  // the domain name only to allow easy matching of records against callbacks
+  // that have wildcard DNS class and/or DNS type.
+  std::unordered_multimap<MdnsNameTable::Id, CallbackInfo> callbacks_;
 };
 
 }  // namespace discovery
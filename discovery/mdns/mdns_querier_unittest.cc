@@ -898,5 +898,51 @@ TEST_F(MdnsQuerierTest, TestMaxRecordsRespected) {
   EXPECT_TRUE(ContainsRecord(querier.get(), record1_created_, DnsType::kA));
 }
 
+TEST_F(MdnsQuerierTest, RestoredRecordsReportedToNewQueries) {
+  std::unique_ptr<MdnsQuerier> querier = CreateQuerier();
+  querier->RestoreCachedRecords({record0_created_, record1_created_});
+  ASSERT_EQ(RecordCount(querier.get()), size_t{2});
+
+  // Records which are already cached aren't restored again.
+  querier->RestoreCachedRecords({record0_updated_, record1_created_});
+  ASSERT_EQ(RecordCount(querier.get()), size_t{2});
+  EXPECT_TRUE(ContainsRecord(querier.get(), record0_created_, DnsType::kA));
+
+  StrictMock<MockRecordChangedCallback> callback;
+  EXPECT_CALL(callback,
+              OnRecordChanged(record0_created_, RecordChangedEvent::kCreated));
+  querier->StartQuery(DomainName{"testing", "local"}, DnsType::kA,
+                      DnsClass::kIN, &callback);
+  testing::Mock::VerifyAndClearExpectations(&callback);
+
+  // Responses from the network replace restored records as usual.
+  EXPECT_CALL(callback,
+              OnRecordChanged(record0_updated_, RecordChangedEvent::kUpdated));
+  receiver_.OnRead(&socket_, CreatePacketWithRecord(record0_updated_));
+}
+
+TEST_F(MdnsQuerierTest, CachedRecordsHaveRemainingTtls) {
+  std::unique_ptr<MdnsQuerier> querier = CreateQuerier();
+  MockRecordChangedCallback callback;
+  querier->StartQuery(DomainName{"testing", "local"}, DnsType::kANY,
+                      DnsClass::kANY, &callback);
+  querier->StartQuery(DomainName{"poking", "local"}, DnsType::kANY,
+                      DnsClass::kANY, &callback);
+  receiver_.OnRead(&socket_, CreatePacketWithRecord(record0_created_));
+  receiver_.OnRead(&socket_,
+                   CreatePacketWithRecord(CreateNsec(
+                       DomainName{"testing", "local"}, DnsType::kAAAA)));
+  clock_.Advance(std::chrono::seconds(10));
+  receiver_.OnRead(&socket_, CreatePacketWithRecord(record1_created_));
+
+  // Negative responses are not included, and the most recently received
+  // record comes first.
+  const std::vector<MdnsRecord> records = querier->GetCachedRecords();
+  ASSERT_EQ(records.size(), size_t{2});
+  EXPECT_EQ(records[0], record1_created_);
+  EXPECT_EQ(records[1].rdata(), record0_created_.rdata());
+  EXPECT_EQ(records[1].ttl(), std::chrono::seconds(110));
+}
+
 }  // namespace discovery
 }  // namespace openscreen
@@ -0,0 +1,103 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_query_aggregator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "discovery/mdns/mdns_sender.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+
+// static
+constexpr std::chrono::milliseconds MdnsQueryAggregator::kAggregationWindow;
+
+MdnsQueryAggregator::MdnsQueryAggregator(MdnsSender* sender,
+                                         TaskRunner* task_runner,
+                                         ClockNowFunctionPtr now_function)
+    : sender_(sender),
+      task_runner_(task_runner),
+      flush_alarm_(now_function, task_runner) {
+  OSP_DCHECK(sender_);
+  OSP_DCHECK(task_runner_);
+}
+
+MdnsQueryAggregator::~MdnsQueryAggregator() = default;
+
+void MdnsQueryAggregator::AddQuery(Query query) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  if (pending_queries_.empty()) {
+    flush_alarm_.ScheduleFromNow([this] { Flush(); }, kAggregationWindow);
+  }
+  pending_queries_.push_back(std::move(query));
+}
+
+void MdnsQueryAggregator::Flush() {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  flush_alarm_.Cancel();
+  std::vector<Query> queries = std::move(pending_queries_);
+  pending_queries_.clear();
+  for (const MdnsMessage& message : CreateMessages(queries)) {
+    sender_->SendMulticast(message);
+  }
+}
+
+// static
+std::vector<MdnsMessage> MdnsQueryAggregator::CreateMessages(
+    const std::vector<Query>& queries) {
+  std::vector<MdnsMessage> messages;
+  MdnsMessage message(CreateMessageId(), MessageType::Query);
+  for (const Query& query : queries) {
+    // Questions can't be added to a message which continues the known answers
+    // of a truncated one, or to a message which is already full.
+    const bool is_continuation =
+        message.questions().empty() && !message.answers().empty();
+    if (is_continuation || (!message.questions().empty() &&
+                            !message.CanAddQuestion(query.question))) {
+      messages.push_back(std::move(message));
+      message = MdnsMessage(CreateMessageId(), MessageType::Query);
+    }
+    message.AddQuestion(query.question);
+
+    // Known answers to earlier questions in the same message aren't repeated.
+    size_t earlier_answer_count = message.answers().size();
+    for (auto it = query.known_answers.begin();
+         it != query.known_answers.end();) {
+      const auto earlier_answers_end =
+          message.answers().begin() + earlier_answer_count;
+      if (std::find(message.answers().begin(), earlier_answers_end, *it) !=
+          earlier_answers_end) {
+        it++;
+      } else if (message.CanAddRecord(*it)) {
+        message.AddAnswer(*it);
+        it++;
+      } else if (message.questions().empty() && message.answers().empty()) {
+        // This case should never happen, because it means a record is too
+        // large to fit into its own message.
+        OSP_LOG_INFO
+            << "Encountered unreasonably large message in cache. Skipping "
+            << "known answer in suppressions...";
+        it++;
+      } else {
+        message.set_truncated();
+        messages.push_back(std::move(message));
+        message = MdnsMessage(CreateMessageId(), MessageType::Query);
+        earlier_answer_count = 0;
+      }
+    }
+  }
+
+  if (!message.questions().empty() || !message.answers().empty()) {
+    messages.push_back(std::move(message));
+  }
+  return messages;
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -0,0 +1,71 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef DISCOVERY_MDNS_MDNS_QUERY_AGGREGATOR_H_
+#define DISCOVERY_MDNS_MDNS_QUERY_AGGREGATOR_H_
+
+#include <vector>
+
+#include "discovery/mdns/mdns_records.h"
+#include "platform/api/task_runner.h"
+#include "platform/api/time.h"
+#include "util/alarm.h"
+
+namespace openscreen {
+namespace discovery {
+
+class MdnsSender;
+
+// Coalesces the queries sent for the questions tracked on one interface.
+// Queries which become due within a short window of each other, such as the
+// refreshes of many records received together, are packed into as few
+// messages as possible instead of each being sent on its own.  As described in
+// RFC 6762 section 7.2, known answers which don't fit into a message with
+// their questions are continued in following messages, and all but the last
+// message of such a sequence have the TC bit set.
+class MdnsQueryAggregator {
+ public:
+  // A question to ask, and the answers to it which are already known.
+  struct Query {
+    MdnsQuestion question;
+    std::vector<MdnsRecord> known_answers;
+  };
+
+  // How long queries are held so that later ones can be sent with them.
+  static constexpr std::chrono::milliseconds kAggregationWindow{20};
+
+  MdnsQueryAggregator(MdnsSender* sender,
+                      TaskRunner* task_runner,
+                      ClockNowFunctionPtr now_function);
+  MdnsQueryAggregator(const MdnsQueryAggregator& other) = delete;
+  MdnsQueryAggregator(MdnsQueryAggregator&& other) noexcept = delete;
+  MdnsQueryAggregator& operator=(const MdnsQueryAggregator& other) = delete;
+  MdnsQueryAggregator& operator=(MdnsQueryAggregator&& other) noexcept =
+      delete;
+  ~MdnsQueryAggregator();
+
+  // Queues |query| to be sent when the current aggregation window ends, or
+  // starts a new window if none is open.
+  void AddQuery(Query query);
+
+  // Sends all queued queries immediately.
+  void Flush();
+
+  // Packs |queries| into multicast query messages, in order.  Each message
+  // holds as many questions as fit, followed by their known answers.
+  static std::vector<MdnsMessage> CreateMessages(
+      const std::vector<Query>& queries);
+
+ private:
+  MdnsSender* const sender_;
+  TaskRunner* const task_runner_;
+  Alarm flush_alarm_;
+
+  std::vector<Query> pending_queries_;
+};
+
+}  // namespace discovery
+}  // namespace openscreen
+
+#endif  // DISCOVERY_MDNS_MDNS_QUERY_AGGREGATOR_H_
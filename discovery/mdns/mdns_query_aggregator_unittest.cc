@@ -0,0 +1,154 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "discovery/mdns/mdns_query_aggregator.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "discovery/mdns/mdns_sender.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "platform/test/fake_udp_socket.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::Return;
+using testing::StrictMock;
+
+class MockMdnsSender : public MdnsSender {
+ public:
+  explicit MockMdnsSender(UdpSocket* socket) : MdnsSender(socket) {}
+
+  MOCK_METHOD1(SendMulticast, Error(const MdnsMessage&));
+  MOCK_METHOD2(SendMessage, Error(const MdnsMessage&, const IPEndpoint&));
+};
+
+MdnsQuestion CreateQuestion(int index) {
+  return MdnsQuestion(
+      DomainName{"instance" + std::to_string(index), "_service", "local"},
+      DnsType::kSRV, DnsClass::kIN, ResponseType::kMulticast);
+}
+
+MdnsRecord CreatePtrRecord(int index) {
+  DomainName target{"instance" + std::to_string(index), "_service", "local"};
+  return MdnsRecord(DomainName{"_service", "local"}, DnsType::kPTR,
+                    DnsClass::kIN, RecordType::kShared,
+                    std::chrono::seconds(4500),
+                    PtrRecordRdata(std::move(target)));
+}
+
+}  // namespace
+
+class MdnsQueryAggregatorTest : public testing::Test {
+ public:
+  MdnsQueryAggregatorTest()
+      : clock_(Clock::now()),
+        task_runner_(&clock_),
+        socket_(&task_runner_),
+        sender_(&socket_),
+        aggregator_(&sender_, &task_runner_, &FakeClock::now) {}
+
+ protected:
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  FakeUdpSocket socket_;
+  StrictMock<MockMdnsSender> sender_;
+  MdnsQueryAggregator aggregator_;
+};
+
+TEST_F(MdnsQueryAggregatorTest, QueriesWithinWindowShareMessage) {
+  aggregator_.AddQuery({CreateQuestion(0), {}});
+  clock_.Advance(MdnsQueryAggregator::kAggregationWindow / 2);
+  aggregator_.AddQuery({CreateQuestion(1), {CreatePtrRecord(1)}});
+
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce(Invoke([](const MdnsMessage& message) {
+        EXPECT_EQ(message.questions().size(), 2u);
+        EXPECT_EQ(message.answers().size(), 1u);
+        EXPECT_FALSE(message.is_truncated());
+        return Error::None();
+      }));
+  clock_.Advance(MdnsQueryAggregator::kAggregationWindow / 2);
+
+  // A later query starts a new window.
+  aggregator_.AddQuery({CreateQuestion(2), {}});
+  testing::Mock::VerifyAndClearExpectations(&sender_);
+  EXPECT_CALL(sender_, SendMulticast(_)).WillOnce(Return(Error::None()));
+  clock_.Advance(MdnsQueryAggregator::kAggregationWindow);
+}
+
+TEST_F(MdnsQueryAggregatorTest, FlushSendsImmediately) {
+  aggregator_.AddQuery({CreateQuestion(0), {}});
+  EXPECT_CALL(sender_, SendMulticast(_)).WillOnce(Return(Error::None()));
+  aggregator_.Flush();
+  testing::Mock::VerifyAndClearExpectations(&sender_);
+
+  // Nothing is left to send when the window ends.
+  clock_.Advance(MdnsQueryAggregator::kAggregationWindow);
+}
+
+TEST_F(MdnsQueryAggregatorTest, SplitsKnownAnswersWithTruncatedBit) {
+  std::vector<MdnsRecord> known_answers;
+  for (int i = 0; i < 100; ++i) {
+    known_answers.push_back(CreatePtrRecord(i));
+  }
+  const std::vector<MdnsMessage> messages = MdnsQueryAggregator::CreateMessages(
+      {{CreateQuestion(0), known_answers}, {CreateQuestion(1), {}}});
+
+  // The known answers of the first question are spread over messages with the
+  // TC bit set on all but the last, and the second question starts a new
+  // message.
+  ASSERT_GE(messages.size(), 3u);
+  size_t answer_count = 0;
+  for (size_t i = 0; i + 1 < messages.size(); ++i) {
+    EXPECT_EQ(messages[i].is_truncated(), i + 2 < messages.size());
+    EXPECT_EQ(messages[i].questions().size(), i == 0 ? 1u : 0u);
+    EXPECT_LT(messages[i].MaxWireSize(), kMaxMulticastMessageSize);
+    answer_count += messages[i].answers().size();
+  }
+  EXPECT_EQ(answer_count, known_answers.size());
+  EXPECT_EQ(messages.back().questions().size(), 1u);
+  EXPECT_TRUE(messages.back().answers().empty());
+  EXPECT_FALSE(messages.back().is_truncated());
+}
+
+TEST_F(MdnsQueryAggregatorTest, PacksQuestionsUntilMessageIsFull) {
+  std::vector<MdnsQueryAggregator::Query> queries;
+  for (int i = 0; i < 100; ++i) {
+    queries.push_back({CreateQuestion(i), {}});
+  }
+  const std::vector<MdnsMessage> messages =
+      MdnsQueryAggregator::CreateMessages(queries);
+
+  ASSERT_GT(messages.size(), 1u);
+  EXPECT_LT(messages.size(), 10u);
+  size_t question_count = 0;
+  for (const MdnsMessage& message : messages) {
+    EXPECT_FALSE(message.is_truncated());
+    EXPECT_LT(message.MaxWireSize(), kMaxMulticastMessageSize);
+    question_count += message.questions().size();
+  }
+  EXPECT_EQ(question_count, queries.size());
+}
+
+TEST_F(MdnsQueryAggregatorTest, SharedKnownAnswersAreSentOnce) {
+  const std::vector<MdnsMessage> messages = MdnsQueryAggregator::CreateMessages(
+      {{CreateQuestion(0), {CreatePtrRecord(0), CreatePtrRecord(1)}},
+       {CreateQuestion(1), {CreatePtrRecord(1), CreatePtrRecord(2)}}});
+
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0].questions().size(), 2u);
+  EXPECT_EQ(messages[0].answers().size(), 3u);
+}
+
+}  // namespace discovery
+}  // namespace openscreen
@@ -57,9 +57,19 @@ bool MdnsReader::Read(TxtRecordRdata::Entry* out) {
   return true;
 }
 
+bool MdnsReader::Read(DomainName* out) {
+  OSP_DCHECK(out);
+  DomainNameView view;
+  if (!Read(&view)) {
+    return false;
+  }
+  *out = view.ToDomainName();
+  return true;
+}
+
 // RFC 1035: https://www.ietf.org/rfc/rfc1035.txt
 // See section 4.1.4. Message compression.
-bool MdnsReader::Read(DomainName* out) {
+bool MdnsReader::Read(DomainNameView* out) {
   OSP_DCHECK(out);
   const uint8_t* position = current();
   // The number of bytes consumed reading from the starting position to either
@@ -73,7 +83,6 @@ bool MdnsReader::Read(DomainName* out) {
   // greater than the length of the buffer.
   size_t bytes_processed = 0;
   size_t domain_name_length = 0;
-  std::vector<absl::string_view> labels;
   // If we are pointing before the beginning or past the end of the buffer, we
   // hit a malformed pointer. If we have processed more bytes than there are in
   // the buffer, we are in a circular compression loop.
@@ -81,12 +90,11 @@ bool MdnsReader::Read(DomainName* out) {
          bytes_processed <= length()) {
     const uint8_t label_type = ReadBigEndian<uint8_t>(position);
     if (IsTerminationLabel(label_type)) {
-      ErrorOr<DomainName> domain =
-          DomainName::TryCreate(labels.begin(), labels.end());
-      if (domain.is_error()) {
+      // Include the termination byte in the size calculation.
+      if (domain_name_length + 1 > kMaxDomainNameLength) {
         return false;
       }
-      *out = std::move(domain.value());
+      *out = DomainNameView(begin(), current());
       if (!bytes_consumed) {
         bytes_consumed = position + sizeof(uint8_t) - current();
       }
@@ -117,7 +125,6 @@ bool MdnsReader::Read(DomainName* out) {
           domain_name_length > kMaxDomainNameLength) {
         return false;
       }
-      labels.push_back(label);
       bytes_processed += label_length;
       position += label_length;
     } else {
@@ -358,6 +365,37 @@ ErrorOr<MdnsMessage> MdnsReader::Read() {
   return Error::Code::kMdnsReadFailure;
 }
 
+Error MdnsReader::Read(MdnsMessageView* out) {
+  OSP_DCHECK(out);
+  out->Clear();
+  Cursor cursor(this);
+  Header header;
+  if (!Read(&header)) {
+    return Error::Code::kMdnsReadFailure;
+  }
+  out->records_.reserve(header.answer_count + header.authority_record_count +
+                        header.additional_record_count);
+  if (!Read(header.question_count, &out->questions_) ||
+      !Read(header.answer_count, &out->records_) ||
+      !Read(header.authority_record_count, &out->records_) ||
+      !Read(header.additional_record_count, &out->records_)) {
+    out->Clear();
+    return Error::Code::kMdnsReadFailure;
+  }
+  if (!IsValidFlagsSection(header.flags)) {
+    out->Clear();
+    return Error::Code::kMdnsNonConformingFailure;
+  }
+
+  out->id_ = header.id;
+  out->type_ = GetMessageType(header.flags);
+  out->is_truncated_ = IsMessageTruncated(header.flags);
+  out->answer_count_ = header.answer_count;
+  out->authority_record_count_ = header.authority_record_count;
+  cursor.Commit();
+  return Error::None();
+}
+
 bool MdnsReader::Read(IPAddress::Version version, IPAddress* out) {
   OSP_DCHECK(out);
   size_t ipaddress_size = (version == IPAddress::Version::kV6)
@@ -467,5 +505,43 @@ bool MdnsReader::Read(NsecBitMapField* out) {
   return false;
 }
 
+bool MdnsReader::Read(MdnsQuestionView* out) {
+  OSP_DCHECK(out);
+  Cursor cursor(this);
+  uint16_t type;
+  uint16_t rrclass;
+  if (Read(&out->name_) && !out->name_.IsRoot() && Read(&type) &&
+      Read(&rrclass)) {
+    out->dns_type_ = static_cast<DnsType>(type);
+    out->dns_class_ = GetDnsClass(rrclass);
+    out->response_type_ = GetResponseType(rrclass);
+    cursor.Commit();
+    return true;
+  }
+  return false;
+}
+
+bool MdnsReader::Read(MdnsRecordView* out) {
+  OSP_DCHECK(out);
+  Cursor cursor(this);
+  const size_t record_offset = offset();
+  uint16_t type;
+  uint16_t rrclass;
+  uint32_t ttl;
+  uint16_t record_length;
+  if (Read(&out->name_) && Read(&type) && Read(&rrclass) && Read(&ttl) &&
+      Read(&record_length) && Skip(record_length)) {
+    out->message_ = absl::MakeConstSpan(begin(), length());
+    out->offset_ = record_offset;
+    out->dns_type_ = static_cast<DnsType>(type);
+    out->dns_class_ = GetDnsClass(rrclass);
+    out->record_type_ = GetRecordType(rrclass);
+    out->ttl_ = std::chrono::seconds(ttl);
+    cursor.Commit();
+    return true;
+  }
+  return false;
+}
+
 }  // namespace discovery
 }  // namespace openscreen
@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include "discovery/mdns/mdns_message_view.h"
 #include "discovery/mdns/mdns_records.h"
 #include "platform/base/error.h"
 #include "util/big_endian.h"
@@ -29,6 +30,7 @@ class MdnsReader : public BigEndianReader {
   // current() remains unchanged.
   bool Read(TxtRecordRdata::Entry* out);
   bool Read(DomainName* out);
+  bool Read(DomainNameView* out);
   bool Read(RawRecordRdata* out);
   bool Read(SrvRecordRdata* out);
   bool Read(ARecordRdata* out);
@@ -47,6 +49,13 @@ class MdnsReader : public BigEndianReader {
   // a mDNS message being read.
   ErrorOr<MdnsMessage> Read();
 
+  // Reads a message like Read() does, but without copying any of it: |out|
+  // refers to this reader's buffer, and reuses the storage it already has.
+  // The structure of the message and all domain names in it are validated,
+  // but record data is only parsed when records are copied with
+  // MdnsRecordView::ToOwned().
+  Error Read(MdnsMessageView* out);
+
  private:
   struct NsecBitMapField {
     uint8_t window_block;
@@ -59,6 +68,8 @@ class MdnsReader : public BigEndianReader {
   bool Read(Header* out);
   bool Read(std::vector<DnsType>* types, int remaining_length);
   bool Read(NsecBitMapField* out);
+  bool Read(MdnsQuestionView* out);
+  bool Read(MdnsRecordView* out);
 
   template <class ItemType>
   bool Read(uint16_t count, std::vector<ItemType>* out) {
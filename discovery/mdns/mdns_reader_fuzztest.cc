@@ -10,6 +10,22 @@ namespace discovery {
 void Fuzz(const uint8_t* data, size_t size) {
   MdnsReader reader(Config{}, data, size);
   reader.Read();
+
+  // The views follow compression pointers lazily, so walk every name in them.
+  MdnsReader view_reader(Config{}, data, size);
+  MdnsMessageView view;
+  if (view_reader.Read(&view).ok()) {
+    for (const MdnsQuestionView& question : view.questions()) {
+      question.ToOwned();
+    }
+    for (const auto& records : {view.answers(), view.authority_records(),
+                                view.additional_records()}) {
+      for (const MdnsRecordView& record : records) {
+        record.name().ToDomainName();
+        record.ToOwned(Config{});
+      }
+    }
+  }
 }
 }  // namespace discovery
 }  // namespace openscreen
@@ -15,6 +15,10 @@ namespace discovery {
 
 MdnsReceiver::ResponseClient::~ResponseClient() = default;
 
+const MdnsNameFilter* MdnsReceiver::ResponseClient::GetNameFilter() const {
+  return nullptr;
+}
+
 MdnsReceiver::MdnsReceiver(Config config) : config_(std::move(config)) {}
 
 MdnsReceiver::~MdnsReceiver() {
@@ -26,11 +30,13 @@ MdnsReceiver::~MdnsReceiver() {
 }
 
 void MdnsReceiver::SetQueryCallback(
-    std::function<void(const MdnsMessage&, const IPEndpoint&)> callback) {
+    std::function<void(const MdnsMessage&, const IPEndpoint&)> callback,
+    QueryFilter filter) {
   // This check verifies that either new or stored callback has a target. It
   // will fail in case multiple objects try to set or clear the callback.
   OSP_DCHECK(static_cast<bool>(query_callback_) != static_cast<bool>(callback));
   query_callback_ = callback;
+  query_filter_ = std::move(filter);
 }
 
 void MdnsReceiver::AddResponseCallback(ResponseClient* callback) {
@@ -63,10 +69,13 @@ void MdnsReceiver::OnRead(UdpSocket* socket,
   UdpPacket packet = std::move(packet_or_error.value());
 
   TRACE_SCOPED(TraceCategory::kMdns, "MdnsReceiver::OnRead");
+  // Only the structure of the message and its names are read here. Record data
+  // is parsed later, for the records which a client copies.
   MdnsReader reader(config_, packet.data(), packet.size());
-  const ErrorOr<MdnsMessage> message = reader.Read();
-  if (message.is_error()) {
-    if (message.error().code() == Error::Code::kMdnsNonConformingFailure) {
+  const Error result = reader.Read(&message_view_);
+  if (!result.ok()) {
+    metrics_.messages_malformed++;
+    if (result.code() == Error::Code::kMdnsNonConformingFailure) {
       OSP_DVLOG << "mDNS message dropped due to invalid rcode or opcode...";
     } else {
       OSP_DVLOG << "mDNS message failed to parse...";
@@ -74,21 +83,90 @@ void MdnsReceiver::OnRead(UdpSocket* socket,
     return;
   }
 
-  if (message.value().type() == MessageType::Response) {
-    for (ResponseClient* client : response_clients_) {
-      client->OnMessageReceived(message.value());
+  if (message_view_.type() == MessageType::Response) {
+    ProcessResponse();
+  } else {
+    ProcessQuery(packet.source());
+  }
+}
+
+bool MdnsReceiver::IsQueryOfInterest() const {
+  if (!query_filter_ || message_view_.questions().empty() ||
+      message_view_.is_truncated()) {
+    return true;
+  }
+
+  for (const MdnsQuestionView& question : message_view_.questions()) {
+    if (query_filter_(question)) {
+      return true;
     }
-    if (response_clients_.empty()) {
-      OSP_DVLOG
-          << "mDNS response message dropped. No response client registered...";
+  }
+  return false;
+}
+
+bool MdnsReceiver::MayContainAnyName(const MdnsNameFilter& filter) const {
+  for (uint64_t hash : name_hashes_) {
+    if (filter.MayContainHash(hash)) {
+      return true;
     }
-  } else {
-    if (query_callback_) {
-      query_callback_(message.value(), packet.source());
-    } else {
-      OSP_DVLOG << "mDNS query message dropped. No query client registered...";
+  }
+  return false;
+}
+
+void MdnsReceiver::ProcessResponse() {
+  if (response_clients_.empty()) {
+    OSP_DVLOG
+        << "mDNS response message dropped. No response client registered...";
+    return;
+  }
+
+  name_hashes_.clear();
+  for (const MdnsRecordView& record : message_view_.answers()) {
+    name_hashes_.push_back(MdnsNameFilter::Hash(record.name()));
+  }
+  for (const MdnsRecordView& record : message_view_.authority_records()) {
+    name_hashes_.push_back(MdnsNameFilter::Hash(record.name()));
+  }
+  for (const MdnsRecordView& record : message_view_.additional_records()) {
+    name_hashes_.push_back(MdnsNameFilter::Hash(record.name()));
+  }
+
+  bool processed = false;
+  for (ResponseClient* client : response_clients_) {
+    const MdnsNameFilter* filter = client->GetNameFilter();
+    if (filter && !MayContainAnyName(*filter)) {
+      continue;
     }
+    client->OnMessageReceived(message_view_);
+    processed = true;
+  }
+
+  if (processed) {
+    metrics_.messages_processed++;
+  } else {
+    metrics_.messages_filtered++;
+  }
+}
+
+void MdnsReceiver::ProcessQuery(const IPEndpoint& src) {
+  if (!query_callback_) {
+    OSP_DVLOG << "mDNS query message dropped. No query client registered...";
+    return;
+  }
+
+  if (!IsQueryOfInterest()) {
+    metrics_.messages_filtered++;
+    return;
+  }
+
+  const ErrorOr<MdnsMessage> message = message_view_.ToOwned(config_);
+  if (message.is_error()) {
+    metrics_.messages_malformed++;
+    OSP_DVLOG << "mDNS query message failed to parse...";
+    return;
   }
+  metrics_.messages_processed++;
+  query_callback_(message.value(), src);
 }
 
 }  // namespace discovery
@@ -5,9 +5,14 @@
 #ifndef DISCOVERY_MDNS_MDNS_RECEIVER_H_
 #define DISCOVERY_MDNS_MDNS_RECEIVER_H_
 
+#include <stdint.h>
+
 #include <functional>
+#include <vector>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_name_filter.h"
 #include "platform/api/udp_socket.h"
 #include "platform/base/error.h"
 #include "platform/base/udp_packet.h"
@@ -23,7 +28,35 @@ class MdnsReceiver {
    public:
     virtual ~ResponseClient();
 
-    virtual void OnMessageReceived(const MdnsMessage& message) = 0;
+    // |message| refers to the received packet, so is only valid during this
+    // call.
+    virtual void OnMessageReceived(const MdnsMessageView& message) = 0;
+
+    // Returns the names this client is interested in. A response is only
+    // passed to the client if one of its records' names may be in the filter.
+    // Returning nullptr, as the default implementation does, passes every
+    // response to the client. The returned filter must stay valid for as long
+    // as the client is registered.
+    virtual const MdnsNameFilter* GetNameFilter() const;
+  };
+
+  // Returns whether a received query may be of interest to the query callback.
+  // It's given a question of the query, and the query is passed on if it
+  // returns true for any of them.
+  using QueryFilter = std::function<bool(const MdnsQuestionView& question)>;
+
+  // Counts the messages received while running.
+  struct Metrics {
+    // Messages which were passed on to the query callback or to at least one
+    // response client.
+    uint64_t messages_processed = 0;
+
+    // Well-formed messages which were dropped because no client was
+    // interested in any of their names.
+    uint64_t messages_filtered = 0;
+
+    // Messages which could not be read, or which do not conform to RFC 6762.
+    uint64_t messages_malformed = 0;
   };
 
   // MdnsReceiver does not own |socket| and |delegate|
@@ -36,8 +69,13 @@ class MdnsReceiver {
   MdnsReceiver& operator=(MdnsReceiver&& other) noexcept = delete;
   ~MdnsReceiver();
 
+  // |filter| is checked against the questions of each received query before
+  // the query is copied and passed to |callback|. Queries without questions
+  // and truncated queries, which may be followed by more known answers, are
+  // always passed on. If |filter| is empty, all queries are passed on.
   void SetQueryCallback(
-      std::function<void(const MdnsMessage&, const IPEndpoint& src)> callback);
+      std::function<void(const MdnsMessage&, const IPEndpoint& src)> callback,
+      QueryFilter filter = nullptr);
   void AddResponseCallback(ResponseClient* callback);
   void RemoveResponseCallback(ResponseClient* callback);
 
@@ -50,19 +88,40 @@ class MdnsReceiver {
 
   void OnRead(UdpSocket* socket, ErrorOr<UdpPacket> packet);
 
+  const Metrics& metrics() const { return metrics_; }
+
  private:
   enum class State {
     kStopped,
     kRunning,
   };
 
+  // Returns whether |message_view_| should be passed on to the query callback.
+  bool IsQueryOfInterest() const;
+
+  // Returns whether any of the names in |name_hashes_| may be in |filter|.
+  bool MayContainAnyName(const MdnsNameFilter& filter) const;
+
+  void ProcessResponse();
+  void ProcessQuery(const IPEndpoint& src);
+
   std::function<void(const MdnsMessage&, const IPEndpoint& src)>
       query_callback_;
+  QueryFilter query_filter_;
   State state_ = State::kStopped;
 
   std::vector<ResponseClient*> response_clients_;
 
   Config config_;
+
+  // Reused for every received message, so that reading one doesn't allocate.
+  MdnsMessageView message_view_;
+
+  // Hashes of the names of the records in |message_view_|, computed once for a
+  // received response and then checked against each client's filter.
+  std::vector<uint64_t> name_hashes_;
+
+  Metrics metrics_;
 };
 
 }  // namespace discovery
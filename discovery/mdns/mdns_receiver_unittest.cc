@@ -23,9 +23,71 @@ using testing::Return;
 
 class MockMdnsReceiverDelegate : public MdnsReceiver::ResponseClient {
  public:
-  MOCK_METHOD(void, OnMessageReceived, (const MdnsMessage&));
+  void OnMessageReceived(const MdnsMessageView& message) override {
+    ErrorOr<MdnsMessage> owned = message.ToOwned(Config{});
+    ASSERT_TRUE(owned.is_value());
+    OnMessageParsed(owned.value());
+  }
+
+  MOCK_METHOD(void, OnMessageParsed, (const MdnsMessage&));
+};
+
+class FilteringMdnsReceiverDelegate : public MockMdnsReceiverDelegate {
+ public:
+  const MdnsNameFilter* GetNameFilter() const override { return &filter; }
+
+  MdnsNameFilter filter;
+};
+
+namespace {
+
+// clang-format off
+const std::vector<uint8_t> kTestingLocalResponseBytes = {
+    0x00, 0x01,  // ID = 1
+    0x84, 0x00,  // FLAGS = AA | RESPONSE
+    0x00, 0x00,  // Question count
+    0x00, 0x01,  // Answer count
+    0x00, 0x00,  // Authority count
+    0x00, 0x00,  // Additional count
+    // Answer
+    0x07, 't', 'e', 's', 't', 'i', 'n', 'g',
+    0x05, 'l', 'o', 'c', 'a', 'l',
+    0x00,
+    0x00, 0x01,              // TYPE = A (1)
+    0x00, 0x01,              // CLASS = IN (1)
+    0x00, 0x00, 0x00, 0x78,  // TTL = 120 seconds
+    0x00, 0x04,              // RDLENGTH = 4 bytes
+    0xac, 0x00, 0x00, 0x01,  // 172.0.0.1
 };
 
+const std::vector<uint8_t> kTestingLocalQueryBytes = {
+    0x00, 0x01,  // ID = 1
+    0x00, 0x00,  // FLAGS = None
+    0x00, 0x01,  // Question count
+    0x00, 0x00,  // Answer count
+    0x00, 0x00,  // Authority count
+    0x00, 0x00,  // Additional count
+    // Question
+    0x07, 't', 'e', 's', 't', 'i', 'n', 'g',
+    0x05, 'l', 'o', 'c', 'a', 'l',
+    0x00,
+    0x00, 0x01,  // TYPE = A (1)
+    0x00, 0x01,  // CLASS = IN (1)
+};
+// clang-format on
+
+UdpPacket CreatePacket(const std::vector<uint8_t>& bytes) {
+  UdpPacket packet(bytes.begin(), bytes.end());
+  packet.set_source(
+      IPEndpoint{.address = IPAddress(192, 168, 1, 1), .port = 31337});
+  packet.set_destination(
+      IPEndpoint{.address = IPAddress(kDefaultMulticastGroupIPv4),
+                 .port = kDefaultMulticastPort});
+  return packet;
+}
+
+}  // namespace
+
 TEST(MdnsReceiverTest, ReceiveQuery) {
   // clang-format off
   const std::vector<uint8_t> kQueryBytes = {
@@ -50,7 +112,7 @@ TEST(MdnsReceiverTest, ReceiveQuery) {
   MdnsReceiver receiver(config);
   receiver.SetQueryCallback(
       [&delegate](const MdnsMessage& message, const IPEndpoint& endpoint) {
-        delegate.OnMessageReceived(message);
+        delegate.OnMessageParsed(message);
       });
   receiver.Start();
 
@@ -67,7 +129,7 @@ TEST(MdnsReceiverTest, ReceiveQuery) {
                  .port = kDefaultMulticastPort});
 
   // Imitate a call to OnRead from NetworkRunner by calling it manually here
-  EXPECT_CALL(delegate, OnMessageReceived(message)).Times(1);
+  EXPECT_CALL(delegate, OnMessageParsed(message)).Times(1);
   receiver.OnRead(&socket, std::move(packet));
 
   receiver.Stop();
@@ -122,12 +184,104 @@ TEST(MdnsReceiverTest, ReceiveResponse) {
                  .port = kDefaultMulticastPort});
 
   // Imitate a call to OnRead from NetworkRunner by calling it manually here
-  EXPECT_CALL(delegate, OnMessageReceived(message)).Times(1);
+  EXPECT_CALL(delegate, OnMessageParsed(message)).Times(1);
   receiver.OnRead(&socket, std::move(packet));
 
   receiver.Stop();
   receiver.RemoveResponseCallback(&delegate);
 }
 
+TEST(MdnsReceiverTest, DropsResponsesNotMatchingClientFilter) {
+  FakeUdpSocket socket;
+  FilteringMdnsReceiverDelegate delegate;
+  MdnsReceiver receiver(Config{});
+  receiver.AddResponseCallback(&delegate);
+  receiver.Start();
+
+  delegate.filter.Add(DomainName{"other", "local"});
+  EXPECT_CALL(delegate, OnMessageParsed(_)).Times(0);
+  receiver.OnRead(&socket, CreatePacket(kTestingLocalResponseBytes));
+  EXPECT_EQ(receiver.metrics().messages_filtered, UINT64_C(1));
+  EXPECT_EQ(receiver.metrics().messages_processed, UINT64_C(0));
+  testing::Mock::VerifyAndClearExpectations(&delegate);
+
+  delegate.filter.Add(DomainName{"TESTING", "local"});
+  EXPECT_CALL(delegate, OnMessageParsed(_)).Times(1);
+  receiver.OnRead(&socket, CreatePacket(kTestingLocalResponseBytes));
+  EXPECT_EQ(receiver.metrics().messages_filtered, UINT64_C(1));
+  EXPECT_EQ(receiver.metrics().messages_processed, UINT64_C(1));
+
+  receiver.Stop();
+  receiver.RemoveResponseCallback(&delegate);
+}
+
+TEST(MdnsReceiverTest, PassesResponseToClientsWithoutFilter) {
+  FakeUdpSocket socket;
+  FilteringMdnsReceiverDelegate filtering_delegate;
+  MockMdnsReceiverDelegate delegate;
+  MdnsReceiver receiver(Config{});
+  receiver.AddResponseCallback(&filtering_delegate);
+  receiver.AddResponseCallback(&delegate);
+  receiver.Start();
+
+  EXPECT_CALL(filtering_delegate, OnMessageParsed(_)).Times(0);
+  EXPECT_CALL(delegate, OnMessageParsed(_)).Times(1);
+  receiver.OnRead(&socket, CreatePacket(kTestingLocalResponseBytes));
+  EXPECT_EQ(receiver.metrics().messages_filtered, UINT64_C(0));
+  EXPECT_EQ(receiver.metrics().messages_processed, UINT64_C(1));
+
+  receiver.Stop();
+  receiver.RemoveResponseCallback(&filtering_delegate);
+  receiver.RemoveResponseCallback(&delegate);
+}
+
+TEST(MdnsReceiverTest, DropsQueriesRejectedByQueryFilter) {
+  FakeUdpSocket socket;
+  MockMdnsReceiverDelegate delegate;
+  MdnsReceiver receiver(Config{});
+  bool accept = false;
+  receiver.SetQueryCallback(
+      [&delegate](const MdnsMessage& message, const IPEndpoint& endpoint) {
+        delegate.OnMessageParsed(message);
+      },
+      [&accept](const MdnsQuestionView& question) {
+        EXPECT_EQ(question.name(), (DomainName{"testing", "local"}));
+        return accept;
+      });
+  receiver.Start();
+
+  EXPECT_CALL(delegate, OnMessageParsed(_)).Times(0);
+  receiver.OnRead(&socket, CreatePacket(kTestingLocalQueryBytes));
+  EXPECT_EQ(receiver.metrics().messages_filtered, UINT64_C(1));
+  testing::Mock::VerifyAndClearExpectations(&delegate);
+
+  accept = true;
+  EXPECT_CALL(delegate, OnMessageParsed(_)).Times(1);
+  receiver.OnRead(&socket, CreatePacket(kTestingLocalQueryBytes));
+  EXPECT_EQ(receiver.metrics().messages_filtered, UINT64_C(1));
+  EXPECT_EQ(receiver.metrics().messages_processed, UINT64_C(1));
+
+  receiver.Stop();
+}
+
+TEST(MdnsReceiverTest, CountsMalformedMessages) {
+  FakeUdpSocket socket;
+  MockMdnsReceiverDelegate delegate;
+  MdnsReceiver receiver(Config{});
+  receiver.AddResponseCallback(&delegate);
+  receiver.Start();
+
+  std::vector<uint8_t> truncated_bytes = kTestingLocalResponseBytes;
+  truncated_bytes.resize(truncated_bytes.size() - 2);
+  EXPECT_CALL(delegate, OnMessageParsed(_)).Times(0);
+  receiver.OnRead(&socket, CreatePacket(truncated_bytes));
+  EXPECT_EQ(receiver.metrics().messages_malformed, UINT64_C(1));
+  EXPECT_EQ(receiver.metrics().messages_filtered, UINT64_C(0));
+  EXPECT_EQ(receiver.metrics().messages_processed, UINT64_C(0));
+
+  receiver.Stop();
+  receiver.RemoveResponseCallback(&delegate);
+}
+
 }  // namespace discovery
 }  // namespace openscreen
@@ -870,6 +870,10 @@ bool MdnsMessage::CanAddRecord(const MdnsRecord& record) {
   return (max_wire_size_ + record.MaxWireSize()) < kMaxMulticastMessageSize;
 }
 
+bool MdnsMessage::CanAddQuestion(const MdnsQuestion& question) {
+  return (max_wire_size_ + question.MaxWireSize()) < kMaxMulticastMessageSize;
+}
+
 uint16_t CreateMessageId() {
   static uint16_t id(0);
   return id++;
@@ -9,6 +9,7 @@
 #include <chrono>
 #include <functional>
 #include <initializer_list>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -26,6 +27,8 @@
 namespace openscreen {
 namespace discovery {
 
+class MdnsEncodedRecord;
+
 bool IsValidDomainLabel(absl::string_view label);
 
 // Represents domain name as a collection of labels, ensures label length and
@@ -488,6 +491,17 @@ class MdnsRecord {
   std::chrono::seconds ttl() const { return ttl_; }
   const Rdata& rdata() const { return rdata_; }
 
+  // The wire format of this record, encoded ahead of time so that MdnsWriter
+  // can copy it rather than serialize the record again. It's shared between
+  // copies of the record, and isn't part of its value: it's ignored by
+  // comparisons and hashing. May be null.
+  const std::shared_ptr<const MdnsEncodedRecord>& encoded() const {
+    return encoded_;
+  }
+  void set_encoded(std::shared_ptr<const MdnsEncodedRecord> encoded) {
+    encoded_ = std::move(encoded);
+  }
+
   template <typename H>
   friend H AbslHashValue(H h, const MdnsRecord& record) {
     return H::combine(std::move(h), record.name_, record.dns_type_,
@@ -509,6 +523,7 @@ class MdnsRecord {
   // Default-constructed Rdata contains default-constructed RawRecordRdata
   // as it is the first alternative type and it is default-constructible.
   Rdata rdata_;
+  std::shared_ptr<const MdnsEncodedRecord> encoded_;
 
 #ifdef _DEBUG
   friend std::ostream& operator<<(std::ostream&, const MdnsRecord& mdns_record);
@@ -602,6 +617,10 @@ class MdnsMessage {
   // beyond kMaxMulticastMessageSize, and true otherwise.
   bool CanAddRecord(const MdnsRecord& record);
 
+  // Returns false if adding a new question would push the size of this message
+  // beyond kMaxMulticastMessageSize, and true otherwise.
+  bool CanAddQuestion(const MdnsQuestion& question);
+
   // Sets the truncated bit (TC), as specified in RFC 1035 Section 4.1.1.
   void set_truncated() { is_truncated_ = true; }
 
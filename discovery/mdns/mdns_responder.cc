@@ -9,6 +9,8 @@
 #include <utility>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/mdns_message_view.h"
+#include "discovery/mdns/mdns_name_filter.h"
 #include "discovery/mdns/mdns_probe_manager.h"
 #include "discovery/mdns/mdns_publisher.h"
 #include "discovery/mdns/mdns_querier.h"
@@ -16,6 +18,7 @@
 #include "discovery/mdns/mdns_receiver.h"
 #include "discovery/mdns/mdns_sender.h"
 #include "platform/api/task_runner.h"
+#include "util/std_util.h"
 
 namespace openscreen {
 namespace discovery {
@@ -26,6 +29,10 @@ constexpr std::array<const char*, 3> kServiceEnumerationDomainLabels{
 
 enum AddResult { kNonePresent = 0, kAdded, kAlreadyKnown };
 
+// RFC 6762 section 7.4: answers multicast by another responder within the last
+// second need not be sent again.
+constexpr std::chrono::seconds kDuplicateAnswerWindow{1};
+
 std::chrono::seconds GetTtlForNsecTargetingType(DnsType type) {
   // NOTE: A 'default' switch statement has intentionally been avoided below to
   // enforce that new DnsTypes added must be added below through a compile-time
@@ -248,6 +255,21 @@ bool IsServiceTypeEnumerationQuery(const MdnsQuestion& question) {
                     kServiceEnumerationDomainLabels.end());
 }
 
+bool IsServiceTypeEnumerationQuery(const MdnsQuestionView& question) {
+  if (question.dns_type() != DnsType::kPTR) {
+    return false;
+  }
+
+  DomainNameView::Iterator label_it = question.name().begin();
+  for (const char* label : kServiceEnumerationDomainLabels) {
+    if (label_it == question.name().end() || *label_it != label) {
+      return false;
+    }
+    ++label_it;
+  }
+  return true;
+}
+
 // Creates the expected response to a type enumeration query as described in RFC
 // 6763 section 9.
 void ApplyServiceTypeEnumerationResults(
@@ -286,6 +308,10 @@ bool IsMultiPacketTruncatedQueryMessage(const MdnsMessage& message) {
 
 MdnsResponder::RecordHandler::~RecordHandler() = default;
 
+const MdnsNameFilter* MdnsResponder::RecordHandler::GetNameFilter() const {
+  return nullptr;
+}
+
 MdnsResponder::TruncatedQuery::TruncatedQuery(MdnsResponder* responder,
                                               TaskRunner* task_runner,
                                               ClockNowFunctionPtr now_function,
@@ -371,7 +397,8 @@ MdnsResponder::MdnsResponder(RecordHandler* record_handler,
                              ClockNowFunctionPtr now_function,
                              MdnsRandom* random_delay,
                              const Config& config)
-    : record_handler_(record_handler),
+    : pending_multicast_alarm_(now_function, task_runner),
+      record_handler_(record_handler),
       ownership_handler_(ownership_handler),
       sender_(sender),
       receiver_(receiver),
@@ -391,13 +418,34 @@ MdnsResponder::MdnsResponder(RecordHandler* record_handler,
   auto func = [this](const MdnsMessage& message, const IPEndpoint& src) {
     OnMessageReceived(message, src);
   };
-  receiver_->SetQueryCallback(std::move(func));
+  auto filter = [this](const MdnsQuestionView& question) {
+    return IsQuestionOfInterest(question);
+  };
+  receiver_->SetQueryCallback(std::move(func), std::move(filter));
+  receiver_->AddResponseCallback(this);
 }
 
 MdnsResponder::~MdnsResponder() {
+  receiver_->RemoveResponseCallback(this);
   receiver_->SetQueryCallback(nullptr);
 }
 
+bool MdnsResponder::IsQuestionOfInterest(
+    const MdnsQuestionView& question) const {
+  if (IsServiceTypeEnumerationQuery(question)) {
+    return true;
+  }
+
+  const MdnsNameFilter* records = record_handler_->GetNameFilter();
+  const MdnsNameFilter* owned_domains = ownership_handler_->GetNameFilter();
+  if (!records || !owned_domains) {
+    return true;
+  }
+
+  const uint64_t hash = MdnsNameFilter::Hash(question.name());
+  return records->MayContainHash(hash) || owned_domains->MayContainHash(hash);
+}
+
 void MdnsResponder::OnMessageReceived(const MdnsMessage& message,
                                       const IPEndpoint& src) {
   OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
@@ -519,6 +567,9 @@ void MdnsResponder::ProcessQueries(
     const IPEndpoint& src,
     const std::vector<MdnsQuestion>& questions,
     const std::vector<MdnsRecord>& known_answers) {
+  std::vector<PendingQuestion> immediate_multicast;
+  std::vector<PendingQuestion> immediate_unicast;
+  std::vector<PendingQuestion> delayed_unicast;
   for (const auto& question : questions) {
     OSP_DVLOG << "\tProcessing mDNS Query for domain: '" << question.name()
               << "', type: '" << question.dns_type() << "' from '" << src
@@ -545,79 +596,223 @@ void MdnsResponder::ProcessQueries(
       OSP_DVLOG << "\tmDNS Query is for service type enumeration!";
     }
 
-    // Relevant records are published, so send them out using the response type
-    // dictated in the question.
-    std::function<void(const MdnsMessage&)> send_response;
-    if (question.response_type() == ResponseType::kMulticast) {
-      send_response = [this](const MdnsMessage& message) {
-        sender_->SendMulticast(message);
-      };
-    } else {
-      OSP_DCHECK(question.response_type() == ResponseType::kUnicast);
-      send_response = [this, src](const MdnsMessage& message) {
-        sender_->SendMessage(message, src);
-      };
-    }
-
     // If this host is the exclusive owner, respond immediately. Else, there may
     // be network contention if all hosts respond simultaneously, so delay the
     // response as dictated by RFC 6762.
+    PendingQuestion pending{question, known_answers, is_exclusive_owner};
+    const bool is_multicast =
+        question.response_type() == ResponseType::kMulticast;
+    OSP_DCHECK(is_multicast ||
+               question.response_type() == ResponseType::kUnicast);
     if (is_exclusive_owner) {
-      SendResponse(question, known_answers, send_response, is_exclusive_owner);
+      (is_multicast ? immediate_multicast : immediate_unicast)
+          .push_back(std::move(pending));
+    } else if (is_multicast) {
+      AddPendingMulticastQuestion(std::move(pending));
     } else {
-      const auto delay = random_delay_->GetSharedRecordResponseDelay();
-      std::function<void()> response = [this, question, known_answers,
-                                        send_response, is_exclusive_owner]() {
-        SendResponse(question, known_answers, send_response,
-                     is_exclusive_owner);
-      };
-      task_runner_->PostTaskWithDelay(response, delay);
+      delayed_unicast.push_back(std::move(pending));
     }
   }
+
+  SendMulticastResponse(immediate_multicast);
+  SendUnicastResponse(immediate_unicast, src);
+  if (!delayed_unicast.empty()) {
+    task_runner_->PostTaskWithDelay(
+        [this, questions = std::move(delayed_unicast), src] {
+          SendUnicastResponse(questions, src);
+        },
+        random_delay_->GetSharedRecordResponseDelay());
+  }
 }
 
-void MdnsResponder::SendResponse(
-    const MdnsQuestion& question,
-    const std::vector<MdnsRecord>& known_answers,
-    std::function<void(const MdnsMessage&)> send_response,
-    bool is_exclusive_owner) {
+void MdnsResponder::AddPendingMulticastQuestion(PendingQuestion question) {
+  if (pending_multicast_questions_.empty()) {
+    pending_multicast_alarm_.ScheduleFromNow(
+        [this] { SendPendingMulticastResponse(); },
+        random_delay_->GetSharedRecordResponseDelay());
+  }
+  pending_multicast_questions_.push_back(std::move(question));
+}
+
+void MdnsResponder::SendPendingMulticastResponse() {
+  std::vector<PendingQuestion> questions =
+      std::move(pending_multicast_questions_);
+  pending_multicast_questions_.clear();
+  SendMulticastResponse(questions);
+}
+
+void MdnsResponder::SendMulticastResponse(
+    const std::vector<PendingQuestion>& questions) {
+  for (const MdnsMessage& message : CreateResponses(questions, true)) {
+    sender_->SendMulticast(message);
+  }
+}
+
+void MdnsResponder::SendUnicastResponse(
+    const std::vector<PendingQuestion>& questions,
+    const IPEndpoint& dest) {
+  for (const MdnsMessage& message : CreateResponses(questions, false)) {
+    sender_->SendMessage(message, dest);
+  }
+}
+
+std::vector<MdnsMessage> MdnsResponder::CreateResponses(
+    const std::vector<PendingQuestion>& questions,
+    bool is_multicast) {
   OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
 
-  MdnsMessage message(CreateMessageId(), MessageType::Response);
+  if (is_multicast) {
+    PruneObservedRecords();
+  }
 
-  if (IsServiceTypeEnumerationQuery(question)) {
-    // This is a special case defined in RFC 6763 section 9, so handle it
-    // separately.
-    ApplyServiceTypeEnumerationResults(&message, record_handler_,
-                                       question.name(), question.dns_class());
-  } else {
-    // NOTE: The exclusive ownership of this record cannot change before this
-    // method is called. Exclusive ownership cannot be gained for a record which
-    // has previously been published, and if this host is the exclusive owner
-    // then this method will have been called without any delay on the task
-    // runner.
-    ApplyQueryResults(&message, record_handler_, question.name(), known_answers,
-                      question.dns_type(), question.dns_class(),
-                      is_exclusive_owner);
-  }
-
-  // Send the response only if it contains answers to the query.
-  OSP_DVLOG << "\tCompleted Processing mDNS Query for domain: '"
-            << question.name() << "', type: '" << question.dns_type()
-            << "', with " << message.answers().size() << " results:";
+  std::vector<MdnsRecord> answers;
+  std::vector<MdnsRecord> additional_records;
+  for (const PendingQuestion& pending : questions) {
+    const MdnsQuestion& question = pending.question;
+    MdnsMessage message(CreateMessageId(), MessageType::Response);
+
+    if (IsServiceTypeEnumerationQuery(question)) {
+      // This is a special case defined in RFC 6763 section 9, so handle it
+      // separately.
+      ApplyServiceTypeEnumerationResults(&message, record_handler_,
+                                         question.name(), question.dns_class());
+    } else {
+      // NOTE: The exclusive ownership of this record cannot change before this
+      // method is called. Exclusive ownership cannot be gained for a record
+      // which has previously been published, and if this host is the exclusive
+      // owner then this method will have been called without any delay on the
+      // task runner.
+      ApplyQueryResults(&message, record_handler_, question.name(),
+                        pending.known_answers, question.dns_type(),
+                        question.dns_class(), pending.is_exclusive_owner);
+    }
+
+    OSP_DVLOG << "\tCompleted Processing mDNS Query for domain: '"
+              << question.name() << "', type: '" << question.dns_type()
+              << "', with " << message.answers().size() << " results:";
 #ifdef _DEBUG
-  for (const auto& record : message.answers()) {
-    OSP_DVLOG << "\t\tanswer (" << record << ")";
+    for (const auto& record : message.answers()) {
+      OSP_DVLOG << "\t\tanswer (" << record << ")";
+    }
+    for (const auto& record : message.additional_records()) {
+      OSP_DVLOG << "\t\tadditional record ('" << record << ")";
+    }
+#endif
+
+    for (const MdnsRecord& record : message.answers()) {
+      if (!Contains(answers, record) &&
+          !(is_multicast && WasRecentlyMulticast(record))) {
+        answers.push_back(record);
+      }
+    }
+    for (const MdnsRecord& record : message.additional_records()) {
+      if (!Contains(additional_records, record)) {
+        additional_records.push_back(record);
+      }
+    }
   }
-  for (const auto& record : message.additional_records()) {
-    OSP_DVLOG << "\t\tadditional record ('" << record << ")";
+
+  // Send a response only if it contains answers to the queries.
+  std::vector<MdnsMessage> messages;
+  if (answers.empty()) {
+    return messages;
   }
-#endif
 
-  if (!message.answers().empty()) {
-    send_response(message);
+  // Split the response into as many messages as needed. Additional records are
+  // added after all answers, leaving out any which are also answers.
+  MdnsMessage message(CreateMessageId(), MessageType::Response);
+  for (const MdnsRecord& record : answers) {
+    if (!message.answers().empty() && !message.CanAddRecord(record)) {
+      messages.push_back(std::move(message));
+      message = MdnsMessage(CreateMessageId(), MessageType::Response);
+    }
+    message.AddAnswer(record);
+  }
+  for (MdnsRecord& record : additional_records) {
+    if (Contains(answers, record) ||
+        (is_multicast && WasRecentlyMulticast(record))) {
+      continue;
+    }
+    if (!message.CanAddRecord(record)) {
+      messages.push_back(std::move(message));
+      message = MdnsMessage(CreateMessageId(), MessageType::Response);
+    }
+    message.AddAdditionalRecord(std::move(record));
+  }
+  messages.push_back(std::move(message));
+  return messages;
+}
+
+bool MdnsResponder::WasRecentlyMulticast(const MdnsRecord& record) const {
+  const auto range =
+      observed_records_.equal_range(MdnsNameFilter::Hash(record.name()));
+  for (auto it = range.first; it != range.second; ++it) {
+    const MdnsRecord& observed = it->second.record;
+    if (observed.dns_type() == record.dns_type() &&
+        observed.dns_class() == record.dns_class() &&
+        observed.ttl() >= record.ttl() && observed.name() == record.name() &&
+        observed.rdata() == record.rdata()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MdnsResponder::PruneObservedRecords() {
+  const Clock::time_point cutoff = now_function_() - kDuplicateAnswerWindow;
+  for (auto it = observed_records_.begin(); it != observed_records_.end();) {
+    if (it->second.time <= cutoff) {
+      it = observed_records_.erase(it);
+    } else {
+      ++it;
+    }
   }
 }
 
+void MdnsResponder::OnMessageReceived(const MdnsMessageView& message) {
+  OSP_DCHECK(task_runner_->IsRunningOnTaskRunner());
+
+  // Only the records which may be answers from this host are of interest.
+  PruneObservedRecords();
+  const MdnsNameFilter* filter = record_handler_->GetNameFilter();
+  const Clock::time_point now = now_function_();
+  auto observe = [this, filter, now](const MdnsRecordView& view) {
+    if (filter && !filter->MayContain(view.name())) {
+      return;
+    }
+    ErrorOr<MdnsRecord> record = view.ToOwned(config_);
+    if (record.is_error() || record.value().ttl() == std::chrono::seconds(0)) {
+      return;
+    }
+
+    // Replace the same record if it's already been observed.
+    const uint64_t hash = MdnsNameFilter::Hash(view.name());
+    const auto range = observed_records_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      MdnsRecord& observed = it->second.record;
+      if (observed.dns_type() == record.value().dns_type() &&
+          observed.dns_class() == record.value().dns_class() &&
+          observed.name() == record.value().name() &&
+          observed.rdata() == record.value().rdata()) {
+        observed = std::move(record.value());
+        it->second.time = now;
+        return;
+      }
+    }
+    observed_records_.emplace(
+        hash, ObservedRecord{std::move(record.value()), now});
+  };
+  for (const MdnsRecordView& view : message.answers()) {
+    observe(view);
+  }
+  for (const MdnsRecordView& view : message.additional_records()) {
+    observe(view);
+  }
+}
+
+const MdnsNameFilter* MdnsResponder::GetNameFilter() const {
+  return record_handler_->GetNameFilter();
+}
+
 }  // namespace discovery
 }  // namespace openscreen
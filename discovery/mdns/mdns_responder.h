@@ -7,8 +7,10 @@
 
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "discovery/mdns/mdns_receiver.h"
 #include "discovery/mdns/mdns_records.h"
 #include "platform/api/time.h"
 #include "platform/base/macros.h"
@@ -23,21 +25,27 @@ namespace discovery {
 
 struct Config;
 class MdnsMessage;
+class MdnsNameFilter;
 class MdnsProbeManager;
+class MdnsQuestionView;
 class MdnsRandom;
-class MdnsReceiver;
 class MdnsRecordChangedCallback;
 class MdnsSender;
 class MdnsQuerier;
 
-// This class is responsible for responding to any incoming mDNS Queries
-// received via the OnMessageReceived() method. When responding, the generated
-// MdnsMessage will contain the requested record(s) in the answers section, or
-// an NSEC record to specify that the requested record was not found in the case
-// of a query with DnsType aside from ANY. In the case where records are found,
-// the additional records field may be populated with additional records, as
-// specified in RFCs 6762 and 6763.
-class MdnsResponder {
+// This class is responsible for responding to any incoming mDNS Queries for
+// the records published on one interface, received via the OnMessageReceived()
+// method. When responding, the generated MdnsMessage will contain the requested
+// record(s) in the answers section, or an NSEC record to specify that the
+// requested record was not found in the case of a query with DnsType aside from
+// ANY. In the case where records are found, the additional records field may be
+// populated with additional records, as specified in RFCs 6762 and 6763.
+//
+// Multicast responses to shared records are delayed by a random 20-120 ms, as
+// RFC 6762 section 6 requires, and the answers to all questions received
+// during that window are sent together. Answers which another responder
+// multicast within the last second are not repeated, per RFC 6762 section 7.4.
+class MdnsResponder : public MdnsReceiver::ResponseClient {
  public:
   // Class to handle querying for existing records.
   class RecordHandler {
@@ -58,6 +66,11 @@ class MdnsResponder {
 
     // Enumerates all PTR records owned by this service.
     virtual std::vector<MdnsRecord::ConstRef> GetPtrRecords(DnsClass clazz) = 0;
+
+    // Returns a filter holding the names of all records owned by this service,
+    // or nullptr if no such filter is maintained, in which case no received
+    // queries are dropped before they reach the responder.
+    virtual const MdnsNameFilter* GetNameFilter() const;
   };
 
   // |record_handler|, |sender|, |receiver|, |task_runner|, |random_delay|, and
@@ -71,11 +84,24 @@ class MdnsResponder {
                 ClockNowFunctionPtr now_function,
                 MdnsRandom* random_delay,
                 const Config& config);
-  ~MdnsResponder();
+  ~MdnsResponder() override;
 
   OSP_DISALLOW_COPY_AND_ASSIGN(MdnsResponder);
 
  private:
+  // A question to be answered, with the answers the querier already knows.
+  struct PendingQuestion {
+    MdnsQuestion question;
+    std::vector<MdnsRecord> known_answers;
+    bool is_exclusive_owner;
+  };
+
+  // A record recently multicast by another responder.
+  struct ObservedRecord {
+    MdnsRecord record;
+    Clock::time_point time;
+  };
+
   // Class which handles processing and responding to queries segmented into
   // multiple messages.
   class TruncatedQuery {
@@ -127,6 +153,10 @@ class MdnsResponder {
     Alarm alarm_;
   };
 
+  // Returns whether a received query with |question| may need a response or
+  // be a probe for a domain owned by this host.
+  bool IsQuestionOfInterest(const MdnsQuestionView& question) const;
+
   // Called when a new MdnsMessage is received.
   void OnMessageReceived(const MdnsMessage& message, const IPEndpoint& src);
 
@@ -142,11 +172,37 @@ class MdnsResponder {
                       const std::vector<MdnsQuestion>& questions,
                       const std::vector<MdnsRecord>& known_answers);
 
-  // Sends the response to the provided query.
-  void SendResponse(const MdnsQuestion& question,
-                    const std::vector<MdnsRecord>& known_answers,
-                    std::function<void(const MdnsMessage&)> send_response,
-                    bool is_exclusive_owner);
+  // Queues |question| to be answered with the other questions received before
+  // the pending multicast response is sent.
+  void AddPendingMulticastQuestion(PendingQuestion question);
+
+  // Sends the pending multicast response.
+  void SendPendingMulticastResponse();
+
+  // Sends the responses to |questions| to the multicast group, or to |dest|.
+  void SendMulticastResponse(const std::vector<PendingQuestion>& questions);
+  void SendUnicastResponse(const std::vector<PendingQuestion>& questions,
+                           const IPEndpoint& dest);
+
+  // Creates the response messages answering all of |questions|. Records which
+  // answer more than one question are only included once. If
+  // |is_multicast|, answers recently multicast by other responders are left
+  // out.
+  std::vector<MdnsMessage> CreateResponses(
+      const std::vector<PendingQuestion>& questions,
+      bool is_multicast);
+
+  // Returns whether another responder multicast |record|, with a TTL at least
+  // as long, within the last second.
+  bool WasRecentlyMulticast(const MdnsRecord& record) const;
+
+  // Forgets records which were multicast more than a second ago.
+  void PruneObservedRecords();
+
+  // MdnsReceiver::ResponseClient overrides, used to observe the records
+  // multicast by other responders.
+  void OnMessageReceived(const MdnsMessageView& message) override;
+  const MdnsNameFilter* GetNameFilter() const override;
 
   // Set of all truncated queries received so far. Per RFC 6762 section 7.1,
   // matching of a query with additional known answers should be done based on
@@ -154,6 +210,15 @@ class MdnsResponder {
   // NOTE: unique_ptrs used because TruncatedQuery is not movable.
   std::map<IPEndpoint, std::unique_ptr<TruncatedQuery>> truncated_queries_;
 
+  // Questions whose multicast responses are delayed, and the alarm which sends
+  // them all together.
+  std::vector<PendingQuestion> pending_multicast_questions_;
+  Alarm pending_multicast_alarm_;
+
+  // Records multicast by other responders within the last second, keyed by the
+  // hash of their names.
+  std::unordered_multimap<uint64_t, ObservedRecord> observed_records_;
+
   RecordHandler* const record_handler_;
   MdnsProbeManager* const ownership_handler_;
   MdnsSender* const sender_;
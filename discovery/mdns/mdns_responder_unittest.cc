@@ -12,6 +12,8 @@
 #include "discovery/mdns/mdns_receiver.h"
 #include "discovery/mdns/mdns_records.h"
 #include "discovery/mdns/mdns_sender.h"
+#include "discovery/mdns/mdns_writer.h"
+#include "platform/base/udp_packet.h"
 #include "platform/test/fake_clock.h"
 #include "platform/test/fake_task_runner.h"
 #include "platform/test/fake_udp_socket.h"
@@ -841,5 +843,79 @@ TEST_F(MdnsResponderTest, EnumerateAllQueryNoResults) {
   clock_.Advance(Clock::duration(kMaximumSharedRecordResponseDelayMs));
 }
 
+TEST_F(MdnsResponderTest, SharedResponsesAggregatedAcrossQueries) {
+  EXPECT_CALL(probe_manager_, IsDomainClaimed(_))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(record_handler_, HasRecords(_, _, _))
+      .WillRepeatedly(Return(true));
+  record_handler_.AddRecord(GetFakeSrvRecord(domain_));
+  record_handler_.AddRecord(GetFakeTxtRecord(domain_));
+
+  OnMessageReceived(CreateMulticastMdnsQuery(DnsType::kSRV), endpoint_);
+  OnMessageReceived(CreateMulticastMdnsQuery(DnsType::kTXT),
+                    IPEndpoint{IPAddress(192, 168, 0, 1), 80});
+  OnMessageReceived(CreateMulticastMdnsQuery(DnsType::kSRV),
+                    IPEndpoint{IPAddress(192, 168, 0, 2), 80});
+
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce([](const MdnsMessage& message) -> Error {
+        EXPECT_EQ(message.answers().size(), size_t{2});
+        EXPECT_TRUE(ContainsRecordType(message.answers(), DnsType::kSRV));
+        EXPECT_TRUE(ContainsRecordType(message.answers(), DnsType::kTXT));
+        return Error::None();
+      });
+  clock_.Advance(Clock::duration(kMaximumSharedRecordResponseDelayMs));
+}
+
+TEST_F(MdnsResponderTest, AnswersMulticastByOtherRespondersSuppressed) {
+  const MdnsRecord srv(domain_, DnsType::kSRV, DnsClass::kIN,
+                       RecordType::kShared, std::chrono::seconds(120),
+                       SrvRecordRdata(0, 0, 80, domain_));
+  const MdnsRecord txt(domain_, DnsType::kTXT, DnsClass::kIN,
+                       RecordType::kShared, std::chrono::seconds(120),
+                       TxtRecordRdata());
+  const MdnsRecord txt_with_shorter_ttl(
+      domain_, DnsType::kTXT, DnsClass::kIN, RecordType::kShared,
+      std::chrono::seconds(60), TxtRecordRdata());
+  EXPECT_CALL(probe_manager_, IsDomainClaimed(_))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(record_handler_, HasRecords(_, _, _))
+      .WillRepeatedly(Return(true));
+  record_handler_.AddRecord(srv);
+  record_handler_.AddRecord(txt);
+  OnMessageReceived(CreateMulticastMdnsQuery(DnsType::kANY), endpoint_);
+
+  // Another responder answers before this one does. Only answers multicast
+  // with a TTL at least as long as this host's are suppressed.
+  MdnsMessage response(0, MessageType::Response);
+  response.AddAnswer(srv);
+  response.AddAnswer(txt_with_shorter_ttl);
+  UdpPacket packet(response.MaxWireSize());
+  MdnsWriter writer(packet.data(), packet.size());
+  ASSERT_TRUE(writer.Write(response));
+  packet.resize(writer.offset());
+  receiver_.Start();
+  receiver_.OnRead(&socket_, std::move(packet));
+
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce([&txt](const MdnsMessage& message) -> Error {
+        EXPECT_EQ(message.answers().size(), size_t{1});
+        EXPECT_EQ(message.answers()[0], txt);
+        return Error::None();
+      });
+  clock_.Advance(Clock::duration(kMaximumSharedRecordResponseDelayMs));
+  testing::Mock::VerifyAndClearExpectations(&sender_);
+
+  // Once a second has passed, the records are sent again.
+  clock_.Advance(std::chrono::seconds(1));
+  OnMessageReceived(CreateMulticastMdnsQuery(DnsType::kANY), endpoint_);
+  EXPECT_CALL(sender_, SendMulticast(_))
+      .WillOnce([](const MdnsMessage& message) -> Error {
+        EXPECT_EQ(message.answers().size(), size_t{2});
+        return Error::None();
+      });
+  clock_.Advance(Clock::duration(kMaximumSharedRecordResponseDelayMs));
+}
+
 }  // namespace discovery
 }  // namespace openscreen
@@ -0,0 +1,113 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares building and serializing mDNS responses from MdnsRecords against
+// doing so from records carrying their MdnsEncodedRecord.
+
+#include <stdio.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "discovery/mdns/mdns_encoded_record.h"
+#include "discovery/mdns/mdns_records.h"
+#include "discovery/mdns/mdns_writer.h"
+#include "discovery/mdns/public/mdns_constants.h"
+#include "util/micro_benchmark.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace discovery {
+namespace {
+
+constexpr int kNumInstances = 4;
+constexpr std::chrono::seconds kTtl{120};
+
+TxtRecordRdata MakeTxtRdata(const std::vector<std::string>& texts) {
+  std::vector<TxtRecordRdata::Entry> entries;
+  for (const std::string& text : texts) {
+    entries.emplace_back(text.begin(), text.end());
+  }
+  ErrorOr<TxtRecordRdata> rdata = TxtRecordRdata::TryCreate(std::move(entries));
+  OSP_CHECK(rdata.is_value());
+  return std::move(rdata.value());
+}
+
+// The records a host publishing |kNumInstances| instances of one service sends
+// in response to a PTR query for it, as MdnsResponder does.
+std::vector<MdnsRecord> MakeServiceRecords() {
+  const DomainName service{"_googlecast", "_tcp", "local"};
+  std::vector<MdnsRecord> records;
+  for (int i = 0; i < kNumInstances; ++i) {
+    const std::string label = "Living-Room-TV-" + std::to_string(i);
+    const DomainName instance{label, "_googlecast", "_tcp", "local"};
+    const DomainName host{label, "local"};
+    records.emplace_back(service, DnsType::kPTR, DnsClass::kIN,
+                         RecordType::kShared, kTtl, PtrRecordRdata(instance));
+    records.emplace_back(instance, DnsType::kSRV, DnsClass::kIN,
+                         RecordType::kUnique, kTtl,
+                         SrvRecordRdata(0, 0, 8009, host));
+    records.emplace_back(
+        instance, DnsType::kTXT, DnsClass::kIN, RecordType::kUnique, kTtl,
+        MakeTxtRdata({"id=" + label, "fn=Living Room TV", "ca=4101", "st=0",
+                      "ve=05"}));
+    const uint8_t host_byte = static_cast<uint8_t>(10 + i);
+    records.emplace_back(host, DnsType::kA, DnsClass::kIN, RecordType::kUnique,
+                         kTtl, ARecordRdata(IPAddress{192, 168, 1, host_byte}));
+    const uint16_t host_hextet = static_cast<uint16_t>(i);
+    records.emplace_back(host, DnsType::kAAAA, DnsClass::kIN,
+                         RecordType::kUnique, kTtl,
+                         AAAARecordRdata(IPAddress{0xfe80, 0, 0, 0, 0x1234,
+                                                   0x5678, 0x9abc,
+                                                   host_hextet}));
+  }
+  return records;
+}
+
+// Builds a response message holding |records| and writes it to |buffer|,
+// returning the number of bytes written.
+size_t WriteResponse(const std::vector<MdnsRecord>& records,
+                     std::vector<uint8_t>* buffer) {
+  MdnsMessage message(0, MessageType::Response);
+  for (const MdnsRecord& record : records) {
+    message.AddAnswer(record);
+  }
+  MdnsWriter writer(buffer->data(), buffer->size());
+  OSP_CHECK(writer.Write(message));
+  return writer.offset();
+}
+
+void RunBenchmarks() {
+  const std::vector<MdnsRecord> records = MakeServiceRecords();
+  std::vector<MdnsRecord> precompiled;
+  for (const MdnsRecord& record : records) {
+    precompiled.push_back(MdnsEncodedRecord::Precompile(record));
+    OSP_CHECK(precompiled.back().encoded());
+  }
+
+  std::vector<uint8_t> buffer(kMaxMulticastMessageSize);
+  const size_t size = WriteResponse(records, &buffer);
+  OSP_CHECK_EQ(WriteResponse(precompiled, &buffer), size);
+  printf("Response: %zu records, %zu bytes\n", records.size(), size);
+
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Write response: MdnsRecord", size, [&records, &buffer] {
+        DoNotOptimize(WriteResponse(records, &buffer));
+      }));
+
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Write response: MdnsEncodedRecord", size, [&precompiled, &buffer] {
+        DoNotOptimize(WriteResponse(precompiled, &buffer));
+      }));
+}
+
+}  // namespace
+}  // namespace discovery
+}  // namespace openscreen
+
+int main(int argc, char** argv) {
+  openscreen::discovery::RunBenchmarks();
+  return 0;
+}
@@ -5,12 +5,15 @@
 #include "discovery/mdns/mdns_service_impl.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "discovery/common/reporting_client.h"
+#include "discovery/mdns/mdns_cache_snapshot.h"
 #include "discovery/mdns/mdns_records.h"
 #include "discovery/mdns/public/mdns_constants.h"
+#include "platform/api/time.h"
 
 namespace openscreen {
 namespace discovery {
@@ -34,7 +37,10 @@ MdnsServiceImpl::MdnsServiceImpl(TaskRunner* task_runner,
       now_function_(now_function),
       reporting_client_(reporting_client),
       receiver_(config),
-      interface_(network_info.index) {
+      interface_(network_info.index),
+      cache_snapshot_period_(
+          std::chrono::seconds(config.querier_cache_snapshot_period_seconds)),
+      cache_snapshot_alarm_(now_function, task_runner) {
   OSP_DCHECK(task_runner_);
   OSP_DCHECK(reporting_client_);
 
@@ -74,6 +80,16 @@ MdnsServiceImpl::MdnsServiceImpl(TaskRunner* task_runner,
     querier_ = std::make_unique<MdnsQuerier>(
         sender_.get(), &receiver_, task_runner_, now_function_, &random_delay_,
         reporting_client_, config);
+    if (!config.querier_cache_snapshot_path.empty()) {
+      cache_snapshot_path_ =
+          config.querier_cache_snapshot_path + "." +
+          (network_info.name.empty() ? std::to_string(network_info.index)
+                                     : network_info.name);
+      LoadCacheSnapshot(config);
+      if (cache_snapshot_period_ > Clock::duration::zero()) {
+        ScheduleCacheSnapshot();
+      }
+    }
   }
   if (config.enable_publication) {
     probe_manager_ = std::make_unique<MdnsProbeManagerImpl>(
@@ -100,7 +116,11 @@ MdnsServiceImpl::MdnsServiceImpl(TaskRunner* task_runner,
   }
 }
 
-MdnsServiceImpl::~MdnsServiceImpl() = default;
+MdnsServiceImpl::~MdnsServiceImpl() {
+  if (!cache_snapshot_path_.empty()) {
+    SaveCacheSnapshot();
+  }
+}
 
 void MdnsServiceImpl::StartQuery(const DomainName& name,
                                  DnsType dns_type,
@@ -140,6 +160,44 @@ Error MdnsServiceImpl::UnregisterRecord(const MdnsRecord& record) {
   return publisher_->UnregisterRecord(record);
 }
 
+void MdnsServiceImpl::LoadCacheSnapshot(const Config& config) {
+  ErrorOr<std::vector<uint8_t>> snapshot =
+      LoadMdnsCacheSnapshot(cache_snapshot_path_);
+  if (snapshot.is_error()) {
+    // There is no snapshot the first time a path is used.
+    OSP_DVLOG << "No mDNS cache snapshot loaded: " << snapshot.error();
+    return;
+  }
+
+  ErrorOr<std::vector<MdnsRecord>> records = ReadMdnsCacheSnapshot(
+      config, snapshot.value(), GetWallTimeSinceUnixEpoch());
+  if (records.is_error()) {
+    OSP_LOG_WARN << "Discarding invalid mDNS cache snapshot "
+                 << cache_snapshot_path_ << ": " << records.error();
+    return;
+  }
+  querier_->RestoreCachedRecords(std::move(records.value()));
+}
+
+void MdnsServiceImpl::SaveCacheSnapshot() {
+  const Error result = SaveMdnsCacheSnapshot(
+      cache_snapshot_path_,
+      WriteMdnsCacheSnapshot(querier_->GetCachedRecords(),
+                             GetWallTimeSinceUnixEpoch()));
+  if (!result.ok()) {
+    OSP_LOG_WARN << "Failed to save mDNS cache snapshot: " << result;
+  }
+}
+
+void MdnsServiceImpl::ScheduleCacheSnapshot() {
+  cache_snapshot_alarm_.ScheduleFromNow(
+      [this] {
+        SaveCacheSnapshot();
+        ScheduleCacheSnapshot();
+      },
+      cache_snapshot_period_);
+}
+
 void MdnsServiceImpl::OnError(UdpSocket* socket, Error error) {
   reporting_client_->OnFatalError(error);
 }
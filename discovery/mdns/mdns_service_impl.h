@@ -6,6 +6,7 @@
 #define DISCOVERY_MDNS_MDNS_SERVICE_IMPL_H_
 
 #include <memory>
+#include <string>
 
 #include "discovery/common/config.h"
 #include "discovery/mdns/mdns_domain_confirmed_provider.h"
@@ -22,6 +23,7 @@
 #include "discovery/mdns/public/mdns_constants.h"
 #include "discovery/mdns/public/mdns_service.h"
 #include "platform/api/udp_socket.h"
+#include "util/alarm.h"
 
 namespace openscreen {
 
@@ -69,6 +71,15 @@ class MdnsServiceImpl : public MdnsService, public UdpSocket::Client {
   void OnBound(UdpSocket* socket) override;
 
  private:
+  // Restores the querier's cache from the snapshot at |cache_snapshot_path_|.
+  void LoadCacheSnapshot(const Config& config);
+
+  // Saves the querier's cache to |cache_snapshot_path_|.
+  void SaveCacheSnapshot();
+
+  // Saves the querier's cache periodically.
+  void ScheduleCacheSnapshot();
+
   TaskRunner* const task_runner_;
   ClockNowFunctionPtr now_function_;
   ReportingClient* const reporting_client_;
@@ -88,6 +99,11 @@ class MdnsServiceImpl : public MdnsService, public UdpSocket::Client {
   std::unique_ptr<MdnsProbeManagerImpl> probe_manager_;
   std::unique_ptr<MdnsPublisher> publisher_;
   std::unique_ptr<MdnsResponder> responder_;
+
+  // Where the querier's cache is saved, or empty if it isn't.
+  std::string cache_snapshot_path_;
+  Clock::duration cache_snapshot_period_;
+  Alarm cache_snapshot_alarm_;
 };
 
 }  // namespace discovery
@@ -9,6 +9,7 @@
 #include <utility>
 
 #include "discovery/common/config.h"
+#include "discovery/mdns/mdns_query_aggregator.h"
 #include "discovery/mdns/mdns_random.h"
 #include "discovery/mdns/mdns_record_changed_callback.h"
 #include "discovery/mdns/mdns_sender.h"
@@ -205,6 +206,7 @@ ErrorOr<MdnsRecordTracker::UpdateType> MdnsRecordTracker::Update(
   }
 
   start_time_ = now_function_();
+  is_tentative_ = false;
   ScheduleFollowUpQuery();
 
   return result;
@@ -242,6 +244,15 @@ bool MdnsRecordTracker::IsNearingExpiry() const {
   return (now_function_() - start_time_) > record_.ttl() / 2;
 }
 
+std::chrono::seconds MdnsRecordTracker::GetRemainingTtl() const {
+  const Clock::duration remaining =
+      start_time_ + record_.ttl() - now_function_();
+  if (remaining <= Clock::duration::zero()) {
+    return std::chrono::seconds(0);
+  }
+  return std::chrono::duration_cast<std::chrono::seconds>(remaining);
+}
+
 bool MdnsRecordTracker::SendQuery() const {
   const Clock::time_point expiration_time = start_time_ + record_.ttl();
   bool is_expired = (now_function_() >= expiration_time);
@@ -291,13 +302,15 @@ MdnsQuestionTracker::MdnsQuestionTracker(MdnsQuestion question,
                                          ClockNowFunctionPtr now_function,
                                          MdnsRandom* random_delay,
                                          const Config& config,
-                                         QueryType query_type)
+                                         QueryType query_type,
+                                         MdnsQueryAggregator* query_aggregator)
     : MdnsTracker(sender,
                   task_runner,
                   now_function,
                   random_delay,
                   TrackerType::kQuestionTracker),
       question_(std::move(question)),
+      query_aggregator_(query_aggregator),
       send_delay_(kMinimumQueryInterval),
       query_type_(query_type),
       maximum_announcement_count_(config.new_query_announcement_count < 0
@@ -366,42 +379,32 @@ bool MdnsQuestionTracker::SendQuery() const {
   }
   last_send_time_ = now;
 
-  MdnsMessage message(CreateMessageId(), MessageType::Query);
-  message.AddQuestion(question_);
-
-  // Send the message and additional known answer packets as needed.
-  for (auto it = adjacent_nodes().begin(); it != adjacent_nodes().end();) {
-    OSP_DCHECK((*it)->tracker_type() == TrackerType::kRecordTracker);
+  MdnsQueryAggregator::Query query{question_, {}};
+  for (const MdnsTracker* tracker : adjacent_nodes()) {
+    OSP_DCHECK(tracker->tracker_type() == TrackerType::kRecordTracker);
 
     const MdnsRecordTracker* record_tracker =
-        static_cast<const MdnsRecordTracker*>(*it);
-    if (record_tracker->IsNearingExpiry()) {
-      it++;
+        static_cast<const MdnsRecordTracker*>(tracker);
+    if (record_tracker->IsNearingExpiry() || record_tracker->is_tentative()) {
       continue;
     }
 
     // A record tracker should only contain one record.
-    std::vector<MdnsRecord> node_records = (*it)->GetRecords();
+    std::vector<MdnsRecord> node_records = tracker->GetRecords();
     OSP_DCHECK(node_records.size() == 1);
-    MdnsRecord node_record = std::move(node_records[0]);
-
-    if (message.CanAddRecord(node_record)) {
-      message.AddAnswer(std::move(node_record));
-      it++;
-    } else if (message.questions().empty() && message.answers().empty()) {
-      // This case should never happen, because it means a record is too large
-      // to fit into its own message.
-      OSP_LOG_INFO
-          << "Encountered unreasonably large message in cache. Skipping "
-          << "known answer in suppressions...";
-      it++;
-    } else {
-      message.set_truncated();
-      sender_->SendMulticast(message);
-      message = MdnsMessage(CreateMessageId(), MessageType::Query);
-    }
+    query.known_answers.push_back(std::move(node_records[0]));
+  }
+
+  if (query_aggregator_) {
+    query_aggregator_->AddQuery(std::move(query));
+    return true;
+  }
+
+  // Send the message and additional known answer packets as needed.
+  for (const MdnsMessage& message :
+       MdnsQueryAggregator::CreateMessages({std::move(query)})) {
+    sender_->SendMulticast(message);
   }
-  sender_->SendMulticast(message);
   return true;
 }
 
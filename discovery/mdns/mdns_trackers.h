@@ -96,6 +96,7 @@ class MdnsTracker {
   mutable std::vector<const MdnsTracker*> adjacent_nodes_;
 };
 
+class MdnsQueryAggregator;
 class MdnsQuestionTracker;
 
 // MdnsRecordTracker manages automatic resending of mDNS queries for
@@ -145,6 +146,17 @@ class MdnsRecordTracker : public MdnsTracker {
   // Half is used due to specifications in RFC 6762 section 7.1.
   bool IsNearingExpiry() const;
 
+  // Returns the time left until the record expires, rounded down to whole
+  // seconds.
+  std::chrono::seconds GetRemainingTtl() const;
+
+  // Marks the record as restored from a cache snapshot rather than received
+  // from the network. Tentative records are not sent as known answers, so that
+  // responders still answer queries for them, and stop being tentative once a
+  // response updates them.
+  void MarkTentative() { is_tentative_ = true; }
+  bool is_tentative() const { return is_tentative_; }
+
   // Returns information about the stored record.
   //
   // NOTE: These methods are NOT all pass-through methods to |record_|.
@@ -194,6 +206,10 @@ class MdnsRecordTracker : public MdnsTracker {
 
   // Number of times record refresh has been attempted.
   size_t attempt_count_ = 0;
+
+  // Whether the record was restored from a snapshot and not yet confirmed.
+  bool is_tentative_ = false;
+
   RecordExpiredCallback record_expired_callback_;
 };
 
@@ -204,13 +220,17 @@ class MdnsQuestionTracker : public MdnsTracker {
   // Supported query types, per RFC 6762 section 5.
   enum class QueryType { kOneShot, kContinuous };
 
+  // If |query_aggregator| is provided, queries are sent through it so they can
+  // share messages with those of other trackers. Otherwise, each query is sent
+  // as soon as it is due.
   MdnsQuestionTracker(MdnsQuestion question,
                       MdnsSender* sender,
                       TaskRunner* task_runner,
                       ClockNowFunctionPtr now_function,
                       MdnsRandom* random_delay,
                       const Config& config,
-                      QueryType query_type = QueryType::kContinuous);
+                      QueryType query_type = QueryType::kContinuous,
+                      MdnsQueryAggregator* query_aggregator = nullptr);
 
   ~MdnsQuestionTracker() override;
 
@@ -237,6 +257,8 @@ class MdnsQuestionTracker : public MdnsTracker {
   // Stores MdnsQuestion provided to Start method call.
   MdnsQuestion question_;
 
+  MdnsQueryAggregator* const query_aggregator_;
+
   // A delay between the currently scheduled and the next queries.
   Clock::duration send_delay_;
 
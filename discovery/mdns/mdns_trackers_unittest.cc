@@ -282,6 +282,31 @@ TEST_F(MdnsTrackerTest, RecordTrackerUpdateResetsTtl) {
   EXPECT_FALSE(expiration_called_);
 }
 
+TEST_F(MdnsTrackerTest, RecordTrackerRemainingTtl) {
+  std::unique_ptr<MdnsRecordTracker> tracker = CreateRecordTracker(a_record_);
+  EXPECT_EQ(tracker->GetRemainingTtl(), a_record_.ttl());
+
+  // Partial seconds are rounded down.
+  clock_.Advance(std::chrono::milliseconds(10500));
+  EXPECT_EQ(tracker->GetRemainingTtl(),
+            a_record_.ttl() - std::chrono::seconds(11));
+
+  EXPECT_EQ(tracker->Update(a_record_).value(),
+            MdnsRecordTracker::UpdateType::kTTLOnly);
+  EXPECT_EQ(tracker->GetRemainingTtl(), a_record_.ttl());
+}
+
+TEST_F(MdnsTrackerTest, RecordTrackerUpdateClearsTentative) {
+  std::unique_ptr<MdnsRecordTracker> tracker = CreateRecordTracker(a_record_);
+  EXPECT_FALSE(tracker->is_tentative());
+  tracker->MarkTentative();
+  EXPECT_TRUE(tracker->is_tentative());
+
+  EXPECT_EQ(tracker->Update(a_record_).value(),
+            MdnsRecordTracker::UpdateType::kTTLOnly);
+  EXPECT_FALSE(tracker->is_tentative());
+}
+
 TEST_F(MdnsTrackerTest, RecordTrackerForceExpiration) {
   expiration_called_ = false;
   std::unique_ptr<MdnsRecordTracker> tracker = CreateRecordTracker(a_record_);
@@ -19,18 +19,6 @@ namespace discovery {
 
 namespace {
 
-std::vector<uint64_t> ComputeDomainNameSubhashes(const DomainName& name) {
-  const std::vector<std::string>& labels = name.labels();
-  uint64_t hash_value = openscreen::kDefaultSeed;
-  std::vector<uint64_t> subhashes(labels.size());
-  for (size_t i = labels.size(); i-- > 0;) {
-    hash_value =
-        ComputeAggregateHash(hash_value, absl::AsciiStrToLower(labels[i]));
-    subhashes[i] = hash_value;
-  }
-  return subhashes;
-}
-
 // This helper method writes the number of bytes between |begin| and |end| minus
 // the size of the uint16_t into the uint16_t length field at |begin|. The
 // method returns true if the number of bytes between |begin| and |end| fits in
@@ -72,7 +60,7 @@ bool MdnsWriter::Write(const DomainName& name) {
   }
 
   Cursor cursor(this);
-  const std::vector<uint64_t> subhashes = ComputeDomainNameSubhashes(name);
+  const std::vector<uint64_t> subhashes = GetCompressionHashes(name);
   // Tentative dictionary contains label pointer entries to be added to the
   // compression dictionary after successfully writing the domain name.
   std::unordered_map<uint64_t, uint16_t> tentative_dictionary;
@@ -212,6 +200,10 @@ bool MdnsWriter::Write(const OptRecordRdata& rdata) {
 }
 
 bool MdnsWriter::Write(const MdnsRecord& record) {
+  if (record.encoded()) {
+    return Write(*record.encoded(), record.ttl());
+  }
+
   Cursor cursor(this);
   if (Write(record.name()) && Write(static_cast<uint16_t>(record.dns_type())) &&
       Write(MakeRecordClass(record.dns_class(), record.record_type())) &&
@@ -223,6 +215,48 @@ bool MdnsWriter::Write(const MdnsRecord& record) {
   return false;
 }
 
+bool MdnsWriter::Write(const MdnsEncodedRecord& record,
+                       std::chrono::seconds ttl) {
+  OSP_DCHECK(!record.names().empty());
+  OSP_DCHECK_EQ(record.names()[0].offset, size_t{0});
+
+  Cursor cursor(this);
+  const MdnsEncodedRecord::Name& record_name = record.names()[0];
+  if (!Write(record, record_name)) {
+    return false;
+  }
+  uint8_t* const fields = current();
+  size_t copied = record_name.size;
+  if (!Write(record.data() + copied, MdnsEncodedRecord::kFixedFieldsSize)) {
+    return false;
+  }
+  copied += MdnsEncodedRecord::kFixedFieldsSize;
+  WriteBigEndian<uint32_t>(static_cast<uint32_t>(ttl.count()),
+                           fields + sizeof(uint16_t) * 2);
+
+  for (size_t i = 1; i < record.names().size(); ++i) {
+    const MdnsEncodedRecord::Name& name = record.names()[i];
+    if (!Write(record.data() + copied, name.offset - copied) ||
+        !Write(record, name)) {
+      return false;
+    }
+    copied = name.offset + name.size;
+  }
+  if (!Write(record.data() + copied, record.size() - copied)) {
+    return false;
+  }
+
+  // Names in the rdata may have been compressed.
+  uint8_t* const rdata_length =
+      fields + MdnsEncodedRecord::kFixedFieldsSize - sizeof(uint16_t);
+  if (record.names().size() > 1 &&
+      !UpdateRecordLength(current(), rdata_length)) {
+    return false;
+  }
+  cursor.Commit();
+  return true;
+}
+
 bool MdnsWriter::Write(const MdnsQuestion& question) {
   Cursor cursor(this);
   if (Write(question.name()) &&
@@ -253,6 +287,20 @@ bool MdnsWriter::Write(const MdnsMessage& message) {
   return false;
 }
 
+// static
+std::vector<uint64_t> MdnsWriter::GetCompressionHashes(
+    const DomainName& name) {
+  const std::vector<std::string>& labels = name.labels();
+  uint64_t hash_value = openscreen::kDefaultSeed;
+  std::vector<uint64_t> subhashes(labels.size());
+  for (size_t i = labels.size(); i-- > 0;) {
+    hash_value =
+        ComputeAggregateHash(hash_value, absl::AsciiStrToLower(labels[i]));
+    subhashes[i] = hash_value;
+  }
+  return subhashes;
+}
+
 bool MdnsWriter::Write(const IPAddress& address) {
   uint8_t bytes[IPAddress::kV6Size];
   size_t size;
@@ -281,5 +329,50 @@ bool MdnsWriter::Write(const Header& header) {
   return false;
 }
 
+bool MdnsWriter::Write(const MdnsEncodedRecord& record,
+                       const MdnsEncodedRecord::Name& name) {
+  // Find the longest suffix of the name which has already been written, and
+  // the labels which precede it. Unlike Write(const DomainName&), the whole
+  // name is measured up front, so that nothing needs to be rolled back.
+  const uint8_t* const labels = record.data() + name.offset;
+  size_t labels_size = 0;
+  size_t label_count = 0;
+  const uint16_t* pointer = nullptr;
+  for (; label_count < name.hashes.size(); ++label_count) {
+    auto find_result = dictionary_.find(name.hashes[label_count]);
+    if (find_result != dictionary_.end()) {
+      pointer = &find_result->second;
+      break;
+    }
+    labels_size += 1 + labels[labels_size];
+  }
+  const size_t size =
+      labels_size + (pointer ? sizeof(uint16_t) : sizeof(kLabelTermination));
+  if (remaining() < size) {
+    return false;
+  }
+
+  // As in Write(const DomainName&), pointers to the labels written are only
+  // added to the compression dictionary once the name has been written.
+  std::unordered_map<uint64_t, uint16_t> tentative_dictionary;
+  size_t label_offset = 0;
+  for (size_t i = 0; i < label_count; ++i) {
+    const size_t offset = current() - begin() + label_offset;
+    if (IsValidPointerLabelOffset(offset)) {
+      tentative_dictionary.insert(
+          std::make_pair(name.hashes[i], MakePointerLabel(offset)));
+    }
+    label_offset += 1 + labels[label_offset];
+  }
+  const bool written = Write(labels, labels_size) &&
+                       (pointer ? Write(*pointer) : Write(kLabelTermination));
+  OSP_DCHECK(written);
+  if (written) {
+    dictionary_.insert(tentative_dictionary.begin(),
+                       tentative_dictionary.end());
+  }
+  return written;
+}
+
 }  // namespace discovery
 }  // namespace openscreen
@@ -5,10 +5,12 @@
 #ifndef DISCOVERY_MDNS_MDNS_WRITER_H_
 #define DISCOVERY_MDNS_MDNS_WRITER_H_
 
+#include <chrono>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "discovery/mdns/mdns_encoded_record.h"
 #include "discovery/mdns/mdns_records.h"
 #include "util/big_endian.h"
 
@@ -37,18 +39,30 @@ class MdnsWriter : public BigEndianWriter {
   bool Write(const OptRecordRdata& rdata);
   // Writes a DNS resource record with its RDATA.
   // The correct type of RDATA to be written is contained in the type
-  // specified in the record.
+  // specified in the record. Records which carry their encoded form are
+  // written from it.
   bool Write(const MdnsRecord& record);
+  // Writes a DNS resource record from its encoded form, with TTL |ttl|.
+  bool Write(const MdnsEncodedRecord& record, std::chrono::seconds ttl);
   bool Write(const MdnsQuestion& question);
   // Writes multiple mDNS questions and records that are a part of
   // a mDNS message being read
   bool Write(const MdnsMessage& message);
 
+  // Returns the hashes under which the suffixes of |name| are held in the
+  // compression dictionary, starting with the whole name.
+  static std::vector<uint64_t> GetCompressionHashes(const DomainName& name);
+
  private:
   bool Write(const IPAddress& address);
   bool Write(const Rdata& rdata);
   bool Write(const Header& header);
 
+  // Writes the name at |name| in |record|, compressing it against the names
+  // already written.
+  bool Write(const MdnsEncodedRecord& record,
+             const MdnsEncodedRecord::Name& name);
+
   template <class ItemType>
   bool Write(const std::vector<ItemType>& collection) {
     Cursor cursor(this);
@@ -5,6 +5,8 @@
 #ifndef DISCOVERY_PUBLIC_DNS_SD_SERVICE_FACTORY_H_
 #define DISCOVERY_PUBLIC_DNS_SD_SERVICE_FACTORY_H_
 
+#include <functional>
+
 #include "discovery/dnssd/public/dns_sd_service.h"
 #include "platform/api/serial_delete_ptr.h"
 
@@ -22,6 +24,24 @@ SerialDeletePtr<DnsSdService> CreateDnsSdService(
     ReportingClient* reporting_client,
     const Config& config);
 
+// Returns the TaskRunner on which the mDNS stack for |network_info| should run.
+using InterfaceTaskRunnerProvider =
+    std::function<TaskRunner*(const InterfaceInfo& network_info)>;
+
+// As above, but the mDNS stack for each interface in |config| runs on the
+// TaskRunner returned for it by |interface_task_runners|, so that traffic on
+// one interface doesn't delay the handling of traffic on any other. The
+// returned service, its callbacks, and |reporting_client| are still called on
+// |task_runner|. Interfaces for which |task_runner| or nullptr is returned run
+// on |task_runner|. The returned TaskRunners must outlive the service.
+// Publisher calls don't wait for the other TaskRunners: errors those interfaces
+// return are reported to |reporting_client| as recoverable errors instead.
+SerialDeletePtr<DnsSdService> CreateDnsSdService(
+    TaskRunner* task_runner,
+    ReportingClient* reporting_client,
+    const Config& config,
+    InterfaceTaskRunnerProvider interface_task_runners);
+
 }  // namespace discovery
 }  // namespace openscreen
 
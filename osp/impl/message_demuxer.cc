@@ -4,6 +4,7 @@
 
 #include "osp/public/message_demuxer.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -19,7 +20,7 @@ namespace osp {
 // Decodes a varUint, expecting it to follow the encoding format described here:
 // https://tools.ietf.org/html/draft-ietf-quic-transport-16#section-16
 ErrorOr<uint64_t> MessageTypeDecoder::DecodeVarUint(
-    const std::vector<uint8_t>& buffer,
+    Span<const uint8_t> buffer,
     size_t* num_bytes_decoded) {
   if (buffer.size() == 0) {
     return Error::Code::kCborIncompleteMessage;
@@ -53,7 +54,7 @@ ErrorOr<uint64_t> MessageTypeDecoder::DecodeVarUint(
 // described here:
 // https://tools.ietf.org/html/draft-ietf-quic-transport-16#section-16
 ErrorOr<msgs::Type> MessageTypeDecoder::DecodeType(
-    const std::vector<uint8_t>& buffer,
+    Span<const uint8_t> buffer,
     size_t* num_bytes_decoded) {
   ErrorOr<uint64_t> message_type =
       MessageTypeDecoder::DecodeVarUint(buffer, num_bytes_decoded);
@@ -117,6 +118,34 @@ MessageDemuxer::MessageWatch& MessageDemuxer::MessageWatch::operator=(
   return *this;
 }
 
+MessageDemuxer::StreamBuffer::StreamBuffer() = default;
+MessageDemuxer::StreamBuffer::StreamBuffer(StreamBuffer&&) noexcept = default;
+MessageDemuxer::StreamBuffer::~StreamBuffer() = default;
+MessageDemuxer::StreamBuffer& MessageDemuxer::StreamBuffer::operator=(
+    StreamBuffer&&) noexcept = default;
+
+void MessageDemuxer::StreamBuffer::Append(const uint8_t* data,
+                                          size_t data_size) {
+  if (begin_) {
+    data_.erase(data_.begin(), data_.begin() + begin_);
+    begin_ = 0;
+  }
+  data_.insert(data_.end(), data, data + data_size);
+}
+
+void MessageDemuxer::StreamBuffer::Consume(size_t size) {
+  OSP_DCHECK_LE(size, this->size());
+  begin_ += size;
+  if (begin_ == data_.size()) {
+    Clear();
+  }
+}
+
+void MessageDemuxer::StreamBuffer::Clear() {
+  data_.clear();
+  begin_ = 0;
+}
+
 MessageDemuxer::MessageDemuxer(ClockNowFunctionPtr now_function,
                                size_t buffer_limit = kDefaultBufferLimit)
     : now_function_(now_function), buffer_limit_(buffer_limit) {
@@ -129,25 +158,23 @@ MessageDemuxer::MessageWatch MessageDemuxer::WatchMessageType(
     uint64_t endpoint_id,
     msgs::Type message_type,
     MessageCallback* callback) {
-  auto callbacks_entry = message_callbacks_.find(endpoint_id);
-  if (callbacks_entry == message_callbacks_.end()) {
-    callbacks_entry =
-        message_callbacks_
-            .emplace(endpoint_id, std::map<msgs::Type, MessageCallback*>{})
-            .first;
-  }
-  auto emplace_result = callbacks_entry->second.emplace(message_type, callback);
-  if (!emplace_result.second)
+  const size_t index = msgs::GetTypeIndex(message_type);
+  OSP_DCHECK_LT(index, msgs::kNumTypes);
+  CallbackTable& callbacks = message_callbacks_[endpoint_id];
+  if (callbacks[index])
     return MessageWatch();
+  callbacks[index] = callback;
+
   auto endpoint_entry = buffers_.find(endpoint_id);
   if (endpoint_entry != buffers_.end()) {
     for (auto& buffer : endpoint_entry->second) {
-      if (buffer.second.empty())
-        continue;
-      auto buffered_type = static_cast<msgs::Type>(buffer.second[0]);
-      if (message_type == buffered_type) {
-        HandleStreamBufferLoop(endpoint_id, buffer.first, callbacks_entry,
-                               &buffer.second);
+      size_t type_length;
+      ErrorOr<msgs::Type> buffered_type = MessageTypeDecoder::DecodeType(
+          Span<const uint8_t>(buffer.second.data(), buffer.second.size()),
+          &type_length);
+      if (buffered_type && buffered_type.value() == message_type) {
+        HandleStreamBuffer(endpoint_id, buffer.first, &callbacks,
+                           &buffer.second);
       }
     }
   }
@@ -157,20 +184,22 @@ MessageDemuxer::MessageWatch MessageDemuxer::WatchMessageType(
 MessageDemuxer::MessageWatch MessageDemuxer::SetDefaultMessageTypeWatch(
     msgs::Type message_type,
     MessageCallback* callback) {
-  auto emplace_result = default_callbacks_.emplace(message_type, callback);
-  if (!emplace_result.second)
+  const size_t index = msgs::GetTypeIndex(message_type);
+  OSP_DCHECK_LT(index, msgs::kNumTypes);
+  if (default_callbacks_[index])
     return MessageWatch();
+  default_callbacks_[index] = callback;
+
   for (auto& endpoint_buffers : buffers_) {
-    auto endpoint_id = endpoint_buffers.first;
-    for (auto& stream_map : endpoint_buffers.second) {
-      if (stream_map.second.empty())
-        continue;
-      auto buffered_type = static_cast<msgs::Type>(stream_map.second[0]);
-      if (message_type == buffered_type) {
-        auto connection_id = stream_map.first;
-        auto callbacks_entry = message_callbacks_.find(endpoint_id);
-        HandleStreamBufferLoop(endpoint_id, connection_id, callbacks_entry,
-                               &stream_map.second);
+    const uint64_t endpoint_id = endpoint_buffers.first;
+    for (auto& buffer : endpoint_buffers.second) {
+      size_t type_length;
+      ErrorOr<msgs::Type> buffered_type = MessageTypeDecoder::DecodeType(
+          Span<const uint8_t>(buffer.second.data(), buffer.second.size()),
+          &type_length);
+      if (buffered_type && buffered_type.value() == message_type) {
+        HandleStreamBuffer(endpoint_id, buffer.first,
+                           GetEndpointCallbacks(endpoint_id), &buffer.second);
       }
     }
   }
@@ -190,96 +219,132 @@ void MessageDemuxer::OnStreamData(uint64_t endpoint_id,
       buffers_.erase(endpoint_id);
     return;
   }
-  std::vector<uint8_t>& buffer = stream_map[connection_id];
-  buffer.insert(buffer.end(), data, data + data_size);
 
-  auto callbacks_entry = message_callbacks_.find(endpoint_id);
-  HandleStreamBufferLoop(endpoint_id, connection_id, callbacks_entry, &buffer);
+  const CallbackTable* endpoint_callbacks = GetEndpointCallbacks(endpoint_id);
+  StreamBuffer& buffer = stream_map[connection_id];
+  if (!buffer.empty()) {
+    buffer.Append(data, data_size);
+    HandleStreamBuffer(endpoint_id, connection_id, endpoint_callbacks,
+                       &buffer);
+  } else {
+    // Nothing is waiting on this stream, so handle messages straight from
+    // |data|, and only copy what's left over.
+    HandleStreamDataResult result =
+        HandleStreamData(endpoint_id, connection_id, endpoint_callbacks,
+                         Span<const uint8_t>(data, data_size));
+    if (!result.discard && result.consumed < data_size) {
+      buffer.Append(data + result.consumed, data_size - result.consumed);
+    }
+  }
 
-  if (buffer.size() > buffer_limit_)
+  if (buffer.size() > GetBufferLimit(endpoint_callbacks, buffer))
     stream_map.erase(connection_id);
 }
 
+void MessageDemuxer::SetMessageTypeBufferLimit(msgs::Type message_type,
+                                               size_t buffer_limit) {
+  const size_t index = msgs::GetTypeIndex(message_type);
+  OSP_DCHECK_LT(index, msgs::kNumTypes);
+  type_buffer_limits_[index] = buffer_limit;
+}
+
 void MessageDemuxer::StopWatchingMessageType(uint64_t endpoint_id,
                                              msgs::Type message_type) {
-  auto& message_map = message_callbacks_[endpoint_id];
-  auto it = message_map.find(message_type);
-  message_map.erase(it);
+  auto it = message_callbacks_.find(endpoint_id);
+  OSP_DCHECK(it != message_callbacks_.end());
+  it->second[msgs::GetTypeIndex(message_type)] = nullptr;
 }
 
 void MessageDemuxer::StopDefaultMessageTypeWatch(msgs::Type message_type) {
-  default_callbacks_.erase(message_type);
+  default_callbacks_[msgs::GetTypeIndex(message_type)] = nullptr;
 }
 
-MessageDemuxer::HandleStreamBufferResult MessageDemuxer::HandleStreamBufferLoop(
-    uint64_t endpoint_id,
-    uint64_t connection_id,
-    std::map<uint64_t, std::map<msgs::Type, MessageCallback*>>::iterator
-        callbacks_entry,
-    std::vector<uint8_t>* buffer) {
-  HandleStreamBufferResult result;
-  do {
-    result = {false, 0};
-    if (callbacks_entry != message_callbacks_.end()) {
-      OSP_VLOG << "attempting endpoint-specific handling";
-      result = HandleStreamBuffer(endpoint_id, connection_id,
-                                  &callbacks_entry->second, buffer);
-    }
-    if (!result.handled) {
-      if (!default_callbacks_.empty()) {
-        OSP_VLOG << "attempting generic message handling";
-        result = HandleStreamBuffer(endpoint_id, connection_id,
-                                    &default_callbacks_, buffer);
-      }
-    }
-    OSP_VLOG_IF(!result.handled) << "no message handler matched";
-  } while (result.consumed && !buffer->empty());
-  return result;
+const MessageDemuxer::CallbackTable* MessageDemuxer::GetEndpointCallbacks(
+    uint64_t endpoint_id) const {
+  auto it = message_callbacks_.find(endpoint_id);
+  return it == message_callbacks_.end() ? nullptr : &it->second;
+}
+
+size_t MessageDemuxer::GetBufferLimit(const CallbackTable* endpoint_callbacks,
+                                      const StreamBuffer& buffer) const {
+  size_t type_length;
+  ErrorOr<msgs::Type> buffered_type = MessageTypeDecoder::DecodeType(
+      Span<const uint8_t>(buffer.data(), buffer.size()), &type_length);
+  if (!buffered_type) {
+    return buffer_limit_;
+  }
+
+  // A type's own limit only applies while something is watching for it, so
+  // nobody can make the demuxer hold a large message that won't be handled.
+  const size_t index = msgs::GetTypeIndex(buffered_type.value());
+  const bool is_watched =
+      (endpoint_callbacks && (*endpoint_callbacks)[index]) ||
+      default_callbacks_[index];
+  if (!is_watched || !type_buffer_limits_[index]) {
+    return buffer_limit_;
+  }
+  return std::max(buffer_limit_, type_buffer_limits_[index]);
 }
 
-// TODO(issuetracker.google.com/281741443): Use openscreen::Span for the
-// |buffer|.
-MessageDemuxer::HandleStreamBufferResult MessageDemuxer::HandleStreamBuffer(
+MessageDemuxer::HandleStreamDataResult MessageDemuxer::HandleStreamData(
     uint64_t endpoint_id,
     uint64_t connection_id,
-    std::map<msgs::Type, MessageCallback*>* message_callbacks,
-    std::vector<uint8_t>* buffer) {
-  size_t consumed = 0;
+    const CallbackTable* endpoint_callbacks,
+    Span<const uint8_t> data) {
   size_t total_consumed = 0;
-  bool handled = false;
-  do {
-    consumed = 0;
+  while (total_consumed < data.size()) {
+    Span<const uint8_t> remaining(data.data() + total_consumed,
+                                  data.size() - total_consumed);
     size_t msg_type_byte_length;
     ErrorOr<msgs::Type> message_type =
-        MessageTypeDecoder::DecodeType(*buffer, &msg_type_byte_length);
+        MessageTypeDecoder::DecodeType(remaining, &msg_type_byte_length);
     if (message_type.is_error()) {
-      buffer->clear();
-      break;
+      return HandleStreamDataResult{total_consumed, true};
     }
-    auto callback_entry = message_callbacks->find(message_type.value());
-    if (callback_entry == message_callbacks->end())
+
+    // Endpoint-specific callbacks take precedence over default ones.
+    const size_t index = msgs::GetTypeIndex(message_type.value());
+    MessageCallback* callback =
+        endpoint_callbacks ? (*endpoint_callbacks)[index] : nullptr;
+    if (!callback) {
+      callback = default_callbacks_[index];
+    }
+    if (!callback) {
+      OSP_VLOG << "no message handler matched";
       break;
-    handled = true;
+    }
+
     OSP_VLOG << "handling message type "
              << static_cast<int>(message_type.value());
-    auto consumed_or_error = callback_entry->second->OnStreamMessage(
+    ErrorOr<size_t> consumed_or_error = callback->OnStreamMessage(
         endpoint_id, connection_id, message_type.value(),
-        buffer->data() + msg_type_byte_length,
-        buffer->size() - msg_type_byte_length, now_function_());
+        remaining.data() + msg_type_byte_length,
+        remaining.size() - msg_type_byte_length, now_function_());
     if (!consumed_or_error) {
-      if (consumed_or_error.error().code() !=
-          Error::Code::kCborIncompleteMessage) {
-        buffer->clear();
-        break;
-      }
-    } else {
-      consumed = consumed_or_error.value();
-      buffer->erase(buffer->begin(),
-                    buffer->begin() + consumed + msg_type_byte_length);
+      const bool discard = consumed_or_error.error().code() !=
+                           Error::Code::kCborIncompleteMessage;
+      return HandleStreamDataResult{total_consumed, discard};
+    }
+    total_consumed += msg_type_byte_length + consumed_or_error.value();
+    if (!consumed_or_error.value()) {
+      break;
     }
-    total_consumed += consumed;
-  } while (consumed && !buffer->empty());
-  return HandleStreamBufferResult{handled, total_consumed};
+  }
+  return HandleStreamDataResult{total_consumed, false};
+}
+
+void MessageDemuxer::HandleStreamBuffer(uint64_t endpoint_id,
+                                        uint64_t connection_id,
+                                        const CallbackTable* endpoint_callbacks,
+                                        StreamBuffer* buffer) {
+  HandleStreamDataResult result =
+      HandleStreamData(endpoint_id, connection_id, endpoint_callbacks,
+                       Span<const uint8_t>(buffer->data(), buffer->size()));
+  if (result.discard) {
+    buffer->Clear();
+  } else {
+    buffer->Consume(result.consumed);
+  }
 }
 
 void StopWatching(MessageDemuxer::MessageWatch* watch) {
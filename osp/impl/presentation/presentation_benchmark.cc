@@ -0,0 +1,314 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Runs a Controller and a Receiver against each other, end to end, and reports
+// how long it takes to set up their QUIC connection and start presentations,
+// and how quickly presentation-connection-messages of various sizes make a
+// round trip or stream from one to the other.
+//
+// The two sides are connected through the FakeQuicBridge used by the unit
+// tests, so these numbers cover the Open Screen Protocol stack above QUIC
+// (message encoding, demuxing, and the presentation state machines) but not
+// QUIC itself or the network.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "osp/impl/quic/testing/quic_test_support.h"
+#include "osp/impl/service_listener_impl.h"
+#include "osp/public/network_service_manager.h"
+#include "osp/public/presentation/presentation_connection.h"
+#include "osp/public/presentation/presentation_controller.h"
+#include "osp/public/presentation/presentation_receiver.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "util/micro_benchmark.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace osp {
+namespace {
+
+using WallClock = std::chrono::steady_clock;
+
+constexpr char kServiceId[] = "service-id";
+constexpr int kNumPresentations = 100;
+constexpr int kMessagesPerBurst = 32;
+constexpr size_t kMessageSizes[] = {16, 256, 4096, 32768};
+
+// Receivers are found by the mDNS listener in production; here the benchmark
+// adds the receiver itself.
+class NoopListenerDelegate final : public ServiceListenerImpl::Delegate {
+ public:
+  ~NoopListenerDelegate() override = default;
+
+  ServiceListenerImpl* listener() { return listener_; }
+
+  void StartListener() override {}
+  void StartAndSuspendListener() override {}
+  void StopListener() override {}
+  void SuspendListener() override {}
+  void ResumeListener() override {}
+  void SearchNow(ServiceListener::State from) override {}
+};
+
+// Counts the messages received on one end of a presentation connection, and
+// echoes them back while |*echo| is set.
+class CountingConnectionDelegate final : public Connection::Delegate {
+ public:
+  explicit CountingConnectionDelegate(const bool* echo) : echo_(echo) {}
+  ~CountingConnectionDelegate() override = default;
+
+  void set_connection(Connection* connection) { connection_ = connection; }
+  int64_t messages_received() const { return messages_received_; }
+
+  // Connection::Delegate overrides.
+  void OnConnected() override {}
+  void OnClosedByRemote() override {}
+  void OnDiscarded() override {}
+  void OnError(const absl::string_view message) override {
+    OSP_LOG_ERROR << "presentation connection error: " << message;
+  }
+  void OnTerminated() override {}
+
+  void OnStringMessage(const absl::string_view message) override {
+    ++messages_received_;
+    if (echo_ && *echo_) {
+      OSP_CHECK(connection_->SendString(message).ok());
+    }
+  }
+
+  void OnBinaryMessage(const std::vector<uint8_t>& data) override {
+    ++messages_received_;
+  }
+
+ private:
+  const bool* const echo_;
+  Connection* connection_ = nullptr;
+  int64_t messages_received_ = 0;
+};
+
+class BenchmarkRequestDelegate final : public RequestDelegate {
+ public:
+  ~BenchmarkRequestDelegate() override = default;
+
+  std::unique_ptr<Connection> TakeConnection() {
+    return std::move(connection_);
+  }
+
+  // RequestDelegate overrides.
+  void OnConnection(std::unique_ptr<Connection> connection) override {
+    connection_ = std::move(connection);
+  }
+  void OnError(const Error& error) override {
+    OSP_LOG_FATAL << "failed to start presentation: " << error;
+  }
+
+ private:
+  std::unique_ptr<Connection> connection_;
+};
+
+// Accepts every presentation, and echoes messages on each of its connections
+// while |echo| is set.
+class BenchmarkReceiverDelegate final : public ReceiverDelegate {
+ public:
+  ~BenchmarkReceiverDelegate() override = default;
+
+  void set_echo(bool echo) { echo_ = echo; }
+
+  // Returns the total number of messages received on all connections.
+  int64_t messages_received() const {
+    int64_t total = 0;
+    for (const auto& delegate : delegates_) {
+      total += delegate->messages_received();
+    }
+    return total;
+  }
+
+  // Must be called before the Receiver is deinitialized.
+  void DestroyConnections() { connections_.clear(); }
+
+  // ReceiverDelegate overrides.
+  std::vector<msgs::UrlAvailability> OnUrlAvailabilityRequest(
+      uint64_t watch_id,
+      uint64_t watch_duration,
+      std::vector<std::string> urls) override {
+    return std::vector<msgs::UrlAvailability>(
+        urls.size(), msgs::UrlAvailability::kAvailable);
+  }
+
+  bool StartPresentation(
+      const Connection::PresentationInfo& info,
+      uint64_t source_id,
+      const std::vector<msgs::HttpHeader>& http_headers) override {
+    delegates_.push_back(std::make_unique<CountingConnectionDelegate>(&echo_));
+    connections_.push_back(std::make_unique<Connection>(
+        info, delegates_.back().get(), Receiver::Get()));
+    delegates_.back()->set_connection(connections_.back().get());
+    Receiver::Get()->OnPresentationStarted(
+        info.id, connections_.back().get(), ResponseResult::kSuccess);
+    return true;
+  }
+
+  bool ConnectToPresentation(uint64_t request_id,
+                             const std::string& id,
+                             uint64_t source_id) override {
+    return false;
+  }
+
+  void TerminatePresentation(const std::string& id,
+                             TerminationReason reason) override {}
+
+ private:
+  bool echo_ = false;
+
+  // Connections are destroyed before their delegates.
+  std::vector<std::unique_ptr<CountingConnectionDelegate>> delegates_;
+  std::vector<std::unique_ptr<Connection>> connections_;
+};
+
+class PresentationBenchmark {
+ public:
+  PresentationBenchmark()
+      : clock_(Clock::now()),
+        task_runner_(&clock_),
+        quic_bridge_(&task_runner_, FakeClock::now) {
+    NetworkServiceManager::Create(
+        std::make_unique<ServiceListenerImpl>(&listener_delegate_), nullptr,
+        std::move(quic_bridge_.quic_client),
+        std::move(quic_bridge_.quic_server));
+    Receiver::Get()->Init();
+    Receiver::Get()->SetReceiverDelegate(&receiver_delegate_);
+    controller_ = std::make_unique<Controller>(FakeClock::now);
+  }
+
+  ~PresentationBenchmark() {
+    // Closing the controller's connections closes the receiver's, so that they
+    // can then be destroyed quietly.
+    connections_.clear();
+    quic_bridge_.RunTasksUntilIdle();
+    receiver_delegate_.DestroyConnections();
+    controller_.reset();
+    Receiver::Get()->SetReceiverDelegate(nullptr);
+    Receiver::Get()->Deinit();
+    NetworkServiceManager::Dispose();
+  }
+
+  void Run() {
+    // Adding the receiver makes the Controller connect to it, to query URL
+    // availability, so this covers the QUIC handshake over the fake bridge.
+    const ServiceInfo info{
+        kServiceId, "benchmark", 1, quic_bridge_.kReceiverEndpoint, {}};
+    PrintMicroBenchmarkResult(TimeOnce("Add receiver and connect", [&] {
+      listener_delegate_.listener()->OnReceiverAdded(info);
+      quic_bridge_.RunTasksUntilIdle();
+    }));
+
+    MicroBenchmarkResult start_result;
+    start_result.name = "Start presentation";
+    for (int i = 0; i < kNumPresentations; ++i) {
+      const MicroBenchmarkResult result = TimeOnce("", [this, i] {
+        StartPresentation("https://example.com/presentation-" +
+                          std::to_string(i));
+      });
+      start_result.iterations += result.iterations;
+      start_result.elapsed += result.elapsed;
+    }
+    PrintMicroBenchmarkResult(start_result);
+
+    Connection* const connection = connections_.front().get();
+    for (size_t size : kMessageSizes) {
+      const std::string message(size, 'x');
+
+      receiver_delegate_.set_echo(true);
+      const int64_t replies_before = controller_delegates_.front()
+                                         ->messages_received();
+      int64_t round_trips = 0;
+      PrintMicroBenchmarkResult(RunMicroBenchmark(
+          "Round trip: " + std::to_string(size) + " bytes", 2 * size,
+          [this, connection, &message, &round_trips] {
+            OSP_CHECK(connection->SendString(message).ok());
+            quic_bridge_.RunTasksUntilIdle();
+            ++round_trips;
+          }));
+      OSP_CHECK_EQ(
+          controller_delegates_.front()->messages_received() - replies_before,
+          round_trips);
+
+      receiver_delegate_.set_echo(false);
+      PrintMicroBenchmarkResult(RunMicroBenchmark(
+          "Stream " + std::to_string(kMessagesPerBurst) + " messages: " +
+              std::to_string(size) + " bytes",
+          kMessagesPerBurst * size, [this, connection, &message] {
+            const int64_t received_before =
+                receiver_delegate_.messages_received();
+            for (int i = 0; i < kMessagesPerBurst; ++i) {
+              OSP_CHECK(connection->SendString(message).ok());
+            }
+            quic_bridge_.RunTasksUntilIdle();
+            OSP_CHECK_EQ(receiver_delegate_.messages_received(),
+                         received_before + kMessagesPerBurst);
+          }));
+    }
+  }
+
+ private:
+  template <typename Function>
+  static MicroBenchmarkResult TimeOnce(const std::string& name,
+                                       Function function) {
+    MicroBenchmarkResult result;
+    result.name = name;
+    result.iterations = 1;
+    const WallClock::time_point start = WallClock::now();
+    function();
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        WallClock::now() - start);
+    return result;
+  }
+
+  // Starts a presentation of |url| on the receiver and waits until the
+  // controller's connection to it is open.
+  void StartPresentation(const std::string& url) {
+    BenchmarkRequestDelegate request_delegate;
+    controller_delegates_.push_back(
+        std::make_unique<CountingConnectionDelegate>(/* echo */ nullptr));
+    Controller::ConnectRequest request = controller_->StartPresentation(
+        url, kServiceId, &request_delegate, controller_delegates_.back().get());
+    OSP_CHECK(request);
+    quic_bridge_.RunTasksUntilIdle();
+
+    std::unique_ptr<Connection> connection = request_delegate.TakeConnection();
+    OSP_CHECK(connection);
+    OSP_CHECK(connection->state() == Connection::State::kConnected);
+    connections_.push_back(std::move(connection));
+  }
+
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  FakeQuicBridge quic_bridge_;
+  NoopListenerDelegate listener_delegate_;
+  BenchmarkReceiverDelegate receiver_delegate_;
+  std::unique_ptr<Controller> controller_;
+
+  // The controller's end of each started presentation's connection, and their
+  // delegates, which must outlive them.
+  std::vector<std::unique_ptr<CountingConnectionDelegate>>
+      controller_delegates_;
+  std::vector<std::unique_ptr<Connection>> connections_;
+};
+
+}  // namespace
+}  // namespace osp
+}  // namespace openscreen
+
+int main(int argc, char** argv) {
+  openscreen::osp::PresentationBenchmark benchmark;
+  benchmark.Run();
+  return 0;
+}
@@ -4,10 +4,89 @@
 
 #include "osp/impl/presentation/presentation_common.h"
 
+#include <cstdint>
+
 #include "absl/strings/ascii.h"
 
 namespace openscreen {
 namespace osp {
+namespace {
+
+// The CBOR major types in a presentation-connection-message.
+constexpr uint8_t kCborUnsignedInteger = 0;
+constexpr uint8_t kCborByteString = 2;
+constexpr uint8_t kCborTextString = 3;
+constexpr uint8_t kCborMap = 5;
+
+// The map keys of a presentation-connection-message's fields.
+constexpr uint8_t kConnectionIdKey = 1;
+constexpr uint8_t kMessageKey = 2;
+
+static_assert(
+    static_cast<uint64_t>(msgs::Type::kPresentationConnectionMessage) < 64,
+    "presentation-connection-message's type is no longer encoded as one byte");
+
+// Writes the CBOR head of an item of |major_type| with argument |value| to
+// |buffer| in its shortest form, as tinycbor does, and returns the position
+// after it.
+uint8_t* WriteCborHead(uint8_t major_type, uint64_t value, uint8_t* buffer) {
+  const uint8_t initial_byte = major_type << 5;
+  if (value < 24) {
+    *buffer++ = initial_byte | static_cast<uint8_t>(value);
+    return buffer;
+  }
+
+  int size;
+  if (value <= UINT8_MAX) {
+    *buffer++ = initial_byte | 24;
+    size = 1;
+  } else if (value <= UINT16_MAX) {
+    *buffer++ = initial_byte | 25;
+    size = 2;
+  } else if (value <= UINT32_MAX) {
+    *buffer++ = initial_byte | 26;
+    size = 4;
+  } else {
+    *buffer++ = initial_byte | 27;
+    size = 8;
+  }
+  for (int i = size - 1; i >= 0; --i) {
+    *buffer++ = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return buffer;
+}
+
+Error WriteConnectionMessage(uint64_t connection_id,
+                             uint8_t message_major_type,
+                             Span<const uint8_t> message,
+                             ProtocolConnection* connection) {
+  if (message.size() > kMaxConnectionMessageSize) {
+    OSP_LOG_WARN << "presentation message of " << message.size()
+                 << " bytes is too large to send";
+    return Error::Code::kParameterOutOfRange;
+  }
+
+  uint8_t header[kMaxConnectionMessageHeaderSize];
+  uint8_t* position = header;
+  *position++ =
+      static_cast<uint8_t>(msgs::Type::kPresentationConnectionMessage);
+  position = WriteCborHead(kCborMap, 2, position);
+  position = WriteCborHead(kCborUnsignedInteger, kConnectionIdKey, position);
+  position = WriteCborHead(kCborUnsignedInteger, connection_id, position);
+  position = WriteCborHead(kCborUnsignedInteger, kMessageKey, position);
+  position = WriteCborHead(message_major_type, message.size(), position);
+  connection->Write(header, position - header);
+
+  for (size_t offset = 0; offset < message.size();
+       offset += kConnectionMessageChunkSize) {
+    connection->Write(
+        message.data() + offset,
+        std::min(kConnectionMessageChunkSize, message.size() - offset));
+  }
+  return Error::None();
+}
+
+}  // namespace
 
 std::unique_ptr<ProtocolConnection> GetProtocolConnection(
     uint64_t endpoint_id) {
@@ -28,6 +107,27 @@ MessageDemuxer* GetClientDemuxer() {
       ->message_demuxer();
 }
 
+Error WriteConnectionStringMessage(uint64_t connection_id,
+                                   absl::string_view message,
+                                   ProtocolConnection* connection) {
+  if (!msgs::IsValidUtf8(message)) {
+    OSP_LOG_WARN << "failed to properly encode presentation message";
+    return Error::Code::kParseError;
+  }
+  return WriteConnectionMessage(
+      connection_id, kCborTextString,
+      Span<const uint8_t>(reinterpret_cast<const uint8_t*>(message.data()),
+                          message.size()),
+      connection);
+}
+
+Error WriteConnectionBinaryMessage(uint64_t connection_id,
+                                   Span<const uint8_t> message,
+                                   ProtocolConnection* connection) {
+  return WriteConnectionMessage(connection_id, kCborByteString, message,
+                                connection);
+}
+
 PresentationID::PresentationID(std::string presentation_id)
     : id_(Error::Code::kParseError) {
   // The spec dictates that the presentation ID must be composed
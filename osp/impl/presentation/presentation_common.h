@@ -9,11 +9,14 @@
 #include <memory>
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "osp/msgs/osp_messages.h"
 #include "osp/public/message_demuxer.h"
 #include "osp/public/network_service_manager.h"
+#include "osp/public/protocol_connection.h"
 #include "osp/public/protocol_connection_server.h"
 #include "platform/api/time.h"
+#include "platform/base/span.h"
 #include "util/osp_logging.h"
 
 namespace openscreen {
@@ -33,6 +36,43 @@ std::unique_ptr<ProtocolConnection> GetProtocolConnection(uint64_t endpoint_id);
 MessageDemuxer* GetServerDemuxer();
 MessageDemuxer* GetClientDemuxer();
 
+// The largest piece of a presentation-connection-message's payload that is
+// written to a ProtocolConnection at once.
+constexpr size_t kConnectionMessageChunkSize = 16 * 1024;
+
+// How much of a stream a MessageDemuxer buffers while waiting for the rest of a
+// presentation-connection-message.  ConnectionManager sets this as the buffer
+// limit for the messages it watches; every other stream keeps the demuxer's own
+// limit.
+constexpr size_t kConnectionMessageBufferLimit = 1 << 20;
+
+// The largest encoding of a presentation-connection-message before its payload:
+// the message type, the map head, both keys, the connection ID, and the head of
+// the payload.
+constexpr size_t kMaxConnectionMessageHeaderSize = 1 + 1 + 2 + 9 + 9;
+
+// The largest payload a presentation-connection-message is sent with, so that
+// the whole message fits in a receiver's buffer until it can be decoded.
+constexpr size_t kMaxConnectionMessageSize =
+    kConnectionMessageBufferLimit - kMaxConnectionMessageHeaderSize;
+
+// These methods write a presentation-connection-message carrying |message| on
+// the presentation connection |connection_id| to |connection|.  The bytes are
+// the same as those encoded by msgs::EncodePresentationConnectionMessage(), but
+// only the CBOR before the message is encoded into a buffer, so the message
+// isn't copied into an encode buffer first.  It is then written straight from
+// the caller's memory in chunks of at most kConnectionMessageChunkSize bytes.
+// There is no flow control: every chunk is written at once, and the QUIC stream
+// keeps a copy of whatever it can't send yet, so sending still takes memory in
+// proportion to the message.  That is why messages larger than
+// kMaxConnectionMessageSize are rejected.
+Error WriteConnectionStringMessage(uint64_t connection_id,
+                                   absl::string_view message,
+                                   ProtocolConnection* connection);
+Error WriteConnectionBinaryMessage(uint64_t connection_id,
+                                   Span<const uint8_t> message,
+                                   ProtocolConnection* connection);
+
 class PresentationID {
  public:
   explicit PresentationID(const std::string presentation_id);
@@ -23,16 +23,6 @@
 namespace openscreen {
 namespace osp {
 
-namespace {
-
-// TODO(jophba): replace Write methods with a unified write message surface
-Error WriteConnectionMessage(const msgs::PresentationConnectionMessage& message,
-                             ProtocolConnection* connection) {
-  return connection->WriteMessage(message,
-                                  msgs::EncodePresentationConnectionMessage);
-}
-}  // namespace
-
 Connection::Connection(const PresentationInfo& info,
                        Delegate* delegate,
                        ParentDelegate* parent_delegate)
@@ -105,32 +95,20 @@ Error Connection::SendString(absl::string_view message) {
   if (state_ != State::kConnected)
     return Error::Code::kNoActiveConnection;
 
-  msgs::PresentationConnectionMessage cbor_message;
   OSP_LOG_INFO << "sending '" << message << "' to (" << presentation_.id << ", "
                << connection_id_.value() << ")";
-  cbor_message.connection_id = connection_id_.value();
-  cbor_message.message.which =
-      msgs::PresentationConnectionMessage::Message::Which::kString;
-
-  new (&cbor_message.message.str) std::string(message);
-
-  return WriteConnectionMessage(cbor_message, protocol_connection_.get());
+  return WriteConnectionStringMessage(connection_id_.value(), message,
+                                      protocol_connection_.get());
 }
 
 Error Connection::SendBinary(std::vector<uint8_t>&& data) {
   if (state_ != State::kConnected)
     return Error::Code::kNoActiveConnection;
 
-  msgs::PresentationConnectionMessage cbor_message;
   OSP_LOG_INFO << "sending " << data.size() << " bytes to (" << presentation_.id
                << ", " << connection_id_.value() << ")";
-  cbor_message.connection_id = connection_id_.value();
-  cbor_message.message.which =
-      msgs::PresentationConnectionMessage::Message::Which::kBytes;
-
-  new (&cbor_message.message.bytes) std::vector<uint8_t>(std::move(data));
-
-  return WriteConnectionMessage(cbor_message, protocol_connection_.get());
+  return WriteConnectionBinaryMessage(connection_id_.value(), data,
+                                      protocol_connection_.get());
 }
 
 Error Connection::Close(CloseReason reason) {
@@ -152,6 +130,8 @@ void Connection::Terminate(TerminationReason reason) {
 }
 
 ConnectionManager::ConnectionManager(MessageDemuxer* demuxer) {
+  demuxer->SetMessageTypeBufferLimit(msgs::Type::kPresentationConnectionMessage,
+                                     kConnectionMessageBufferLimit);
   message_watch_ = demuxer->SetDefaultMessageTypeWatch(
       msgs::Type::kPresentationConnectionMessage, this);
 
@@ -186,98 +166,86 @@ ErrorOr<size_t> ConnectionManager::OnStreamMessage(uint64_t endpoint_id,
                                                    const uint8_t* buffer,
                                                    size_t buffer_size,
                                                    Clock::time_point now) {
-  switch (message_type) {
-    case msgs::Type::kPresentationConnectionMessage: {
-      msgs::PresentationConnectionMessage message;
-      ssize_t bytes_decoded = msgs::DecodePresentationConnectionMessage(
-          buffer, buffer_size, &message);
-      if (bytes_decoded < 0) {
-        OSP_LOG_WARN << "presentation-connection-message parse error";
-        return Error::Code::kParseError;
-      }
-
-      Connection* connection = GetConnection(message.connection_id);
-      if (!connection) {
-        return Error::Code::kItemNotFound;
-      }
-
-      switch (message.message.which) {
-        case decltype(message.message.which)::kString:
-          connection->get_delegate()->OnStringMessage(message.message.str);
-          break;
-        case decltype(message.message.which)::kBytes:
-          connection->get_delegate()->OnBinaryMessage(message.message.bytes);
-          break;
-        default:
-          OSP_LOG_WARN << "uninitialized message data in "
-                          "presentation-connection-message";
-          break;
-      }
-      return bytes_decoded;
-    }
-
-    case msgs::Type::kPresentationConnectionCloseRequest: {
-      msgs::PresentationConnectionCloseRequest request;
-      ssize_t bytes_decoded = msgs::DecodePresentationConnectionCloseRequest(
-          buffer, buffer_size, &request);
-      if (bytes_decoded < 0) {
-        OSP_LOG_WARN << "decode presentation-connection-close-request error: "
-                     << bytes_decoded;
-        return Error::Code::kCborInvalidMessage;
-      }
-
-      msgs::PresentationConnectionCloseResponse response;
-      response.request_id = request.request_id;
-
-      Connection* connection = GetConnection(request.connection_id);
-      if (connection) {
-        response.result =
-            msgs::PresentationConnectionCloseResponse_result::kSuccess;
-        connection->OnClosedByRemote();
-      } else {
-        response.result = msgs::PresentationConnectionCloseResponse_result::
-            kInvalidConnectionId;
-      }
-
-      std::unique_ptr<ProtocolConnection> protocol_connection =
-          NetworkServiceManager::Get()
-              ->GetProtocolConnectionServer()
-              ->CreateProtocolConnection(endpoint_id);
-      if (protocol_connection) {
-        protocol_connection->WriteMessage(
-            response, &msgs::EncodePresentationConnectionCloseResponse);
-      }
-
-      return (response.result ==
-              msgs::PresentationConnectionCloseResponse_result::kSuccess)
-                 ? ErrorOr<size_t>(bytes_decoded)
-                 : Error::Code::kNoActiveConnection;
-    }
-
-    case msgs::Type::kPresentationConnectionCloseEvent: {
-      msgs::PresentationConnectionCloseEvent event;
-      ssize_t bytes_decoded = msgs::DecodePresentationConnectionCloseEvent(
-          buffer, buffer_size, &event);
-      if (bytes_decoded < 0) {
-        OSP_LOG_WARN << "decode presentation-connection-close-event error: "
-                     << bytes_decoded;
-        return Error::Code::kParseError;
-      }
-
-      Connection* connection = GetConnection(event.connection_id);
-      if (!connection) {
-        return Error::Code::kNoActiveConnection;
-      }
-
-      connection->OnClosedByRemote();
-      return bytes_decoded;
-    }
-
-    // TODO(jophba): The spec says to close the connection if we get a message
-    // we don't understand. Figure out how to honor the spec here.
+  // Messages are decoded into views, so string messages are passed to the
+  // delegate without being copied out of |buffer|.
+  ErrorOr<size_t> result = DecodeAndDispatchMessage(
+      message_type, buffer, buffer_size,
+      [this, endpoint_id](const auto& message) {
+        return HandleMessage(endpoint_id, message);
+      });
+  if (result.is_error() &&
+      result.error().code() == Error::Code::kCborParsing) {
+    OSP_LOG_WARN << "parse error in message of type "
+                 << static_cast<uint64_t>(message_type);
+  }
+  return result;
+}
+
+Error ConnectionManager::HandleMessage(
+    uint64_t endpoint_id,
+    const msgs::PresentationConnectionMessageView& message) {
+  Connection* connection = GetConnection(message.connection_id);
+  if (!connection) {
+    return Error::Code::kItemNotFound;
+  }
+
+  switch (message.message.which) {
+    case decltype(message.message.which)::kString:
+      connection->get_delegate()->OnStringMessage(message.message.str);
+      break;
+    case decltype(message.message.which)::kBytes:
+      connection->get_delegate()->OnBinaryMessage(std::vector<uint8_t>(
+          message.message.bytes.begin(), message.message.bytes.end()));
+      break;
     default:
-      return Error::Code::kUnknownMessageType;
+      OSP_LOG_WARN << "uninitialized message data in "
+                      "presentation-connection-message";
+      break;
   }
+  return Error::None();
+}
+
+Error ConnectionManager::HandleMessage(
+    uint64_t endpoint_id,
+    const msgs::PresentationConnectionCloseRequestView& request) {
+  msgs::PresentationConnectionCloseResponse response;
+  response.request_id = request.request_id;
+
+  Connection* connection = GetConnection(request.connection_id);
+  if (connection) {
+    response.result =
+        msgs::PresentationConnectionCloseResponse_result::kSuccess;
+    connection->OnClosedByRemote();
+  } else {
+    response.result = msgs::PresentationConnectionCloseResponse_result::
+        kInvalidConnectionId;
+  }
+
+  std::unique_ptr<ProtocolConnection> protocol_connection =
+      NetworkServiceManager::Get()
+          ->GetProtocolConnectionServer()
+          ->CreateProtocolConnection(endpoint_id);
+  if (protocol_connection) {
+    protocol_connection->WriteMessage(
+        response, &msgs::EncodePresentationConnectionCloseResponse);
+  }
+
+  return (response.result ==
+          msgs::PresentationConnectionCloseResponse_result::kSuccess)
+             ? Error::None()
+             : Error::Code::kNoActiveConnection;
+}
+
+Error ConnectionManager::HandleMessage(
+    uint64_t endpoint_id,
+    const msgs::PresentationConnectionCloseEventView& event) {
+  Connection* connection = GetConnection(event.connection_id);
+  if (!connection) {
+    return Error::Code::kNoActiveConnection;
+  }
+
+  connection->OnClosedByRemote();
+  return Error::None();
 }
 
 Connection* ConnectionManager::GetConnection(uint64_t connection_id) {
@@ -5,10 +5,13 @@
 #include "osp/public/presentation/presentation_connection.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "osp/impl/presentation/presentation_common.h"
 #include "osp/impl/presentation/testing/mock_connection_delegate.h"
 #include "osp/impl/quic/testing/fake_quic_connection.h"
 #include "osp/impl/quic/testing/fake_quic_connection_factory.h"
@@ -53,8 +56,84 @@ class MockConnectRequest final
   MOCK_METHOD1(OnConnectionFailed, void(uint64_t request_id));
 };
 
+// Records what is written to it.
+class RecordingProtocolConnection final : public ProtocolConnection {
+ public:
+  RecordingProtocolConnection() : ProtocolConnection(1, 1) {}
+  ~RecordingProtocolConnection() override = default;
+
+  // ProtocolConnection overrides.
+  void Write(const uint8_t* data, size_t data_size) override {
+    written.insert(written.end(), data, data + data_size);
+    write_sizes.push_back(data_size);
+  }
+  void CloseWriteEnd() override {}
+
+  std::vector<uint8_t> written;
+  std::vector<size_t> write_sizes;
+};
+
+// Encodes a presentation-connection-message the same way as
+// ProtocolConnection::WriteMessage(), but without its size limit.
+std::vector<uint8_t> EncodeConnectionMessage(
+    const msgs::PresentationConnectionMessage& message) {
+  msgs::CborEncodeBuffer buffer(
+      msgs::CborEncodeBuffer::kDefaultInitialEncodeBufferSize, 1 << 20);
+  EXPECT_TRUE(msgs::EncodePresentationConnectionMessage(message, &buffer));
+  return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.size());
+}
+
 }  // namespace
 
+TEST(ConnectionMessageTest, WritesSameBytesAsEncoder) {
+  constexpr uint64_t kConnectionId = 300;
+
+  // The sizes cover each length of CBOR head.
+  for (size_t size : {0, 23, 24, 256, 70000}) {
+    msgs::PresentationConnectionMessage message;
+    message.connection_id = kConnectionId;
+    message.message.which =
+        msgs::PresentationConnectionMessage::Message::Which::kString;
+    new (&message.message.str) std::string(size, 'x');
+
+    RecordingProtocolConnection connection;
+    EXPECT_TRUE(WriteConnectionStringMessage(kConnectionId,
+                                             message.message.str, &connection)
+                    .ok());
+    EXPECT_EQ(EncodeConnectionMessage(message), connection.written);
+
+    const std::vector<uint8_t> data(size, 0xab);
+    message.message.str.~basic_string();
+    message.message.which =
+        msgs::PresentationConnectionMessage::Message::Which::kBytes;
+    new (&message.message.bytes) std::vector<uint8_t>(data);
+
+    connection.written.clear();
+    EXPECT_TRUE(
+        WriteConnectionBinaryMessage(kConnectionId, data, &connection).ok());
+    EXPECT_EQ(EncodeConnectionMessage(message), connection.written);
+  }
+}
+
+TEST(ConnectionMessageTest, WritesLargeMessageInChunks) {
+  const std::vector<uint8_t> data(2 * kConnectionMessageChunkSize + 1, 0);
+  RecordingProtocolConnection connection;
+  EXPECT_TRUE(WriteConnectionBinaryMessage(1, data, &connection).ok());
+
+  // The header is followed by the message, a chunk at a time.
+  ASSERT_EQ(4u, connection.write_sizes.size());
+  EXPECT_EQ(kConnectionMessageChunkSize, connection.write_sizes[1]);
+  EXPECT_EQ(kConnectionMessageChunkSize, connection.write_sizes[2]);
+  EXPECT_EQ(1u, connection.write_sizes[3]);
+}
+
+TEST(ConnectionMessageTest, RejectsInvalidUtf8) {
+  RecordingProtocolConnection connection;
+  EXPECT_FALSE(
+      WriteConnectionStringMessage(1, "\xc0 invalid", &connection).ok());
+  EXPECT_TRUE(connection.written.empty());
+}
+
 class ConnectionTest : public ::testing::Test {
  public:
   ConnectionTest() {
@@ -88,6 +167,45 @@ class ConnectionTest : public ::testing::Test {
     return response;
   }
 
+  // Opens a stream from the controller to the receiver, and connects
+  // |controller| and |receiver| over it as presentation connection
+  // |connection_id|.
+  void ConnectOverQuic(uint64_t connection_id,
+                       Connection* controller,
+                       Connection* receiver) {
+    MockConnectRequest mock_connect_request;
+    std::unique_ptr<ProtocolConnection> controller_stream;
+    std::unique_ptr<ProtocolConnection> receiver_stream;
+    NetworkServiceManager::Get()->GetProtocolConnectionClient()->Connect(
+        quic_bridge_->kReceiverEndpoint, &mock_connect_request);
+    EXPECT_CALL(mock_connect_request, OnConnectionOpenedMock(_, _))
+        .WillOnce(Invoke([&controller_stream](uint64_t request_id,
+                                              ProtocolConnection* stream) {
+          controller_stream.reset(stream);
+        }));
+
+    EXPECT_CALL(quic_bridge_->mock_server_observer,
+                OnIncomingConnectionMock(_))
+        .WillOnce(testing::WithArgs<0>(testing::Invoke(
+            [&receiver_stream](
+                std::unique_ptr<ProtocolConnection>& connection) {
+              receiver_stream = std::move(connection);
+            })));
+
+    quic_bridge_->RunTasksUntilIdle();
+    ASSERT_TRUE(controller_stream);
+    ASSERT_TRUE(receiver_stream);
+
+    uint64_t controller_endpoint_id = receiver_stream->endpoint_id();
+    uint64_t receiver_endpoint_id = controller_stream->endpoint_id();
+    controller->OnConnected(connection_id, receiver_endpoint_id,
+                            std::move(controller_stream));
+    receiver->OnConnected(connection_id, controller_endpoint_id,
+                          std::move(receiver_stream));
+    controller_connection_manager_->AddConnection(controller);
+    receiver_connection_manager_->AddConnection(receiver);
+  }
+
   std::unique_ptr<FakeClock> fake_clock_;
   std::unique_ptr<FakeTaskRunner> task_runner_;
   std::unique_ptr<FakeQuicBridge> quic_bridge_;
@@ -140,37 +258,9 @@ TEST_F(ConnectionTest, ConnectAndSend) {
   EXPECT_EQ(Connection::State::kConnecting, controller.state());
   EXPECT_EQ(Connection::State::kConnecting, receiver.state());
 
-  MockConnectRequest mock_connect_request;
-  std::unique_ptr<ProtocolConnection> controller_stream;
-  std::unique_ptr<ProtocolConnection> receiver_stream;
-  NetworkServiceManager::Get()->GetProtocolConnectionClient()->Connect(
-      quic_bridge_->kReceiverEndpoint, &mock_connect_request);
-  EXPECT_CALL(mock_connect_request, OnConnectionOpenedMock(_, _))
-      .WillOnce(Invoke([&controller_stream](uint64_t request_id,
-                                            ProtocolConnection* stream) {
-        controller_stream.reset(stream);
-      }));
-
-  EXPECT_CALL(quic_bridge_->mock_server_observer, OnIncomingConnectionMock(_))
-      .WillOnce(testing::WithArgs<0>(testing::Invoke(
-          [&receiver_stream](std::unique_ptr<ProtocolConnection>& connection) {
-            receiver_stream = std::move(connection);
-          })));
-
-  quic_bridge_->RunTasksUntilIdle();
-  ASSERT_TRUE(controller_stream);
-  ASSERT_TRUE(receiver_stream);
-
   EXPECT_CALL(mock_controller_delegate, OnConnected());
   EXPECT_CALL(mock_receiver_delegate, OnConnected());
-  uint64_t controller_endpoint_id = receiver_stream->endpoint_id();
-  uint64_t receiver_endpoint_id = controller_stream->endpoint_id();
-  controller.OnConnected(connection_id, receiver_endpoint_id,
-                         std::move(controller_stream));
-  receiver.OnConnected(connection_id, controller_endpoint_id,
-                       std::move(receiver_stream));
-  controller_connection_manager_->AddConnection(&controller);
-  receiver_connection_manager_->AddConnection(&receiver);
+  ConnectOverQuic(connection_id, &controller, &receiver);
 
   EXPECT_EQ(Connection::State::kConnected, controller.state());
   EXPECT_EQ(Connection::State::kConnected, receiver.state());
@@ -224,5 +314,44 @@ TEST_F(ConnectionTest, ConnectAndSend) {
   receiver_connection_manager_->RemoveConnection(&receiver);
 }
 
+TEST_F(ConnectionTest, SendsMessagesLargerThan64KiB) {
+  const std::string id{"deadbeef01234"};
+  const std::string url{"https://example.com/receiver.html"};
+  NiceMock<MockConnectionDelegate> mock_controller_delegate;
+  NiceMock<MockConnectionDelegate> mock_receiver_delegate;
+  Connection controller(Connection::PresentationInfo{id, url},
+                        &mock_controller_delegate, &mock_controller_);
+  Connection receiver(Connection::PresentationInfo{id, url},
+                      &mock_receiver_delegate, &mock_receiver_);
+  ConnectOverQuic(13, &controller, &receiver);
+  ASSERT_EQ(Connection::State::kConnected, receiver.state());
+
+  // Both messages are written in many chunks, and decoded by the receiver's
+  // MessageDemuxer once all of them have arrived.
+  const std::string message(200 * 1024, 'x');
+  EXPECT_TRUE(controller.SendString(message).ok());
+  EXPECT_CALL(mock_receiver_delegate,
+              OnStringMessage(static_cast<absl::string_view>(message)));
+  quic_bridge_->RunTasksUntilIdle();
+
+  std::vector<uint8_t> data(kMaxConnectionMessageSize);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  const std::vector<uint8_t> expected_data = data;
+  EXPECT_TRUE(controller.SendBinary(std::move(data)).ok());
+  EXPECT_CALL(mock_receiver_delegate, OnBinaryMessage(expected_data));
+  quic_bridge_->RunTasksUntilIdle();
+
+  // Anything larger wouldn't fit in the receiver's buffer.
+  EXPECT_EQ(Error::Code::kParameterOutOfRange,
+            controller
+                .SendBinary(std::vector<uint8_t>(kMaxConnectionMessageSize + 1))
+                .code());
+
+  controller_connection_manager_->RemoveConnection(&controller);
+  receiver_connection_manager_->RemoveConnection(&receiver);
+}
+
 }  // namespace osp
 }  // namespace openscreen
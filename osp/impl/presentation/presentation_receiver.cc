@@ -400,7 +400,7 @@ Error Receiver::OnPresentationStarted(const std::string& presentation_id,
   }
 
   response.result = msgs::PresentationStartResponse_result::kSuccess;
-  response.connection_id = connection->connection_id();
+  response.connection_id = initiation_response.connection_id;
 
   Presentation& presentation = started_presentations_[presentation_id];
   presentation.endpoint_id = initiation_response.endpoint_id;
@@ -442,7 +442,7 @@ Error Receiver::OnConnectionCreated(uint64_t request_id,
   msgs::PresentationConnectionOpenResponse response;
   response.request_id = request_id;
   response.result = msgs::PresentationConnectionOpenResponse_result::kSuccess;
-  response.connection_id = connection->connection_id();
+  response.connection_id = connection_response.value()->connection_id;
 
   auto protocol_connection =
       GetProtocolConnection(connection_response.value()->endpoint_id);
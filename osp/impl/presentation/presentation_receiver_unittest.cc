@@ -5,6 +5,8 @@
 #include "osp/public/presentation/presentation_receiver.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -197,6 +199,60 @@ TEST_F(PresentationReceiverTest, StartPresentation) {
   EXPECT_EQ(connection.connection_id(), response.connection_id);
 }
 
+TEST_F(PresentationReceiverTest, StartTwoPresentationsFromOneController) {
+  MockMessageCallback mock_callback;
+  MessageDemuxer::MessageWatch initiation_watch =
+      quic_bridge_->controller_demuxer->SetDefaultMessageTypeWatch(
+          msgs::Type::kPresentationStartResponse, &mock_callback);
+
+  std::unique_ptr<ProtocolConnection> stream = MakeClientStream();
+  ASSERT_TRUE(stream);
+
+  const std::string presentation_ids[] = {"KMvyNqTCvvSv7v5X",
+                                          "bTQH4JbwQdZdPFtC"};
+  NiceMock<MockConnectionDelegate> null_connection_delegate;
+  std::vector<std::unique_ptr<Connection>> connections;
+  std::vector<msgs::PresentationStartResponse> responses;
+  for (uint64_t i = 0; i < 2; ++i) {
+    msgs::PresentationStartRequest request;
+    request.request_id = i;
+    request.presentation_id = presentation_ids[i];
+    request.url = url1_;
+    msgs::CborEncodeBuffer buffer;
+    ASSERT_TRUE(msgs::EncodePresentationStartRequest(request, &buffer));
+    stream->Write(buffer.data(), buffer.size());
+    EXPECT_CALL(mock_receiver_delegate_, StartPresentation(_, _, _))
+        .WillOnce(::testing::Return(true));
+    quic_bridge_->RunTasksUntilIdle();
+
+    connections.push_back(std::make_unique<Connection>(
+        Connection::PresentationInfo{presentation_ids[i], url1_},
+        &null_connection_delegate, Receiver::Get()));
+    EXPECT_EQ(Error::None(), Receiver::Get()->OnPresentationStarted(
+                                 presentation_ids[i], connections.back().get(),
+                                 ResponseResult::kSuccess));
+    EXPECT_CALL(mock_callback, OnStreamMessage(_, _, _, _, _, _))
+        .WillOnce(Invoke([&responses](uint64_t endpoint_id, uint64_t cid,
+                                      msgs::Type message_type,
+                                      const uint8_t* buf, size_t buf_size,
+                                      Clock::time_point now) {
+          responses.emplace_back();
+          return msgs::DecodePresentationStartResponse(buf, buf_size,
+                                                       &responses.back());
+        }));
+    quic_bridge_->RunTasksUntilIdle();
+  }
+
+  // Each response carries the ID of its own connection, so that the
+  // controller can tell them apart.
+  ASSERT_EQ(2u, responses.size());
+  for (size_t i = 0; i < 2; ++i) {
+    EXPECT_EQ(msgs::Result::kSuccess, responses[i].result);
+    EXPECT_EQ(connections[i]->connection_id(), responses[i].connection_id);
+  }
+  EXPECT_NE(responses[0].connection_id, responses[1].connection_id);
+}
+
 // TODO(btolsch): Connect and reconnect.
 // TODO(btolsch): Terminate request and event.
 
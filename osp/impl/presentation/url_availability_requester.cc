@@ -24,20 +24,17 @@ namespace {
 static constexpr Clock::duration kWatchDuration = seconds(20);
 static constexpr Clock::duration kWatchRefreshPadding = seconds(2);
 
-std::vector<std::string>::iterator PartitionUrlsBySetMembership(
-    std::vector<std::string>* urls,
-    const std::set<std::string>& membership_test) {
-  return std::partition(
-      urls->begin(), urls->end(), [&membership_test](const std::string& url) {
-        return membership_test.find(url) == membership_test.end();
-      });
+bool TestBit(const std::vector<bool>& bits, size_t index) {
+  return index < bits.size() && bits[index];
 }
 
-void MoveVectorSegment(std::vector<std::string>::iterator first,
-                       std::vector<std::string>::iterator last,
-                       std::set<std::string>* target) {
-  for (auto it = first; it != last; ++it)
-    target->emplace(std::move(*it));
+void SetBit(std::vector<bool>* bits, size_t index, bool value) {
+  if (index >= bits->size()) {
+    if (!value)
+      return;
+    bits->resize(index + 1);
+  }
+  (*bits)[index] = value;
 }
 
 uint64_t GetNextRequestId(const uint64_t endpoint_id) {
@@ -49,6 +46,9 @@ uint64_t GetNextRequestId(const uint64_t endpoint_id) {
 
 }  // namespace
 
+// static
+constexpr UrlAvailabilityRequester::UrlId UrlAvailabilityRequester::kNoUrlId;
+
 UrlAvailabilityRequester::UrlAvailabilityRequester(
     ClockNowFunctionPtr now_function)
     : now_function_(now_function) {
@@ -59,60 +59,49 @@ UrlAvailabilityRequester::~UrlAvailabilityRequester() = default;
 
 void UrlAvailabilityRequester::AddObserver(const std::vector<std::string>& urls,
                                            ReceiverObserver* observer) {
+  std::vector<UrlId> url_ids;
+  url_ids.reserve(urls.size());
   for (const auto& url : urls) {
-    observers_by_url_[url].push_back(observer);
+    const UrlId url_id = InternUrl(url);
+    observed_urls_[url_id].observers.push_back(observer);
+    url_ids.push_back(url_id);
   }
   for (auto& entry : receiver_by_service_id_) {
     auto& receiver = entry.second;
-    receiver->GetOrRequestAvailabilities(urls, observer);
+    receiver->GetOrRequestAvailabilities(url_ids, observer);
+    receiver->SendPendingRequest();
   }
 }
 
 void UrlAvailabilityRequester::RemoveObserverUrls(
     const std::vector<std::string>& urls,
     ReceiverObserver* observer) {
-  std::set<std::string> unobserved_urls;
+  std::vector<UrlId> unobserved_url_ids;
   for (const auto& url : urls) {
-    auto observer_entry = observers_by_url_.find(url);
-    if (observer_entry == observers_by_url_.end())
+    const UrlId url_id = FindUrlId(url);
+    if (!IsObserved(url_id))
       continue;
-    auto& observers = observer_entry->second;
+    auto& observers = observed_urls_[url_id].observers;
     observers.erase(std::remove(observers.begin(), observers.end(), observer),
                     observers.end());
-    if (observers.empty()) {
-      unobserved_urls.emplace(std::move(observer_entry->first));
-      observers_by_url_.erase(observer_entry);
-      for (auto& entry : receiver_by_service_id_) {
-        auto& receiver = entry.second;
-        receiver->known_availability_by_url.erase(url);
-      }
-    }
-  }
-
-  for (auto& entry : receiver_by_service_id_) {
-    auto& receiver = entry.second;
-    receiver->RemoveUnobservedRequests(unobserved_urls);
-    receiver->RemoveUnobservedWatches(unobserved_urls);
+    if (observers.empty())
+      unobserved_url_ids.push_back(url_id);
   }
+  RemoveUnobservedUrls(unobserved_url_ids);
 }
 
 void UrlAvailabilityRequester::RemoveObserver(ReceiverObserver* observer) {
-  std::set<std::string> unobserved_urls;
-  for (auto& entry : observers_by_url_) {
-    auto& observer_list = entry.second;
-    auto it = std::remove(observer_list.begin(), observer_list.end(), observer);
-    if (it != observer_list.end()) {
-      observer_list.erase(it);
-      if (observer_list.empty())
-        unobserved_urls.insert(entry.first);
+  std::vector<UrlId> unobserved_url_ids;
+  for (UrlId url_id = 0; url_id < observed_urls_.size(); ++url_id) {
+    auto& observers = observed_urls_[url_id].observers;
+    auto it = std::remove(observers.begin(), observers.end(), observer);
+    if (it != observers.end()) {
+      observers.erase(it, observers.end());
+      if (observers.empty())
+        unobserved_url_ids.push_back(url_id);
     }
   }
-
-  for (auto& entry : receiver_by_service_id_) {
-    auto& receiver = entry.second;
-    receiver->RemoveUnobservedRequests(unobserved_urls);
-    receiver->RemoveUnobservedWatches(unobserved_urls);
-  }
+  RemoveUnobservedUrls(unobserved_url_ids);
 }
 
 void UrlAvailabilityRequester::AddReceiver(const ServiceInfo& info) {
@@ -122,11 +111,11 @@ void UrlAvailabilityRequester::AddReceiver(const ServiceInfo& info) {
           this, info.service_id,
           info.v4_endpoint.address ? info.v4_endpoint : info.v6_endpoint));
   std::unique_ptr<ReceiverRequester>& receiver = result.first->second;
-  std::vector<std::string> urls;
-  urls.reserve(observers_by_url_.size());
-  for (const auto& url : observers_by_url_)
-    urls.push_back(url.first);
-  receiver->RequestUrlAvailabilities(std::move(urls));
+  for (UrlId url_id = 0; url_id < observed_urls_.size(); ++url_id) {
+    if (IsObserved(url_id))
+      receiver->pending_url_ids.push_back(url_id);
+  }
+  receiver->SendPendingRequest();
 }
 
 void UrlAvailabilityRequester::ChangeReceiver(const ServiceInfo& info) {}
@@ -161,6 +150,54 @@ Clock::time_point UrlAvailabilityRequester::RefreshWatches() {
   return minimum_schedule_time;
 }
 
+UrlAvailabilityRequester::UrlId UrlAvailabilityRequester::InternUrl(
+    const std::string& url) {
+  auto result = url_ids_.emplace(url, kNoUrlId);
+  if (!result.second)
+    return result.first->second;
+
+  UrlId url_id;
+  if (free_url_ids_.empty()) {
+    url_id = static_cast<UrlId>(observed_urls_.size());
+    observed_urls_.emplace_back();
+  } else {
+    url_id = free_url_ids_.back();
+    free_url_ids_.pop_back();
+  }
+  observed_urls_[url_id].url = url;
+  result.first->second = url_id;
+  return url_id;
+}
+
+UrlAvailabilityRequester::UrlId UrlAvailabilityRequester::FindUrlId(
+    const std::string& url) const {
+  auto it = url_ids_.find(url);
+  return it == url_ids_.end() ? kNoUrlId : it->second;
+}
+
+void UrlAvailabilityRequester::RemoveUnobservedUrls(
+    const std::vector<UrlId>& unobserved_url_ids) {
+  if (unobserved_url_ids.empty())
+    return;
+
+  for (auto& entry : receiver_by_service_id_) {
+    auto& receiver = entry.second;
+    for (UrlId url_id : unobserved_url_ids)
+      receiver->ForgetAvailability(url_id);
+    receiver->RemoveUnobservedRequests();
+    receiver->RemoveUnobservedWatches();
+    receiver->SendPendingRequest();
+  }
+
+  // No request or watch refers to these ids any more, so they can be reused.
+  for (UrlId url_id : unobserved_url_ids) {
+    ObservedUrl& observed_url = observed_urls_[url_id];
+    url_ids_.erase(observed_url.url);
+    observed_url.url.clear();
+    free_url_ids_.push_back(url_id);
+  }
+}
+
 UrlAvailabilityRequester::ReceiverRequester::ReceiverRequester(
     UrlAvailabilityRequester* listener,
     const std::string& service_id,
@@ -175,57 +212,64 @@ UrlAvailabilityRequester::ReceiverRequester::ReceiverRequester(
 UrlAvailabilityRequester::ReceiverRequester::~ReceiverRequester() = default;
 
 void UrlAvailabilityRequester::ReceiverRequester::GetOrRequestAvailabilities(
-    const std::vector<std::string>& requested_urls,
+    const std::vector<UrlId>& url_ids,
     ReceiverObserver* observer) {
-  std::vector<std::string> unknown_urls;
-  for (const auto& url : requested_urls) {
-    auto availability_entry = known_availability_by_url.find(url);
-    if (availability_entry == known_availability_by_url.end()) {
-      unknown_urls.emplace_back(url);
+  for (UrlId url_id : url_ids) {
+    if (!TestBit(known_urls, url_id)) {
+      pending_url_ids.push_back(url_id);
       continue;
     }
 
-    msgs::UrlAvailability availability = availability_entry->second;
     if (observer) {
-      switch (availability) {
-        case msgs::UrlAvailability::kAvailable:
-          observer->OnReceiverAvailable(url, service_id);
-          break;
-        case msgs::UrlAvailability::kUnavailable:
-        case msgs::UrlAvailability::kInvalid:
-          observer->OnReceiverUnavailable(url, service_id);
-          break;
+      const std::string& url = listener->observed_urls_[url_id].url;
+      if (TestBit(available_urls, url_id)) {
+        observer->OnReceiverAvailable(url, service_id);
+      } else {
+        observer->OnReceiverUnavailable(url, service_id);
       }
     }
   }
-  if (!unknown_urls.empty()) {
-    RequestUrlAvailabilities(std::move(unknown_urls));
-  }
 }
 
-void UrlAvailabilityRequester::ReceiverRequester::RequestUrlAvailabilities(
-    std::vector<std::string> urls) {
-  if (urls.empty())
+void UrlAvailabilityRequester::ReceiverRequester::SendPendingRequest() {
+  if (!connection_ || pending_url_ids.empty())
     return;
+
+  std::vector<UrlId> url_ids = TakePendingUrlIds();
   const uint64_t request_id = GetNextRequestId(endpoint_id_);
-  ErrorOr<uint64_t> watch_id_or_error(0);
-  if (!connection_ || (watch_id_or_error = SendRequest(request_id, urls))) {
-    request_by_id.emplace(request_id,
-                          Request{watch_id_or_error.value(), std::move(urls)});
+  ErrorOr<uint64_t> watch_id_or_error = SendRequest(request_id, url_ids);
+  if (watch_id_or_error) {
+    request_by_id.emplace(
+        request_id, Request{watch_id_or_error.value(), std::move(url_ids)});
   } else {
-    for (const auto& url : urls)
-      for (auto& observer : listener->observers_by_url_[url])
-        observer->OnRequestFailed(url, service_id);
+    ReportRequestFailed(url_ids);
   }
 }
 
+std::vector<UrlAvailabilityRequester::UrlId>
+UrlAvailabilityRequester::ReceiverRequester::TakePendingUrlIds() {
+  std::vector<UrlId> url_ids;
+  url_ids.reserve(pending_url_ids.size());
+  std::vector<bool> seen(listener->observed_urls_.size());
+  for (UrlId url_id : pending_url_ids) {
+    if (!seen[url_id]) {
+      seen[url_id] = true;
+      url_ids.push_back(url_id);
+    }
+  }
+  pending_url_ids.clear();
+  return url_ids;
+}
+
 ErrorOr<uint64_t> UrlAvailabilityRequester::ReceiverRequester::SendRequest(
     uint64_t request_id,
-    const std::vector<std::string>& urls) {
+    const std::vector<UrlId>& url_ids) {
   uint64_t watch_id = next_watch_id++;
   msgs::PresentationUrlAvailabilityRequest cbor_request;
   cbor_request.request_id = request_id;
-  cbor_request.urls = urls;
+  cbor_request.urls.reserve(url_ids.size());
+  for (UrlId url_id : url_ids)
+    cbor_request.urls.push_back(listener->observed_urls_[url_id].url);
   cbor_request.watch_id = watch_id;
   cbor_request.watch_duration = to_microseconds(kWatchDuration).count();
 
@@ -234,7 +278,7 @@ ErrorOr<uint64_t> UrlAvailabilityRequester::ReceiverRequester::SendRequest(
     OSP_VLOG << "writing presentation-url-availability-request";
     connection_->Write(buffer.data(), buffer.size());
     watch_by_id.emplace(
-        watch_id, Watch{listener->now_function_() + kWatchDuration, urls});
+        watch_id, Watch{listener->now_function_() + kWatchDuration, url_ids});
     if (!event_watch) {
       event_watch = GetClientDemuxer()->WatchMessageType(
           endpoint_id_, msgs::Type::kPresentationUrlAvailabilityEvent, this);
@@ -248,16 +292,27 @@ ErrorOr<uint64_t> UrlAvailabilityRequester::ReceiverRequester::SendRequest(
   return Error::Code::kCborEncoding;
 }
 
+void UrlAvailabilityRequester::ReceiverRequester::ReportRequestFailed(
+    const std::vector<UrlId>& url_ids) {
+  for (UrlId url_id : url_ids) {
+    if (!listener->IsObserved(url_id))
+      continue;
+    const ObservedUrl& observed_url = listener->observed_urls_[url_id];
+    for (auto* observer : observed_url.observers)
+      observer->OnRequestFailed(observed_url.url, service_id);
+  }
+}
+
 Clock::time_point UrlAvailabilityRequester::ReceiverRequester::RefreshWatches(
     Clock::time_point now) {
   Clock::time_point minimum_schedule_time = now + kWatchDuration;
-  std::vector<std::vector<std::string>> new_requests;
   for (auto entry = watch_by_id.begin(); entry != watch_by_id.end();) {
     Watch& watch = entry->second;
     const Clock::time_point buffered_deadline =
         watch.deadline - kWatchRefreshPadding;
     if (now > buffered_deadline) {
-      new_requests.emplace_back(std::move(watch.urls));
+      pending_url_ids.insert(pending_url_ids.end(), watch.url_ids.begin(),
+                             watch.url_ids.end());
       entry = watch_by_id.erase(entry);
     } else {
       ++entry;
@@ -268,119 +323,109 @@ Clock::time_point UrlAvailabilityRequester::ReceiverRequester::RefreshWatches(
   if (watch_by_id.empty())
     StopWatching(&event_watch);
 
-  for (auto& request : new_requests)
-    RequestUrlAvailabilities(std::move(request));
+  SendPendingRequest();
 
   return minimum_schedule_time;
 }
 
 Error::Code UrlAvailabilityRequester::ReceiverRequester::UpdateAvailabilities(
-    const std::vector<std::string>& urls,
+    const std::vector<UrlId>& url_ids,
     const std::vector<msgs::UrlAvailability>& availabilities) {
-  auto availability_it = availabilities.begin();
-  if (urls.size() != availabilities.size()) {
+  if (url_ids.size() != availabilities.size()) {
     return Error::Code::kCborInvalidMessage;
   }
-  for (const auto& url : urls) {
-    auto observer_entry = listener->observers_by_url_.find(url);
-    if (observer_entry == listener->observers_by_url_.end())
+  auto availability_it = availabilities.begin();
+  for (UrlId url_id : url_ids) {
+    const bool available =
+        (*availability_it++ == msgs::UrlAvailability::kAvailable);
+    if (!listener->IsObserved(url_id))
       continue;
-    std::vector<ReceiverObserver*>& observers = observer_entry->second;
-    auto result = known_availability_by_url.emplace(url, *availability_it);
-    auto entry = result.first;
-    bool inserted = result.second;
-    bool updated = (entry->second != *availability_it);
-    if (inserted || updated) {
-      switch (*availability_it) {
-        case msgs::UrlAvailability::kAvailable:
-          for (auto* observer : observers)
-            observer->OnReceiverAvailable(url, service_id);
-          break;
-        case msgs::UrlAvailability::kUnavailable:
-        case msgs::UrlAvailability::kInvalid:
-          for (auto* observer : observers)
-            observer->OnReceiverUnavailable(url, service_id);
-          break;
-        default:
-          break;
+
+    // Only observers of URLs whose availability changed are notified.
+    if (TestBit(known_urls, url_id) &&
+        TestBit(available_urls, url_id) == available) {
+      continue;
+    }
+    SetBit(&known_urls, url_id, true);
+    SetBit(&available_urls, url_id, available);
+
+    const ObservedUrl& observed_url = listener->observed_urls_[url_id];
+    for (auto* observer : observed_url.observers) {
+      if (available) {
+        observer->OnReceiverAvailable(observed_url.url, service_id);
+      } else {
+        observer->OnReceiverUnavailable(observed_url.url, service_id);
       }
     }
-    ++availability_it;
   }
   return Error::Code::kNone;
 }
 
-void UrlAvailabilityRequester::ReceiverRequester::RemoveUnobservedRequests(
-    const std::set<std::string>& unobserved_urls) {
-  std::map<uint64_t, Request> new_requests;
-  std::set<std::string> still_observed_urls;
-  for (auto entry = request_by_id.begin(); entry != request_by_id.end();
-       ++entry) {
-    Request& request = entry->second;
-    auto split = PartitionUrlsBySetMembership(&request.urls, unobserved_urls);
-    if (split == request.urls.end())
+void UrlAvailabilityRequester::ReceiverRequester::RemoveUnobservedRequests() {
+  auto is_unobserved = [this](UrlId url_id) {
+    return url_id != kNoUrlId && !listener->IsObserved(url_id);
+  };
+  pending_url_ids.erase(std::remove_if(pending_url_ids.begin(),
+                                       pending_url_ids.end(), is_unobserved),
+                        pending_url_ids.end());
+
+  // Requests that include an unobserved URL are replaced by requests for their
+  // other URLs.  They are kept, without any URLs, until their responses
+  // arrive.
+  for (auto& entry : request_by_id) {
+    Request& request = entry.second;
+    if (std::none_of(request.url_ids.begin(), request.url_ids.end(),
+                     is_unobserved)) {
       continue;
-    MoveVectorSegment(request.urls.begin(), split, &still_observed_urls);
-    if (connection_)
-      watch_by_id.erase(request.watch_id);
-  }
-  if (!still_observed_urls.empty()) {
-    const uint64_t new_request_id = GetNextRequestId(endpoint_id_);
-    ErrorOr<uint64_t> watch_id_or_error(0);
-    std::vector<std::string> urls;
-    urls.reserve(still_observed_urls.size());
-    for (auto& url : still_observed_urls)
-      urls.emplace_back(std::move(url));
-    if (!connection_ ||
-        (watch_id_or_error = SendRequest(new_request_id, urls))) {
-      new_requests.emplace(new_request_id,
-                           Request{watch_id_or_error.value(), std::move(urls)});
-    } else {
-      for (const auto& url : urls)
-        for (auto& observer : listener->observers_by_url_[url])
-          observer->OnRequestFailed(url, service_id);
     }
+    for (UrlId& url_id : request.url_ids) {
+      if (listener->IsObserved(url_id))
+        pending_url_ids.push_back(url_id);
+      url_id = kNoUrlId;
+    }
+    watch_by_id.erase(request.watch_id);
   }
 
-  for (auto& entry : new_requests)
-    request_by_id.emplace(entry.first, std::move(entry.second));
-
   if (request_by_id.empty())
     StopWatching(&response_watch);
 }
 
-void UrlAvailabilityRequester::ReceiverRequester::RemoveUnobservedWatches(
-    const std::set<std::string>& unobserved_urls) {
-  std::set<std::string> still_observed_urls;
+void UrlAvailabilityRequester::ReceiverRequester::RemoveUnobservedWatches() {
   for (auto entry = watch_by_id.begin(); entry != watch_by_id.end();) {
     Watch& watch = entry->second;
-    auto split = PartitionUrlsBySetMembership(&watch.urls, unobserved_urls);
-    if (split == watch.urls.end()) {
+    if (std::all_of(watch.url_ids.begin(), watch.url_ids.end(),
+                    [this](UrlId url_id) {
+                      return listener->IsObserved(url_id);
+                    })) {
       ++entry;
       continue;
     }
-    MoveVectorSegment(watch.urls.begin(), split, &still_observed_urls);
+    for (UrlId url_id : watch.url_ids) {
+      if (listener->IsObserved(url_id))
+        pending_url_ids.push_back(url_id);
+    }
     entry = watch_by_id.erase(entry);
   }
 
-  std::vector<std::string> urls;
-  urls.reserve(still_observed_urls.size());
-  for (auto& url : still_observed_urls)
-    urls.emplace_back(std::move(url));
-  RequestUrlAvailabilities(std::move(urls));
   // TODO(btolsch): These message watch cancels could be tested by expecting
   // messages to fall through to the default watch.
   if (watch_by_id.empty())
     StopWatching(&event_watch);
 }
 
+void UrlAvailabilityRequester::ReceiverRequester::ForgetAvailability(
+    UrlId url_id) {
+  SetBit(&known_urls, url_id, false);
+  SetBit(&available_urls, url_id, false);
+}
+
 void UrlAvailabilityRequester::ReceiverRequester::RemoveReceiver() {
-  for (const auto& availability : known_availability_by_url) {
-    if (availability.second == msgs::UrlAvailability::kAvailable) {
-      const std::string& url = availability.first;
-      for (auto& observer : listener->observers_by_url_[url])
-        observer->OnReceiverUnavailable(url, service_id);
-    }
+  for (UrlId url_id = 0; url_id < available_urls.size(); ++url_id) {
+    if (!available_urls[url_id] || !listener->IsObserved(url_id))
+      continue;
+    const ObservedUrl& observed_url = listener->observed_urls_[url_id];
+    for (auto* observer : observed_url.observers)
+      observer->OnReceiverUnavailable(observed_url.url, service_id);
   }
 }
 
@@ -392,31 +437,16 @@ void UrlAvailabilityRequester::ReceiverRequester::OnConnectionOpened(
   // connection stays alive, even without constant traffic.
   endpoint_id_ = connection->endpoint_id();
   connection_ = std::move(connection);
-  ErrorOr<uint64_t> watch_id_or_error(0);
-  for (auto entry = request_by_id.begin(); entry != request_by_id.end();) {
-    if ((watch_id_or_error = SendRequest(entry->first, entry->second.urls))) {
-      entry->second.watch_id = watch_id_or_error.value();
-      ++entry;
-    } else {
-      entry = request_by_id.erase(entry);
-    }
-  }
+
+  // Everything requested while the connection was opening is sent together.
+  SendPendingRequest();
 }
 
 void UrlAvailabilityRequester::ReceiverRequester::OnConnectionFailed(
     uint64_t request_id) {
   connect_request.MarkComplete();
 
-  std::set<std::string> waiting_urls;
-  for (auto& entry : request_by_id) {
-    Request& request = entry.second;
-    for (auto& url : request.urls) {
-      waiting_urls.emplace(std::move(url));
-    }
-  }
-  for (const auto& url : waiting_urls)
-    for (auto& observer : listener->observers_by_url_[url])
-      observer->OnRequestFailed(url, service_id);
+  ReportRequestFailed(TakePendingUrlIds());
 
   std::string id = std::move(service_id);
   listener->receiver_by_service_id_.erase(id);
@@ -445,14 +475,14 @@ ErrorOr<size_t> UrlAvailabilityRequester::ReceiverRequester::OnStreamMessage(
           OSP_LOG_ERROR << "bad response id: " << response.request_id;
           return Error::Code::kCborInvalidResponseId;
         }
-        std::vector<std::string>& urls = request_entry->second.urls;
-        if (urls.size() != response.url_availabilities.size()) {
-          OSP_LOG_WARN << "bad response size: expected " << urls.size()
+        std::vector<UrlId>& url_ids = request_entry->second.url_ids;
+        if (url_ids.size() != response.url_availabilities.size()) {
+          OSP_LOG_WARN << "bad response size: expected " << url_ids.size()
                        << " but got " << response.url_availabilities.size();
           return Error::Code::kCborInvalidMessage;
         }
         Error::Code update_result =
-            UpdateAvailabilities(urls, response.url_availabilities);
+            UpdateAvailabilities(url_ids, response.url_availabilities);
         if (update_result != Error::Code::kNone) {
           return update_result;
         }
@@ -474,9 +504,9 @@ ErrorOr<size_t> UrlAvailabilityRequester::ReceiverRequester::OnStreamMessage(
       } else {
         auto watch_entry = watch_by_id.find(event.watch_id);
         if (watch_entry != watch_by_id.end()) {
-          std::vector<std::string> urls = watch_entry->second.urls;
+          std::vector<UrlId> url_ids = watch_entry->second.url_ids;
           Error::Code update_result =
-              UpdateAvailabilities(urls, event.url_availabilities);
+              UpdateAvailabilities(url_ids, event.url_availabilities);
           if (update_result != Error::Code::kNone) {
             return update_result;
           }
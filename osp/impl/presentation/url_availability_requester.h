@@ -7,8 +7,8 @@
 
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/msgs/osp_messages.h"
@@ -28,6 +28,13 @@ namespace osp {
 // It uses the availability protocol message watch mechanism to stay informed of
 // any availability changes as long as at least one observer is registered for a
 // given URL.
+//
+// Each observed URL is interned to a small integer id, and each receiver keeps
+// its known availabilities as bit rows indexed by those ids, so that checking
+// N URLs against M receivers costs N hash lookups rather than N*M map lookups.
+// The URLs that need to be (re-)requested from a receiver during one call are
+// coalesced into a single request, as are all those requested before its
+// connection opens.
 class UrlAvailabilityRequester {
  public:
   explicit UrlAvailabilityRequester(ClockNowFunctionPtr now_function);
@@ -67,6 +74,20 @@ class UrlAvailabilityRequester {
   Clock::time_point RefreshWatches();
 
  private:
+  // Identifies an observed URL by its index in |observed_urls_|.
+  using UrlId = uint32_t;
+
+  // Marks a URL that is no longer observed in an outstanding request.
+  static constexpr UrlId kNoUrlId = ~UrlId{0};
+
+  struct ObservedUrl {
+    std::string url;
+
+    // Empty if the entry is unused, in which case its id is in
+    // |free_url_ids_|.
+    std::vector<ReceiverObserver*> observers;
+  };
+
   // Handles Presentation API URL availability requests and watches for one
   // particular receiver.  When first constructed, it attempts to open a
   // ProtocolConnection to the receiver, then it makes an availability request
@@ -79,12 +100,15 @@ class UrlAvailabilityRequester {
         MessageDemuxer::MessageCallback {
     struct Request {
       uint64_t watch_id;
-      std::vector<std::string> urls;
+
+      // In the order they were requested, so that they match the
+      // availabilities in the response.
+      std::vector<UrlId> url_ids;
     };
 
     struct Watch {
       Clock::time_point deadline;
-      std::vector<std::string> urls;
+      std::vector<UrlId> url_ids;
     };
 
     ReceiverRequester(UrlAvailabilityRequester* listener,
@@ -92,18 +116,33 @@ class UrlAvailabilityRequester {
                       const IPEndpoint& endpoint);
     ~ReceiverRequester() override;
 
-    void GetOrRequestAvailabilities(
-        const std::vector<std::string>& requested_urls,
-        ReceiverObserver* observer);
-    void RequestUrlAvailabilities(std::vector<std::string> urls);
+    // Reports the known availability of each of |url_ids| to |observer|, and
+    // adds the others to |pending_url_ids|.
+    void GetOrRequestAvailabilities(const std::vector<UrlId>& url_ids,
+                                    ReceiverObserver* observer);
+
+    // Sends one request for all of |pending_url_ids|, once the connection is
+    // open.
+    void SendPendingRequest();
+
+    // Returns |pending_url_ids| without duplicates, and clears it.
+    std::vector<UrlId> TakePendingUrlIds();
     ErrorOr<uint64_t> SendRequest(uint64_t request_id,
-                                  const std::vector<std::string>& urls);
+                                  const std::vector<UrlId>& url_ids);
+    void ReportRequestFailed(const std::vector<UrlId>& url_ids);
+
+    // Adds the URLs of watches that are about to expire to |pending_url_ids|.
     Clock::time_point RefreshWatches(Clock::time_point now);
     Error::Code UpdateAvailabilities(
-        const std::vector<std::string>& urls,
+        const std::vector<UrlId>& url_ids,
         const std::vector<msgs::UrlAvailability>& availabilities);
-    void RemoveUnobservedRequests(const std::set<std::string>& unobserved_urls);
-    void RemoveUnobservedWatches(const std::set<std::string>& unobserved_urls);
+
+    // Drop the URLs which are no longer observed from |pending_url_ids| and
+    // from the requests and watches including them, and add the other URLs of
+    // those requests and watches to |pending_url_ids|.
+    void RemoveUnobservedRequests();
+    void RemoveUnobservedWatches();
+    void ForgetAvailability(UrlId url_id);
     void RemoveReceiver();
 
     // ProtocolConnectionClient::ConnectionRequestCallback overrides.
@@ -136,12 +175,35 @@ class UrlAvailabilityRequester {
     MessageDemuxer::MessageWatch event_watch;
     std::map<uint64_t, Watch> watch_by_id;
 
-    std::map<std::string, msgs::UrlAvailability> known_availability_by_url;
+    // This receiver's row of the availability matrix: bit i of each is set
+    // if the availability of URL id i is known, and if it is available,
+    // respectively.  Bits beyond the end of either are clear.
+    std::vector<bool> known_urls;
+    std::vector<bool> available_urls;
+
+    // The URLs to include in the next request.
+    std::vector<UrlId> pending_url_ids;
   };
 
+  // Returns the id of |url|, assigning it one if it is not observed.
+  UrlId InternUrl(const std::string& url);
+
+  // Returns kNoUrlId if |url| is not observed.
+  UrlId FindUrlId(const std::string& url) const;
+
+  bool IsObserved(UrlId url_id) const {
+    return url_id != kNoUrlId && !observed_urls_[url_id].observers.empty();
+  }
+
+  // Stops all the receivers watching the URLs in |unobserved_url_ids|, which
+  // no longer have any observers, and frees their ids for reuse.
+  void RemoveUnobservedUrls(const std::vector<UrlId>& unobserved_url_ids);
+
   const ClockNowFunctionPtr now_function_;
 
-  std::map<std::string, std::vector<ReceiverObserver*>> observers_by_url_;
+  std::vector<ObservedUrl> observed_urls_;
+  std::vector<UrlId> free_url_ids_;
+  std::unordered_map<std::string, UrlId> url_ids_;
 
   std::map<std::string, std::unique_ptr<ReceiverRequester>>
       receiver_by_service_id_;
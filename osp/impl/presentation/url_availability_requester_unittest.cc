@@ -562,6 +562,88 @@ TEST_F(UrlAvailabilityRequesterTest, RefreshWatches) {
   quic_bridge_->RunTasksUntilIdle();
 }
 
+TEST_F(UrlAvailabilityRequesterTest, RefreshWatchesCoalescesRequests) {
+  listener_.AddReceiver(info1_);
+
+  MockReceiverObserver mock_observer1;
+  listener_.AddObserver({url1_}, &mock_observer1);
+
+  msgs::PresentationUrlAvailabilityRequest request;
+  ExpectStreamMessage(&mock_callback_, &request);
+
+  std::unique_ptr<ProtocolConnection> stream = ExpectIncomingConnection();
+  ASSERT_TRUE(stream);
+
+  EXPECT_EQ(std::vector<std::string>{url1_}, request.urls);
+  SendAvailabilityResponse(
+      request,
+      std::vector<msgs::UrlAvailability>{msgs::UrlAvailability::kAvailable},
+      stream.get());
+
+  EXPECT_CALL(mock_observer1, OnReceiverAvailable(url1_, service_id_));
+  quic_bridge_->RunTasksUntilIdle();
+
+  MockReceiverObserver mock_observer2;
+  listener_.AddObserver({url2_}, &mock_observer2);
+  ExpectStreamMessage(&mock_callback_, &request);
+  quic_bridge_->RunTasksUntilIdle();
+
+  EXPECT_EQ(std::vector<std::string>{url2_}, request.urls);
+  SendAvailabilityResponse(
+      request,
+      std::vector<msgs::UrlAvailability>{msgs::UrlAvailability::kAvailable},
+      stream.get());
+
+  EXPECT_CALL(mock_observer2, OnReceiverAvailable(url2_, service_id_));
+  quic_bridge_->RunTasksUntilIdle();
+
+  // Both watches expire, and are renewed by a single request.
+  fake_clock_->Advance(std::chrono::seconds(60));
+
+  ExpectStreamMessage(&mock_callback_, &request);
+  listener_.RefreshWatches();
+  quic_bridge_->RunTasksUntilIdle();
+
+  EXPECT_EQ((std::vector<std::string>{url1_, url2_}), request.urls);
+  SendAvailabilityResponse(
+      request,
+      std::vector<msgs::UrlAvailability>{msgs::UrlAvailability::kAvailable,
+                                         msgs::UrlAvailability::kUnavailable},
+      stream.get());
+
+  EXPECT_CALL(mock_observer1, OnReceiverAvailable(_, _)).Times(0);
+  EXPECT_CALL(mock_observer1, OnReceiverUnavailable(_, _)).Times(0);
+  EXPECT_CALL(mock_observer2, OnReceiverUnavailable(url2_, service_id_));
+  quic_bridge_->RunTasksUntilIdle();
+}
+
+TEST_F(UrlAvailabilityRequesterTest, CoalescesRequestsBeforeConnection) {
+  listener_.AddReceiver(info1_);
+
+  MockReceiverObserver mock_observer1;
+  MockReceiverObserver mock_observer2;
+  listener_.AddObserver({url1_}, &mock_observer1);
+  listener_.AddObserver({url1_, url2_}, &mock_observer2);
+
+  msgs::PresentationUrlAvailabilityRequest request;
+  ExpectStreamMessage(&mock_callback_, &request);
+
+  std::unique_ptr<ProtocolConnection> stream = ExpectIncomingConnection();
+  ASSERT_TRUE(stream);
+
+  EXPECT_EQ((std::vector<std::string>{url1_, url2_}), request.urls);
+  SendAvailabilityResponse(
+      request,
+      std::vector<msgs::UrlAvailability>{msgs::UrlAvailability::kAvailable,
+                                         msgs::UrlAvailability::kUnavailable},
+      stream.get());
+
+  EXPECT_CALL(mock_observer1, OnReceiverAvailable(url1_, service_id_));
+  EXPECT_CALL(mock_observer2, OnReceiverAvailable(url1_, service_id_));
+  EXPECT_CALL(mock_observer2, OnReceiverUnavailable(url2_, service_id_));
+  quic_bridge_->RunTasksUntilIdle();
+}
+
 TEST_F(UrlAvailabilityRequesterTest, ResponseAfterRemoveObserver) {
   listener_.AddReceiver(info1_);
 
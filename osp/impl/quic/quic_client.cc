@@ -50,6 +50,7 @@ bool QuicClient::Stop() {
 
 void QuicClient::Cleanup() {
   for (auto& entry : connections_) {
+    entry.second.delegate->CloseIdleStreams();
     entry.second.delegate->DestroyClosedStreams();
     if (!entry.second.delegate->has_streams())
       entry.second.connection->Close();
@@ -102,8 +103,10 @@ void QuicClient::OnConnectionDestroyed(QuicProtocolConnection* connection) {
     return;
 
   auto connection_entry = connections_.find(connection->endpoint_id());
-  if (connection_entry == connections_.end())
+  if (connection_entry == connections_.end()) {
+    connection->stream()->CloseWriteEnd();
     return;
+  }
 
   connection_entry->second.delegate->DropProtocolConnection(connection);
 }
@@ -6,8 +6,8 @@
 #define OSP_IMPL_QUIC_QUIC_CLIENT_H_
 
 #include <cstdint>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/impl/quic/quic_connection_factory.h"
@@ -103,7 +103,7 @@ class QuicClient final : public ProtocolConnectionClient,
 
   // Maps an IPEndpoint to a generated endpoint ID.  This is used to insulate
   // callers from post-handshake changes to a connections actual peer endpoint.
-  std::map<IPEndpoint, uint64_t> endpoint_map_;
+  std::unordered_map<IPEndpoint, uint64_t, IPEndpointHash> endpoint_map_;
 
   // Value that will be used for the next new endpoint in a Connect call.
   uint64_t next_endpoint_id_ = 0;
@@ -111,7 +111,8 @@ class QuicClient final : public ProtocolConnectionClient,
   // Maps request IDs to their callbacks.  The callback is paired with the
   // IPEndpoint it originally requested to connect to so cancelling the request
   // can also remove a pending connection.
-  std::map<uint64_t, std::pair<IPEndpoint, ConnectionRequestCallback*>>
+  std::unordered_map<uint64_t,
+                     std::pair<IPEndpoint, ConnectionRequestCallback*>>
       request_map_;
 
   // Value that will be used for the next new connection request.
@@ -119,11 +120,12 @@ class QuicClient final : public ProtocolConnectionClient,
 
   // Maps endpoint addresses to data about connections that haven't successfully
   // completed the QUIC handshake.
-  std::map<IPEndpoint, PendingConnectionData> pending_connections_;
+  std::unordered_map<IPEndpoint, PendingConnectionData, IPEndpointHash>
+      pending_connections_;
 
   // Maps endpoint IDs to data about connections that have successfully
   // completed the QUIC handshake.
-  std::map<uint64_t, ServiceConnectionData> connections_;
+  std::unordered_map<uint64_t, ServiceConnectionData> connections_;
 
   // Connections (endpoint IDs) that need to be destroyed, but have to wait for
   // the next event loop due to the underlying QUIC implementation's way of
@@ -269,5 +269,49 @@ TEST_F(QuicClientTest, RequestIds) {
   EXPECT_EQ(0u, client_->endpoint_request_ids()->GetNextRequestId(endpoint_id));
 }
 
+TEST_F(QuicClientTest, ReuseIdleStream) {
+  client_->Start();
+
+  std::unique_ptr<ProtocolConnection> connection;
+  ConnectionCallback connection_callback(&connection);
+  ProtocolConnectionClient::ConnectRequest request =
+      client_->Connect(quic_bridge_->kReceiverEndpoint, &connection_callback);
+  ASSERT_TRUE(request);
+  quic_bridge_->RunTasksUntilIdle();
+  ASSERT_TRUE(connection);
+  const uint64_t endpoint_id = connection->endpoint_id();
+
+  // A stream is reused once its ProtocolConnection is destroyed.
+  std::unique_ptr<ProtocolConnection> connection1 =
+      client_->CreateProtocolConnection(endpoint_id);
+  ASSERT_TRUE(connection1);
+  const uint64_t stream_id = connection1->id();
+  connection1.reset();
+  std::unique_ptr<ProtocolConnection> connection2 =
+      client_->CreateProtocolConnection(endpoint_id);
+  ASSERT_TRUE(connection2);
+  EXPECT_EQ(stream_id, connection2->id());
+  SendTestMessage(connection2.get());
+
+  // Streams whose write end was closed are not reused.
+  connection2.reset();
+  std::unique_ptr<ProtocolConnection> connection3 =
+      client_->CreateProtocolConnection(endpoint_id);
+  ASSERT_TRUE(connection3);
+  EXPECT_NE(stream_id, connection3->id());
+
+  // Idle streams are closed by the next clean-up.
+  const uint64_t idle_stream_id = connection3->id();
+  connection3.reset();
+  fake_clock_->Advance(std::chrono::seconds(1));
+  quic_bridge_->RunTasksUntilIdle();
+  std::unique_ptr<ProtocolConnection> connection4 =
+      client_->CreateProtocolConnection(endpoint_id);
+  ASSERT_TRUE(connection4);
+  EXPECT_NE(idle_stream_id, connection4->id());
+
+  client_->Stop();
+}
+
 }  // namespace osp
 }  // namespace openscreen
@@ -124,8 +124,8 @@ void QuicConnectionFactoryImpl::OnRead(UdpSocket* socket,
   if (conn_it == connections_.end()) {
     if (server_delegate_) {
       OSP_VLOG << __func__ << ": spawning connection from " << packet.source();
-      auto transport =
-          std::make_unique<UdpTransport>(packet.socket(), packet.source());
+      auto transport = std::make_unique<UdpTransport>(
+          task_runner_, packet.socket(), packet.source());
       ::quic::QuartcSessionConfig session_config;
       session_config.perspective = ::quic::Perspective::IS_SERVER;
       session_config.packet_transport = transport.get();
@@ -158,7 +158,8 @@ std::unique_ptr<QuicConnection> QuicConnectionFactoryImpl::Connect(
     return nullptr;
   }
   std::unique_ptr<UdpSocket> socket = std::move(create_result.value());
-  auto transport = std::make_unique<UdpTransport>(socket.get(), endpoint);
+  auto transport =
+      std::make_unique<UdpTransport>(task_runner_, socket.get(), endpoint);
 
   ::quic::QuartcSessionConfig session_config;
   session_config.perspective = ::quic::Perspective::IS_CLIENT;
@@ -5,8 +5,8 @@
 #ifndef OSP_IMPL_QUIC_QUIC_CONNECTION_FACTORY_IMPL_H_
 #define OSP_IMPL_QUIC_QUIC_CONNECTION_FACTORY_IMPL_H_
 
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/impl/quic/quic_connection_factory.h"
@@ -54,7 +54,7 @@ class QuicConnectionFactoryImpl final : public QuicConnectionFactory {
     QuicConnection* connection;
     UdpSocket* socket;  // References one of the owned |sockets_|.
   };
-  std::map<IPEndpoint, OpenConnection> connections_;
+  std::unordered_map<IPEndpoint, OpenConnection, IPEndpointHash> connections_;
 
   // NOTE: Must be provided in constructor and stored as an instance variable
   // rather than using the static accessor method to allow for UTs to mock this
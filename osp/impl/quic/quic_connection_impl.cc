@@ -9,6 +9,7 @@
 
 #include "absl/types/optional.h"
 #include "osp/impl/quic/quic_connection_factory_impl.h"
+#include "platform/api/task_runner.h"
 #include "platform/base/error.h"
 #include "third_party/chromium_quic/src/net/third_party/quic/platform/impl/quic_chromium_clock.h"
 #include "util/osp_logging.h"
@@ -17,26 +18,50 @@
 namespace openscreen {
 namespace osp {
 
-UdpTransport::UdpTransport(UdpSocket* socket, const IPEndpoint& destination)
-    : socket_(socket), destination_(destination) {
+UdpTransport::UdpTransport(TaskRunner* task_runner,
+                           UdpSocket* socket,
+                           const IPEndpoint& destination)
+    : task_runner_(task_runner), socket_(socket), destination_(destination) {
+  OSP_DCHECK(task_runner_);
   OSP_DCHECK(socket_);
 }
 
-UdpTransport::UdpTransport(UdpTransport&&) noexcept = default;
 UdpTransport::~UdpTransport() = default;
 
-UdpTransport& UdpTransport::operator=(UdpTransport&&) noexcept = default;
-
 int UdpTransport::Write(const char* buffer,
                         size_t buffer_length,
                         const PacketInfo& info) {
   TRACE_SCOPED(TraceCategory::kQuic, "UdpTransport::Write");
-  socket_->SendMessage(buffer, buffer_length, destination_);
+  if (num_pending_packets_ == 0) {
+    task_runner_->PostTask([weak_this = weak_factory_.GetWeakPtr()] {
+      if (weak_this) {
+        weak_this->Flush();
+      }
+    });
+  }
+  if (num_pending_packets_ == pending_packets_.size()) {
+    pending_packets_.emplace_back();
+  }
+  const uint8_t* const data = reinterpret_cast<const uint8_t*>(buffer);
+  pending_packets_[num_pending_packets_++].assign(data, data + buffer_length);
+
   OSP_DCHECK_LE(buffer_length,
                 static_cast<size_t>(std::numeric_limits<int>::max()));
   return static_cast<int>(buffer_length);
 }
 
+void UdpTransport::Flush() {
+  TRACE_SCOPED(TraceCategory::kQuic, "UdpTransport::Flush");
+  if (num_pending_packets_ == 0) {
+    return;
+  }
+  socket_->SendMessages(
+      Span<const std::vector<uint8_t>>(pending_packets_.data(),
+                                       num_pending_packets_),
+      destination_);
+  num_pending_packets_ = 0;
+}
+
 QuicStreamImpl::QuicStreamImpl(QuicStream::Delegate* delegate,
                                ::quic::QuartcStream* stream)
     : QuicStream(delegate, stream->id()), stream_(stream) {
@@ -147,6 +172,8 @@ void QuicConnectionImpl::OnConnectionClosed(
     const ::quic::QuicString& error_details,
     ::quic::ConnectionCloseSource source) {
   TRACE_SCOPED(TraceCategory::kQuic, "QuicConnectionImpl::OnConnectionClosed");
+  // The factory may destroy the socket, so send the final packets now.
+  udp_transport_->Flush();
   parent_factory_->OnConnectionClosed(this);
   delegate_->OnConnectionClosed(session_->connection_id());
 }
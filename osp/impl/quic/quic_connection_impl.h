@@ -7,6 +7,7 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "osp/impl/quic/quic_connection.h"
 #include "platform/api/udp_socket.h"
@@ -18,30 +19,52 @@
 #include "third_party/chromium_quic/src/net/third_party/quic/quartc/quartc_packet_writer.h"
 #include "third_party/chromium_quic/src/net/third_party/quic/quartc/quartc_session.h"
 #include "third_party/chromium_quic/src/net/third_party/quic/quartc/quartc_stream.h"
+#include "util/weak_ptr.h"
 
 namespace openscreen {
+
+class TaskRunner;
+
 namespace osp {
 
 class QuicConnectionFactoryImpl;
 
+// Collects the packets the QUIC session writes while handling one event, such
+// as a received packet or an alarm, and sends them together from a task posted
+// to |task_runner|, so that a burst of packets costs one system call where the
+// platform supports it.
 class UdpTransport final : public ::quic::QuartcPacketTransport {
  public:
-  UdpTransport(UdpSocket* socket, const IPEndpoint& destination);
-  UdpTransport(UdpTransport&&) noexcept;
+  UdpTransport(TaskRunner* task_runner,
+               UdpSocket* socket,
+               const IPEndpoint& destination);
+  UdpTransport(const UdpTransport&) = delete;
   ~UdpTransport() override;
 
-  UdpTransport& operator=(UdpTransport&&) noexcept;
+  UdpTransport& operator=(const UdpTransport&) = delete;
 
   // ::quic::QuartcPacketTransport overrides.
   int Write(const char* buffer,
             size_t buffer_length,
             const PacketInfo& info) override;
 
+  // Sends any packets written since the last flush.  Must be called before
+  // |socket_| is destroyed if written packets must not be dropped.
+  void Flush();
+
   UdpSocket* socket() const { return socket_; }
 
  private:
-  UdpSocket* socket_;
-  IPEndpoint destination_;
+  TaskRunner* const task_runner_;
+  UdpSocket* const socket_;
+  const IPEndpoint destination_;
+
+  // The packets waiting to be sent.  Only the first |num_pending_packets_| are
+  // in use; the rest keep their capacity for reuse by later writes.
+  std::vector<std::vector<uint8_t>> pending_packets_;
+  size_t num_pending_packets_ = 0;
+
+  WeakPtrFactory<UdpTransport> weak_factory_{this};
 };
 
 class QuicStreamImpl final : public QuicStream,
@@ -69,8 +69,10 @@ bool QuicServer::Resume() {
 }
 
 void QuicServer::Cleanup() {
-  for (auto& entry : connections_)
+  for (auto& entry : connections_) {
+    entry.second.delegate->CloseIdleStreams();
     entry.second.delegate->DestroyClosedStreams();
+  }
 
   for (uint64_t endpoint_id : delete_connections_) {
     auto it = connections_.find(endpoint_id);
@@ -105,8 +107,10 @@ void QuicServer::OnConnectionDestroyed(QuicProtocolConnection* connection) {
     return;
 
   auto connection_entry = connections_.find(connection->endpoint_id());
-  if (connection_entry == connections_.end())
+  if (connection_entry == connections_.end()) {
+    connection->stream()->CloseWriteEnd();
     return;
+  }
 
   connection_entry->second.delegate->DropProtocolConnection(connection);
 }
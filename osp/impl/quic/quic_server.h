@@ -6,8 +6,8 @@
 #define OSP_IMPL_QUIC_QUIC_SERVER_H_
 
 #include <cstdint>
-#include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "osp/impl/quic/quic_connection_factory.h"
 #include "osp/impl/quic/quic_service_common.h"
@@ -84,18 +84,19 @@ class QuicServer final : public ProtocolConnectionServer,
 
   // Maps an IPEndpoint to a generated endpoint ID.  This is used to insulate
   // callers from post-handshake changes to a connections actual peer endpoint.
-  std::map<IPEndpoint, uint64_t> endpoint_map_;
+  std::unordered_map<IPEndpoint, uint64_t, IPEndpointHash> endpoint_map_;
 
   // Value that will be used for the next new endpoint in a Connect call.
   uint64_t next_endpoint_id_ = 0;
 
   // Maps endpoint addresses to data about connections that haven't successfully
   // completed the QUIC handshake.
-  std::map<IPEndpoint, ServiceConnectionData> pending_connections_;
+  std::unordered_map<IPEndpoint, ServiceConnectionData, IPEndpointHash>
+      pending_connections_;
 
   // Maps endpoint IDs to data about connections that have successfully
   // completed the QUIC handshake.
-  std::map<uint64_t, ServiceConnectionData> connections_;
+  std::unordered_map<uint64_t, ServiceConnectionData> connections_;
 
   // Connections (endpoint IDs) that need to be destroyed, but have to wait for
   // the next event loop due to the underlying QUIC implementation's way of
@@ -18,12 +18,20 @@ std::unique_ptr<QuicProtocolConnection> QuicProtocolConnection::FromExisting(
     QuicConnection* connection,
     ServiceConnectionDelegate* delegate,
     uint64_t endpoint_id) {
+  std::unique_ptr<QuicProtocolConnection> pc =
+      delegate->TakeIdleStream(owner, endpoint_id);
+  if (pc) {
+    OSP_VLOG << "QUIC stream reused for endpoint " << endpoint_id;
+    return pc;
+  }
+
   OSP_VLOG << "QUIC stream created for endpoint " << endpoint_id;
   std::unique_ptr<QuicStream> stream = connection->MakeOutgoingStream(delegate);
-  auto pc = std::make_unique<QuicProtocolConnection>(owner, endpoint_id,
-                                                     stream->id());
+  pc = std::make_unique<QuicProtocolConnection>(owner, endpoint_id,
+                                                stream->id());
   pc->set_stream(stream.get());
-  delegate->AddStreamPair(ServiceStreamPair(std::move(stream), pc.get()));
+  delegate->AddStreamPair(
+      ServiceStreamPair(std::move(stream), pc.get(), /* outgoing */ true));
   return pc;
 }
 
@@ -34,7 +42,6 @@ QuicProtocolConnection::QuicProtocolConnection(Owner* owner,
 
 QuicProtocolConnection::~QuicProtocolConnection() {
   if (stream_) {
-    stream_->CloseWriteEnd();
     owner_->OnConnectionDestroyed(this);
     stream_ = nullptr;
   }
@@ -48,6 +55,7 @@ void QuicProtocolConnection::Write(const uint8_t* data, size_t data_size) {
 void QuicProtocolConnection::CloseWriteEnd() {
   if (stream_)
     stream_->CloseWriteEnd();
+  write_end_closed_ = true;
 }
 
 void QuicProtocolConnection::OnClose() {
@@ -57,10 +65,12 @@ void QuicProtocolConnection::OnClose() {
 
 ServiceStreamPair::ServiceStreamPair(
     std::unique_ptr<QuicStream> stream,
-    QuicProtocolConnection* protocol_connection)
+    QuicProtocolConnection* protocol_connection,
+    bool outgoing)
     : stream(std::move(stream)),
       connection_id(protocol_connection->id()),
-      protocol_connection(std::move(protocol_connection)) {}
+      protocol_connection(std::move(protocol_connection)),
+      outgoing(outgoing) {}
 ServiceStreamPair::~ServiceStreamPair() = default;
 
 ServiceStreamPair::ServiceStreamPair(ServiceStreamPair&& other) noexcept =
@@ -85,10 +95,52 @@ void ServiceConnectionDelegate::AddStreamPair(ServiceStreamPair&& stream_pair) {
 
 void ServiceConnectionDelegate::DropProtocolConnection(
     QuicProtocolConnection* connection) {
-  auto stream_entry = streams_.find(connection->stream()->id());
-  if (stream_entry == streams_.end())
+  QuicStream* const stream = connection->stream();
+  auto stream_entry = streams_.find(stream->id());
+  if (stream_entry == streams_.end()) {
+    stream->CloseWriteEnd();
     return;
-  stream_entry->second.protocol_connection = nullptr;
+  }
+
+  ServiceStreamPair& stream_pair = stream_entry->second;
+  stream_pair.protocol_connection = nullptr;
+  if (stream_pair.outgoing && !connection->write_end_closed()) {
+    idle_streams_.push_back(stream_entry->first);
+  } else {
+    stream->CloseWriteEnd();
+  }
+}
+
+std::unique_ptr<QuicProtocolConnection>
+ServiceConnectionDelegate::TakeIdleStream(QuicProtocolConnection::Owner* owner,
+                                          uint64_t endpoint_id) {
+  while (!idle_streams_.empty()) {
+    const uint64_t stream_id = idle_streams_.back();
+    idle_streams_.pop_back();
+
+    // The other endpoint may have closed the stream since it became idle.
+    auto stream_entry = streams_.find(stream_id);
+    if (stream_entry == streams_.end())
+      continue;
+
+    ServiceStreamPair& stream_pair = stream_entry->second;
+    OSP_DCHECK(!stream_pair.protocol_connection);
+    auto pc = std::make_unique<QuicProtocolConnection>(
+        owner, endpoint_id, stream_pair.connection_id);
+    pc->set_stream(stream_pair.stream.get());
+    stream_pair.protocol_connection = pc.get();
+    return pc;
+  }
+  return nullptr;
+}
+
+void ServiceConnectionDelegate::CloseIdleStreams() {
+  for (uint64_t stream_id : idle_streams_) {
+    auto stream_entry = streams_.find(stream_id);
+    if (stream_entry != streams_.end())
+      stream_entry->second.stream->CloseWriteEnd();
+  }
+  idle_streams_.clear();
 }
 
 void ServiceConnectionDelegate::DestroyClosedStreams() {
@@ -107,8 +159,8 @@ void ServiceConnectionDelegate::OnIncomingStream(
     std::unique_ptr<QuicStream> stream) {
   OSP_VLOG << "Incoming QUIC stream from endpoint " << endpoint_id_;
   pending_connection_->set_stream(stream.get());
-  AddStreamPair(
-      ServiceStreamPair(std::move(stream), pending_connection_.get()));
+  AddStreamPair(ServiceStreamPair(std::move(stream), pending_connection_.get(),
+                                  /* outgoing */ false));
   parent_->OnIncomingStream(std::move(pending_connection_));
 }
 
@@ -6,8 +6,8 @@
 #define OSP_IMPL_QUIC_QUIC_SERVICE_COMMON_H_
 
 #include <cstdint>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/impl/quic/quic_connection.h"
@@ -24,7 +24,9 @@ class QuicProtocolConnection final : public ProtocolConnection {
    public:
     virtual ~Owner() = default;
 
-    // Called right before |connection| is destroyed (destructor runs).
+    // Called right before |connection| is destroyed (destructor runs).  The
+    // owner either closes the write end of its stream, or keeps the stream
+    // open for reuse (see ServiceConnectionDelegate::DropProtocolConnection).
     virtual void OnConnectionDestroyed(QuicProtocolConnection* connection) = 0;
   };
 
@@ -46,16 +48,20 @@ class QuicProtocolConnection final : public ProtocolConnection {
   QuicStream* stream() { return stream_; }
   void set_stream(QuicStream* stream) { stream_ = stream; }
 
+  bool write_end_closed() const { return write_end_closed_; }
+
   void OnClose();
 
  private:
   Owner* const owner_;
   QuicStream* stream_ = nullptr;
+  bool write_end_closed_ = false;
 };
 
 struct ServiceStreamPair {
   ServiceStreamPair(std::unique_ptr<QuicStream> stream,
-                    QuicProtocolConnection* protocol_connection);
+                    QuicProtocolConnection* protocol_connection,
+                    bool outgoing);
   ~ServiceStreamPair();
   ServiceStreamPair(ServiceStreamPair&&) noexcept;
   ServiceStreamPair& operator=(ServiceStreamPair&&) noexcept;
@@ -63,6 +69,9 @@ struct ServiceStreamPair {
   std::unique_ptr<QuicStream> stream;
   uint64_t connection_id;
   QuicProtocolConnection* protocol_connection;
+
+  // True if this endpoint opened the stream.
+  bool outgoing;
 };
 
 class ServiceConnectionDelegate final : public QuicConnection::Delegate,
@@ -90,8 +99,24 @@ class ServiceConnectionDelegate final : public QuicConnection::Delegate,
   ~ServiceConnectionDelegate() override;
 
   void AddStreamPair(ServiceStreamPair&& stream_pair);
+
+  // Detaches |connection| from its stream.  If this endpoint opened the stream
+  // and |connection| didn't close its write end, the stream is kept open so
+  // TakeIdleStream() can give it to a later QuicProtocolConnection.  Otherwise,
+  // its write end is closed.
   void DropProtocolConnection(QuicProtocolConnection* connection);
 
+  // Returns a new QuicProtocolConnection using a stream kept open by
+  // DropProtocolConnection(), or nullptr if there is none.
+  std::unique_ptr<QuicProtocolConnection> TakeIdleStream(
+      QuicProtocolConnection::Owner* owner,
+      uint64_t endpoint_id);
+
+  // Closes the write end of every stream kept open by DropProtocolConnection()
+  // that hasn't been reused.  This should be called periodically, so idle
+  // streams don't keep a connection open forever.
+  void CloseIdleStreams();
+
   // This should be called at the end of each event loop that effects this
   // connection so streams that were closed by the other endpoint can be
   // destroyed properly.
@@ -120,8 +145,12 @@ class ServiceConnectionDelegate final : public QuicConnection::Delegate,
   IPEndpoint endpoint_;
   uint64_t endpoint_id_;
   std::unique_ptr<QuicProtocolConnection> pending_connection_;
-  std::map<uint64_t, ServiceStreamPair> streams_;
+  std::unordered_map<uint64_t, ServiceStreamPair> streams_;
   std::vector<ServiceStreamPair> closed_streams_;
+
+  // IDs of streams in |streams_| that have no QuicProtocolConnection, and may
+  // be reused.
+  std::vector<uint64_t> idle_streams_;
 };
 
 struct ServiceConnectionData {
@@ -4,7 +4,7 @@
 
 #include "osp/impl/receiver_list.h"
 
-#include <algorithm>
+#include <utility>
 
 namespace openscreen {
 namespace osp {
@@ -12,36 +12,72 @@ namespace osp {
 ReceiverList::ReceiverList() = default;
 ReceiverList::~ReceiverList() = default;
 
-void ReceiverList::OnReceiverAdded(const ServiceInfo& info) {
-  receivers_.emplace_back(info);
+bool ReceiverList::OnReceiverAdded(const ServiceInfo& info) {
+  auto result = index_.emplace(info.service_id, receivers_.size());
+  if (result.second) {
+    receivers_.emplace_back(info);
+    is_removed_.push_back(false);
+  } else {
+    receivers_[result.first->second] = info;
+  }
+  return result.second;
 }
 
 Error ReceiverList::OnReceiverChanged(const ServiceInfo& info) {
-  auto existing_info = std::find_if(receivers_.begin(), receivers_.end(),
-                                    [&info](const ServiceInfo& x) {
-                                      return x.service_id == info.service_id;
-                                    });
-  if (existing_info == receivers_.end())
+  auto it = index_.find(info.service_id);
+  if (it == index_.end())
     return Error::Code::kItemNotFound;
 
-  *existing_info = info;
+  receivers_[it->second] = info;
   return Error::None();
 }
 
 Error ReceiverList::OnReceiverRemoved(const ServiceInfo& info) {
-  const auto it = std::remove(receivers_.begin(), receivers_.end(), info);
-  if (it == receivers_.end())
+  auto it = index_.find(info.service_id);
+  if (it == index_.end())
     return Error::Code::kItemNotFound;
 
-  receivers_.erase(it, receivers_.end());
+  is_removed_[it->second] = true;
+  ++removed_count_;
+  index_.erase(it);
+  if (removed_count_ > receivers_.size() / 2) {
+    Compact();
+  }
   return Error::None();
 }
 
 Error ReceiverList::OnAllReceiversRemoved() {
-  const auto empty = receivers_.empty();
+  const auto empty = index_.empty();
   receivers_.clear();
+  is_removed_.clear();
+  removed_count_ = 0;
+  index_.clear();
   return empty ? Error::Code::kItemNotFound : Error::None();
 }
 
+const std::vector<ServiceInfo>& ReceiverList::receivers() const {
+  if (removed_count_) {
+    Compact();
+  }
+  return receivers_;
+}
+
+void ReceiverList::Compact() const {
+  size_t position = 0;
+  for (size_t i = 0; i < receivers_.size(); ++i) {
+    if (is_removed_[i]) {
+      continue;
+    }
+    if (i != position) {
+      receivers_[position] = std::move(receivers_[i]);
+      index_[receivers_[position].service_id] = position;
+    }
+    ++position;
+  }
+  receivers_.resize(position);
+  is_removed_.assign(position, false);
+  removed_count_ = 0;
+}
+
 }  // namespace osp
 }  // namespace openscreen
@@ -5,6 +5,8 @@
 #ifndef OSP_IMPL_RECEIVER_LIST_H_
 #define OSP_IMPL_RECEIVER_LIST_H_
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/public/service_info.h"
@@ -13,6 +15,10 @@
 namespace openscreen {
 namespace osp {
 
+// The receivers known to a ServiceListener, in the order they were added.  They
+// are indexed by service ID, and removed receivers are only compacted away
+// once many have been removed or the receivers are read, so that each update
+// takes amortized constant time however many receivers there are.
 class ReceiverList {
  public:
   ReceiverList();
@@ -20,16 +26,31 @@ class ReceiverList {
   ReceiverList(ReceiverList&&) = delete;
   ReceiverList& operator=(ReceiverList&&) = delete;
 
-  void OnReceiverAdded(const ServiceInfo& info);
+  // Adds |info|, or replaces the receiver with the same service ID.  Returns
+  // true if the receiver is new.
+  bool OnReceiverAdded(const ServiceInfo& info);
 
   Error OnReceiverChanged(const ServiceInfo& info);
+
+  // Removes the receiver with the same service ID as |info|.
   Error OnReceiverRemoved(const ServiceInfo& info);
   Error OnAllReceiversRemoved();
 
-  const std::vector<ServiceInfo>& receivers() const { return receivers_; }
+  // Returns the receivers, in the order they were added.
+  const std::vector<ServiceInfo>& receivers() const;
 
  private:
-  std::vector<ServiceInfo> receivers_;
+  // Drops the removed receivers from |receivers_|, keeping the order of the
+  // others.
+  void Compact() const;
+
+  // Includes removed receivers until Compact() is called.
+  mutable std::vector<ServiceInfo> receivers_;
+  mutable std::vector<bool> is_removed_;
+  mutable size_t removed_count_ = 0;
+
+  // The position of each receiver in |receivers_|, by service ID.
+  mutable std::unordered_map<std::string, size_t> index_;
 };
 
 }  // namespace osp
@@ -4,12 +4,18 @@
 
 #include "osp/impl/receiver_list.h"
 
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "platform/base/error.h"
 
 namespace openscreen {
 namespace osp {
 
+using ::testing::ElementsAre;
+
 TEST(ReceiverListTest, AddReceivers) {
   ReceiverList list;
 
@@ -17,7 +23,7 @@ TEST(ReceiverListTest, AddReceivers) {
 
   const ServiceInfo receiver1{
       "id1", "name1", 1, {{192, 168, 1, 10}, 12345}, {}};
-  list.OnReceiverAdded(receiver1);
+  EXPECT_TRUE(list.OnReceiverAdded(receiver1));
 
   ASSERT_EQ(1u, list.receivers().size());
   EXPECT_EQ(receiver1, list.receivers()[0]);
@@ -30,13 +36,14 @@ TEST(ReceiverListTest, AddReceivers) {
   EXPECT_EQ(receiver1, list.receivers()[0]);
   EXPECT_EQ(receiver2, list.receivers()[1]);
 
-  list.OnReceiverAdded(receiver1);
+  // Adding a receiver again replaces it.
+  const ServiceInfo receiver1_alt_name{
+      "id1", "name1 alt", 1, {{192, 168, 1, 10}, 12345}, {}};
+  EXPECT_FALSE(list.OnReceiverAdded(receiver1_alt_name));
 
-  // No duplicate checking.
-  ASSERT_EQ(3u, list.receivers().size());
-  EXPECT_EQ(receiver1, list.receivers()[0]);
+  ASSERT_EQ(2u, list.receivers().size());
+  EXPECT_EQ(receiver1_alt_name, list.receivers()[0]);
   EXPECT_EQ(receiver2, list.receivers()[1]);
-  EXPECT_EQ(receiver1, list.receivers()[2]);
 }
 
 TEST(ReceiverListTest, ChangeReceivers) {
@@ -78,6 +85,58 @@ TEST(ReceiverListTest, RemoveReceivers) {
   EXPECT_EQ(receiver2, list.receivers()[0]);
 }
 
+TEST(ReceiverListTest, RemoveReceiversKeepsIndex) {
+  ReceiverList list;
+  std::vector<ServiceInfo> receivers;
+  for (int i = 0; i < 4; ++i) {
+    receivers.push_back(ServiceInfo{"id" + std::to_string(i),
+                                    "name" + std::to_string(i),
+                                    1,
+                                    {{192, 168, 1, 10}, 12345},
+                                    {}});
+    list.OnReceiverAdded(receivers.back());
+  }
+
+  EXPECT_TRUE(list.OnReceiverRemoved(receivers[1]).ok());
+  EXPECT_TRUE(list.OnReceiverRemoved(receivers[0]).ok());
+  EXPECT_FALSE(list.OnReceiverRemoved(receivers[0]).ok());
+  EXPECT_THAT(list.receivers(), ElementsAre(receivers[2], receivers[3]));
+
+  // The receivers that moved can still be found by their service IDs.
+  ServiceInfo changed = receivers[3];
+  changed.friendly_name = "name3 alt";
+  EXPECT_TRUE(list.OnReceiverChanged(changed).ok());
+  EXPECT_TRUE(list.OnReceiverRemoved(receivers[2]).ok());
+  EXPECT_THAT(list.receivers(), ElementsAre(changed));
+}
+
+TEST(ReceiverListTest, RemoveReceiversKeepsOrder) {
+  ReceiverList list;
+  std::vector<ServiceInfo> receivers;
+  for (int i = 0; i < 8; ++i) {
+    receivers.push_back(ServiceInfo{"id" + std::to_string(i),
+                                    "name" + std::to_string(i),
+                                    1,
+                                    {{192, 168, 1, 10}, 12345},
+                                    {}});
+    list.OnReceiverAdded(receivers.back());
+  }
+
+  // Enough receivers are removed for the list to compact itself.
+  for (int i : {0, 2, 3, 5, 6}) {
+    EXPECT_TRUE(list.OnReceiverRemoved(receivers[i]).ok());
+  }
+  list.OnReceiverAdded(receivers[2]);
+  EXPECT_THAT(list.receivers(), ElementsAre(receivers[1], receivers[4],
+                                            receivers[7], receivers[2]));
+
+  EXPECT_TRUE(list.OnReceiverRemoved(receivers[4]).ok());
+  EXPECT_THAT(list.receivers(),
+              ElementsAre(receivers[1], receivers[7], receivers[2]));
+  EXPECT_TRUE(list.OnReceiverChanged(receivers[7]).ok());
+  EXPECT_FALSE(list.OnReceiverChanged(receivers[4]).ok());
+}
+
 TEST(ReceiverListTest, RemoveAllReceivers) {
   ReceiverList list;
   const ServiceInfo receiver1{
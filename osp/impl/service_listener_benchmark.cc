@@ -0,0 +1,198 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how quickly ServiceListenerImpl keeps its receiver list and its
+// observers up to date when many receivers are known, as they churn and as the
+// whole list is refreshed, with and without batching the updates.
+
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "osp/impl/service_listener_impl.h"
+#include "util/micro_benchmark.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace osp {
+namespace {
+
+constexpr int kNumReceivers = 500;
+
+// Every kChurnInterval-th receiver is removed and added again by each churn.
+constexpr int kChurnInterval = 10;
+
+class NoopListenerDelegate final : public ServiceListenerImpl::Delegate {
+ public:
+  ~NoopListenerDelegate() override = default;
+
+  void StartListener() override {}
+  void StartAndSuspendListener() override {}
+  void StopListener() override {}
+  void SuspendListener() override {}
+  void ResumeListener() override {}
+  void SearchNow(ServiceListener::State from) override {}
+};
+
+// Tracks the receivers' endpoints, as the Controller does, and counts how many
+// times it is notified.
+class TrackingObserver final : public ServiceListener::Observer {
+ public:
+  ~TrackingObserver() override = default;
+
+  size_t num_receivers() const { return endpoints_.size(); }
+  int64_t notifications() const { return notifications_; }
+
+  // ServiceListener::Observer overrides.
+  void OnStarted() override {}
+  void OnStopped() override {}
+  void OnSuspended() override {}
+  void OnSearching() override {}
+
+  void OnReceiverAdded(const ServiceInfo& info) override {
+    ++notifications_;
+    endpoints_[info.service_id] = info.v4_endpoint;
+  }
+  void OnReceiverChanged(const ServiceInfo& info) override {
+    ++notifications_;
+    endpoints_[info.service_id] = info.v4_endpoint;
+  }
+  void OnReceiverRemoved(const ServiceInfo& info) override {
+    ++notifications_;
+    endpoints_.erase(info.service_id);
+  }
+  void OnAllReceiversRemoved() override {
+    ++notifications_;
+    endpoints_.clear();
+  }
+
+  void OnReceiversChanged(
+      const ServiceListener::ReceiverChanges& changes) override {
+    ++notifications_;
+    for (const ServiceInfo& info : changes.added) {
+      endpoints_[info.service_id] = info.v4_endpoint;
+    }
+    for (const ServiceInfo& info : changes.changed) {
+      endpoints_[info.service_id] = info.v4_endpoint;
+    }
+    for (const ServiceInfo& info : changes.removed) {
+      endpoints_.erase(info.service_id);
+    }
+  }
+
+  void OnError(ServiceListenerError) override {}
+  void OnMetrics(ServiceListener::Metrics) override {}
+
+ private:
+  std::map<std::string, IPEndpoint> endpoints_;
+  int64_t notifications_ = 0;
+};
+
+std::vector<ServiceInfo> MakeReceivers() {
+  std::vector<ServiceInfo> receivers;
+  for (int i = 0; i < kNumReceivers; ++i) {
+    const std::string name = "receiver-" + std::to_string(i);
+    receivers.push_back(ServiceInfo{
+        name + "-id",
+        name,
+        1,
+        {IPAddress(10, 0, static_cast<uint8_t>(i >> 8),
+                   static_cast<uint8_t>(i)),
+         4433},
+        {}});
+  }
+  return receivers;
+}
+
+// Removes every |interval|-th receiver and adds it again, in a single batch if
+// |batch| is set.
+void Churn(const std::vector<ServiceInfo>& receivers,
+           int interval,
+           bool batch,
+           ServiceListenerImpl* listener) {
+  if (batch) {
+    listener->BeginReceiverUpdates();
+  }
+  for (size_t i = 0; i < receivers.size(); i += interval) {
+    listener->OnReceiverRemoved(receivers[i]);
+  }
+  for (size_t i = 0; i < receivers.size(); i += interval) {
+    listener->OnReceiverAdded(receivers[i]);
+  }
+  if (batch) {
+    listener->EndReceiverUpdates();
+  }
+}
+
+void RunBenchmarks() {
+  const std::vector<ServiceInfo> receivers = MakeReceivers();
+  printf("Receivers: %d\n", kNumReceivers);
+
+  NoopListenerDelegate delegate;
+  ServiceListenerImpl listener(&delegate);
+  TrackingObserver observer;
+  listener.AddObserver(&observer);
+
+  for (bool batch : {false, true}) {
+    const std::string suffix = batch ? " (batched)" : "";
+
+    PrintMicroBenchmarkResult(RunMicroBenchmark(
+        "Add and remove all receivers" + suffix, 0,
+        [&receivers, &listener, batch] {
+          if (batch) {
+            listener.BeginReceiverUpdates();
+          }
+          for (const ServiceInfo& info : receivers) {
+            listener.OnReceiverAdded(info);
+          }
+          if (batch) {
+            listener.EndReceiverUpdates();
+            listener.BeginReceiverUpdates();
+          }
+          for (const ServiceInfo& info : receivers) {
+            listener.OnReceiverRemoved(info);
+          }
+          if (batch) {
+            listener.EndReceiverUpdates();
+          }
+        }));
+    OSP_CHECK_EQ(observer.num_receivers(), 0u);
+
+    for (const ServiceInfo& info : receivers) {
+      listener.OnReceiverAdded(info);
+    }
+
+    // A full refresh, such as after the network changes, rediscovers every
+    // receiver.
+    PrintMicroBenchmarkResult(RunMicroBenchmark(
+        "Refresh all receivers" + suffix, 0, [&receivers, &listener, batch] {
+          Churn(receivers, 1, batch, &listener);
+        }));
+
+    const int64_t notifications_before = observer.notifications();
+    PrintMicroBenchmarkResult(RunMicroBenchmark(
+        "Churn " + std::to_string(kNumReceivers / kChurnInterval) +
+            " receivers" + suffix,
+        0, [&receivers, &listener, batch] {
+          Churn(receivers, kChurnInterval, batch, &listener);
+        }));
+    OSP_CHECK_EQ(observer.num_receivers(), receivers.size());
+    OSP_CHECK_GT(observer.notifications(), notifications_before);
+
+    listener.OnAllReceiversRemoved();
+  }
+
+  listener.RemoveObserver(&observer);
+}
+
+}  // namespace
+}  // namespace osp
+}  // namespace openscreen
+
+int main(int argc, char** argv) {
+  openscreen::osp::RunBenchmarks();
+  return 0;
+}
@@ -5,6 +5,7 @@
 #include "osp/impl/service_listener_impl.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "platform/base/error.h"
 #include "util/osp_logging.h"
@@ -63,31 +64,50 @@ ServiceListenerImpl::ServiceListenerImpl(Delegate* delegate)
 ServiceListenerImpl::~ServiceListenerImpl() = default;
 
 void ServiceListenerImpl::OnReceiverAdded(const ServiceInfo& info) {
-  receiver_list_.OnReceiverAdded(info);
+  const bool is_new = receiver_list_.OnReceiverAdded(info);
+  if (batch_depth_) {
+    RecordChange(info, /* was_known */ !is_new, /* is_known */ true);
+    return;
+  }
   for (auto* observer : observers_) {
-    observer->OnReceiverAdded(info);
+    if (is_new) {
+      observer->OnReceiverAdded(info);
+    } else {
+      observer->OnReceiverChanged(info);
+    }
   }
 }
 
 void ServiceListenerImpl::OnReceiverChanged(const ServiceInfo& info) {
   const Error changed_error = receiver_list_.OnReceiverChanged(info);
-  if (changed_error.ok()) {
-    for (auto* observer : observers_) {
-      observer->OnReceiverChanged(info);
-    }
+  if (!changed_error.ok()) {
+    return;
+  }
+  if (batch_depth_) {
+    RecordChange(info, /* was_known */ true, /* is_known */ true);
+    return;
+  }
+  for (auto* observer : observers_) {
+    observer->OnReceiverChanged(info);
   }
 }
 
 void ServiceListenerImpl::OnReceiverRemoved(const ServiceInfo& info) {
   const Error removed_error = receiver_list_.OnReceiverRemoved(info);
-  if (removed_error.ok()) {
-    for (auto* observer : observers_) {
-      observer->OnReceiverRemoved(info);
-    }
+  if (!removed_error.ok()) {
+    return;
+  }
+  if (batch_depth_) {
+    RecordChange(info, /* was_known */ true, /* is_known */ false);
+    return;
+  }
+  for (auto* observer : observers_) {
+    observer->OnReceiverRemoved(info);
   }
 }
 
 void ServiceListenerImpl::OnAllReceiversRemoved() {
+  NotifyReceiverChanges();
   const Error removed_all_error = receiver_list_.OnAllReceiversRemoved();
   if (removed_all_error.ok()) {
     for (auto* observer : observers_) {
@@ -96,6 +116,17 @@ void ServiceListenerImpl::OnAllReceiversRemoved() {
   }
 }
 
+void ServiceListenerImpl::BeginReceiverUpdates() {
+  ++batch_depth_;
+}
+
+void ServiceListenerImpl::EndReceiverUpdates() {
+  OSP_DCHECK_GT(batch_depth_, 0);
+  if (--batch_depth_ == 0) {
+    NotifyReceiverChanges();
+  }
+}
+
 void ServiceListenerImpl::OnError(ServiceListenerError error) {
   last_error_ = error;
   for (auto* observer : observers_) {
@@ -205,5 +236,43 @@ void ServiceListenerImpl::MaybeNotifyObservers() {
   }
 }
 
+void ServiceListenerImpl::RecordChange(const ServiceInfo& info,
+                                       bool was_known,
+                                       bool is_known) {
+  auto result = pending_change_index_.emplace(info.service_id,
+                                              pending_changes_.size());
+  if (result.second) {
+    pending_changes_.push_back(PendingChange{info, was_known, is_known});
+    return;
+  }
+
+  // Only the first update in a batch shows whether the receiver was known
+  // before it.
+  PendingChange& change = pending_changes_[result.first->second];
+  change.info = info;
+  change.is_known = is_known;
+}
+
+void ServiceListenerImpl::NotifyReceiverChanges() {
+  ReceiverChanges changes;
+  for (PendingChange& change : pending_changes_) {
+    if (change.is_known) {
+      (change.was_known ? changes.changed : changes.added)
+          .push_back(std::move(change.info));
+    } else if (change.was_known) {
+      changes.removed.push_back(std::move(change.info));
+    }
+  }
+  pending_changes_.clear();
+  pending_change_index_.clear();
+
+  if (changes.empty()) {
+    return;
+  }
+  for (auto* observer : observers_) {
+    observer->OnReceiversChanged(changes);
+  }
+}
+
 }  // namespace osp
 }  // namespace openscreen
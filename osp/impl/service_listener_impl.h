@@ -5,6 +5,8 @@
 #ifndef OSP_IMPL_SERVICE_LISTENER_IMPL_H_
 #define OSP_IMPL_SERVICE_LISTENER_IMPL_H_
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/impl/receiver_list.h"
@@ -44,11 +46,22 @@ class ServiceListenerImpl final : public ServiceListener,
   ~ServiceListenerImpl() override;
 
   // Called by |delegate_| when there are updates to the available receivers.
+  // Any updates pending in a batch are reported before OnAllReceiversRemoved()
+  // is.
   void OnReceiverAdded(const ServiceInfo& info);
   void OnReceiverChanged(const ServiceInfo& info);
   void OnReceiverRemoved(const ServiceInfo& info);
   void OnAllReceiversRemoved();
 
+  // May be called by |delegate_| around a burst of updates to the available
+  // receivers, such as a full refresh.  The net changes made by the updates in
+  // between are reported to observers once, by EndReceiverUpdates(), rather
+  // than after each update.  Batches may be nested.  Updates outside of a
+  // batch, which is how delegates report them unless they opt in, are reported
+  // to observers one at a time.
+  void BeginReceiverUpdates();
+  void EndReceiverUpdates();
+
   // Called by |delegate_| when an internal error occurs.
   void OnError(ServiceListenerError error);
 
@@ -70,13 +83,36 @@ class ServiceListenerImpl final : public ServiceListener,
   // kStopping which are done automatically).
   void SetState(State state);
 
+  // A receiver updated during the current batch of updates.
+  struct PendingChange {
+    ServiceInfo info;
+
+    // Whether the receiver was known before the batch began, and is now.
+    bool was_known;
+    bool is_known;
+  };
+
   // Notifies each observer in |observers_| if the transition to |state_| is one
   // that is watched by the observer interface.
   void MaybeNotifyObservers();
 
+  // Records an update, made during a batch, to the receiver described by
+  // |info|.
+  void RecordChange(const ServiceInfo& info, bool was_known, bool is_known);
+
+  // Reports the changes recorded during the batch to the observers.
+  void NotifyReceiverChanges();
+
   Delegate* const delegate_;
   ReceiverList receiver_list_;
 
+  int batch_depth_ = 0;
+  std::vector<PendingChange> pending_changes_;
+
+  // The position of each receiver's change in |pending_changes_|, by service
+  // ID.
+  std::unordered_map<std::string, size_t> pending_change_index_;
+
   OSP_DISALLOW_COPY_AND_ASSIGN(ServiceListenerImpl);
 };
 
@@ -18,6 +18,7 @@ using ::testing::ElementsAre;
 using ::testing::Expectation;
 using ::testing::Mock;
 using ::testing::NiceMock;
+using ::testing::UnorderedElementsAre;
 
 using State = ServiceListener::State;
 
@@ -363,6 +364,69 @@ TEST_F(ServiceListenerImplTest, ReceiverObserverPassThrough) {
   service_listener_->RemoveObserver(&observer);
 }
 
+TEST_F(ServiceListenerImplTest, BatchesReceiverUpdates) {
+  const ServiceInfo receiver1{
+      "id1", "name1", 1, {{192, 168, 1, 10}, 12345}, {}};
+  const ServiceInfo receiver2{
+      "id2", "name2", 1, {{192, 168, 1, 11}, 12345}, {}};
+  const ServiceInfo receiver3{
+      "id3", "name3", 1, {{192, 168, 1, 12}, 12345}, {}};
+  const ServiceInfo receiver4{
+      "id4", "name4", 1, {{192, 168, 1, 13}, 12345}, {}};
+  const ServiceInfo receiver1_alt_name{
+      "id1", "name1 alt", 1, {{192, 168, 1, 10}, 12345}, {}};
+  const ServiceInfo receiver2_alt_name{
+      "id2", "name2 alt", 1, {{192, 168, 1, 11}, 12345}, {}};
+  MockObserver observer;
+  service_listener_->AddObserver(&observer);
+
+  EXPECT_CALL(observer, OnReceiverAdded(receiver1));
+  EXPECT_CALL(observer, OnReceiverAdded(receiver2));
+  service_listener_->BeginReceiverUpdates();
+  service_listener_->OnReceiverAdded(receiver1);
+  service_listener_->OnReceiverAdded(receiver2);
+  service_listener_->EndReceiverUpdates();
+  Mock::VerifyAndClearExpectations(&observer);
+
+  // Nothing is reported until the outermost batch ends, and then only the net
+  // change to each receiver is.
+  EXPECT_CALL(observer, OnReceiverAdded(_)).Times(0);
+  EXPECT_CALL(observer, OnReceiverChanged(_)).Times(0);
+  EXPECT_CALL(observer, OnReceiverRemoved(_)).Times(0);
+  service_listener_->BeginReceiverUpdates();
+  service_listener_->BeginReceiverUpdates();
+  service_listener_->OnReceiverChanged(receiver1_alt_name);
+  service_listener_->OnReceiverRemoved(receiver2);
+  service_listener_->OnReceiverAdded(receiver2_alt_name);
+  service_listener_->OnReceiverAdded(receiver3);
+  service_listener_->OnReceiverRemoved(receiver3);
+  service_listener_->OnReceiverAdded(receiver4);
+  service_listener_->OnReceiverRemoved(receiver1_alt_name);
+  service_listener_->EndReceiverUpdates();
+  EXPECT_THAT(service_listener_->GetReceivers(),
+              UnorderedElementsAre(receiver2_alt_name, receiver4));
+  Mock::VerifyAndClearExpectations(&observer);
+
+  EXPECT_CALL(observer, OnReceiverAdded(receiver4));
+  EXPECT_CALL(observer, OnReceiverChanged(receiver2_alt_name));
+  EXPECT_CALL(observer, OnReceiverRemoved(receiver1_alt_name));
+  service_listener_->EndReceiverUpdates();
+  Mock::VerifyAndClearExpectations(&observer);
+
+  // Pending changes are reported before all receivers are removed.
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(observer, OnReceiverAdded(receiver3));
+    EXPECT_CALL(observer, OnAllReceiversRemoved());
+  }
+  service_listener_->BeginReceiverUpdates();
+  service_listener_->OnReceiverAdded(receiver3);
+  service_listener_->OnAllReceiversRemoved();
+  service_listener_->EndReceiverUpdates();
+  EXPECT_TRUE(service_listener_->GetReceivers().empty());
+  service_listener_->RemoveObserver(&observer);
+}
+
 TEST_F(ServiceListenerImplTest, MultipleObservers) {
   MockObserver observer1;
   MockObserver observer2;
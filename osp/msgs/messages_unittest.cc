@@ -7,9 +7,13 @@
 
 using openscreen::msgs::CborEncodeBuffer;
 using openscreen::msgs::HttpHeader;
+using openscreen::msgs::PresentationConnectionCloseEvent;
 using openscreen::msgs::PresentationConnectionMessage;
+using openscreen::msgs::PresentationConnectionMessageView;
 using openscreen::msgs::PresentationStartRequest;
+using openscreen::msgs::PresentationStartRequestView;
 using openscreen::msgs::PresentationUrlAvailabilityRequest;
+using openscreen::msgs::PresentationUrlAvailabilityRequestView;
 
 namespace openscreen {
 namespace osp {
@@ -227,5 +231,229 @@ TEST(PresentationMessagesTest, CborEncodeBufferTooLarge) {
   ASSERT_FALSE(EncodePresentationUrlAvailabilityRequest(request, &buffer));
 }
 
+TEST(PresentationMessagesTest, EncodedSizeMatchesEncoding) {
+  uint8_t buffer[256];
+  std::vector<std::string> urls{"https://example.com/receiver.html",
+                                "https://openscreen.org/demo_receiver.html"};
+  for (uint64_t request_id : {uint64_t{0}, uint64_t{23}, uint64_t{24},
+                              uint64_t{300}, uint64_t{70000},
+                              uint64_t{1} << 40}) {
+    PresentationUrlAvailabilityRequest request{request_id, urls};
+    ssize_t bytes_out = EncodePresentationUrlAvailabilityRequest(
+        request, buffer, sizeof(buffer));
+    ASSERT_GT(bytes_out, 0);
+    EXPECT_EQ(static_cast<size_t>(bytes_out),
+              EncodedSizePresentationUrlAvailabilityRequest(request));
+  }
+}
+
+TEST(PresentationMessagesTest, EncodedSizeOptionalField) {
+  uint8_t buffer[256];
+  PresentationConnectionCloseEvent event;
+  event.connection_id = 1234;
+  event.reason = msgs::PresentationConnectionCloseEvent_reason::
+      kUnrecoverableErrorWhileSendingOrReceivingMessage;
+  event.has_error_message = false;
+  ssize_t bytes_out =
+      EncodePresentationConnectionCloseEvent(event, buffer, sizeof(buffer));
+  ASSERT_GT(bytes_out, 0);
+  EXPECT_EQ(static_cast<size_t>(bytes_out),
+            EncodedSizePresentationConnectionCloseEvent(event));
+
+  event.has_error_message = true;
+  event.error_message = "the connection was lost";
+  bytes_out =
+      EncodePresentationConnectionCloseEvent(event, buffer, sizeof(buffer));
+  ASSERT_GT(bytes_out, 0);
+  EXPECT_EQ(static_cast<size_t>(bytes_out),
+            EncodedSizePresentationConnectionCloseEvent(event));
+}
+
+TEST(PresentationMessagesTest, EncodedSizeConnectionMessage) {
+  std::vector<uint8_t> buffer(100000);
+  PresentationConnectionMessage message;
+  message.connection_id = 1234;
+  message.message.which =
+      PresentationConnectionMessage::Message::Which::kString;
+  new (&message.message.str) std::string(70000, 'a');
+  ssize_t bytes_out = EncodePresentationConnectionMessage(
+      message, buffer.data(), buffer.size());
+  ASSERT_GT(bytes_out, 0);
+  EXPECT_EQ(static_cast<size_t>(bytes_out),
+            EncodedSizePresentationConnectionMessage(message));
+
+  PresentationConnectionMessage bytes_message;
+  bytes_message.connection_id = 1234;
+  bytes_message.message.which =
+      PresentationConnectionMessage::Message::Which::kBytes;
+  new (&bytes_message.message.bytes) std::vector<uint8_t>(300, 7);
+  bytes_out = EncodePresentationConnectionMessage(bytes_message, buffer.data(),
+                                                  buffer.size());
+  ASSERT_GT(bytes_out, 0);
+  EXPECT_EQ(static_cast<size_t>(bytes_out),
+            EncodedSizePresentationConnectionMessage(bytes_message));
+}
+
+TEST(PresentationMessagesTest, CborEncodeBufferExactSize) {
+  std::string url = "https://example.com/receiver.html";
+  std::vector<std::string> urls(100, url);
+  PresentationUrlAvailabilityRequest request{7, urls};
+  CborEncodeBuffer buffer;
+  ASSERT_TRUE(EncodePresentationUrlAvailabilityRequest(request, &buffer));
+  // One byte of type key precedes the message.
+  EXPECT_EQ(buffer.size(),
+            1 + EncodedSizePresentationUrlAvailabilityRequest(request));
+}
+
+TEST(PresentationMessagesTest, DecodeRequestView) {
+  uint8_t buffer[256];
+  std::vector<std::string> urls{"https://example.com/receiver.html",
+                                "https://openscreen.org/demo_receiver.html",
+                                "https://turt.le/asdfXCV"};
+  ssize_t bytes_out = EncodePresentationUrlAvailabilityRequest(
+      PresentationUrlAvailabilityRequest{7, urls, 500, 3}, buffer,
+      sizeof(buffer));
+  ASSERT_LE(bytes_out, static_cast<ssize_t>(sizeof(buffer)));
+  ASSERT_GT(bytes_out, 0);
+
+  PresentationUrlAvailabilityRequestView view;
+  ssize_t bytes_read =
+      DecodePresentationUrlAvailabilityRequestView(buffer, bytes_out, &view);
+  ASSERT_EQ(bytes_read, bytes_out);
+  EXPECT_EQ(7u, view.request_id);
+  EXPECT_EQ(500u, view.watch_duration);
+  EXPECT_EQ(3u, view.watch_id);
+  ASSERT_EQ(urls.size(), view.urls.size());
+  for (size_t i = 0; i < urls.size(); ++i) {
+    EXPECT_EQ(urls[i], view.urls[i]);
+    // The view points into |buffer| rather than owning a copy.
+    EXPECT_GE(reinterpret_cast<const uint8_t*>(view.urls[i].data()), buffer);
+    EXPECT_LT(reinterpret_cast<const uint8_t*>(view.urls[i].data()),
+              buffer + bytes_out);
+  }
+}
+
+TEST(PresentationMessagesTest, DecodeViewWithNestedStructs) {
+  uint8_t buffer[256];
+  const std::vector<HttpHeader> headers{{"accept-language", "en-US"},
+                                        {"user-agent", "openscreen"}};
+  ssize_t bytes_out = EncodePresentationStartRequest(
+      PresentationStartRequest{13, "lksdjfloiqwerlkjasdlfq",
+                               "https://example.com/receiver.html", headers},
+      buffer, sizeof(buffer));
+  ASSERT_LE(bytes_out, static_cast<ssize_t>(sizeof(buffer)));
+  ASSERT_GT(bytes_out, 0);
+
+  PresentationStartRequestView view;
+  ssize_t bytes_read =
+      DecodePresentationStartRequestView(buffer, bytes_out, &view);
+  ASSERT_EQ(bytes_read, bytes_out);
+  EXPECT_EQ(13u, view.request_id);
+  EXPECT_EQ("lksdjfloiqwerlkjasdlfq", view.presentation_id);
+  EXPECT_EQ("https://example.com/receiver.html", view.url);
+  ASSERT_EQ(2u, view.headers.size());
+  EXPECT_EQ("accept-language", view.headers[0].key);
+  EXPECT_EQ("en-US", view.headers[0].value);
+  EXPECT_EQ("user-agent", view.headers[1].key);
+  EXPECT_EQ("openscreen", view.headers[1].value);
+}
+
+TEST(PresentationMessagesTest, DecodeConnectionMessageView) {
+  uint8_t buffer[256];
+  PresentationConnectionMessage message;
+  message.connection_id = 1234;
+  message.message.which = PresentationConnectionMessage::Message::Which::kBytes;
+  new (&message.message.bytes) std::vector<uint8_t>{0, 1, 2, 3, 255, 254};
+  ssize_t bytes_out =
+      EncodePresentationConnectionMessage(message, buffer, sizeof(buffer));
+  ASSERT_GT(bytes_out, 0);
+
+  PresentationConnectionMessageView view;
+  ssize_t bytes_read =
+      DecodePresentationConnectionMessageView(buffer, bytes_out, &view);
+  ASSERT_EQ(bytes_read, bytes_out);
+  EXPECT_EQ(1234u, view.connection_id);
+  ASSERT_EQ(PresentationConnectionMessageView::Message::Which::kBytes,
+            view.message.which);
+  EXPECT_EQ(message.message.bytes,
+            std::vector<uint8_t>(view.message.bytes.begin(),
+                                 view.message.bytes.end()));
+
+  // A truncated message can't be decoded until the rest of it arrives.
+  EXPECT_EQ(msgs::kParserEOF, DecodePresentationConnectionMessageView(
+                                  buffer, bytes_out - 1, &view));
+}
+
+TEST(PresentationMessagesTest, DecodeViewInvalidUtf8) {
+  uint8_t buffer[256];
+  std::vector<std::string> urls{"https://example.com/receiver.html"};
+  ssize_t bytes_out = EncodePresentationUrlAvailabilityRequest(
+      PresentationUrlAvailabilityRequest{7, urls}, buffer, sizeof(buffer));
+  ASSERT_GT(bytes_out, 0);
+  buffer[30] = 0xc0;
+
+  PresentationUrlAvailabilityRequestView view;
+  ASSERT_GT(0,
+            DecodePresentationUrlAvailabilityRequestView(buffer, bytes_out,
+                                                         &view));
+}
+
+namespace {
+
+// Counts the presentation-connection-close-events it is given, and every other
+// message.
+struct CloseEventHandler {
+  void operator()(const PresentationConnectionCloseEvent& event) {
+    EXPECT_EQ(7u, event.connection_id);
+    ++close_events;
+  }
+
+  template <typename Message>
+  void operator()(const Message& message) {
+    ++other_messages;
+  }
+
+  int close_events = 0;
+  int other_messages = 0;
+};
+
+}  // namespace
+
+TEST(PresentationMessagesTest, TypeTableMatchesTypeIndex) {
+  for (size_t i = 0; i < msgs::kNumTypes; ++i) {
+    EXPECT_EQ(i, msgs::GetTypeIndex(msgs::kAllTypes[i]));
+  }
+  EXPECT_EQ(msgs::kNumTypes, msgs::GetTypeIndex(msgs::Type::kUnknown));
+}
+
+TEST(PresentationMessagesTest, DecodeAndDispatch) {
+  uint8_t buffer[256];
+  ssize_t bytes_out = EncodePresentationConnectionCloseEvent(
+      PresentationConnectionCloseEvent{
+          7, msgs::PresentationConnectionCloseEvent_reason::kCloseMethodCalled,
+          false, ""},
+      buffer, sizeof(buffer));
+  ASSERT_GT(bytes_out, 0);
+
+  // Each message is passed to the handler's overload for its struct.
+  CloseEventHandler handler;
+  EXPECT_EQ(bytes_out, msgs::DecodeAndDispatch(
+                           msgs::Type::kPresentationConnectionCloseEvent,
+                           buffer, bytes_out, handler));
+  EXPECT_EQ(1, handler.close_events);
+  EXPECT_EQ(0, handler.other_messages);
+
+  // The handler isn't called when decoding fails.
+  EXPECT_EQ(msgs::kParserEOF,
+            msgs::DecodeAndDispatch(
+                msgs::Type::kPresentationConnectionCloseEvent, buffer,
+                bytes_out - 1, handler));
+  EXPECT_EQ(msgs::kParserUnknownType,
+            msgs::DecodeAndDispatch(msgs::Type::kUnknown, buffer, bytes_out,
+                                    handler));
+  EXPECT_EQ(1, handler.close_events);
+  EXPECT_EQ(0, handler.other_messages);
+}
+
 }  // namespace osp
 }  // namespace openscreen
@@ -5,13 +5,15 @@
 #ifndef OSP_PUBLIC_MESSAGE_DEMUXER_H_
 #define OSP_PUBLIC_MESSAGE_DEMUXER_H_
 
-#include <map>
+#include <array>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "osp/msgs/osp_messages.h"
 #include "platform/api/time.h"
 #include "platform/base/error.h"
+#include "platform/base/span.h"
 
 namespace openscreen {
 namespace osp {
@@ -78,6 +80,12 @@ class MessageDemuxer {
   MessageWatch SetDefaultMessageTypeWatch(msgs::Type message_type,
                                           MessageCallback* callback);
 
+  // Lets a stream buffer up to |buffer_limit| bytes, instead of the limit the
+  // demuxer was created with, while the message at its head is of type
+  // |message_type| and that type is being watched.  Streams whose buffered
+  // data grows past their limit are dropped.
+  void SetMessageTypeBufferLimit(msgs::Type message_type, size_t buffer_limit);
+
   // Gives data from |endpoint_id| to the demuxer for processing.
   // TODO(btolsch): It'd be nice if errors could propagate out of here to close
   // the stream.
@@ -87,47 +95,117 @@ class MessageDemuxer {
                     size_t data_size);
 
  private:
-  struct HandleStreamBufferResult {
-    bool handled;
+  // The callback for each message type, indexed by msgs::GetTypeIndex().
+  using CallbackTable = std::array<MessageCallback*, msgs::kNumTypes>;
+
+  // The data received on a stream that hasn't been handled yet.  Handled data
+  // is consumed by advancing past it, and what remains is only moved to the
+  // front when more data is appended.
+  class StreamBuffer {
+   public:
+    StreamBuffer();
+    StreamBuffer(StreamBuffer&&) noexcept;
+    ~StreamBuffer();
+    StreamBuffer& operator=(StreamBuffer&&) noexcept;
+
+    const uint8_t* data() const { return data_.data() + begin_; }
+    size_t size() const { return data_.size() - begin_; }
+    bool empty() const { return begin_ == data_.size(); }
+
+    void Append(const uint8_t* data, size_t data_size);
+    void Consume(size_t size);
+    void Clear();
+
+   private:
+    std::vector<uint8_t> data_;
+    size_t begin_ = 0;
+  };
+
+  struct HandleStreamDataResult {
+    // The number of bytes at the start of the data that were handled.
     size_t consumed;
+
+    // True if the data can't be handled, and should be dropped.
+    bool discard;
   };
 
   void StopWatchingMessageType(uint64_t endpoint_id, msgs::Type message_type);
   void StopDefaultMessageTypeWatch(msgs::Type message_type);
 
-  HandleStreamBufferResult HandleStreamBufferLoop(
-      uint64_t endpoint_id,
-      uint64_t connection_id,
-      std::map<uint64_t, std::map<msgs::Type, MessageCallback*>>::iterator
-          endpoint_entry,
-      std::vector<uint8_t>* buffer);
+  // Returns the callbacks for |endpoint_id|, or nullptr if it has none.
+  const CallbackTable* GetEndpointCallbacks(uint64_t endpoint_id) const;
+
+  // Returns how many bytes |buffer| may hold before its stream is dropped.
+  size_t GetBufferLimit(const CallbackTable* endpoint_callbacks,
+                        const StreamBuffer& buffer) const;
 
-  HandleStreamBufferResult HandleStreamBuffer(
+  // Passes each complete message at the start of |data| to its callback, until
+  // one is incomplete or has no callback.
+  HandleStreamDataResult HandleStreamData(
       uint64_t endpoint_id,
       uint64_t connection_id,
-      std::map<msgs::Type, MessageCallback*>* message_callbacks,
-      std::vector<uint8_t>* buffer);
+      const CallbackTable* endpoint_callbacks,
+      Span<const uint8_t> data);
+
+  // Calls HandleStreamData() with the contents of |buffer|, and removes what
+  // it handles.
+  void HandleStreamBuffer(uint64_t endpoint_id,
+                          uint64_t connection_id,
+                          const CallbackTable* endpoint_callbacks,
+                          StreamBuffer* buffer);
 
   const ClockNowFunctionPtr now_function_;
   const size_t buffer_limit_;
-  std::map<uint64_t, std::map<msgs::Type, MessageCallback*>> message_callbacks_;
-  std::map<msgs::Type, MessageCallback*> default_callbacks_;
+
+  // The buffer limit set for each message type, indexed by
+  // msgs::GetTypeIndex(), or zero if it has none.
+  std::array<size_t, msgs::kNumTypes> type_buffer_limits_{};
+
+  std::unordered_map<uint64_t, CallbackTable> message_callbacks_;
+  CallbackTable default_callbacks_{};
 
   // Map<endpoint_id, Map<connection_id, data_buffer>>
-  std::map<uint64_t, std::map<uint64_t, std::vector<uint8_t>>> buffers_;
+  std::unordered_map<uint64_t, std::unordered_map<uint64_t, StreamBuffer>>
+      buffers_;
 };
 
 // TODO(btolsch): Make sure all uses of MessageWatch are converted to this
 // resest function for readability.
 void StopWatching(MessageDemuxer::MessageWatch* watch);
 
+// Decodes the message of type |message_type| in |buffer| into its view, and
+// passes it to |handler|, which must return an Error for any message view.
+// This lets a MessageCallback watching several message types decode and handle
+// each with a single switch, with its handler for each type chosen at compile
+// time.  Returns the number of bytes decoded, the error returned by |handler|,
+// or Error::Code::kCborIncompleteMessage if the message isn't all in |buffer|
+// yet.
+template <typename Handler>
+ErrorOr<size_t> DecodeAndDispatchMessage(msgs::Type message_type,
+                                         const uint8_t* buffer,
+                                         size_t buffer_size,
+                                         Handler&& handler) {
+  Error error = Error::None();
+  const ssize_t result = msgs::DecodeViewAndDispatch(
+      message_type, buffer, buffer_size,
+      [&handler, &error](const auto& message) { error = handler(message); });
+  if (result < 0) {
+    return result == msgs::kParserEOF ? Error::Code::kCborIncompleteMessage
+                                      : Error::Code::kCborParsing;
+  }
+  if (!error.ok()) {
+    return error;
+  }
+  return static_cast<size_t>(result);
+}
+
 class MessageTypeDecoder {
  public:
-  static ErrorOr<msgs::Type> DecodeType(const std::vector<uint8_t>& buffer,
+  static ErrorOr<msgs::Type> DecodeType(Span<const uint8_t> buffer,
                                         size_t* num_bytes_decoded);
 
  private:
-  static ErrorOr<uint64_t> DecodeVarUint(const std::vector<uint8_t>& buffer,
+  static ErrorOr<uint64_t> DecodeVarUint(Span<const uint8_t> buffer,
                                          size_t* num_bytes_decoded);
 };
 
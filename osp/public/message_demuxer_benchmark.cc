@@ -0,0 +1,126 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how quickly MessageDemuxer passes many small messages, arriving on
+// many endpoints, to their callbacks, both when each read holds only whole
+// messages and when messages are split across reads.
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "osp/msgs/osp_messages.h"
+#include "osp/public/message_demuxer.h"
+#include "platform/api/time.h"
+#include "util/micro_benchmark.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace osp {
+namespace {
+
+constexpr int kNumEndpoints = 64;
+constexpr int kMessagesPerRead = 16;
+constexpr uint64_t kConnectionId = 1;
+
+// Decodes each presentation-connection-message without copying it, as
+// ConnectionManager does.
+class CountingCallback final : public MessageDemuxer::MessageCallback {
+ public:
+  ~CountingCallback() override = default;
+
+  ErrorOr<size_t> OnStreamMessage(uint64_t endpoint_id,
+                                  uint64_t connection_id,
+                                  msgs::Type message_type,
+                                  const uint8_t* buffer,
+                                  size_t buffer_size,
+                                  Clock::time_point now) override {
+    msgs::PresentationConnectionMessageView message;
+    const ssize_t result = msgs::DecodePresentationConnectionMessageView(
+        buffer, buffer_size, &message);
+    if (result < 0) {
+      return result == msgs::kParserEOF ? Error::Code::kCborIncompleteMessage
+                                        : Error::Code::kCborParsing;
+    }
+    ++count_;
+    DoNotOptimize(message);
+    return result;
+  }
+
+  int64_t count() const { return count_; }
+
+ private:
+  int64_t count_ = 0;
+};
+
+// Returns |kMessagesPerRead| short string messages, each preceded by its type,
+// and sets |split| to a position within the text of the middle one.
+std::vector<uint8_t> MakeMessages(size_t* split) {
+  std::vector<uint8_t> data;
+  for (int i = 0; i < kMessagesPerRead; ++i) {
+    msgs::PresentationConnectionMessage message;
+    message.connection_id = kConnectionId;
+    message.message.which =
+        msgs::PresentationConnectionMessage::Message::Which::kString;
+    new (&message.message.str) std::string("ping " + std::to_string(i));
+
+    msgs::CborEncodeBuffer buffer;
+    OSP_CHECK(msgs::EncodePresentationConnectionMessage(message, &buffer));
+    data.insert(data.end(), buffer.data(), buffer.data() + buffer.size());
+    if (i == kMessagesPerRead / 2) {
+      *split = data.size() - 3;
+    }
+  }
+  return data;
+}
+
+void RunBenchmarks() {
+  size_t split = 0;
+  const std::vector<uint8_t> data = MakeMessages(&split);
+  printf("Read: %d messages, %zu bytes\n", kMessagesPerRead, data.size());
+
+  MessageDemuxer demuxer(&Clock::now, MessageDemuxer::kDefaultBufferLimit);
+  CountingCallback callback;
+  std::vector<MessageDemuxer::MessageWatch> watches;
+  for (uint64_t endpoint_id = 1; endpoint_id <= kNumEndpoints; ++endpoint_id) {
+    watches.push_back(demuxer.WatchMessageType(
+        endpoint_id, msgs::Type::kPresentationConnectionMessage, &callback));
+    OSP_CHECK(watches.back());
+  }
+
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Demux whole messages", data.size() * kNumEndpoints,
+      [&demuxer, &data] {
+        for (uint64_t endpoint_id = 1; endpoint_id <= kNumEndpoints;
+             ++endpoint_id) {
+          demuxer.OnStreamData(endpoint_id, kConnectionId, data.data(),
+                               data.size());
+        }
+      }));
+
+  // Each first read ends partway through a message, which must be buffered
+  // until the next read completes it.
+  PrintMicroBenchmarkResult(RunMicroBenchmark(
+      "Demux split messages", data.size() * kNumEndpoints,
+      [&demuxer, &data, split] {
+        for (uint64_t endpoint_id = 1; endpoint_id <= kNumEndpoints;
+             ++endpoint_id) {
+          demuxer.OnStreamData(endpoint_id, kConnectionId, data.data(), split);
+          demuxer.OnStreamData(endpoint_id, kConnectionId, data.data() + split,
+                               data.size() - split);
+        }
+      }));
+
+  OSP_CHECK_GT(callback.count(), 0);
+}
+
+}  // namespace
+}  // namespace osp
+}  // namespace openscreen
+
+int main(int argc, char** argv) {
+  openscreen::osp::RunBenchmarks();
+  return 0;
+}
@@ -56,6 +56,23 @@ class MessageDemuxerTest : public ::testing::Test {
   MessageDemuxer demuxer_{FakeClock::now, MessageDemuxer::kDefaultBufferLimit};
 };
 
+// Records the presentation-connection-open-requests it is given, and rejects
+// every other type of message.
+class OpenRequestHandler {
+ public:
+  Error operator()(const msgs::PresentationConnectionOpenRequestView& request) {
+    urls.emplace_back(request.url);
+    return Error::None();
+  }
+
+  template <typename Message>
+  Error operator()(const Message& message) {
+    return Error::Code::kUnknownMessageType;
+  }
+
+  std::vector<std::string> urls;
+};
+
 }  // namespace
 
 TEST_F(MessageDemuxerTest, WatchStartStop) {
@@ -331,6 +348,141 @@ TEST_F(MessageDemuxerTest, BufferLimit) {
   ExpectDecodedRequest(decode_result, received_request);
 }
 
+TEST_F(MessageDemuxerTest, BufferLimitForMessageType) {
+  demuxer_.SetMessageTypeBufferLimit(msgs::Type::kPresentationConnectionMessage,
+                                     1 << 20);
+
+  // Both messages are larger than the default limit, but smaller than the
+  // limit for presentation-connection-messages.
+  msgs::PresentationConnectionOpenRequest request{1, "fry-am-the-egg-man",
+                                                  std::string(70000, 'u')};
+  msgs::CborEncodeBuffer request_buffer(250, 1 << 20);
+  ASSERT_TRUE(
+      msgs::EncodePresentationConnectionOpenRequest(request, &request_buffer));
+  msgs::PresentationConnectionMessage message;
+  message.connection_id = 7;
+  message.message.which =
+      msgs::PresentationConnectionMessage::Message::Which::kString;
+  new (&message.message.str) std::string(70000, 'm');
+  msgs::CborEncodeBuffer message_buffer(250, 1 << 20);
+  ASSERT_TRUE(
+      msgs::EncodePresentationConnectionMessage(message, &message_buffer));
+
+  MessageDemuxer::MessageWatch request_watch = demuxer_.WatchMessageType(
+      endpoint_id_, msgs::Type::kPresentationConnectionOpenRequest,
+      &mock_callback_);
+  MessageDemuxer::MessageWatch message_watch = demuxer_.WatchMessageType(
+      endpoint_id_, msgs::Type::kPresentationConnectionMessage,
+      &mock_callback_);
+  std::vector<msgs::Type> decoded_types;
+  EXPECT_CALL(mock_callback_, OnStreamMessage(endpoint_id_, _, _, _, _, _))
+      .WillRepeatedly(Invoke([&decoded_types](
+                                 uint64_t endpoint_id, uint64_t connection_id,
+                                 msgs::Type message_type, const uint8_t* buffer,
+                                 size_t buffer_size, Clock::time_point now) {
+        ssize_t result;
+        if (message_type == msgs::Type::kPresentationConnectionMessage) {
+          msgs::PresentationConnectionMessage decoded;
+          result = msgs::DecodePresentationConnectionMessage(
+              buffer, buffer_size, &decoded);
+        } else {
+          msgs::PresentationConnectionOpenRequest decoded;
+          result = msgs::DecodePresentationConnectionOpenRequest(
+              buffer, buffer_size, &decoded);
+        }
+        if (result > 0) {
+          decoded_types.push_back(message_type);
+        }
+        return ConvertDecodeResult(result);
+      }));
+
+  // Each message is sent on its own stream, with its last byte held back until
+  // everything before it is buffered.
+  const uint64_t request_connection_id = 1;
+  const uint64_t message_connection_id = 2;
+  const size_t request_split = request_buffer.size() - 1;
+  const size_t message_split = message_buffer.size() - 1;
+  demuxer_.OnStreamData(endpoint_id_, request_connection_id,
+                        request_buffer.data(), request_split);
+  demuxer_.OnStreamData(endpoint_id_, message_connection_id,
+                        message_buffer.data(), message_split);
+  EXPECT_TRUE(decoded_types.empty());
+  demuxer_.OnStreamData(endpoint_id_, request_connection_id,
+                        request_buffer.data() + request_split, 1);
+  demuxer_.OnStreamData(endpoint_id_, message_connection_id,
+                        message_buffer.data() + message_split, 1);
+
+  // The presentation-connection-open-request's stream was dropped once its
+  // buffer grew past the default limit.
+  EXPECT_EQ(std::vector<msgs::Type>{msgs::Type::kPresentationConnectionMessage},
+            decoded_types);
+}
+
+TEST_F(MessageDemuxerTest, MultipleMessagesWithPartialTail) {
+  MessageDemuxer::MessageWatch watch = demuxer_.WatchMessageType(
+      endpoint_id_, msgs::Type::kPresentationConnectionOpenRequest,
+      &mock_callback_);
+  ASSERT_TRUE(watch);
+
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 3; ++i) {
+    data.insert(data.end(), buffer_.data(), buffer_.data() + buffer_.size());
+  }
+
+  msgs::PresentationConnectionOpenRequest received_request;
+  ssize_t decode_result = 0;
+  EXPECT_CALL(
+      mock_callback_,
+      OnStreamMessage(endpoint_id_, connection_id_,
+                      msgs::Type::kPresentationConnectionOpenRequest, _, _, _))
+      .Times(4)
+      .WillRepeatedly(Invoke([&decode_result, &received_request](
+                                 uint64_t endpoint_id, uint64_t connection_id,
+                                 msgs::Type message_type, const uint8_t* buffer,
+                                 size_t buffer_size, Clock::time_point now) {
+        decode_result = msgs::DecodePresentationConnectionOpenRequest(
+            buffer, buffer_size, &received_request);
+        return ConvertDecodeResult(decode_result);
+      }));
+  // The first two messages are handled straight away, and the third is
+  // buffered until the rest of it arrives.
+  const size_t split = data.size() - 3;
+  demuxer_.OnStreamData(endpoint_id_, connection_id_, data.data(), split);
+  demuxer_.OnStreamData(endpoint_id_, connection_id_, data.data() + split,
+                        data.size() - split);
+  ExpectDecodedRequest(decode_result, received_request);
+}
+
+TEST_F(MessageDemuxerTest, DecodeAndDispatchMessage) {
+  // |buffer_| starts with the two byte message type.
+  const uint8_t* const message = buffer_.data() + 2;
+  const size_t message_size = buffer_.size() - 2;
+  OpenRequestHandler handler;
+
+  ErrorOr<size_t> result = DecodeAndDispatchMessage(
+      msgs::Type::kPresentationConnectionOpenRequest, message, message_size,
+      handler);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), message_size);
+  EXPECT_EQ(handler.urls, std::vector<std::string>{request_.url});
+
+  // Incomplete messages aren't passed to the handler.
+  result = DecodeAndDispatchMessage(
+      msgs::Type::kPresentationConnectionOpenRequest, message,
+      message_size - 1, handler);
+  ASSERT_TRUE(result.is_error());
+  EXPECT_EQ(result.error().code(), Error::Code::kCborIncompleteMessage);
+  EXPECT_EQ(handler.urls.size(), 1u);
+
+  // The handler's error is returned for messages it doesn't accept.
+  result = DecodeAndDispatchMessage(
+      msgs::Type::kPresentationConnectionCloseEvent, message, message_size,
+      handler);
+  ASSERT_TRUE(result.is_error());
+  EXPECT_NE(result.error().code(), Error::Code::kCborIncompleteMessage);
+  EXPECT_EQ(handler.urls.size(), 1u);
+}
+
 TEST_F(MessageDemuxerTest, DeserializeMessages) {
   std::vector<uint8_t> kAgentInfoResponseSerialized{0x0B, 0xFF};
   std::vector<uint8_t> kPresentationConnectionCloseEventSerialized{0x40, 0x71,
@@ -358,7 +510,8 @@ TEST_F(MessageDemuxerTest, DeserializeMessages) {
   EXPECT_EQ(kAuthenticationRequestInfo.value(),
             msgs::Type::kAuthenticationRequest);
 
-  auto kUnknownInfo = MessageTypeDecoder::DecodeType({0xFF}, &used_bytes);
+  auto kUnknownInfo = MessageTypeDecoder::DecodeType(
+      std::vector<uint8_t>{0xFF}, &used_bytes);
   EXPECT_TRUE(kUnknownInfo.is_error());
 }
 
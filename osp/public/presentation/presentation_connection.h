@@ -203,6 +203,22 @@ class ConnectionManager final : public MessageDemuxer::MessageCallback {
   Connection* GetConnection(uint64_t connection_id);
 
  private:
+  // Handle each type of message watched by OnStreamMessage().
+  Error HandleMessage(uint64_t endpoint_id,
+                      const msgs::PresentationConnectionMessageView& message);
+  Error HandleMessage(
+      uint64_t endpoint_id,
+      const msgs::PresentationConnectionCloseRequestView& request);
+  Error HandleMessage(uint64_t endpoint_id,
+                      const msgs::PresentationConnectionCloseEventView& event);
+
+  // TODO(jophba): The spec says to close the connection if we get a message
+  // we don't understand. Figure out how to honor the spec here.
+  template <typename Message>
+  Error HandleMessage(uint64_t endpoint_id, const Message& message) {
+    return Error::Code::kUnknownMessageType;
+  }
+
   // TODO(btolsch): Connection IDs were changed to be per-endpoint, but this
   // table then needs to be <endpoint id, connection id> since connection id is
   // still not unique globally.
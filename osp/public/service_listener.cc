@@ -21,6 +21,26 @@ ServiceListenerError& ServiceListenerError::operator=(
 ServiceListener::Metrics::Metrics() = default;
 ServiceListener::Metrics::~Metrics() = default;
 
+ServiceListener::ReceiverChanges::ReceiverChanges() = default;
+ServiceListener::ReceiverChanges::ReceiverChanges(ReceiverChanges&&) noexcept =
+    default;
+ServiceListener::ReceiverChanges::~ReceiverChanges() = default;
+ServiceListener::ReceiverChanges& ServiceListener::ReceiverChanges::operator=(
+    ReceiverChanges&&) noexcept = default;
+
+void ServiceListener::Observer::OnReceiversChanged(
+    const ReceiverChanges& changes) {
+  for (const ServiceInfo& info : changes.added) {
+    OnReceiverAdded(info);
+  }
+  for (const ServiceInfo& info : changes.changed) {
+    OnReceiverChanged(info);
+  }
+  for (const ServiceInfo& info : changes.removed) {
+    OnReceiverRemoved(info);
+  }
+}
+
 ServiceListener::ServiceListener() : state_(State::kStopped) {}
 ServiceListener::~ServiceListener() = default;
 
@@ -73,6 +73,23 @@ class ServiceListener {
     size_t num_ipv6_receivers = 0;
   };
 
+  // The receivers added, changed, and removed by a batch of updates, each in
+  // the order in which they were first updated.
+  struct ReceiverChanges {
+    ReceiverChanges();
+    ReceiverChanges(ReceiverChanges&&) noexcept;
+    ~ReceiverChanges();
+    ReceiverChanges& operator=(ReceiverChanges&&) noexcept;
+
+    bool empty() const {
+      return added.empty() && changed.empty() && removed.empty();
+    }
+
+    std::vector<ServiceInfo> added;
+    std::vector<ServiceInfo> changed;
+    std::vector<ServiceInfo> removed;
+  };
+
   class Observer {
    public:
     virtual ~Observer() = default;
@@ -94,6 +111,11 @@ class ServiceListener {
     // interfaces have been disabled.
     virtual void OnAllReceiversRemoved() = 0;
 
+    // Called once for each batch of changes to the listener's receiver list,
+    // such as those found by one discovery burst, instead of the methods above.
+    // By default, this calls them for each receiver in |changes|.
+    virtual void OnReceiversChanged(const ReceiverChanges& changes);
+
     // Reports an error.
     virtual void OnError(ServiceListenerError) = 0;
 
@@ -143,7 +165,8 @@ class ServiceListener {
   // Returns the last error reported by this listener.
   const ServiceListenerError& last_error() const { return last_error_; }
 
-  // Returns the current list of receivers known to the ServiceListener.
+  // Returns the current list of receivers known to the ServiceListener, in the
+  // order they were found.
   virtual const std::vector<ServiceInfo>& GetReceivers() const = 0;
 
  protected:
@@ -9,6 +9,13 @@ namespace openscreen {
 UdpSocket::UdpSocket() = default;
 UdpSocket::~UdpSocket() = default;
 
+void UdpSocket::SendMessages(Span<const std::vector<uint8_t>> messages,
+                             const IPEndpoint& dest) {
+  for (const std::vector<uint8_t>& message : messages) {
+    SendMessage(message.data(), message.size(), dest);
+  }
+}
+
 UdpSocket::Client::~Client() = default;
 
 }  // namespace openscreen
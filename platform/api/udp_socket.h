@@ -9,10 +9,12 @@
 #include <stdint.h>  // uint8_t
 
 #include <memory>
+#include <vector>
 
 #include "platform/api/network_interface.h"
 #include "platform/base/error.h"
 #include "platform/base/ip_address.h"
+#include "platform/base/span.h"
 #include "platform/base/udp_packet.h"
 
 namespace openscreen {
@@ -114,6 +116,12 @@ class UdpSocket {
                            size_t length,
                            const IPEndpoint& dest) = 0;
 
+  // Sends each of |messages| to |dest|, in order, as if by calling
+  // SendMessage() for each.  Implementations may send them all with a single
+  // system call.  The default implementation just calls SendMessage().
+  virtual void SendMessages(Span<const std::vector<uint8_t>> messages,
+                            const IPEndpoint& dest);
+
   // Sets the DSCP value to use for all messages sent from this socket.
   virtual void SetDscp(DscpMode state) = 0;
 
@@ -213,6 +213,23 @@ bool operator!=(const IPEndpoint& a, const IPEndpoint& b) {
   return !(a == b);
 }
 
+size_t IPEndpointHash::operator()(const IPEndpoint& endpoint) const {
+  // FNV-1a, over only the bytes that IPAddress::operator==() compares.
+  uint64_t hash = UINT64_C(0xcbf29ce484222325);
+  const auto mix = [&hash](uint8_t byte) {
+    hash = (hash ^ byte) * UINT64_C(0x100000001b3);
+  };
+  const IPAddress& address = endpoint.address;
+  mix(static_cast<uint8_t>(address.version()));
+  const size_t size = address.IsV4() ? IPAddress::kV4Size : IPAddress::kV6Size;
+  for (size_t i = 0; i < size; ++i) {
+    mix(address.bytes()[i]);
+  }
+  mix(static_cast<uint8_t>(endpoint.port >> 8));
+  mix(static_cast<uint8_t>(endpoint.port));
+  return static_cast<size_t>(hash);
+}
+
 bool IPAddress::operator<(const IPAddress& other) const {
   if (version() != other.version()) {
     return version() < other.version();
@@ -174,6 +174,11 @@ inline bool operator>=(const IPEndpoint& a, const IPEndpoint& b) {
   return !(a < b);
 }
 
+// Hashes an IPEndpoint, for use as the key of an unordered container.
+struct IPEndpointHash {
+  size_t operator()(const IPEndpoint& endpoint) const;
+};
+
 // Outputs a string of the form:
 //      123.234.34.56
 //   or fe80:0000:0000:0000:1234:5678:9abc:def0
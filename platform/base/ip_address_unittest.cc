@@ -414,6 +414,21 @@ TEST(IPAddressTest, IPEndpointComparisons) {
   EXPECT_TRUE(kV6High >= kV6Low);
 }
 
+TEST(IPAddressTest, IPEndpointHash) {
+  const IPEndpointHash hash;
+  const IPEndpoint kV4{{192, 168, 0, 1}, 8009};
+  const IPEndpoint kV6{{0xfe80, 0, 0, 0, 0x1234, 0x5678, 0x9abc, 0xdef0}, 8009};
+  const uint8_t kV4Bytes[] = {192, 168, 0, 1};
+
+  EXPECT_EQ(hash(kV4),
+            hash(IPEndpoint{IPAddress(IPAddress::Version::kV4, kV4Bytes),
+                            8009}));
+  EXPECT_EQ(hash(kV6), hash(IPEndpoint{kV6.address, 8009}));
+  EXPECT_NE(hash(kV4), hash(IPEndpoint{kV4.address, 8010}));
+  EXPECT_NE(hash(kV4), hash(IPEndpoint{{192, 168, 0, 2}, 8009}));
+  EXPECT_NE(hash(kV4), hash(kV6));
+}
+
 TEST(IPAddressTest, OstreamOperatorForIPv4) {
   std::ostringstream oss;
   oss << IPAddress{192, 168, 1, 2};
@@ -5,6 +5,8 @@
 #ifndef PLATFORM_BASE_TLS_CONNECT_OPTIONS_H_
 #define PLATFORM_BASE_TLS_CONNECT_OPTIONS_H_
 
+#include <string>
+
 #include "platform/base/macros.h"
 
 namespace openscreen {
@@ -14,6 +16,16 @@ struct TlsConnectOptions {
   // a known hostname, and will typically be “true” for cast code.
   // For example, the cast_socket always sets true.
   bool unsafely_skip_certificate_validation;
+
+  // When true, the session negotiated with the remote endpoint is cached and
+  // offered again on the next Connect() to the same endpoint, so that
+  // reconnects can skip the full handshake.
+  bool enable_session_resumption = false;
+
+  // Identifies the certificate the remote endpoint is expected to present
+  // (e.g. a fingerprint advertised through service discovery), if known.
+  // Cached sessions are only offered to the same endpoint and fingerprint.
+  std::string peer_fingerprint;
 };
 
 }  // namespace openscreen
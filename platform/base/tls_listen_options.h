@@ -5,6 +5,7 @@
 #ifndef PLATFORM_BASE_TLS_LISTEN_OPTIONS_H_
 #define PLATFORM_BASE_TLS_LISTEN_OPTIONS_H_
 
+#include <chrono>
 #include <cstdint>
 
 #include "platform/base/macros.h"
@@ -13,6 +14,15 @@ namespace openscreen {
 
 struct TlsListenOptions {
   uint32_t backlog_size;
+
+  // When true, accepted connections issue session tickets so that clients can
+  // resume their sessions instead of performing a full handshake.
+  bool enable_session_tickets = false;
+
+  // How often the keys protecting session tickets are replaced.  Tickets stay
+  // valid for up to twice this interval.
+  std::chrono::seconds session_ticket_key_rotation_interval =
+      std::chrono::hours(1);
 };
 
 }  // namespace openscreen
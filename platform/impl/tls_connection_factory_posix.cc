@@ -8,6 +8,9 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/ip.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
@@ -25,6 +28,7 @@
 #include "platform/base/tls_listen_options.h"
 #include "platform/impl/stream_socket.h"
 #include "platform/impl/tls_connection_posix.h"
+#include "platform/impl/tls_session_cache_posix.h"
 #include "util/crypto/certificate_utils.h"
 #include "util/crypto/openssl_util.h"
 #include "util/osp_logging.h"
@@ -32,8 +36,128 @@
 
 namespace openscreen {
 
+// State used by the OpenSSL session callbacks, which are only given the SSL
+// connection.  It is owned by the SSL_CTX, since connections keep the context
+// alive after the factory that created them is destroyed.
+struct TlsSessionState {
+  TlsClientSessionCache client_sessions;
+  TlsTicketKeyRing ticket_keys{
+      TlsListenOptions{}.session_ticket_key_rotation_interval, Clock::now};
+};
+
 namespace {
 
+void FreeSessionState(void* parent,
+                      void* ptr,
+                      CRYPTO_EX_DATA* ad,
+                      int index,
+                      long argl,  // NOLINT(runtime/int)
+                      void* argp) {
+  delete static_cast<TlsSessionState*>(ptr);
+}
+
+void FreeSessionKey(void* parent,
+                    void* ptr,
+                    CRYPTO_EX_DATA* ad,
+                    int index,
+                    long argl,  // NOLINT(runtime/int)
+                    void* argp) {
+  delete static_cast<TlsClientSessionCache::Key*>(ptr);
+}
+
+// The SSL_CTX ex_data slot holding its TlsSessionState.
+int GetSessionStateIndex() {
+  static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr,
+                                                    nullptr, &FreeSessionState);
+  return index;
+}
+
+// The SSL ex_data slot holding the TlsClientSessionCache::Key of a client
+// connection that caches its sessions.
+int GetSessionKeyIndex() {
+  static const int index =
+      SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, &FreeSessionKey);
+  return index;
+}
+
+TlsSessionState* GetSessionState(const SSL* ssl) {
+  return static_cast<TlsSessionState*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), GetSessionStateIndex()));
+}
+
+const TlsClientSessionCache::Key* GetSessionKey(const SSL* ssl) {
+  return static_cast<const TlsClientSessionCache::Key*>(
+      SSL_get_ex_data(ssl, GetSessionKeyIndex()));
+}
+
+// Called by OpenSSL when a client receives a new session.  With TLS 1.3 this
+// happens after the handshake, on the thread reading from the connection.
+int OnNewClientSession(SSL* ssl, SSL_SESSION* session) {
+  const TlsClientSessionCache::Key* key = GetSessionKey(ssl);
+  TlsSessionState* state = GetSessionState(ssl);
+  if (!key || !state) {
+    return 0;
+  }
+
+  // Returning 1 transfers ownership of |session| to the cache.
+  state->client_sessions.Put(*key, bssl::UniquePtr<SSL_SESSION>(session));
+  return 1;
+}
+
+// Called by OpenSSL to set up the cipher and HMAC contexts used to encrypt a
+// new session ticket, or to decrypt one presented by a client.
+int OnTicketKeyRequest(SSL* ssl,
+                       uint8_t* key_name,
+                       uint8_t* iv,
+                       EVP_CIPHER_CTX* cipher_ctx,
+                       HMAC_CTX* hmac_ctx,
+                       int encrypt) {
+  TlsSessionState* state = GetSessionState(ssl);
+  if (!state) {
+    return encrypt ? -1 : 0;
+  }
+
+  TlsTicketKeyRing::Key key;
+  bool needs_renewal = false;
+  if (encrypt) {
+    key = state->ticket_keys.GetEncryptionKey();
+    if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_128_cbc())) != 1) {
+      return -1;
+    }
+    std::memcpy(key_name, key.name.data(), key.name.size());
+    if (!EVP_EncryptInit_ex(cipher_ctx, EVP_aes_128_cbc(), nullptr,
+                            key.aes_key.data(), iv)) {
+      return -1;
+    }
+  } else {
+    // Tickets encrypted with an unknown or expired key fall back to a full
+    // handshake.
+    if (!state->ticket_keys.FindDecryptionKey(key_name, &key,
+                                              &needs_renewal)) {
+      return 0;
+    }
+    if (!EVP_DecryptInit_ex(cipher_ctx, EVP_aes_128_cbc(), nullptr,
+                            key.aes_key.data(), iv)) {
+      return -1;
+    }
+  }
+
+  if (!HMAC_Init_ex(hmac_ctx, key.hmac_key.data(), key.hmac_key.size(),
+                    EVP_sha256(), nullptr)) {
+    return -1;
+  }
+  return needs_renewal ? 2 : 1;
+}
+
+void RecordHandshake(const SSL& ssl,
+                     TlsConnectionFactoryPosix::HandshakeCounts* counts) {
+  if (SSL_session_reused(&ssl)) {
+    ++counts->resumed;
+  } else {
+    ++counts->full;
+  }
+}
+
 ErrorOr<std::vector<uint8_t>> GetDEREncodedPeerCertificate(const SSL& ssl) {
   X509* const peer_cert = SSL_get_peer_certificate(&ssl);
   ErrorOr<std::vector<uint8_t>> der_peer_cert =
@@ -69,7 +193,6 @@ TlsConnectionFactoryPosix::~TlsConnectionFactoryPosix() {
   }
 }
 
-// TODO(issuetracker.google.com/281741213): Add support for resuming sessions.
 // TODO(issuetracker.google.com/281741213): Integrate with Auth.
 void TlsConnectionFactoryPosix::Connect(const IPEndpoint& remote_address,
                                         const TlsConnectOptions& options) {
@@ -97,6 +220,11 @@ void TlsConnectionFactoryPosix::Connect(const IPEndpoint& remote_address,
     SSL_set_verify(connection->ssl_.get(), SSL_VERIFY_PEER, nullptr);
   }
 
+  if (options.enable_session_resumption) {
+    EnableSessionResumption(connection->ssl_.get(), remote_address,
+                            options.peer_fingerprint);
+  }
+
   Connect(std::move(connection));
 }
 
@@ -130,6 +258,12 @@ void TlsConnectionFactoryPosix::Listen(const IPEndpoint& local_address,
 
   auto socket = std::make_unique<StreamSocketPosix>(local_address);
   socket->Bind();
+  session_tickets_enabled_ = options.enable_session_tickets;
+  if (session_tickets_enabled_ && session_state_) {
+    session_state_->ticket_keys.set_rotation_interval(
+        options.session_ticket_key_rotation_interval);
+  }
+
   socket->Listen(options.backlog_size);
   if (socket->state() == TcpSocketState::kClosed) {
     DispatchError(Error::Code::kSocketListenFailure);
@@ -184,6 +318,10 @@ void TlsConnectionFactoryPosix::OnSocketAccepted(
     return;
   }
 
+  if (!session_tickets_enabled_) {
+    SSL_set_options(connection->ssl_.get(), SSL_OP_NO_TICKET);
+  }
+
   Accept(std::move(connection));
 }
 
@@ -206,6 +344,23 @@ bool TlsConnectionFactoryPosix::ConfigureSsl(TlsConnectionPosix* connection) {
   return true;
 }
 
+void TlsConnectionFactoryPosix::EnableSessionResumption(
+    SSL* ssl,
+    const IPEndpoint& remote_address,
+    const std::string& peer_fingerprint) {
+  OSP_DCHECK(session_state_);
+  auto key = std::make_unique<TlsClientSessionCache::Key>(remote_address,
+                                                          peer_fingerprint);
+  bssl::UniquePtr<SSL_SESSION> session =
+      session_state_->client_sessions.Get(*key);
+  if (session) {
+    SSL_set_session(ssl, session.get());
+  }
+  if (SSL_set_ex_data(ssl, GetSessionKeyIndex(), key.get())) {
+    key.release();
+  }
+}
+
 ErrorOr<bssl::UniquePtr<SSL>> TlsConnectionFactoryPosix::GetSslConnection() {
   EnsureInitialized();
   if (!ssl_context_.get()) {
@@ -233,6 +388,20 @@ void TlsConnectionFactoryPosix::Initialize() {
 
   SSL_CTX_set_mode(context, SSL_MODE_ENABLE_PARTIAL_WRITE);
 
+  // Sessions are only resumed using tickets, so servers keep no per-session
+  // state, and clients keep their sessions in |session_state_|.
+  auto session_state = std::make_unique<TlsSessionState>();
+  if (!SSL_CTX_set_ex_data(context, GetSessionStateIndex(),
+                           session_state.get())) {
+    SSL_CTX_free(context);
+    return;
+  }
+  session_state_ = session_state.release();
+  SSL_CTX_set_session_cache_mode(
+      context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL);
+  SSL_CTX_sess_set_new_cb(context, &OnNewClientSession);
+  SSL_CTX_set_tlsext_ticket_key_cb(context, &OnTicketKeyRequest);
+
   ssl_context_.reset(context);
 }
 
@@ -256,12 +425,20 @@ void TlsConnectionFactoryPosix::Connect(
       return;
     } else {
       OSP_DVLOG << "SSL_connect failed with error: " << error;
+      // Don't offer a session that may have caused the failure again.
+      const TlsClientSessionCache::Key* key =
+          GetSessionKey(connection->ssl_.get());
+      if (key && session_state_) {
+        session_state_->client_sessions.Remove(*key);
+      }
       DispatchConnectionFailed(connection->GetRemoteEndpoint());
       TRACE_SET_RESULT(error);
       return;
     }
   }
 
+  RecordHandshake(*connection->ssl_, &connect_handshake_counts_);
+
   ErrorOr<std::vector<uint8_t>> der_peer_cert =
       GetDEREncodedPeerCertificate(*connection->ssl_);
   if (!der_peer_cert) {
@@ -308,6 +485,8 @@ void TlsConnectionFactoryPosix::Accept(
     }
   }
 
+  RecordHandshake(*connection->ssl_, &accept_handshake_counts_);
+
   ErrorOr<std::vector<uint8_t>> der_peer_cert =
       GetDEREncodedPeerCertificate(*connection->ssl_);
   std::vector<uint8_t> der_peer_cert_value;
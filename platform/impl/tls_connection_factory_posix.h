@@ -6,8 +6,10 @@
 #define PLATFORM_IMPL_TLS_CONNECTION_FACTORY_POSIX_H_
 
 #include <openssl/ssl.h>
+#include <stdint.h>
 
 #include <memory>
+#include <string>
 
 #include "platform/api/tls_connection.h"
 #include "platform/api/tls_connection_factory.h"
@@ -19,10 +21,16 @@
 namespace openscreen {
 
 class StreamSocket;
+struct TlsSessionState;
 
 class TlsConnectionFactoryPosix : public TlsConnectionFactory,
                                   public TlsDataRouterPosix::SocketObserver {
  public:
+  struct HandshakeCounts {
+    uint64_t full = 0;
+    uint64_t resumed = 0;
+  };
+
   TlsConnectionFactoryPosix(Client* client,
                             TaskRunner* task_runner,
                             PlatformClientPosix* platform_client =
@@ -39,6 +47,15 @@ class TlsConnectionFactoryPosix : public TlsConnectionFactory,
   void Listen(const IPEndpoint& local_address,
               const TlsListenOptions& options) override;
 
+  // The number of successful handshakes of connections made by Connect() and
+  // of connections accepted after Listen(), by whether the session was resumed.
+  const HandshakeCounts& connect_handshake_counts() const {
+    return connect_handshake_counts_;
+  }
+  const HandshakeCounts& accept_handshake_counts() const {
+    return accept_handshake_counts_;
+  }
+
  private:
   // TlsDataRouterPosix::SocketObserver overrides.
   void OnConnectionPending(StreamSocketPosix* socket) override;
@@ -50,6 +67,12 @@ class TlsConnectionFactoryPosix : public TlsConnectionFactory,
   // returning true if the process is successful, false otherwise.
   bool ConfigureSsl(TlsConnectionPosix* connection);
 
+  // Offers the session cached for |remote_address| and |peer_fingerprint|, if
+  // any, and caches the sessions the server issues on |ssl|.
+  void EnableSessionResumption(SSL* ssl,
+                               const IPEndpoint& remote_address,
+                               const std::string& peer_fingerprint);
+
   // Ensures that SSL is initialized, then gets a new SSL connection.
   ErrorOr<bssl::UniquePtr<SSL>> GetSslConnection();
 
@@ -78,6 +101,13 @@ class TlsConnectionFactoryPosix : public TlsConnectionFactory,
   // from the SSL_CTX is non-trivial, so we store a property instead.
   bool listen_credentials_set_ = false;
 
+  // Whether accepted connections issue session tickets, as set by the most
+  // recent Listen() call.
+  bool session_tickets_enabled_ = false;
+
+  HandshakeCounts connect_handshake_counts_;
+  HandshakeCounts accept_handshake_counts_;
+
   Client* const client_;
   TaskRunner* const task_runner_;
   PlatformClientPosix* const platform_client_;
@@ -85,6 +115,9 @@ class TlsConnectionFactoryPosix : public TlsConnectionFactory,
   // SSL context, for creating SSL Connections via BoringSSL.
   bssl::UniquePtr<SSL_CTX> ssl_context_;
 
+  // Session resumption state, owned by |ssl_context_|.
+  TlsSessionState* session_state_ = nullptr;
+
   WeakPtrFactory<TlsConnectionFactoryPosix> weak_factory_{this};
 
   OSP_DISALLOW_COPY_AND_ASSIGN(TlsConnectionFactoryPosix);
@@ -0,0 +1,245 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/tls_connection_factory_posix.h"
+
+#include <openssl/mem.h>
+#include <openssl/rsa.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "platform/api/task_runner.h"
+#include "platform/base/tls_connect_options.h"
+#include "platform/base/tls_credentials.h"
+#include "platform/base/tls_listen_options.h"
+#include "platform/impl/platform_client_posix.h"
+#include "testing/util/task_util.h"
+#include "util/crypto/certificate_utils.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace {
+
+constexpr uint8_t kLoopbackV4[4] = {127, 0, 0, 1};
+constexpr Clock::duration kPollInterval = std::chrono::milliseconds(10);
+constexpr int kMaxPollAttempts = 500;
+constexpr uint8_t kGreeting[] = {'h', 'e', 'l', 'l', 'o'};
+
+TlsCredentials GenerateCredentials() {
+  bssl::UniquePtr<EVP_PKEY> key = GenerateRsaKeyPair();
+  ErrorOr<bssl::UniquePtr<X509>> cert = CreateSelfSignedX509Certificate(
+      "Test TLS Server", std::chrono::hours(24), *key);
+  OSP_CHECK(cert);
+  ErrorOr<std::vector<uint8_t>> der_cert =
+      ExportX509CertificateToDer(*cert.value());
+  OSP_CHECK(der_cert);
+
+  uint8_t* key_bytes = nullptr;
+  size_t key_length = 0;
+  OSP_CHECK(RSA_private_key_to_bytes(&key_bytes, &key_length,
+                                     EVP_PKEY_get0_RSA(key.get())));
+  std::vector<uint8_t> der_key(key_bytes, key_bytes + key_length);
+  OPENSSL_free(key_bytes);
+
+  return TlsCredentials(std::move(der_key), {}, std::move(der_cert.value()));
+}
+
+// One end of the TLS connections, which keeps every connection it is given and
+// counts the bytes read from them.  The factory and connection callbacks run on
+// the TaskRunner, while the test thread polls the counts.
+class TlsPeer final : public TlsConnectionFactory::Client,
+                      public TlsConnection::Client {
+ public:
+  ~TlsPeer() override = default;
+
+  int num_connections() const { return num_connections_; }
+  int num_failures() const { return num_failures_; }
+  size_t bytes_read() const { return bytes_read_; }
+  std::vector<std::unique_ptr<TlsConnection>>& connections() {
+    return connections_;
+  }
+
+  // TlsConnectionFactory::Client overrides.
+  void OnAccepted(TlsConnectionFactory* factory,
+                  std::vector<uint8_t> der_x509_peer_cert,
+                  std::unique_ptr<TlsConnection> connection) override {
+    AddConnection(std::move(connection));
+  }
+  void OnConnected(TlsConnectionFactory* factory,
+                   std::vector<uint8_t> der_x509_peer_cert,
+                   std::unique_ptr<TlsConnection> connection) override {
+    AddConnection(std::move(connection));
+  }
+  void OnConnectionFailed(TlsConnectionFactory* factory,
+                          const IPEndpoint& remote_address) override {
+    ++num_failures_;
+  }
+  void OnError(TlsConnectionFactory* factory, Error error) override {
+    ++num_failures_;
+  }
+
+  // TlsConnection::Client overrides.
+  void OnError(TlsConnection* connection, Error error) override {}
+  void OnRead(TlsConnection* connection, std::vector<uint8_t> block) override {
+    bytes_read_ += block.size();
+  }
+
+ private:
+  void AddConnection(std::unique_ptr<TlsConnection> connection) {
+    connection->SetClient(this);
+    connections_.push_back(std::move(connection));
+    ++num_connections_;
+  }
+
+  std::vector<std::unique_ptr<TlsConnection>> connections_;
+  std::atomic<int> num_connections_{0};
+  std::atomic<int> num_failures_{0};
+  std::atomic<size_t> bytes_read_{0};
+};
+
+class TlsConnectionFactoryPosixTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    PlatformClientPosix::Create(std::chrono::milliseconds(10));
+    task_runner_ = PlatformClientPosix::GetInstance()->GetTaskRunner();
+    RunOnTaskRunner([this] {
+      server_factory_ =
+          std::make_unique<TlsConnectionFactoryPosix>(&server_, task_runner_);
+      client_factory_ =
+          std::make_unique<TlsConnectionFactoryPosix>(&client_, task_runner_);
+    });
+  }
+
+  void TearDown() override {
+    RunOnTaskRunner([this] {
+      client_.connections().clear();
+      server_.connections().clear();
+      client_factory_.reset();
+      server_factory_.reset();
+    });
+    PlatformClientPosix::ShutDown();
+  }
+
+ protected:
+  // Runs |task| on the TaskRunner, which is where the factories must be used,
+  // and waits for it to finish.
+  void RunOnTaskRunner(std::function<void()> task) {
+    std::atomic_bool done{false};
+    task_runner_->PostTask([&task, &done] {
+      task();
+      done = true;
+    });
+    WaitForCondition([&done] { return done.load(); }, kPollInterval,
+                     kMaxPollAttempts);
+  }
+
+  void Listen(uint16_t port, bool enable_session_tickets) {
+    server_endpoint_ = IPEndpoint{IPAddress(kLoopbackV4), port};
+    RunOnTaskRunner([this, enable_session_tickets] {
+      server_factory_->SetListenCredentials(GenerateCredentials());
+      TlsListenOptions options{1u};
+      options.enable_session_tickets = enable_session_tickets;
+      server_factory_->Listen(server_endpoint_, options);
+    });
+  }
+
+  // Makes a new connection to the server, then has the server send data over
+  // it.  Once the client has read that data, it has also processed any session
+  // ticket the server sent after the handshake.
+  void ConnectAndExchangeData(bool enable_session_resumption) {
+    const int num_connections = client_.num_connections();
+    const size_t bytes_read = client_.bytes_read();
+    RunOnTaskRunner([this, enable_session_resumption] {
+      TlsConnectOptions options{true};
+      options.enable_session_resumption = enable_session_resumption;
+      client_factory_->Connect(server_endpoint_, options);
+    });
+    WaitForCondition(
+        [this, num_connections] {
+          return client_.num_connections() > num_connections &&
+                 server_.num_connections() > num_connections;
+        },
+        kPollInterval, kMaxPollAttempts);
+    ASSERT_EQ(0, client_.num_failures());
+    ASSERT_EQ(0, server_.num_failures());
+
+    RunOnTaskRunner([this] {
+      EXPECT_TRUE(
+          server_.connections().back()->Send(kGreeting, sizeof(kGreeting)));
+    });
+    WaitForCondition(
+        [this, bytes_read] {
+          return client_.bytes_read() >= bytes_read + sizeof(kGreeting);
+        },
+        kPollInterval, kMaxPollAttempts);
+  }
+
+  void GetHandshakeCounts(
+      TlsConnectionFactoryPosix::HandshakeCounts* connect_counts,
+      TlsConnectionFactoryPosix::HandshakeCounts* accept_counts) {
+    RunOnTaskRunner([this, connect_counts, accept_counts] {
+      *connect_counts = client_factory_->connect_handshake_counts();
+      *accept_counts = server_factory_->accept_handshake_counts();
+    });
+  }
+
+  TaskRunner* task_runner_ = nullptr;
+  IPEndpoint server_endpoint_;
+  TlsPeer server_;
+  TlsPeer client_;
+  std::unique_ptr<TlsConnectionFactoryPosix> server_factory_;
+  std::unique_ptr<TlsConnectionFactoryPosix> client_factory_;
+};
+
+}  // namespace
+
+TEST_F(TlsConnectionFactoryPosixTest, ResumesSessionsWithTickets) {
+  Listen(65331, true);
+  ConnectAndExchangeData(true);
+  ConnectAndExchangeData(true);
+
+  TlsConnectionFactoryPosix::HandshakeCounts connect_counts;
+  TlsConnectionFactoryPosix::HandshakeCounts accept_counts;
+  GetHandshakeCounts(&connect_counts, &accept_counts);
+  EXPECT_EQ(1u, connect_counts.full);
+  EXPECT_EQ(1u, connect_counts.resumed);
+  EXPECT_EQ(1u, accept_counts.full);
+  EXPECT_EQ(1u, accept_counts.resumed);
+}
+
+TEST_F(TlsConnectionFactoryPosixTest, PerformsFullHandshakesWithoutTickets) {
+  Listen(65332, false);
+  ConnectAndExchangeData(true);
+  ConnectAndExchangeData(true);
+
+  TlsConnectionFactoryPosix::HandshakeCounts connect_counts;
+  TlsConnectionFactoryPosix::HandshakeCounts accept_counts;
+  GetHandshakeCounts(&connect_counts, &accept_counts);
+  EXPECT_EQ(2u, connect_counts.full);
+  EXPECT_EQ(0u, connect_counts.resumed);
+  EXPECT_EQ(2u, accept_counts.full);
+  EXPECT_EQ(0u, accept_counts.resumed);
+}
+
+TEST_F(TlsConnectionFactoryPosixTest, OnlyResumesWhenTheClientOptsIn) {
+  Listen(65333, true);
+  ConnectAndExchangeData(false);
+  ConnectAndExchangeData(false);
+
+  TlsConnectionFactoryPosix::HandshakeCounts connect_counts;
+  TlsConnectionFactoryPosix::HandshakeCounts accept_counts;
+  GetHandshakeCounts(&connect_counts, &accept_counts);
+  EXPECT_EQ(2u, connect_counts.full);
+  EXPECT_EQ(0u, connect_counts.resumed);
+  EXPECT_EQ(2u, accept_counts.full);
+  EXPECT_EQ(0u, accept_counts.resumed);
+}
+
+}  // namespace openscreen
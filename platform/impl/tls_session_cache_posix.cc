@@ -0,0 +1,148 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/tls_session_cache_posix.h"
+
+#include <cstring>
+
+#include "util/crypto/random_bytes.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+
+using clock_operators::operator<<;
+
+namespace {
+
+TlsTicketKeyRing::Key CreateTicketKey(Clock::time_point now) {
+  TlsTicketKeyRing::Key key;
+  key.name = GenerateRandomBytes16();
+  GenerateRandomBytes(key.aes_key.data(), key.aes_key.size());
+  GenerateRandomBytes(key.hmac_key.data(), key.hmac_key.size());
+  key.created = now;
+  return key;
+}
+
+}  // namespace
+
+TlsClientSessionCache::TlsClientSessionCache(size_t max_entries)
+    : max_entries_(max_entries) {
+  OSP_DCHECK_GT(max_entries_, 0u);
+}
+
+TlsClientSessionCache::~TlsClientSessionCache() = default;
+
+bssl::UniquePtr<SSL_SESSION> TlsClientSessionCache::Get(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+
+  SSL_SESSION* const session = it->second->session.get();
+  const uint64_t expiry = static_cast<uint64_t>(SSL_SESSION_get_time(session)) +
+                          SSL_SESSION_get_timeout(session);
+  if (expiry <= static_cast<uint64_t>(GetWallTimeSinceUnixEpoch().count())) {
+    lru_order_.erase(it->second);
+    entries_.erase(it);
+    return nullptr;
+  }
+
+  lru_order_.splice(lru_order_.begin(), lru_order_, it->second);
+  SSL_SESSION_up_ref(session);
+  return bssl::UniquePtr<SSL_SESSION>(session);
+}
+
+void TlsClientSessionCache::Put(const Key& key,
+                                bssl::UniquePtr<SSL_SESSION> session) {
+  if (!session || !SSL_SESSION_is_resumable(session.get())) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    it->second->session = std::move(session);
+    lru_order_.splice(lru_order_.begin(), lru_order_, it->second);
+    return;
+  }
+
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(lru_order_.back().key);
+    lru_order_.pop_back();
+  }
+  lru_order_.push_front(Entry{key, std::move(session)});
+  entries_.emplace(key, lru_order_.begin());
+}
+
+void TlsClientSessionCache::Remove(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_order_.erase(it->second);
+    entries_.erase(it);
+  }
+}
+
+size_t TlsClientSessionCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+TlsTicketKeyRing::TlsTicketKeyRing(Clock::duration rotation_interval,
+                                   ClockNowFunctionPtr now_function)
+    : now_function_(now_function),
+      rotation_interval_(rotation_interval),
+      current_key_(CreateTicketKey(now_function_())) {
+  OSP_DCHECK_GT(rotation_interval_, Clock::duration::zero());
+}
+
+TlsTicketKeyRing::~TlsTicketKeyRing() = default;
+
+TlsTicketKeyRing::Key TlsTicketKeyRing::GetEncryptionKey() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  MaybeRotate();
+  return current_key_;
+}
+
+bool TlsTicketKeyRing::FindDecryptionKey(const uint8_t* name,
+                                         Key* key,
+                                         bool* needs_renewal) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Clock::time_point now = MaybeRotate();
+  if (std::memcmp(name, current_key_.name.data(), current_key_.name.size()) ==
+      0) {
+    *key = current_key_;
+    *needs_renewal = false;
+    return true;
+  }
+  if (has_previous_key_ &&
+      now - previous_key_.created < 2 * rotation_interval_ &&
+      std::memcmp(name, previous_key_.name.data(),
+                  previous_key_.name.size()) == 0) {
+    *key = previous_key_;
+    *needs_renewal = true;
+    return true;
+  }
+  return false;
+}
+
+void TlsTicketKeyRing::set_rotation_interval(
+    Clock::duration rotation_interval) {
+  OSP_DCHECK_GT(rotation_interval, Clock::duration::zero());
+  std::lock_guard<std::mutex> lock(mutex_);
+  rotation_interval_ = rotation_interval;
+}
+
+Clock::time_point TlsTicketKeyRing::MaybeRotate() {
+  const Clock::time_point now = now_function_();
+  if (now - current_key_.created >= rotation_interval_) {
+    previous_key_ = current_key_;
+    has_previous_key_ = true;
+    current_key_ = CreateTicketKey(now);
+  }
+  return now;
+}
+
+}  // namespace openscreen
@@ -0,0 +1,117 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PLATFORM_IMPL_TLS_SESSION_CACHE_POSIX_H_
+#define PLATFORM_IMPL_TLS_SESSION_CACHE_POSIX_H_
+
+#include <openssl/ssl.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "platform/api/time.h"
+#include "platform/base/ip_address.h"
+#include "platform/base/macros.h"
+
+namespace openscreen {
+
+// A Least Recently Used cache of client-side TLS sessions, keyed by remote
+// endpoint and expected peer certificate fingerprint.  New sessions are
+// delivered by OpenSSL on whichever thread reads from the connection, so this
+// class is thread-safe.
+class TlsClientSessionCache {
+ public:
+  using Key = std::pair<IPEndpoint, std::string>;
+
+  static constexpr size_t kDefaultMaxEntries = 32;
+
+  explicit TlsClientSessionCache(size_t max_entries = kDefaultMaxEntries);
+  ~TlsClientSessionCache();
+
+  // Returns a new reference to the session cached for |key|, or nullptr.  An
+  // expired session is dropped instead of being returned.
+  bssl::UniquePtr<SSL_SESSION> Get(const Key& key);
+
+  // Caches |session| for |key|, replacing any previous session.  Sessions that
+  // cannot be resumed are ignored.
+  void Put(const Key& key, bssl::UniquePtr<SSL_SESSION> session);
+
+  // Drops the session cached for |key|, e.g. after a failed handshake.
+  void Remove(const Key& key);
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    Key key;
+    bssl::UniquePtr<SSL_SESSION> session;
+  };
+
+  using LruList = std::list<Entry>;
+
+  const size_t max_entries_;
+
+  mutable std::mutex mutex_;
+
+  // Most recently used entries appear at the front of the list.
+  LruList lru_order_ ABSL_GUARDED_BY(mutex_);
+  std::map<Key, LruList::iterator> entries_ ABSL_GUARDED_BY(mutex_);
+
+  OSP_DISALLOW_COPY_AND_ASSIGN(TlsClientSessionCache);
+};
+
+// The keys used by a server to encrypt and authenticate its session tickets.
+// A new key is generated once the current one is older than the rotation
+// interval.  Tickets encrypted with the previous key are still accepted, but
+// renewed, until that key is twice as old as the rotation interval.  This
+// class is thread-safe.
+class TlsTicketKeyRing {
+ public:
+  struct Key {
+    std::array<uint8_t, 16> name;
+    std::array<uint8_t, 16> aes_key;
+    std::array<uint8_t, 32> hmac_key;
+    Clock::time_point created;
+  };
+
+  TlsTicketKeyRing(Clock::duration rotation_interval,
+                   ClockNowFunctionPtr now_function);
+  ~TlsTicketKeyRing();
+
+  // Returns the key to use for new tickets.
+  Key GetEncryptionKey();
+
+  // Looks up the key named |name|.  Returns false if it is unknown or has
+  // expired.  |needs_renewal| is set if the ticket should be replaced with one
+  // encrypted using the current key.
+  bool FindDecryptionKey(const uint8_t* name, Key* key, bool* needs_renewal);
+
+  void set_rotation_interval(Clock::duration rotation_interval);
+
+ private:
+  // Replaces the current key if it is older than the rotation interval, and
+  // returns the current time.
+  Clock::time_point MaybeRotate() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const ClockNowFunctionPtr now_function_;
+
+  std::mutex mutex_;
+  Clock::duration rotation_interval_ ABSL_GUARDED_BY(mutex_);
+  Key current_key_ ABSL_GUARDED_BY(mutex_);
+  bool has_previous_key_ ABSL_GUARDED_BY(mutex_) = false;
+  Key previous_key_ ABSL_GUARDED_BY(mutex_);
+
+  OSP_DISALLOW_COPY_AND_ASSIGN(TlsTicketKeyRing);
+};
+
+}  // namespace openscreen
+
+#endif  // PLATFORM_IMPL_TLS_SESSION_CACHE_POSIX_H_
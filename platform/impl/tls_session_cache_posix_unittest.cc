@@ -0,0 +1,183 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/tls_session_cache_posix.h"
+
+#include <openssl/ssl.h>
+
+#include <chrono>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "platform/test/fake_clock.h"
+
+namespace openscreen {
+namespace {
+
+constexpr Clock::duration kRotationInterval = std::chrono::hours(1);
+
+constexpr uint32_t kSessionTimeoutSeconds = 3600;
+
+const TlsClientSessionCache::Key kFirstKey{
+    IPEndpoint{{192, 168, 1, 10}, 8009}, "first"};
+const TlsClientSessionCache::Key kSecondKey{
+    IPEndpoint{{192, 168, 1, 11}, 8009}, "second"};
+const TlsClientSessionCache::Key kThirdKey{
+    IPEndpoint{{192, 168, 1, 12}, 8009}, "third"};
+
+class TlsClientSessionCacheTest : public ::testing::Test {
+ protected:
+  // Creates a resumable session with the given |id|, created |age| ago.
+  bssl::UniquePtr<SSL_SESSION> CreateSession(
+      const std::string& id,
+      std::chrono::seconds age = std::chrono::seconds(0)) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ssl_context_.get()));
+    EXPECT_TRUE(SSL_SESSION_set1_id(
+        session.get(), reinterpret_cast<const uint8_t*>(id.data()), id.size()));
+    SSL_SESSION_set_time(session.get(),
+                         (GetWallTimeSinceUnixEpoch() - age).count());
+    SSL_SESSION_set_timeout(session.get(), kSessionTimeoutSeconds);
+    return session;
+  }
+
+  static std::string GetSessionId(const SSL_SESSION* session) {
+    unsigned int length = 0;
+    const uint8_t* id = SSL_SESSION_get_id(session, &length);
+    return std::string(reinterpret_cast<const char*>(id), length);
+  }
+
+  bssl::UniquePtr<SSL_CTX> ssl_context_{SSL_CTX_new(TLS_method())};
+};
+
+class TlsTicketKeyRingTest : public ::testing::Test {
+ protected:
+  FakeClock clock_{Clock::now()};
+  TlsTicketKeyRing key_ring_{kRotationInterval, &FakeClock::now};
+};
+
+}  // namespace
+
+TEST_F(TlsClientSessionCacheTest, LooksUpSessionsByKey) {
+  TlsClientSessionCache cache;
+  EXPECT_FALSE(cache.Get(kFirstKey));
+
+  cache.Put(kFirstKey, CreateSession("session-1"));
+  cache.Put(kSecondKey, CreateSession("session-2"));
+  EXPECT_EQ(2u, cache.size());
+
+  bssl::UniquePtr<SSL_SESSION> session = cache.Get(kFirstKey);
+  ASSERT_TRUE(session);
+  EXPECT_EQ("session-1", GetSessionId(session.get()));
+  session = cache.Get(kSecondKey);
+  ASSERT_TRUE(session);
+  EXPECT_EQ("session-2", GetSessionId(session.get()));
+
+  // The same endpoint with a different expected certificate is a different
+  // key.
+  EXPECT_FALSE(cache.Get(
+      TlsClientSessionCache::Key{kFirstKey.first, "other fingerprint"}));
+}
+
+TEST_F(TlsClientSessionCacheTest, ReplacesAndRemovesSessions) {
+  TlsClientSessionCache cache;
+  cache.Put(kFirstKey, CreateSession("old"));
+  cache.Put(kFirstKey, CreateSession("new"));
+  EXPECT_EQ(1u, cache.size());
+  bssl::UniquePtr<SSL_SESSION> session = cache.Get(kFirstKey);
+  ASSERT_TRUE(session);
+  EXPECT_EQ("new", GetSessionId(session.get()));
+
+  cache.Remove(kFirstKey);
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_FALSE(cache.Get(kFirstKey));
+}
+
+TEST_F(TlsClientSessionCacheTest, IgnoresSessionsThatCannotBeResumed) {
+  TlsClientSessionCache cache;
+  cache.Put(kFirstKey, nullptr);
+  cache.Put(kFirstKey,
+            bssl::UniquePtr<SSL_SESSION>(SSL_SESSION_new(ssl_context_.get())));
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_FALSE(cache.Get(kFirstKey));
+}
+
+TEST_F(TlsClientSessionCacheTest, EvictsLeastRecentlyUsedSession) {
+  TlsClientSessionCache cache(2);
+  cache.Put(kFirstKey, CreateSession("session-1"));
+  cache.Put(kSecondKey, CreateSession("session-2"));
+
+  // Using the first session makes the second one the least recently used.
+  EXPECT_TRUE(cache.Get(kFirstKey));
+  cache.Put(kThirdKey, CreateSession("session-3"));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.Get(kFirstKey));
+  EXPECT_FALSE(cache.Get(kSecondKey));
+  EXPECT_TRUE(cache.Get(kThirdKey));
+}
+
+TEST_F(TlsClientSessionCacheTest, DropsExpiredSessions) {
+  TlsClientSessionCache cache;
+  cache.Put(kFirstKey,
+            CreateSession("expired",
+                          std::chrono::seconds(kSessionTimeoutSeconds + 1)));
+  cache.Put(kSecondKey,
+            CreateSession("valid",
+                          std::chrono::seconds(kSessionTimeoutSeconds - 60)));
+  EXPECT_EQ(2u, cache.size());
+
+  EXPECT_FALSE(cache.Get(kFirstKey));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_TRUE(cache.Get(kSecondKey));
+}
+
+TEST_F(TlsTicketKeyRingTest, UsesTheSameKeyWithinARotationInterval) {
+  const TlsTicketKeyRing::Key first = key_ring_.GetEncryptionKey();
+  clock_.Advance(kRotationInterval / 2);
+  const TlsTicketKeyRing::Key second = key_ring_.GetEncryptionKey();
+  EXPECT_EQ(first.name, second.name);
+  EXPECT_EQ(first.aes_key, second.aes_key);
+  EXPECT_EQ(first.hmac_key, second.hmac_key);
+
+  TlsTicketKeyRing::Key found;
+  bool needs_renewal = true;
+  ASSERT_TRUE(
+      key_ring_.FindDecryptionKey(first.name.data(), &found, &needs_renewal));
+  EXPECT_EQ(first.aes_key, found.aes_key);
+  EXPECT_FALSE(needs_renewal);
+}
+
+TEST_F(TlsTicketKeyRingTest, RenewsTicketsFromThePreviousKey) {
+  const TlsTicketKeyRing::Key first = key_ring_.GetEncryptionKey();
+  clock_.Advance(kRotationInterval);
+  const TlsTicketKeyRing::Key second = key_ring_.GetEncryptionKey();
+  EXPECT_NE(first.name, second.name);
+
+  TlsTicketKeyRing::Key found;
+  bool needs_renewal = false;
+  ASSERT_TRUE(
+      key_ring_.FindDecryptionKey(first.name.data(), &found, &needs_renewal));
+  EXPECT_EQ(first.hmac_key, found.hmac_key);
+  EXPECT_TRUE(needs_renewal);
+
+  ASSERT_TRUE(
+      key_ring_.FindDecryptionKey(second.name.data(), &found, &needs_renewal));
+  EXPECT_EQ(second.hmac_key, found.hmac_key);
+  EXPECT_FALSE(needs_renewal);
+}
+
+TEST_F(TlsTicketKeyRingTest, RejectsExpiredAndUnknownKeys) {
+  const TlsTicketKeyRing::Key first = key_ring_.GetEncryptionKey();
+  clock_.Advance(2 * kRotationInterval);
+
+  TlsTicketKeyRing::Key found;
+  bool needs_renewal = false;
+  EXPECT_FALSE(
+      key_ring_.FindDecryptionKey(first.name.data(), &found, &needs_renewal));
+
+  const uint8_t unknown_name[16] = {};
+  EXPECT_FALSE(
+      key_ring_.FindDecryptionKey(unknown_name, &found, &needs_renewal));
+}
+
+}  // namespace openscreen
@@ -20,6 +20,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/types/optional.h"
 #include "platform/api/task_runner.h"
@@ -35,6 +36,15 @@ namespace {
 constexpr int kMaxUdpBufferSize = 64 << 10;
 #endif
 
+// The most packets read from a socket, and passed to its client in one task,
+// each time it becomes readable.
+constexpr int kMaxPacketsPerRead = 16;
+
+#if defined(OS_LINUX)
+// The most messages passed to each sendmmsg() call.
+constexpr size_t kMaxMessagesPerSend = 64;
+#endif
+
 constexpr bool IsPowerOf2(uint32_t x) {
   return (x > 0) && ((x & (x - 1)) == 0);
 }
@@ -467,28 +477,47 @@ void UdpSocketPosix::ReceiveMessage() {
     return;
   }
 
-  ErrorOr<UdpPacket> read_result = Error::Code::kUnknownError;
-  switch (local_endpoint_.address.version()) {
-    case UdpSocket::Version::kV4: {
-      read_result = ReceiveMessageInternal<sockaddr_in, in_pktinfo>(handle_.fd);
-      break;
+  // Read every packet that is already waiting, up to a limit, so a burst of
+  // packets costs the client one task rather than one per packet.
+  std::vector<ErrorOr<UdpPacket>> read_results;
+  for (int i = 0; i < kMaxPacketsPerRead; ++i) {
+    ErrorOr<UdpPacket> read_result = Error::Code::kUnknownError;
+    switch (local_endpoint_.address.version()) {
+      case UdpSocket::Version::kV4: {
+        read_result =
+            ReceiveMessageInternal<sockaddr_in, in_pktinfo>(handle_.fd);
+        break;
+      }
+      case UdpSocket::Version::kV6: {
+        read_result =
+            ReceiveMessageInternal<sockaddr_in6, in6_pktinfo>(handle_.fd);
+        break;
+      }
+      default: {
+        OSP_NOTREACHED();
+      }
     }
-    case UdpSocket::Version::kV6: {
-      read_result =
-          ReceiveMessageInternal<sockaddr_in6, in6_pktinfo>(handle_.fd);
+
+    if (read_result.is_error()) {
+      // After the first packet, running out of packets to read is expected.
+      if (read_results.empty() ||
+          read_result.error().code() != Error::Code::kAgain) {
+        read_results.push_back(std::move(read_result));
+      }
       break;
     }
-    default: {
-      OSP_NOTREACHED();
-    }
+    read_results.push_back(std::move(read_result));
   }
 
   task_runner_->PostTask([weak_this = weak_factory_.GetWeakPtr(),
-                          result = std::move(read_result)]() mutable {
-    if (auto* self = weak_this.get()) {
-      if (auto* client = self->client_) {
-        client->OnRead(self, std::move(result));
+                          results = std::move(read_results)]() mutable {
+    for (ErrorOr<UdpPacket>& result : results) {
+      // The client may destroy this socket while handling a packet.
+      auto* self = weak_this.get();
+      if (!self || !self->client_) {
+        return;
       }
+      self->client_->OnRead(self, std::move(result));
     }
   });
 }
@@ -548,6 +577,72 @@ void UdpSocketPosix::SendMessage(const void* data,
   OSP_DCHECK_EQ(static_cast<size_t>(num_bytes_sent), length);
 }
 
+void UdpSocketPosix::SendMessages(Span<const std::vector<uint8_t>> messages,
+                                  const IPEndpoint& dest) {
+#if defined(OS_LINUX)
+  if (is_closed()) {
+    if (client_) {
+      client_->OnSendError(this, Error::Code::kSocketClosedFailure);
+    }
+    return;
+  }
+
+  struct sockaddr_in sa4 {};
+  struct sockaddr_in6 sa6 {};
+  void* name = nullptr;
+  socklen_t name_length = 0;
+  switch (local_endpoint_.address.version()) {
+    case UdpSocket::Version::kV4: {
+      sa4.sin_family = AF_INET;
+      sa4.sin_port = htons(dest.port);
+      dest.address.CopyToV4(reinterpret_cast<uint8_t*>(&sa4.sin_addr.s_addr));
+      name = &sa4;
+      name_length = sizeof(sa4);
+      break;
+    }
+
+    case UdpSocket::Version::kV6: {
+      sa6.sin6_family = AF_INET6;
+      sa6.sin6_port = htons(dest.port);
+      dest.address.CopyToV6(reinterpret_cast<uint8_t*>(&sa6.sin6_addr.s6_addr));
+      name = &sa6;
+      name_length = sizeof(sa6);
+      break;
+    }
+  }
+
+  struct iovec iovs[kMaxMessagesPerSend];
+  struct mmsghdr headers[kMaxMessagesPerSend];
+  size_t num_sent = 0;
+  while (num_sent < messages.size()) {
+    const size_t count =
+        std::min(messages.size() - num_sent, kMaxMessagesPerSend);
+    for (size_t i = 0; i < count; ++i) {
+      const std::vector<uint8_t>& message = messages[num_sent + i];
+      iovs[i] = {const_cast<uint8_t*>(message.data()), message.size()};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_name = name;
+      headers[i].msg_hdr.msg_namelen = name_length;
+      headers[i].msg_hdr.msg_iov = &iovs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // sendmmsg() sends at least one message unless it fails.
+    const int num_messages_sent = sendmmsg(handle_.fd, headers, count, 0);
+    if (num_messages_sent == -1) {
+      if (client_) {
+        client_->OnSendError(
+            this, ChooseError(errno, Error::Code::kSocketSendFailure));
+      }
+      return;
+    }
+    num_sent += num_messages_sent;
+  }
+#else
+  UdpSocket::SendMessages(messages, dest);
+#endif  // defined(OS_LINUX)
+}
+
 void UdpSocketPosix::SetDscp(UdpSocket::DscpMode state) {
   if (is_closed()) {
     OnError(Error::Code::kSocketClosedFailure);
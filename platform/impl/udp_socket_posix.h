@@ -43,6 +43,8 @@ class UdpSocketPosix : public UdpSocket {
   void SendMessage(const void* data,
                    size_t length,
                    const IPEndpoint& dest) override;
+  void SendMessages(Span<const std::vector<uint8_t>> messages,
+                    const IPEndpoint& dest) override;
   void SetDscp(DscpMode state) override;
 
   const SocketHandle& GetHandle() const;
@@ -50,9 +52,10 @@ class UdpSocketPosix : public UdpSocket {
  protected:
   friend class UdpSocketReaderPosix;
 
-  // Called by UdpSocketReaderPosix to perform a non-blocking read on the socket
-  // and then dispatch the packet to this socket's Client. This method is the
-  // only one in this class possibly being called from another thread.
+  // Called by UdpSocketReaderPosix to perform non-blocking reads on the socket
+  // and then dispatch the packets read to this socket's Client in one task.
+  // This method is the only one in this class possibly being called from
+  // another thread.
   void ReceiveMessage();
 
  private:
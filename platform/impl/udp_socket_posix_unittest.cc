@@ -0,0 +1,123 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/impl/udp_socket_posix.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <memory>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "platform/impl/socket_handle_posix.h"
+#include "platform/test/fake_clock.h"
+#include "platform/test/fake_task_runner.h"
+#include "platform/test/fake_udp_socket.h"
+
+namespace openscreen {
+namespace {
+
+using ::testing::_;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::StrictMock;
+
+// Exposes ReceiveMessage(), which is normally called by UdpSocketReaderPosix.
+class TestUdpSocketPosix : public UdpSocketPosix {
+ public:
+  TestUdpSocketPosix(TaskRunner* task_runner, Client* client, int fd)
+      : UdpSocketPosix(task_runner,
+                       client,
+                       SocketHandle(fd),
+                       IPEndpoint{IPAddress(127, 0, 0, 1), 0},
+                       nullptr) {}
+  ~TestUdpSocketPosix() override = default;
+
+  using UdpSocketPosix::ReceiveMessage;
+};
+
+int CreateNonBlockingSocket() {
+  const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  EXPECT_NE(fd, -1);
+  EXPECT_NE(fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK), -1);
+  return fd;
+}
+
+class UdpSocketPosixTest : public ::testing::Test {
+ public:
+  UdpSocketPosixTest() : clock_(Clock::now()), task_runner_(&clock_) {
+    EXPECT_CALL(sender_client_, OnBound(_));
+    EXPECT_CALL(receiver_client_, OnBound(_));
+    sender_ = std::make_unique<TestUdpSocketPosix>(
+        &task_runner_, &sender_client_, CreateNonBlockingSocket());
+    receiver_ = std::make_unique<TestUdpSocketPosix>(
+        &task_runner_, &receiver_client_, CreateNonBlockingSocket());
+    sender_->Bind();
+    receiver_->Bind();
+  }
+
+ protected:
+  FakeClock clock_;
+  FakeTaskRunner task_runner_;
+  StrictMock<FakeUdpSocket::MockClient> sender_client_;
+  StrictMock<FakeUdpSocket::MockClient> receiver_client_;
+  std::unique_ptr<TestUdpSocketPosix> sender_;
+  std::unique_ptr<TestUdpSocketPosix> receiver_;
+};
+
+TEST_F(UdpSocketPosixTest, SendsAndReceivesBatchInOrder) {
+  const std::vector<std::vector<uint8_t>> messages = {
+      {1}, {2, 2}, {3, 3, 3}};
+  sender_->SendMessages(messages, receiver_->GetLocalEndpoint());
+
+  std::vector<std::vector<uint8_t>> received;
+  {
+    InSequence s;
+    EXPECT_CALL(receiver_client_, OnReadInternal(receiver_.get(), _))
+        .Times(3)
+        .WillRepeatedly(
+            Invoke([this, &received](UdpSocket*,
+                                     const ErrorOr<UdpPacket>& packet) {
+              ASSERT_TRUE(packet.is_value());
+              EXPECT_EQ(packet.value().source(), sender_->GetLocalEndpoint());
+              received.emplace_back(packet.value().begin(),
+                                    packet.value().end());
+            }));
+  }
+
+  // All of the waiting packets are read, and then passed on by one task.
+  receiver_->ReceiveMessage();
+  EXPECT_EQ(task_runner_.ready_task_count(), 1);
+  task_runner_.RunTasksUntilIdle();
+  EXPECT_EQ(received, messages);
+}
+
+TEST_F(UdpSocketPosixTest, StopsDeliveringBatchWhenDestroyed) {
+  const std::vector<std::vector<uint8_t>> messages = {{1}, {2}, {3}};
+  sender_->SendMessages(messages, receiver_->GetLocalEndpoint());
+
+  EXPECT_CALL(receiver_client_, OnReadInternal(receiver_.get(), _))
+      .WillOnce(Invoke([this](UdpSocket*, const ErrorOr<UdpPacket>& packet) {
+        receiver_.reset();
+      }));
+
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+}
+
+TEST_F(UdpSocketPosixTest, ReportsErrorWhenNothingToRead) {
+  EXPECT_CALL(receiver_client_, OnReadInternal(receiver_.get(), _))
+      .WillOnce(Invoke([](UdpSocket*, const ErrorOr<UdpPacket>& packet) {
+        ASSERT_TRUE(packet.is_error());
+        EXPECT_EQ(packet.error().code(), Error::Code::kAgain);
+      }));
+
+  receiver_->ReceiveMessage();
+  task_runner_.RunTasksUntilIdle();
+}
+
+}  // namespace
+}  // namespace openscreen
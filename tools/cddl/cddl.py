@@ -34,9 +34,11 @@ def main():
 
   if (args.verbose):
     print('Creating C++ files from provided CDDL file...')
-  echoAndRunCommand([args.cddl, "--header", args.header, "--cc", args.cc,
-                     "--gen-dir", args.gen_dir, args.file],
-                     False, log, args.verbose)
+  command = [args.cddl, "--header", args.header, "--cc", args.cc,
+             "--gen-dir", args.gen_dir]
+  if args.views:
+    command.append("--views")
+  echoAndRunCommand(command + [args.file], False, log, args.verbose)
 
   clangFormatLocation = findClangFormat()
   if not clangFormatLocation:
@@ -63,6 +65,8 @@ def parseInput():
      be redirected.")
   parser.add_argument("--verbose", help="Specify that we should log info \
      messages to stdout")
+  parser.add_argument("--views", action="store_true", help="Also generate \
+     view structs, whose strings and bytes point into the decoded buffer.")
   parser.add_argument("file", help="the input file which contains the spec")
   return parser.parse_args()
 
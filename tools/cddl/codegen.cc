@@ -83,6 +83,32 @@ std::string CppTypeToString(const CppType& cpp_type) {
   }
 }
 
+// Returns a string which represents the C++ type of |cpp_type| in a view
+// struct, where strings and bytes point into the buffer the view was decoded
+// from.  Returns an empty string if there is no valid representation for
+// |cpp_type|.
+std::string ViewTypeToString(const CppType& cpp_type) {
+  switch (cpp_type.which) {
+    case CppType::Which::kString:
+      return "absl::string_view";
+    case CppType::Which::kBytes:
+      return "absl::Span<const uint8_t>";
+    case CppType::Which::kVector: {
+      std::string element_string =
+          ViewTypeToString(*cpp_type.vector_type.element_type);
+      if (element_string.empty())
+        return std::string();
+      return "std::vector<" + element_string + ">";
+    }
+    case CppType::Which::kStruct:
+      return ToCamelCase(cpp_type.name) + "View";
+    case CppType::Which::kTaggedType:
+      return ViewTypeToString(*cpp_type.tagged_type.real_type);
+    default:
+      return CppTypeToString(cpp_type);
+  }
+}
+
 bool WriteEnumEqualityOperatorSwitchCases(int fd,
                                           const CppType& parent,
                                           std::string child_name,
@@ -242,12 +268,57 @@ bool WriteStructEqualityOperator(int fd,
   return true;
 }
 
-// Write the C++ struct member definitions of every type in |members| to the
+// Writes the view of the discriminated union |type| as the struct |name| to the
 // file descriptor |fd|.
+bool WriteDiscriminatedUnionView(int fd,
+                                 const std::string& name,
+                                 const CppType& type) {
+  dprintf(fd, "  struct %s {\n", name.c_str());
+  dprintf(fd, "  enum class Which {\n");
+  for (auto* union_member : type.discriminated_union.members) {
+    switch (union_member->which) {
+      case CppType::Which::kUint64:
+        dprintf(fd, "    kUint64,\n");
+        break;
+      case CppType::Which::kString:
+        dprintf(fd, "    kString,\n");
+        break;
+      case CppType::Which::kBytes:
+        dprintf(fd, "    kBytes,\n");
+        break;
+      default:
+        return false;
+    }
+  }
+  dprintf(fd, "    kUninitialized,\n");
+  dprintf(fd, "  } which = Which::kUninitialized;\n");
+  for (auto* union_member : type.discriminated_union.members) {
+    switch (union_member->which) {
+      case CppType::Which::kUint64:
+        dprintf(fd, "    uint64_t uint;\n");
+        break;
+      case CppType::Which::kString:
+        dprintf(fd, "    absl::string_view str;\n");
+        break;
+      case CppType::Which::kBytes:
+        dprintf(fd, "    absl::Span<const uint8_t> bytes;\n");
+        break;
+      default:
+        return false;
+    }
+  }
+  dprintf(fd, "  };\n");
+  return true;
+}
+
+// Write the C++ struct member definitions of every type in |members| to the
+// file descriptor |fd|.  If |as_view| is true, the members are those of the
+// struct's view.
 bool WriteStructMembers(
     int fd,
     const std::string& name,
-    const std::vector<CppType::Struct::CppMember>& members) {
+    const std::vector<CppType::Struct::CppMember>& members,
+    bool as_view) {
   for (const auto& x : members) {
     std::string type_string;
     switch (x.type->which) {
@@ -255,21 +326,28 @@ bool WriteStructMembers(
         if (x.type->struct_type.key_type ==
             CppType::Struct::KeyType::kPlainGroup) {
           if (!WriteStructMembers(fd, x.type->name,
-                                  x.type->struct_type.members))
+                                  x.type->struct_type.members, as_view))
             return false;
           continue;
         } else {
-          type_string = ToCamelCase(x.name);
+          type_string = ToCamelCase(x.name) + (as_view ? "View" : "");
         }
       } break;
       case CppType::Which::kOptional: {
         // TODO(btolsch): Make this optional<T> when one lands.
         dprintf(fd, "  bool has_%s;\n", ToUnderscoreId(x.name).c_str());
-        type_string = CppTypeToString(*x.type->optional_type);
+        type_string = as_view ? ViewTypeToString(*x.type->optional_type)
+                              : CppTypeToString(*x.type->optional_type);
       } break;
       case CppType::Which::kDiscriminatedUnion: {
         std::string cid = ToUnderscoreId(x.name);
         type_string = ToCamelCase(x.name);
+        if (as_view) {
+          // Views don't own their members, so a plain struct will do.
+          if (!WriteDiscriminatedUnionView(fd, type_string, *x.type))
+            return false;
+          break;
+        }
         dprintf(fd, "  struct %s {\n", type_string.c_str());
         dprintf(fd, "    %s();\n    ~%s();\n\n", type_string.c_str(),
                 type_string.c_str());
@@ -319,7 +397,8 @@ bool WriteStructMembers(
         dprintf(fd, "  };\n");
       } break;
       default:
-        type_string = CppTypeToString(*x.type);
+        type_string =
+            as_view ? ViewTypeToString(*x.type) : CppTypeToString(*x.type);
         break;
     }
     if (type_string.empty())
@@ -341,11 +420,15 @@ void WriteEnumMembers(int fd, const CppType& type) {
 }
 
 // Writes a C++ type definition for |type| to the file descriptor |fd|.  This
-// only generates a definition for enums and structs.
-bool WriteTypeDefinition(int fd, const CppType& type) {
+// only generates a definition for enums and structs.  If |as_view| is true,
+// this generates the definition of a struct's view instead, and nothing for
+// enums, which views share with their structs.
+bool WriteTypeDefinition(int fd, const CppType& type, bool as_view) {
   std::string name = ToCamelCase(type.name);
   switch (type.which) {
     case CppType::Which::kEnum: {
+      if (as_view)
+        break;
       dprintf(fd, "\nenum class %s : uint64_t {\n", name.c_str());
       WriteEnumMembers(fd, type);
       dprintf(fd, "};\n");
@@ -353,14 +436,21 @@ bool WriteTypeDefinition(int fd, const CppType& type) {
         return false;
     } break;
     case CppType::Which::kStruct: {
+      if (as_view) {
+        name += "View";
+      }
       dprintf(fd, "\nstruct %s {\n", name.c_str());
       if (type.type_key != absl::nullopt) {
         dprintf(fd, "  // type key: %" PRIu64 "\n", type.type_key.value());
       }
-      dprintf(fd, "  bool operator==(const %s& other) const;\n", name.c_str());
-      dprintf(fd, "  bool operator!=(const %s& other) const;\n\n",
-              name.c_str());
-      if (!WriteStructMembers(fd, type.name, type.struct_type.members))
+      if (!as_view) {
+        dprintf(fd, "  bool operator==(const %s& other) const;\n",
+                name.c_str());
+        dprintf(fd, "  bool operator!=(const %s& other) const;\n\n",
+                name.c_str());
+      }
+      if (!WriteStructMembers(fd, type.name, type.struct_type.members,
+                              as_view))
         return false;
       dprintf(fd, "};\n");
     } break;
@@ -375,23 +465,24 @@ bool WriteTypeDefinition(int fd, const CppType& type) {
 // is done by walking the tree of types defined by |cpp_type| (e.g. all the
 // members for a struct).  |defs| contains the names of types that have already
 // been written.  If a type hasn't been written and needs to be, its name will
-// also be added to |defs|.
+// also be added to |defs|.  |as_view| is passed to WriteTypeDefinition().
 bool EnsureDependentTypeDefinitionsWritten(int fd,
                                            const CppType& cpp_type,
+                                           bool as_view,
                                            std::set<std::string>* defs) {
   switch (cpp_type.which) {
     case CppType::Which::kVector: {
       return EnsureDependentTypeDefinitionsWritten(
-          fd, *cpp_type.vector_type.element_type, defs);
+          fd, *cpp_type.vector_type.element_type, as_view, defs);
     }
     case CppType::Which::kEnum: {
       if (defs->find(cpp_type.name) != defs->end())
         return true;
       for (const auto* x : cpp_type.enum_type.sub_members)
-        if (!EnsureDependentTypeDefinitionsWritten(fd, *x, defs))
+        if (!EnsureDependentTypeDefinitionsWritten(fd, *x, as_view, defs))
           return false;
       defs->emplace(cpp_type.name);
-      WriteTypeDefinition(fd, cpp_type);
+      WriteTypeDefinition(fd, cpp_type, as_view);
     } break;
     case CppType::Which::kStruct: {
       if (cpp_type.struct_type.key_type !=
@@ -399,24 +490,25 @@ bool EnsureDependentTypeDefinitionsWritten(int fd,
         if (defs->find(cpp_type.name) != defs->end())
           return true;
         for (const auto& x : cpp_type.struct_type.members)
-          if (!EnsureDependentTypeDefinitionsWritten(fd, *x.type, defs))
+          if (!EnsureDependentTypeDefinitionsWritten(fd, *x.type, as_view,
+                                                     defs))
             return false;
         defs->emplace(cpp_type.name);
-        WriteTypeDefinition(fd, cpp_type);
+        WriteTypeDefinition(fd, cpp_type, as_view);
       }
     } break;
     case CppType::Which::kOptional: {
       return EnsureDependentTypeDefinitionsWritten(fd, *cpp_type.optional_type,
-                                                   defs);
+                                                   as_view, defs);
     }
     case CppType::Which::kDiscriminatedUnion: {
       for (const auto* x : cpp_type.discriminated_union.members)
-        if (!EnsureDependentTypeDefinitionsWritten(fd, *x, defs))
+        if (!EnsureDependentTypeDefinitionsWritten(fd, *x, as_view, defs))
           return false;
     } break;
     case CppType::Which::kTaggedType: {
       if (!EnsureDependentTypeDefinitionsWritten(
-              fd, *cpp_type.tagged_type.real_type, defs)) {
+              fd, *cpp_type.tagged_type.real_type, as_view, defs)) {
         return false;
       }
     } break;
@@ -450,7 +542,7 @@ bool WriteTypeDefinitions(int fd, CppSymbolTable* table) {
             CppType::Struct::KeyType::kPlainGroup) {
       continue;
     }
-    if (!EnsureDependentTypeDefinitionsWritten(fd, *real_type, &defs))
+    if (!EnsureDependentTypeDefinitionsWritten(fd, *real_type, false, &defs))
       return false;
   }
 
@@ -461,6 +553,48 @@ bool WriteTypeDefinitions(int fd, CppSymbolTable* table) {
             type->type_key.value());
   }
   dprintf(fd, "};\n");
+
+  // Type keys are sparse, so tables indexed by type use this dense index.
+  const std::vector<CppType*> types = table->TypesWithId();
+  dprintf(fd, "\nconstexpr size_t kNumTypes = %zu;\n", types.size());
+  dprintf(fd,
+          "\n// Returns a distinct index below kNumTypes for each known Type, "
+          "or kNumTypes\n// for Type::kUnknown.\n");
+  dprintf(fd, "constexpr size_t GetTypeIndex(Type type) {\n");
+  dprintf(fd, "  switch (type) {\n");
+  for (size_t i = 0; i < types.size(); ++i) {
+    dprintf(fd, "    case Type::k%s: return %zu;\n",
+            ToCamelCase(types[i]->name).c_str(), i);
+  }
+  dprintf(fd, "    default: return kNumTypes;\n");
+  dprintf(fd, "  }\n}\n");
+
+  dprintf(fd, "\n// Every known Type, in the order given by GetTypeIndex().\n");
+  dprintf(fd, "constexpr Type kAllTypes[kNumTypes] = {\n");
+  for (CppType* type : types) {
+    dprintf(fd, "    Type::k%s,\n", ToCamelCase(type->name).c_str());
+  }
+  dprintf(fd, "};\n");
+  return true;
+}
+
+// Writes the view struct definition for every C++ struct type in |table|, in
+// the same order as WriteTypeDefinitions().
+bool WriteViewTypeDefinitions(int fd, CppSymbolTable* table) {
+  dprintf(fd,
+          "\n// Views of the types above, whose strings and bytes point into "
+          "the buffer\n// they were decoded from, rather than being copied. "
+          "A view may only be used\n// while that buffer is.\n");
+  std::set<std::string> defs;
+  for (const std::unique_ptr<CppType>& real_type : table->cpp_types) {
+    if (real_type->which != CppType::Which::kStruct ||
+        real_type->struct_type.key_type ==
+            CppType::Struct::KeyType::kPlainGroup) {
+      continue;
+    }
+    if (!EnsureDependentTypeDefinitionsWritten(fd, *real_type, true, &defs))
+      return false;
+  }
   return true;
 }
 
@@ -481,8 +615,53 @@ bool WriteTypeParserDefinition(int fd, CppSymbolTable* table) {
   return true;
 }
 
+// Writes a function template which decodes a message of any Type with a
+// single switch, and passes the result to a handler whose overload for each
+// message struct is chosen at compile time.  The messages are decoded into
+// their views if |as_view| is true.
+bool WriteDispatcher(int fd, CppSymbolTable* table, bool as_view) {
+  const char* const suffix = as_view ? "View" : "";
+  dprintf(fd,
+          "\n// Decodes the message of type |type| at the start of |buffer|, "
+          "and calls\n// |handler| with it.  |handler| must accept a "
+          "reference to any of the %s\n// above.  Returns what the Decode "
+          "function for |type| returns, or\n// kParserUnknownType if |type| "
+          "isn't known.  |handler| is only called if the\n// message is "
+          "decoded.\n",
+          as_view ? "views" : "message structs");
+  dprintf(fd, "template <typename Handler>\n");
+  dprintf(fd, "ssize_t Decode%sAndDispatch(Type type,\n", suffix);
+  dprintf(fd, "    const uint8_t* buffer,\n    size_t length,\n");
+  dprintf(fd, "    Handler&& handler) {\n");
+  dprintf(fd, "  switch (type) {\n");
+  for (CppType* real_type : table->TypesWithId()) {
+    if (real_type->which != CppType::Which::kStruct ||
+        real_type->struct_type.key_type ==
+            CppType::Struct::KeyType::kPlainGroup) {
+      return false;
+    }
+    const std::string cpp_name = ToCamelCase(real_type->name) + suffix;
+    dprintf(fd, "    case Type::k%s: {\n",
+            ToCamelCase(real_type->name).c_str());
+    dprintf(fd, "      %s message;\n", cpp_name.c_str());
+    dprintf(fd,
+            "      const ssize_t result = Decode%s(buffer, length, "
+            "&message);\n",
+            cpp_name.c_str());
+    dprintf(fd, "      if (result >= 0) {\n");
+    dprintf(fd, "        handler(message);\n");
+    dprintf(fd, "      }\n");
+    dprintf(fd, "      return result;\n");
+    dprintf(fd, "    }\n");
+  }
+  dprintf(fd, "    default:\n");
+  dprintf(fd, "      return kParserUnknownType;\n");
+  dprintf(fd, "  }\n}\n");
+  return true;
+}
+
 // Writes the function prototypes for the encode and decode functions for each
-// type in |table| to the file descriptor |fd|.
+// type in |table|, and the dispatcher over them, to the file descriptor |fd|.
 bool WriteFunctionDeclarations(int fd, CppSymbolTable* table) {
   for (CppType* real_type : table->TypesWithId()) {
     const auto& name = real_type->name;
@@ -498,11 +677,30 @@ bool WriteFunctionDeclarations(int fd, CppSymbolTable* table) {
     dprintf(fd, "ssize_t Encode%s(\n", cpp_name.c_str());
     dprintf(fd, "    const %s& data,\n", cpp_name.c_str());
     dprintf(fd, "    uint8_t* buffer,\n    size_t length);\n");
+    dprintf(fd, "size_t EncodedSize%s(const %s& data);\n", cpp_name.c_str(),
+            cpp_name.c_str());
     dprintf(fd, "ssize_t Decode%s(\n", cpp_name.c_str());
     dprintf(fd, "    const uint8_t* buffer,\n    size_t length,\n");
     dprintf(fd, "    %s* data);\n", cpp_name.c_str());
   }
-  return true;
+  return WriteDispatcher(fd, table, false);
+}
+
+// Writes the prototypes for the view decode functions for each type in |table|,
+// and the dispatcher over them, to the file descriptor |fd|.
+bool WriteViewFunctionDeclarations(int fd, CppSymbolTable* table) {
+  for (CppType* real_type : table->TypesWithId()) {
+    if (real_type->which != CppType::Which::kStruct ||
+        real_type->struct_type.key_type ==
+            CppType::Struct::KeyType::kPlainGroup) {
+      return false;
+    }
+    std::string cpp_name = ToCamelCase(real_type->name);
+    dprintf(fd, "\nssize_t Decode%sView(\n", cpp_name.c_str());
+    dprintf(fd, "    const uint8_t* buffer,\n    size_t length,\n");
+    dprintf(fd, "    %sView* data);\n", cpp_name.c_str());
+  }
+  return WriteDispatcher(fd, table, true);
 }
 
 bool WriteMapEncoder(int fd,
@@ -849,6 +1047,190 @@ bool WriteArrayEncoder(int fd,
   return true;
 }
 
+// Returns the size of the CBOR head encoding |value| as a major type argument.
+uint64_t CborHeadSize(uint64_t value) {
+  if (value < 24) {
+    return 1;
+  } else if (value <= UINT8_MAX) {
+    return 2;
+  } else if (value <= UINT16_MAX) {
+    return 3;
+  } else if (value <= UINT32_MAX) {
+    return 5;
+  }
+  return 9;
+}
+
+bool WriteGroupEncodedSize(
+    int fd,
+    const std::string& name,
+    const std::vector<CppType::Struct::CppMember>& members,
+    const std::string& nested_type_scope,
+    bool is_map);
+
+// Writes the statements adding the encoded size of the C++ type |cpp_type| to
+// the local |size| to the file descriptor |fd|.  This mirrors WriteEncoder(),
+// and the resulting size is exactly what it would encode.  |name| is the C++
+// variable name whose size is needed.  |nested_type_scope| is the closest C++
+// scope name (i.e. struct name), which may be used to access local enum
+// constants.
+bool WriteEncodedSize(int fd,
+                      const std::string& name,
+                      const CppType& cpp_type,
+                      const std::string& nested_type_scope) {
+  switch (cpp_type.which) {
+    case CppType::Which::kStruct:
+      if (cpp_type.struct_type.key_type == CppType::Struct::KeyType::kMap) {
+        return WriteGroupEncodedSize(fd, name, cpp_type.struct_type.members,
+                                     cpp_type.name, true);
+      } else if (cpp_type.struct_type.key_type ==
+                 CppType::Struct::KeyType::kArray) {
+        return WriteGroupEncodedSize(fd, name, cpp_type.struct_type.members,
+                                     cpp_type.name, false);
+      } else {
+        for (const auto& x : cpp_type.struct_type.members) {
+          if (x.integer_key.has_value()) {
+            dprintf(fd, "  size += %" PRIu64 ";\n",
+                    CborHeadSize(x.integer_key.value()));
+          } else {
+            dprintf(fd, "  size += %" PRIu64 ";\n",
+                    CborHeadSize(x.name.size()) + x.name.size());
+          }
+          if (!WriteEncodedSize(fd, name + "." + ToUnderscoreId(x.name),
+                                *x.type, nested_type_scope)) {
+            return false;
+          }
+        }
+        return true;
+      }
+    case CppType::Which::kUint64:
+      dprintf(fd, "  size += CborHeadSize(%s);\n",
+              ToUnderscoreId(name).c_str());
+      return true;
+    case CppType::Which::kString:
+    case CppType::Which::kBytes: {
+      std::string cid = ToUnderscoreId(name);
+      dprintf(fd, "  size += CborHeadSize(%s.size()) + %s.size();\n",
+              cid.c_str(), cid.c_str());
+      return true;
+    }
+    case CppType::Which::kVector: {
+      std::string cid = ToUnderscoreId(name);
+      dprintf(fd, "  size += CborHeadSize(%s.size());\n", cid.c_str());
+      dprintf(fd, "  for (const auto& x : %s) {\n", cid.c_str());
+      if (!WriteEncodedSize(fd, "x", *cpp_type.vector_type.element_type,
+                            nested_type_scope)) {
+        return false;
+      }
+      dprintf(fd, "  }\n");
+      return true;
+    }
+    case CppType::Which::kEnum: {
+      dprintf(fd, "  size += CborHeadSize(static_cast<uint64_t>(%s));\n",
+              ToUnderscoreId(name).c_str());
+      return true;
+    }
+    case CppType::Which::kDiscriminatedUnion: {
+      for (const auto* union_member : cpp_type.discriminated_union.members) {
+        std::string which;
+        std::string member_name;
+        switch (union_member->which) {
+          case CppType::Which::kUint64:
+            which = "kUint64";
+            member_name = name + ".uint";
+            break;
+          case CppType::Which::kString:
+            which = "kString";
+            member_name = name + ".str";
+            break;
+          case CppType::Which::kBytes:
+            which = "kBytes";
+            member_name = name + ".bytes";
+            break;
+          default:
+            return false;
+        }
+        dprintf(fd, "  case %s::%s::Which::%s:\n",
+                ToCamelCase(nested_type_scope).c_str(),
+                ToCamelCase(cpp_type.name).c_str(), which.c_str());
+        if (!WriteEncodedSize(fd, ToUnderscoreId(member_name), *union_member,
+                              nested_type_scope)) {
+          return false;
+        }
+        dprintf(fd, "    break;\n");
+      }
+      // Encoding an uninitialized union fails, so its size doesn't matter.
+      dprintf(fd, "  case %s::%s::Which::kUninitialized:\n",
+              ToCamelCase(nested_type_scope).c_str(),
+              ToCamelCase(cpp_type.name).c_str());
+      dprintf(fd, "    break;\n");
+      return true;
+    }
+    case CppType::Which::kTaggedType: {
+      dprintf(fd, "  size += %" PRIu64 ";\n",
+              CborHeadSize(cpp_type.tagged_type.tag));
+      return WriteEncodedSize(fd, name, *cpp_type.tagged_type.real_type,
+                              nested_type_scope);
+    }
+    default:
+      break;
+  }
+  return false;
+}
+
+// Writes the statements adding the encoded size of a CBOR map (if |is_map|) or
+// array with the C++ type members in |members| to the local |size| to the file
+// descriptor |fd|, mirroring WriteMapEncoder() and WriteArrayEncoder().
+bool WriteGroupEncodedSize(
+    int fd,
+    const std::string& name,
+    const std::vector<CppType::Struct::CppMember>& members,
+    const std::string& nested_type_scope,
+    bool is_map) {
+  std::string name_id = ToUnderscoreId(name);
+  MemberCountResult member_counts = CountMemberTypes(fd, name_id, members);
+  if (member_counts.num_optional == 0) {
+    dprintf(fd, "  size += %" PRIu64 ";\n",
+            CborHeadSize(member_counts.num_required));
+  } else {
+    dprintf(fd, "  size += CborHeadSize(%d + num_optionals_present);\n",
+            member_counts.num_required);
+  }
+
+  for (const auto& x : members) {
+    std::string fullname = name;
+    CppType* member_type = x.type;
+    if (x.type->which != CppType::Which::kStruct ||
+        x.type->struct_type.key_type != CppType::Struct::KeyType::kPlainGroup) {
+      if (x.type->which == CppType::Which::kOptional) {
+        member_type = x.type->optional_type;
+        dprintf(fd, "  if (%s.has_%s) {\n", name_id.c_str(),
+                ToUnderscoreId(x.name).c_str());
+      }
+      if (is_map) {
+        const uint64_t key_size =
+            x.integer_key.has_value()
+                ? CborHeadSize(x.integer_key.value())
+                : CborHeadSize(x.name.size()) + x.name.size();
+        dprintf(fd, "  size += %" PRIu64 ";\n", key_size);
+      }
+      if (x.type->which == CppType::Which::kDiscriminatedUnion) {
+        dprintf(fd, "  switch (%s.%s.which) {\n", fullname.c_str(),
+                x.name.c_str());
+      }
+      fullname = fullname + "." + x.name;
+    }
+    if (!WriteEncodedSize(fd, fullname, *member_type, nested_type_scope)) {
+      return false;
+    }
+    if (x.type->which == CppType::Which::kOptional ||
+        x.type->which == CppType::Which::kDiscriminatedUnion) {
+      dprintf(fd, "  }\n");
+    }
+  }
+  return true;
+}
+
 uint8_t GetByte(uint64_t value, size_t byte) {
   return static_cast<uint8_t>((value >> (byte * 8)) & 0xFF);
 }
@@ -945,27 +1327,26 @@ bool WriteEncoders(int fd, CppSymbolTable* table) {
 bool Encode%1$s(
     const %1$s& data,
     CborEncodeBuffer* buffer) {
+  const uint8_t type_id[] = %2$s;
+  const size_t encoded_size = EncodedSize%1$s(data);
   if (buffer->AvailableLength() == 0 &&
-      !buffer->Append(CborEncodeBuffer::kDefaultInitialEncodeBufferSize))
+      !buffer->Append(sizeof(type_id) + encoded_size))
     return false;
-  const uint8_t type_id[] = %2$s;
   if(!buffer->SetType(type_id, sizeof(type_id))) {
     return false;
   }
-  while (true) {
-    size_t available_length = buffer->AvailableLength();
-    ssize_t error_or_size = msgs::Encode%1$s(
-        data, buffer->Position(), available_length);
-    if (IsError(error_or_size)) {
-      return false;
-    } else if (error_or_size > static_cast<ssize_t>(available_length)) {
-      if (!buffer->ResizeBy(error_or_size - available_length))
-        return false;
-    } else {
-      buffer->ResizeBy(error_or_size - available_length);
-      return true;
-    }
+  // Size the buffer exactly, so the message is encoded in a single pass.
+  if (!buffer->ResizeBy(static_cast<ssize_t>(encoded_size) -
+                        static_cast<ssize_t>(buffer->AvailableLength()))) {
+    return false;
   }
+  ssize_t error_or_size = msgs::Encode%1$s(
+      data, buffer->Position(), encoded_size);
+  if (IsError(error_or_size)) {
+    return false;
+  }
+  OSP_DCHECK_EQ(static_cast<size_t>(error_or_size), encoded_size);
+  return true;
 }
 )";
 
@@ -1004,22 +1385,63 @@ bool Encode%1$s(
             "buffer));\n");
     dprintf(fd, "  }\n");
     dprintf(fd, "}\n");
+
+    dprintf(fd, "\nsize_t EncodedSize%s(const %s& data) {\n", cpp_name.c_str(),
+            cpp_name.c_str());
+    dprintf(fd, "  size_t size = 0;\n");
+    if (!WriteGroupEncodedSize(
+            fd, "data", real_type->struct_type.members, name,
+            real_type->struct_type.key_type ==
+                CppType::Struct::KeyType::kMap)) {
+      return false;
+    }
+    dprintf(fd, "  return size;\n");
+    dprintf(fd, "}\n");
   }
   return true;
 }
 
+// Writes the decoding of the definite length string at |it<decoder_depth>| to
+// the file descriptor |fd|, as a |view_type| pointing into the buffer being
+// decoded.  |name| is the C++ variable name of the view, and
+// |length<temp_length>| has already been declared.
+void WriteStringViewDecoder(int fd,
+                            const std::string& name,
+                            const char* view_type,
+                            const char* pointer_type,
+                            int decoder_depth,
+                            int temp_length) {
+  dprintf(fd, "  if (!cbor_value_is_length_known(&it%d)) {\n", decoder_depth);
+  dprintf(fd, "    return -CborErrorUnknownLength;\n");
+  dprintf(fd, "  }\n");
+  dprintf(fd,
+          "  CBOR_RETURN_ON_ERROR(cbor_value_get_string_length(&it%d, "
+          "&length%d));\n",
+          decoder_depth, temp_length);
+  dprintf(fd, "  CBOR_RETURN_ON_ERROR(cbor_value_advance(&it%d));\n",
+          decoder_depth);
+  // The contents of a definite length string end where the next value starts.
+  dprintf(fd,
+          "  %s = %s(reinterpret_cast<%s>(cbor_value_get_next_byte(&it%d)) - "
+          "length%d, length%d);\n",
+          name.c_str(), view_type, pointer_type, decoder_depth, temp_length,
+          temp_length);
+}
+
 bool WriteMapDecoder(int fd,
                      const std::string& name,
                      const std::string& member_accessor,
                      const std::vector<CppType::Struct::CppMember>& members,
                      int decoder_depth,
-                     int* temporary_count);
+                     int* temporary_count,
+                     bool as_view);
 bool WriteArrayDecoder(int fd,
                        const std::string& name,
                        const std::string& member_accessor,
                        const std::vector<CppType::Struct::CppMember>& members,
                        int decoder_depth,
-                       int* temporary_count);
+                       int* temporary_count,
+                       bool as_view);
 
 // Writes the decoding function for the C++ type |cpp_type| to the file
 // descriptor |fd|.  |name| is the C++ variable name that needs to be encoded.
@@ -1027,13 +1449,15 @@ bool WriteArrayDecoder(int fd,
 // pointer type.  |decoder_depth| is used to independently name independent cbor
 // decoders that need to be created.  |temporary_count| is used to ensure
 // temporaries get unique names by appending an automatically incremented
-// integer.
+// integer.  If |as_view| is true, |name| is a view, and strings and bytes are
+// pointed to rather than copied.
 bool WriteDecoder(int fd,
                   const std::string& name,
                   const std::string& member_accessor,
                   const CppType& cpp_type,
                   int decoder_depth,
-                  int* temporary_count) {
+                  int* temporary_count,
+                  bool as_view) {
   switch (cpp_type.which) {
     case CppType::Which::kUint64: {
       dprintf(fd,
@@ -1050,6 +1474,11 @@ bool WriteDecoder(int fd,
               "  CBOR_RETURN_ON_ERROR(cbor_value_validate(&it%d, "
               "CborValidateUtf8));\n",
               decoder_depth);
+      if (as_view) {
+        WriteStringViewDecoder(fd, name, "absl::string_view", "const char*",
+                               decoder_depth, temp_length);
+        return true;
+      }
       dprintf(fd, "  if (cbor_value_is_length_known(&it%d)) {\n",
               decoder_depth);
       dprintf(fd,
@@ -1077,6 +1506,21 @@ bool WriteDecoder(int fd,
     case CppType::Which::kBytes: {
       int temp_length = (*temporary_count)++;
       dprintf(fd, "  size_t length%d = 0;", temp_length);
+      if (as_view) {
+        if (cpp_type.bytes_type.fixed_size) {
+          dprintf(fd,
+                  "  CBOR_RETURN_ON_ERROR(cbor_value_get_string_length(&it%d, "
+                  "&length%d));\n",
+                  decoder_depth, temp_length);
+          dprintf(fd, "  if (length%d != %d) {\n", temp_length,
+                  static_cast<int>(cpp_type.bytes_type.fixed_size.value()));
+          dprintf(fd, "    return -CborErrorImproperValue;\n");
+          dprintf(fd, "  }\n");
+        }
+        WriteStringViewDecoder(fd, name, "absl::Span<const uint8_t>",
+                               "const uint8_t*", decoder_depth, temp_length);
+        return true;
+      }
       dprintf(fd, "  if (cbor_value_is_length_known(&it%d)) {\n",
               decoder_depth);
       dprintf(fd,
@@ -1147,7 +1591,7 @@ bool WriteDecoder(int fd,
               name.c_str(), member_accessor.c_str(), name.c_str(),
               member_accessor.c_str());
       if (!WriteDecoder(fd, "(*i)", ".", *cpp_type.vector_type.element_type,
-                        decoder_depth + 1, temporary_count)) {
+                        decoder_depth + 1, temporary_count, as_view)) {
         return false;
       }
       dprintf(fd, "  }\n");
@@ -1172,12 +1616,12 @@ bool WriteDecoder(int fd,
       if (cpp_type.struct_type.key_type == CppType::Struct::KeyType::kMap) {
         return WriteMapDecoder(fd, name, member_accessor,
                                cpp_type.struct_type.members, decoder_depth + 1,
-                               temporary_count);
+                               temporary_count, as_view);
       } else if (cpp_type.struct_type.key_type ==
                  CppType::Struct::KeyType::kArray) {
         return WriteArrayDecoder(fd, name, member_accessor,
                                  cpp_type.struct_type.members,
-                                 decoder_depth + 1, temporary_count);
+                                 decoder_depth + 1, temporary_count, as_view);
       }
     } break;
     case CppType::Which::kDiscriminatedUnion: {
@@ -1199,7 +1643,7 @@ bool WriteDecoder(int fd,
             dprintf(fd, "  %s.which = decltype(%s)::Which::kUint64;\n",
                     name.c_str(), name.c_str());
             if (!WriteDecoder(fd, name + ".uint", ".", *x, decoder_depth,
-                              temporary_count)) {
+                              temporary_count, as_view)) {
               return false;
             }
             break;
@@ -1209,9 +1653,11 @@ bool WriteDecoder(int fd,
             dprintf(fd, "  %s.which = decltype(%s)::Which::kString;\n",
                     name.c_str(), name.c_str());
             std::string str_name = name + ".str";
-            dprintf(fd, "  new (&%s) std::string();\n", str_name.c_str());
+            if (!as_view) {
+              dprintf(fd, "  new (&%s) std::string();\n", str_name.c_str());
+            }
             if (!WriteDecoder(fd, str_name, ".", *x, decoder_depth,
-                              temporary_count)) {
+                              temporary_count, as_view)) {
               return false;
             }
           } break;
@@ -1221,10 +1667,12 @@ bool WriteDecoder(int fd,
             std::string bytes_name = name + ".bytes";
             dprintf(fd, "  %s.which = decltype(%s)::Which::kBytes;\n",
                     name.c_str(), name.c_str());
-            dprintf(fd, "  new (&%s) std::vector<uint8_t>();\n",
-                    bytes_name.c_str());
+            if (!as_view) {
+              dprintf(fd, "  new (&%s) std::vector<uint8_t>();\n",
+                      bytes_name.c_str());
+            }
             if (!WriteDecoder(fd, bytes_name, ".", *x, decoder_depth,
-                              temporary_count)) {
+                              temporary_count, as_view)) {
               return false;
             }
           } break;
@@ -1249,7 +1697,7 @@ bool WriteDecoder(int fd,
               decoder_depth);
       if (!WriteDecoder(fd, name, member_accessor,
                         *cpp_type.tagged_type.real_type, decoder_depth,
-                        temporary_count)) {
+                        temporary_count, as_view)) {
         return false;
       }
       return true;
@@ -1266,13 +1714,14 @@ bool WriteDecoder(int fd,
 // is a pointer type.  |decoder_depth| is used to independently name independent
 // cbor decoders that need to be created.  |temporary_count| is used to ensure
 // temporaries get unique names by appending an automatically incremented
-// integer.
+// integer.  |as_view| is passed to WriteDecoder().
 bool WriteMapDecoder(int fd,
                      const std::string& name,
                      const std::string& member_accessor,
                      const std::vector<CppType::Struct::CppMember>& members,
                      int decoder_depth,
-                     int* temporary_count) {
+                     int* temporary_count,
+                     bool as_view) {
   dprintf(fd, "  if (cbor_value_get_type(&it%d) != CborMapType) {\n",
           decoder_depth - 1);
   dprintf(fd, "    return -1;\n");
@@ -1323,7 +1772,7 @@ bool WriteMapDecoder(int fd,
       dprintf(fd, "    %s%shas_%s = true;\n", name.c_str(),
               member_accessor.c_str(), cid.c_str());
       if (!WriteDecoder(fd, fullname, ".", *x.type->optional_type,
-                        decoder_depth, temporary_count)) {
+                        decoder_depth, temporary_count, as_view)) {
         return false;
       }
       dprintf(fd, "  } else {\n");
@@ -1342,7 +1791,7 @@ bool WriteMapDecoder(int fd,
                 decoder_depth, x.name.c_str());
       }
       if (!WriteDecoder(fd, fullname, ".", *x.type, decoder_depth,
-                        temporary_count)) {
+                        temporary_count, as_view)) {
         return false;
       }
     }
@@ -1360,13 +1809,14 @@ bool WriteMapDecoder(int fd,
 // is a pointer type.  |decoder_depth| is used to independently name independent
 // cbor decoders that need to be created.  |temporary_count| is used to ensure
 // temporaries get unique names by appending an automatically incremented
-// integer.
+// integer.  |as_view| is passed to WriteDecoder().
 bool WriteArrayDecoder(int fd,
                        const std::string& name,
                        const std::string& member_accessor,
                        const std::vector<CppType::Struct::CppMember>& members,
                        int decoder_depth,
-                       int* temporary_count) {
+                       int* temporary_count,
+                       bool as_view) {
   dprintf(fd, "  if (cbor_value_get_type(&it%d) != CborArrayType) {\n",
           decoder_depth - 1);
   dprintf(fd, "    return -1;\n");
@@ -1410,7 +1860,7 @@ bool WriteArrayDecoder(int fd,
       dprintf(fd, "    %s%shas_%s = true;\n", name.c_str(),
               member_accessor.c_str(), cid.c_str());
       if (!WriteDecoder(fd, fullname, ".", *x.type->optional_type,
-                        decoder_depth, temporary_count)) {
+                        decoder_depth, temporary_count, as_view)) {
         return false;
       }
       dprintf(fd, "  } else {\n");
@@ -1419,7 +1869,7 @@ bool WriteArrayDecoder(int fd,
       dprintf(fd, "  }\n");
     } else {
       if (!WriteDecoder(fd, fullname, ".", *x.type, decoder_depth,
-                        temporary_count)) {
+                        temporary_count, as_view)) {
         return false;
       }
     }
@@ -1446,6 +1896,40 @@ bool WriteEqualityOperators(int fd, CppSymbolTable* table) {
   return true;
 }
 
+// Writes the decoder function definition for |type| to the file descriptor
+// |fd|, which decodes into its view if |as_view| is true.
+bool WriteDecodeFunction(int fd, const CppType& type, bool as_view) {
+  int temporary_count = 0;
+  std::string cpp_name = ToCamelCase(type.name) + (as_view ? "View" : "");
+  dprintf(fd, "\nssize_t Decode%s(\n", cpp_name.c_str());
+  dprintf(fd, "    const uint8_t* buffer,\n    size_t length,\n");
+  dprintf(fd, "    %s* data) {\n", cpp_name.c_str());
+  dprintf(fd, "  CborParser parser;\n");
+  dprintf(fd, "  CborValue it0;\n");
+  dprintf(
+      fd,
+      "  CBOR_RETURN_ON_ERROR(cbor_parser_init(buffer, length, 0, &parser, "
+      "&it0));\n");
+  if (type.struct_type.key_type == CppType::Struct::KeyType::kMap) {
+    if (!WriteMapDecoder(fd, "data", "->", type.struct_type.members, 1,
+                         &temporary_count, as_view)) {
+      return false;
+    }
+  } else {
+    if (!WriteArrayDecoder(fd, "data", "->", type.struct_type.members, 1,
+                           &temporary_count, as_view)) {
+      return false;
+    }
+  }
+  dprintf(
+      fd,
+      "  auto result = static_cast<ssize_t>(cbor_value_get_next_byte(&it0) - "
+      "buffer);\n");
+  dprintf(fd, "  return result;\n");
+  dprintf(fd, "}\n");
+  return true;
+}
+
 // Writes a decoder function definition for every type in |table| to the file
 // descriptor |fd|.
 bool WriteDecoders(int fd, CppSymbolTable* table) {
@@ -1453,40 +1937,30 @@ bool WriteDecoders(int fd, CppSymbolTable* table) {
     return false;
   }
   for (CppType* real_type : table->TypesWithId()) {
-    const auto& name = real_type->name;
-    int temporary_count = 0;
     if (real_type->which != CppType::Which::kStruct ||
         real_type->struct_type.key_type ==
             CppType::Struct::KeyType::kPlainGroup) {
       continue;
     }
-    std::string cpp_name = ToCamelCase(name);
-    dprintf(fd, "\nssize_t Decode%s(\n", cpp_name.c_str());
-    dprintf(fd, "    const uint8_t* buffer,\n    size_t length,\n");
-    dprintf(fd, "    %s* data) {\n", cpp_name.c_str());
-    dprintf(fd, "  CborParser parser;\n");
-    dprintf(fd, "  CborValue it0;\n");
-    dprintf(
-        fd,
-        "  CBOR_RETURN_ON_ERROR(cbor_parser_init(buffer, length, 0, &parser, "
-        "&it0));\n");
-    if (real_type->struct_type.key_type == CppType::Struct::KeyType::kMap) {
-      if (!WriteMapDecoder(fd, "data", "->", real_type->struct_type.members, 1,
-                           &temporary_count)) {
-        return false;
-      }
-    } else {
-      if (!WriteArrayDecoder(fd, "data", "->", real_type->struct_type.members,
-                             1, &temporary_count)) {
-        return false;
-      }
+    if (!WriteDecodeFunction(fd, *real_type, false)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes a view decoder function definition for every type in |table| to the
+// file descriptor |fd|.
+bool WriteViewDecoders(int fd, CppSymbolTable* table) {
+  for (CppType* real_type : table->TypesWithId()) {
+    if (real_type->which != CppType::Which::kStruct ||
+        real_type->struct_type.key_type ==
+            CppType::Struct::KeyType::kPlainGroup) {
+      continue;
+    }
+    if (!WriteDecodeFunction(fd, *real_type, true)) {
+      return false;
     }
-    dprintf(
-        fd,
-        "  auto result = static_cast<ssize_t>(cbor_value_get_next_byte(&it0) - "
-        "buffer);\n");
-    dprintf(fd, "  return result;\n");
-    dprintf(fd, "}\n");
   }
   return true;
 }
@@ -1516,6 +1990,8 @@ bool WriteHeaderPrologue(int fd, const std::string& header_filename) {
 #include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "third_party/tinycbor/src/src/cbor.h"
 
 namespace openscreen {
@@ -1523,6 +1999,7 @@ namespace msgs {
 
 enum CborErrors {
   kParserEOF = -CborErrorUnexpectedEOF,
+  kParserUnknownType = -CborErrorUnknownType,
 };
 
 class CborEncodeBuffer;
@@ -1567,6 +2044,9 @@ class CborEncodeBuffer {
 CborError ExpectKey(CborValue* it, const uint64_t key);
 CborError ExpectKey(CborValue* it, const char* key, size_t key_length);
 
+// Returns whether |s| is valid UTF-8, as the contents of text strings must be.
+bool IsValidUtf8(absl::string_view s);
+
 }  // namespace msgs
 }  // namespace openscreen
 #endif  // %s)";
@@ -1606,7 +2086,24 @@ namespace {
 #define EXPECT_KEY_CONSTANT(it, key) ExpectKey(it, key, sizeof(key) - 1)
 #define EXPECT_INT_KEY_CONSTANT(it, key) ExpectKey(it, key)
 
-bool IsValidUtf8(const std::string& s) {
+// Returns the size of the CBOR head encoding |value|, which is followed by the
+// contents of strings, arrays, and maps.
+size_t CborHeadSize(uint64_t value) {
+  if (value < 24) {
+    return 1;
+  } else if (value <= UINT8_MAX) {
+    return 2;
+  } else if (value <= UINT16_MAX) {
+    return 3;
+  } else if (value <= UINT32_MAX) {
+    return 5;
+  }
+  return 9;
+}
+
+}  // namespace
+
+bool IsValidUtf8(absl::string_view s) {
   const uint8_t* buffer = reinterpret_cast<const uint8_t*>(s.data());
   const uint8_t* end = buffer + s.size();
   while (buffer < end) {
@@ -1617,7 +2114,6 @@ bool IsValidUtf8(const std::string& s) {
   }
   return true;
 }
-}  // namespace
 
 CborError ExpectKey(CborValue* it, const uint64_t key) {
   if  (!cbor_value_is_unsigned_integer(it))
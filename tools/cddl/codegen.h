@@ -8,9 +8,12 @@
 #include "tools/cddl/sema.h"
 
 bool WriteTypeDefinitions(int fd, CppSymbolTable* table);
+bool WriteViewTypeDefinitions(int fd, CppSymbolTable* table);
 bool WriteFunctionDeclarations(int fd, CppSymbolTable* table);
+bool WriteViewFunctionDeclarations(int fd, CppSymbolTable* table);
 bool WriteEncoders(int fd, CppSymbolTable* table);
 bool WriteDecoders(int fd, CppSymbolTable* table);
+bool WriteViewDecoders(int fd, CppSymbolTable* table);
 bool WriteEqualityOperators(int fd, CppSymbolTable* table);
 bool WriteHeaderPrologue(int fd, const std::string& header_filename);
 bool WriteHeaderEpilogue(int fd, const std::string& header_filename);
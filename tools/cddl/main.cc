@@ -42,6 +42,7 @@ struct CommandLineArguments {
   std::string cc_filename;
   std::string gen_dir;
   std::string cddl_filename;
+  bool views = false;
 };
 
 CommandLineArguments ParseCommandLineArguments(int argc, char** argv) {
@@ -85,6 +86,10 @@ CommandLineArguments ParseCommandLineArguments(int argc, char** argv) {
       --argc;
       ++argv;
       result.gen_dir = *argv;
+    } else if (strcmp(*argv, "--views") == 0) {
+      // Also generate view structs, and decoders which point them into the
+      // decoded buffer instead of copying strings and bytes.
+      result.views = true;
     } else if (!result.cddl_filename.empty()) {
       return {};
     } else {
@@ -110,9 +115,9 @@ int main(int argc, char** argv) {
   if (args.cddl_filename.empty()) {
     std::cerr << "Usage: " << std::endl
               << "cddl --header parsed.h --cc parsed.cc --gen-dir "
-                 "output/generated input.cddl"
+                 "output/generated [--views] input.cddl"
               << std::endl
-              << "All flags are required." << std::endl
+              << "All flags except --views are required." << std::endl
               << "Example: " << std::endl
               << "./cddl --header osp_messages.h --cc osp_messages.cc "
                  "--gen-dir gen/msgs ../../msgs/osp_messages.cddl"
@@ -207,6 +212,16 @@ int main(int argc, char** argv) {
   }
   Logger::Log("Successfully wrote function declarations!");
 
+  if (args.views) {
+    Logger::Log("Writing view type definitions...");
+    if (!WriteViewTypeDefinitions(header_fd, &cpp_result.second) ||
+        !WriteViewFunctionDeclarations(header_fd, &cpp_result.second)) {
+      Logger::Error("WriteViewTypeDefinitions failed");
+      return 1;
+    }
+    Logger::Log("Successfully wrote view type definitions!");
+  }
+
   Logger::Log("Writing header epilogue...");
   if (!WriteHeaderEpilogue(header_fd, args.header_filename)) {
     Logger::Error("WriteHeaderEpilogue failed");
@@ -235,6 +250,15 @@ int main(int argc, char** argv) {
   }
   Logger::Log("Successfully wrote decoders!");
 
+  if (args.views) {
+    Logger::Log("Writing view decoders...");
+    if (!WriteViewDecoders(cc_fd, &cpp_result.second)) {
+      Logger::Error("WriteViewDecoders failed");
+      return 1;
+    }
+    Logger::Log("Successfully wrote view decoders!");
+  }
+
   Logger::Log("Writing equality operators...");
   if (!WriteEqualityOperators(cc_fd, &cpp_result.second)) {
     Logger::Error("WriteStructEqualityOperators failed");
@@ -15,7 +15,6 @@ namespace openscreen {
 
 Error SHA256HashString(absl::string_view str,
                        uint8_t output[SHA256_DIGEST_LENGTH]) {
-  bssl::UniquePtr<EVP_MD_CTX> context(EVP_MD_CTX_new());
   if (!EVP_Digest(str.data(), str.size(), output, nullptr, EVP_sha256(),
                   nullptr)) {
     return Error::Code::kSha256HashFailure;
@@ -16,32 +16,36 @@
 #include "json/value.h"
 #include "platform/base/error.h"
 #include "util/chrono_helpers.h"
+#include "util/json/json_scalar.h"
 #include "util/json/json_serialization.h"
+#include "util/json/streaming_json_reader.h"
+#include "util/json/streaming_json_writer.h"
+#include "util/osp_logging.h"
 #include "util/simple_fraction.h"
 
 // This file contains helper methods for parsing JSON, in an attempt to
-// reduce boilerplate code when working with JsonCpp.
+// reduce boilerplate code when working with JsonCpp or json::StreamingReader.
 namespace openscreen {
 namespace json {
 
-inline bool TryParseBool(const Json::Value& value, bool* out) {
-  if (!value.isBool()) {
+inline bool TryParseBool(const Scalar& value, bool* out) {
+  if (!value.is_bool()) {
     return false;
   }
-  *out = value.asBool();
+  *out = value.AsBool();
   return true;
 }
 
 // A general note about parsing primitives. "Validation" in this context
 // generally means ensuring that the values are non-negative, excepting doubles
 // which may be negative in some cases.
-inline bool TryParseDouble(const Json::Value& value,
+inline bool TryParseDouble(const Scalar& value,
                            double* out,
                            bool allow_negative = false) {
-  if (!value.isDouble()) {
+  if (!value.IsNumber()) {
     return false;
   }
-  const double d = value.asDouble();
+  const double d = value.AsDouble();
   if (std::isnan(d)) {
     return false;
   }
@@ -52,11 +56,11 @@ inline bool TryParseDouble(const Json::Value& value,
   return true;
 }
 
-inline bool TryParseInt(const Json::Value& value, int* out) {
-  if (!value.isInt()) {
+inline bool TryParseInt(const Scalar& value, int* out) {
+  if (!value.IsInt()) {
     return false;
   }
-  int i = value.asInt();
+  int i = value.AsInt();
   if (i < 0) {
     return false;
   }
@@ -64,29 +68,29 @@ inline bool TryParseInt(const Json::Value& value, int* out) {
   return true;
 }
 
-inline bool TryParseUint(const Json::Value& value, uint32_t* out) {
-  if (!value.isUInt()) {
+inline bool TryParseUint(const Scalar& value, uint32_t* out) {
+  if (!value.IsUint()) {
     return false;
   }
-  *out = value.asUInt();
+  *out = value.AsUint();
   return true;
 }
 
-inline bool TryParseString(const Json::Value& value, std::string* out) {
-  if (!value.isString()) {
+inline bool TryParseString(const Scalar& value, std::string* out) {
+  if (!value.is_string()) {
     return false;
   }
-  *out = value.asString();
+  const absl::string_view s = value.AsString();
+  out->assign(s.data(), s.size());
   return true;
 }
 
 // We want to be more robust when we parse fractions then just
 // allowing strings, this will parse numeral values such as
 // value: 50 as well as value: "50" and value: "100/2".
-inline bool TryParseSimpleFraction(const Json::Value& value,
-                                   SimpleFraction* out) {
-  if (value.isInt()) {
-    int parsed = value.asInt();
+inline bool TryParseSimpleFraction(const Scalar& value, SimpleFraction* out) {
+  if (value.IsInt()) {
+    int parsed = value.AsInt();
     if (parsed < 0) {
       return false;
     }
@@ -94,8 +98,8 @@ inline bool TryParseSimpleFraction(const Json::Value& value,
     return true;
   }
 
-  if (value.isString()) {
-    auto fraction_or_error = SimpleFraction::FromString(value.asString());
+  if (value.is_string()) {
+    auto fraction_or_error = SimpleFraction::FromString(value.AsString());
     if (!fraction_or_error) {
       return false;
     }
@@ -110,7 +114,7 @@ inline bool TryParseSimpleFraction(const Json::Value& value,
   return false;
 }
 
-inline bool TryParseMilliseconds(const Json::Value& value, milliseconds* out) {
+inline bool TryParseMilliseconds(const Scalar& value, milliseconds* out) {
   int out_ms;
   if (!TryParseInt(value, &out_ms) || out_ms < 0) {
     return false;
@@ -119,6 +123,38 @@ inline bool TryParseMilliseconds(const Json::Value& value, milliseconds* out) {
   return true;
 }
 
+// The Json::Value versions of the above, which have the same semantics.
+inline bool TryParseBool(const Json::Value& value, bool* out) {
+  return TryParseBool(Scalar::FromValue(value), out);
+}
+
+inline bool TryParseDouble(const Json::Value& value,
+                           double* out,
+                           bool allow_negative = false) {
+  return TryParseDouble(Scalar::FromValue(value), out, allow_negative);
+}
+
+inline bool TryParseInt(const Json::Value& value, int* out) {
+  return TryParseInt(Scalar::FromValue(value), out);
+}
+
+inline bool TryParseUint(const Json::Value& value, uint32_t* out) {
+  return TryParseUint(Scalar::FromValue(value), out);
+}
+
+inline bool TryParseString(const Json::Value& value, std::string* out) {
+  return TryParseString(Scalar::FromValue(value), out);
+}
+
+inline bool TryParseSimpleFraction(const Json::Value& value,
+                                   SimpleFraction* out) {
+  return TryParseSimpleFraction(Scalar::FromValue(value), out);
+}
+
+inline bool TryParseMilliseconds(const Json::Value& value, milliseconds* out) {
+  return TryParseMilliseconds(Scalar::FromValue(value), out);
+}
+
 template <typename T>
 using Parser = std::function<bool(const Json::Value&, T*)>;
 
@@ -147,17 +183,171 @@ bool TryParseArray(const Json::Value& value,
 }
 
 inline bool TryParseIntArray(const Json::Value& value, std::vector<int>* out) {
-  return TryParseArray<int>(value, TryParseInt, out);
+  return TryParseArray<int>(
+      value, [](const Json::Value& v, int* i) { return TryParseInt(v, i); },
+      out);
 }
 
 inline bool TryParseUintArray(const Json::Value& value,
                               std::vector<uint32_t>* out) {
-  return TryParseArray<uint32_t>(value, TryParseUint, out);
+  return TryParseArray<uint32_t>(
+      value,
+      [](const Json::Value& v, uint32_t* u) { return TryParseUint(v, u); },
+      out);
 }
 
 inline bool TryParseStringArray(const Json::Value& value,
                                 std::vector<std::string>* out) {
-  return TryParseArray<std::string>(value, TryParseString, out);
+  return TryParseArray<std::string>(
+      value,
+      [](const Json::Value& v, std::string* s) { return TryParseString(v, s); },
+      out);
+}
+
+// Reads an array with a StreamingReader, using a |parser| that reads exactly
+// one value: bool(StreamingReader*, T*).  Like the Json::Value version, |out|
+// is reset to an empty vector in any error case.
+template <typename T, typename ElementParser>
+bool TryParseArray(StreamingReader* reader,
+                   ElementParser parser,
+                   std::vector<T>* out) {
+  out->clear();
+  if (!reader->BeginArray()) {
+    return false;
+  }
+
+  bool is_valid = true;
+  while (reader->NextElement()) {
+    if (!is_valid) {
+      reader->SkipValue();
+      continue;
+    }
+    T v;
+    if (parser(reader, &v)) {
+      out->push_back(std::move(v));
+    } else {
+      is_valid = false;
+    }
+  }
+
+  if (!is_valid || !reader->ok() || out->empty()) {
+    out->clear();
+    return false;
+  }
+  return true;
+}
+
+inline bool TryParseIntArray(StreamingReader* reader, std::vector<int>* out) {
+  return TryParseArray<int>(
+      reader,
+      [](StreamingReader* r, int* value) {
+        return TryParseInt(r->ReadScalar(), value);
+      },
+      out);
+}
+
+inline bool TryParseUintArray(StreamingReader* reader,
+                              std::vector<uint32_t>* out) {
+  return TryParseArray<uint32_t>(
+      reader,
+      [](StreamingReader* r, uint32_t* u) {
+        return TryParseUint(r->ReadScalar(), u);
+      },
+      out);
+}
+
+inline bool TryParseStringArray(StreamingReader* reader,
+                                std::vector<std::string>* out) {
+  return TryParseArray<std::string>(
+      reader,
+      [](StreamingReader* r, std::string* s) {
+        return TryParseString(r->ReadScalar(), s);
+      },
+      out);
+}
+
+// Binds the scalar members of an object to a |Fields| struct, so that the
+// values can be validated by one piece of code once the whole object has been
+// read.  Members that are missing are left null.
+template <typename Fields>
+struct FieldBinding {
+  const char* key;
+  Scalar Fields::*member;
+};
+
+// Reads the next value, which should be an object, with a StreamingReader.
+// Members that aren't bound are passed to |read_other|, a
+// bool(absl::string_view key) which returns false if it didn't read the
+// member's value, in which case it is skipped.  Returns false if the value
+// isn't an object.
+template <typename Fields, size_t N, typename OtherMemberReader>
+bool BindFields(StreamingReader* reader,
+                const FieldBinding<Fields> (&bindings)[N],
+                Fields* out,
+                OtherMemberReader read_other) {
+  if (!reader->BeginObject()) {
+    return false;
+  }
+
+  absl::string_view key;
+  while (reader->NextKey(&key)) {
+    const FieldBinding<Fields>* binding = nullptr;
+    for (const FieldBinding<Fields>& b : bindings) {
+      if (key == b.key) {
+        binding = &b;
+        break;
+      }
+    }
+
+    if (binding) {
+      out->*binding->member = reader->ReadScalar();
+    } else if (!read_other(key)) {
+      reader->SkipValue();
+    }
+  }
+  return reader->ok();
+}
+
+template <typename Fields, size_t N>
+bool BindFields(StreamingReader* reader,
+                const FieldBinding<Fields> (&bindings)[N],
+                Fields* out) {
+  return BindFields(reader, bindings, out,
+                    [](absl::string_view) { return false; });
+}
+
+// Types that are read with a StreamingReader and written with a
+// StreamingWriter use these to provide their Json::Value methods, so that each
+// message format has a single implementation.
+
+// Returns the result of |read|, a Result(StreamingReader*), reading |value|.
+template <typename ValueReader>
+auto ReadFromValue(const Json::Value& value, ValueReader read)
+    -> decltype(read(static_cast<StreamingReader*>(nullptr))) {
+  // Stringify() rejects empty objects and arrays, which are valid documents.
+  std::string document;
+  if (value.empty()) {
+    document = value.isObject() ? "{}" : value.isArray() ? "[]" : "null";
+  } else {
+    document = Stringify(value).value("null");
+  }
+
+  StreamingReader reader;
+  reader.Reset(document);
+  return read(&reader);
+}
+
+// Returns the value written by |write|, a void(StreamingWriter*).
+template <typename ValueWriter>
+Json::Value WriteToValue(ValueWriter write) {
+  std::string document;
+  StreamingWriter writer(&document);
+  write(&writer);
+  OSP_CHECK(writer.is_complete());
+
+  ErrorOr<Json::Value> value = Parse(document);
+  OSP_CHECK(value.is_value()) << value.error();
+  return std::move(value.value());
 }
 
 }  // namespace json
@@ -0,0 +1,192 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/json/json_scalar.h"
+
+#include <cmath>
+#include <limits>
+
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace json {
+
+namespace {
+
+bool IsIntegral(double d) {
+  double integral_part;
+  return std::modf(d, &integral_part) == 0.0;
+}
+
+}  // namespace
+
+// static
+Scalar Scalar::FromBool(bool value) {
+  Scalar scalar;
+  scalar.type_ = Type::kBool;
+  scalar.bool_ = value;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromInt(int64_t value) {
+  Scalar scalar;
+  scalar.type_ = Type::kInt;
+  scalar.int_ = value;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromUint(uint64_t value) {
+  Scalar scalar;
+  scalar.type_ = Type::kUint;
+  scalar.uint_ = value;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromDouble(double value) {
+  Scalar scalar;
+  scalar.type_ = Type::kDouble;
+  scalar.double_ = value;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromString(absl::string_view value) {
+  Scalar scalar;
+  scalar.type_ = Type::kString;
+  scalar.string_ = value;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromArray() {
+  Scalar scalar;
+  scalar.type_ = Type::kArray;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromObject() {
+  Scalar scalar;
+  scalar.type_ = Type::kObject;
+  return scalar;
+}
+
+// static
+Scalar Scalar::FromValue(const Json::Value& value) {
+  switch (value.type()) {
+    case Json::nullValue:
+      return Scalar();
+    case Json::intValue:
+      return FromInt(value.asLargestInt());
+    case Json::uintValue:
+      return FromUint(value.asLargestUInt());
+    case Json::realValue:
+      return FromDouble(value.asDouble());
+    case Json::stringValue: {
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      if (!value.getString(&begin, &end)) {
+        return FromString(absl::string_view());
+      }
+      return FromString(absl::string_view(begin, end - begin));
+    }
+    case Json::booleanValue:
+      return FromBool(value.asBool());
+    case Json::arrayValue:
+      return FromArray();
+    case Json::objectValue:
+      return FromObject();
+  }
+  OSP_NOTREACHED();
+}
+
+bool Scalar::IsNumber() const {
+  return type_ == Type::kInt || type_ == Type::kUint ||
+         type_ == Type::kDouble;
+}
+
+bool Scalar::IsInt() const {
+  switch (type_) {
+    case Type::kInt:
+      return int_ >= std::numeric_limits<int>::min() &&
+             int_ <= std::numeric_limits<int>::max();
+    case Type::kUint:
+      return uint_ <= static_cast<uint64_t>(std::numeric_limits<int>::max());
+    case Type::kDouble:
+      return double_ >= std::numeric_limits<int>::min() &&
+             double_ <= std::numeric_limits<int>::max() &&
+             IsIntegral(double_);
+    default:
+      return false;
+  }
+}
+
+bool Scalar::IsUint() const {
+  switch (type_) {
+    case Type::kInt:
+      return int_ >= 0 &&
+             static_cast<uint64_t>(int_) <=
+                 std::numeric_limits<uint32_t>::max();
+    case Type::kUint:
+      return uint_ <= std::numeric_limits<uint32_t>::max();
+    case Type::kDouble:
+      return double_ >= 0 &&
+             double_ <= std::numeric_limits<uint32_t>::max() &&
+             IsIntegral(double_);
+    default:
+      return false;
+  }
+}
+
+bool Scalar::AsBool() const {
+  OSP_DCHECK(is_bool());
+  return bool_;
+}
+
+int Scalar::AsInt() const {
+  OSP_DCHECK(IsInt());
+  switch (type_) {
+    case Type::kInt:
+      return static_cast<int>(int_);
+    case Type::kUint:
+      return static_cast<int>(uint_);
+    default:
+      return static_cast<int>(double_);
+  }
+}
+
+uint32_t Scalar::AsUint() const {
+  OSP_DCHECK(IsUint());
+  switch (type_) {
+    case Type::kInt:
+      return static_cast<uint32_t>(int_);
+    case Type::kUint:
+      return static_cast<uint32_t>(uint_);
+    default:
+      return static_cast<uint32_t>(double_);
+  }
+}
+
+double Scalar::AsDouble() const {
+  OSP_DCHECK(IsNumber());
+  switch (type_) {
+    case Type::kInt:
+      return static_cast<double>(int_);
+    case Type::kUint:
+      return static_cast<double>(uint_);
+    default:
+      return double_;
+  }
+}
+
+absl::string_view Scalar::AsString() const {
+  OSP_DCHECK(is_string());
+  return string_;
+}
+
+}  // namespace json
+}  // namespace openscreen
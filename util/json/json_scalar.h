@@ -0,0 +1,84 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UTIL_JSON_JSON_SCALAR_H_
+#define UTIL_JSON_JSON_SCALAR_H_
+
+#include <stdint.h>
+
+#include "absl/strings/string_view.h"
+#include "json/value.h"
+
+namespace openscreen {
+namespace json {
+
+// A single JSON value, as read by StreamingReader or taken from a Json::Value.
+// Strings are not copied, so a Scalar must not outlive the document (or the
+// Json::Value) it was read from.  Objects and arrays only carry their type.
+//
+// The Is*() predicates follow those of Json::Value, so that parsing code gives
+// the same result whichever way a message was read.
+class Scalar {
+ public:
+  enum class Type : uint8_t {
+    kNull,
+    kBool,
+    kInt,
+    kUint,
+    kDouble,
+    kString,
+    kArray,
+    kObject
+  };
+
+  Scalar() = default;
+
+  static Scalar FromBool(bool value);
+  static Scalar FromInt(int64_t value);
+  static Scalar FromUint(uint64_t value);
+  static Scalar FromDouble(double value);
+  static Scalar FromString(absl::string_view value);
+  static Scalar FromArray();
+  static Scalar FromObject();
+
+  // The returned Scalar refers to the string stored in |value|, if any.
+  static Scalar FromValue(const Json::Value& value);
+
+  Type type() const { return type_; }
+  bool is_null() const { return type_ == Type::kNull; }
+  bool is_bool() const { return type_ == Type::kBool; }
+  bool is_string() const { return type_ == Type::kString; }
+  bool is_array() const { return type_ == Type::kArray; }
+  bool is_object() const { return type_ == Type::kObject; }
+
+  // True for any number, like Json::Value::isDouble().
+  bool IsNumber() const;
+
+  // True for integral numbers in the range of int32_t and uint32_t
+  // respectively, like Json::Value::isInt() and isUInt().
+  bool IsInt() const;
+  bool IsUint() const;
+
+  // These must only be called if the corresponding predicate is true.
+  bool AsBool() const;
+  int AsInt() const;
+  uint32_t AsUint() const;
+  double AsDouble() const;
+  absl::string_view AsString() const;
+
+ private:
+  Type type_ = Type::kNull;
+  union {
+    bool bool_;
+    int64_t int_ = 0;
+    uint64_t uint_;
+    double double_;
+  };
+  absl::string_view string_;
+};
+
+}  // namespace json
+}  // namespace openscreen
+
+#endif  // UTIL_JSON_JSON_SCALAR_H_
@@ -0,0 +1,553 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/json/streaming_json_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace json {
+
+namespace {
+
+// The same nesting limit as json::Parse().
+constexpr size_t kMaxDepth = 1000;
+
+// Objects with up to this many keys are checked for duplicates by scanning
+// their keys, which is faster than hashing for the small objects that make up
+// most messages.  The keys of larger objects are added to a set, so that
+// checking each key doesn't take time proportional to the size of the object.
+constexpr size_t kMaxScannedKeys = 16;
+
+bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+}  // namespace
+
+StreamingReader::StreamingReader() = default;
+StreamingReader::~StreamingReader() = default;
+
+void StreamingReader::Reset(absl::string_view document) {
+  document_ = document;
+  position_ = 0;
+  error_ = Error::None();
+  root_started_ = false;
+  value_expected_ = true;
+  stack_.clear();
+  keys_.clear();
+  key_set_.clear();
+  unescaped_used_ = 0;
+}
+
+Scalar StreamingReader::ReadScalar() {
+  const size_t depth = stack_.size();
+  Scalar value;
+  if (!ReadValueStart(&value)) {
+    return Scalar();
+  }
+  if (value.is_object() || value.is_array()) {
+    SkipToDepth(depth);
+  }
+  return ok() ? value : Scalar();
+}
+
+bool StreamingReader::BeginObject() {
+  if (!ok()) {
+    return false;
+  }
+  SkipWhitespace();
+  if (!AtEnd() && Peek() == '{') {
+    Scalar value;
+    return ReadValueStart(&value);
+  }
+  SkipValue();
+  return false;
+}
+
+bool StreamingReader::BeginArray() {
+  if (!ok()) {
+    return false;
+  }
+  SkipWhitespace();
+  if (!AtEnd() && Peek() == '[') {
+    Scalar value;
+    return ReadValueStart(&value);
+  }
+  SkipValue();
+  return false;
+}
+
+void StreamingReader::SkipValue() {
+  const size_t depth = stack_.size();
+  Scalar value;
+  if (ReadValueStart(&value) && (value.is_object() || value.is_array())) {
+    SkipToDepth(depth);
+  }
+}
+
+bool StreamingReader::PeekNull() {
+  if (!ok() || !value_expected_) {
+    return false;
+  }
+  SkipWhitespace();
+  return !AtEnd() && Peek() == 'n';
+}
+
+bool StreamingReader::NextKey(absl::string_view* key) {
+  if (!ok()) {
+    return false;
+  }
+  if (value_expected_ || stack_.empty() || !stack_.back().is_object) {
+    OSP_DLOG_WARN << "NextKey() called while not reading an object";
+    SetError("Not reading the members of an object");
+    return false;
+  }
+
+  Container& container = stack_.back();
+  SkipWhitespace();
+  if (AtEnd()) {
+    SetError("Missing '}' at end of object");
+    return false;
+  }
+  if (Peek() == '}') {
+    ++position_;
+    if (container.size > kMaxScannedKeys) {
+      for (size_t i = container.first_key; i < keys_.size(); ++i) {
+        key_set_.erase(DepthAndKey(stack_.size(), keys_[i]));
+      }
+    }
+    keys_.resize(container.first_key);
+    stack_.pop_back();
+    return false;
+  }
+  if (container.size > 0) {
+    if (Peek() != ',') {
+      SetError("Missing ',' or '}' in object declaration");
+      return false;
+    }
+    ++position_;
+    SkipWhitespace();
+  }
+  if (AtEnd() || Peek() != '"') {
+    SetError("Missing '}' or object member name");
+    return false;
+  }
+  if (!ReadString(key)) {
+    return false;
+  }
+
+  bool is_duplicate = false;
+  if (container.size < kMaxScannedKeys) {
+    is_duplicate = std::find(keys_.begin() + container.first_key, keys_.end(),
+                             *key) != keys_.end();
+  } else {
+    if (container.size == kMaxScannedKeys) {
+      for (size_t i = container.first_key; i < keys_.size(); ++i) {
+        key_set_.emplace(stack_.size(), keys_[i]);
+      }
+    }
+    is_duplicate = !key_set_.emplace(stack_.size(), *key).second;
+  }
+  if (is_duplicate) {
+    SetError(absl::StrCat("Duplicate key: '", *key, "'"));
+    return false;
+  }
+  keys_.push_back(*key);
+
+  SkipWhitespace();
+  if (AtEnd() || Peek() != ':') {
+    SetError("Missing ':' after object member name");
+    return false;
+  }
+  ++position_;
+  ++container.size;
+  value_expected_ = true;
+  return true;
+}
+
+bool StreamingReader::NextElement() {
+  if (!ok()) {
+    return false;
+  }
+  if (value_expected_ || stack_.empty() || stack_.back().is_object) {
+    OSP_DLOG_WARN << "NextElement() called while not reading an array";
+    SetError("Not reading the elements of an array");
+    return false;
+  }
+
+  Container& container = stack_.back();
+  SkipWhitespace();
+  if (AtEnd()) {
+    SetError("Missing ']' at end of array");
+    return false;
+  }
+  if (Peek() == ']') {
+    ++position_;
+    stack_.pop_back();
+    return false;
+  }
+  if (container.size > 0) {
+    if (Peek() != ',') {
+      SetError("Missing ',' or ']' in array declaration");
+      return false;
+    }
+    ++position_;
+  }
+  ++container.size;
+  value_expected_ = true;
+  return true;
+}
+
+Error StreamingReader::Finish() {
+  while (ok() && (value_expected_ || !stack_.empty())) {
+    Advance();
+  }
+  if (ok()) {
+    SkipWhitespace();
+    if (!AtEnd()) {
+      SetError("Extra non-whitespace after JSON value");
+    }
+  }
+  return error_;
+}
+
+bool StreamingReader::ReadValueStart(Scalar* value) {
+  if (!ok()) {
+    return false;
+  }
+  if (!value_expected_) {
+    OSP_DLOG_WARN << "Value read while a key or element was expected";
+    SetError("Unexpected read of a value");
+    return false;
+  }
+
+  SkipWhitespace();
+  if (AtEnd()) {
+    SetError(root_started_ ? "Unexpected end of document" : "Empty document");
+    return false;
+  }
+
+  const char c = Peek();
+  if (!root_started_) {
+    root_started_ = true;
+    if (c != '{' && c != '[') {
+      SetError(
+          "A valid JSON document must be either an array or an object value");
+      return false;
+    }
+  }
+
+  value_expected_ = false;
+  switch (c) {
+    case '{':
+    case '[':
+      if (stack_.size() >= kMaxDepth) {
+        SetError("Exceeded stack limit");
+        return false;
+      }
+      ++position_;
+      stack_.push_back(Container{c == '{', 0, keys_.size()});
+      *value = (c == '{') ? Scalar::FromObject() : Scalar::FromArray();
+      return true;
+
+    case '"': {
+      absl::string_view string;
+      if (!ReadString(&string)) {
+        return false;
+      }
+      *value = Scalar::FromString(string);
+      return true;
+    }
+
+    case 't':
+      *value = Scalar::FromBool(true);
+      return ReadLiteral("true");
+
+    case 'f':
+      *value = Scalar::FromBool(false);
+      return ReadLiteral("false");
+
+    case 'n':
+      *value = Scalar();
+      return ReadLiteral("null");
+
+    default:
+      return ReadNumber(value);
+  }
+}
+
+void StreamingReader::Advance() {
+  if (value_expected_) {
+    Scalar value;
+    ReadValueStart(&value);
+  } else if (!stack_.empty() && stack_.back().is_object) {
+    absl::string_view key;
+    NextKey(&key);
+  } else {
+    NextElement();
+  }
+}
+
+void StreamingReader::SkipToDepth(size_t depth) {
+  while (ok() && stack_.size() > depth) {
+    Advance();
+  }
+}
+
+bool StreamingReader::ReadString(absl::string_view* out) {
+  OSP_DCHECK_EQ(Peek(), '"');
+  const size_t start = ++position_;
+
+  // Most strings have no escape sequences, and can be returned as a view into
+  // the document.
+  while (!AtEnd()) {
+    const char c = Peek();
+    if (c == '"') {
+      *out = document_.substr(start, position_ - start);
+      ++position_;
+      return true;
+    }
+    if (c == '\\') {
+      break;
+    }
+    ++position_;
+  }
+
+  if (unescaped_used_ == unescaped_.size()) {
+    unescaped_.emplace_back();
+  }
+  std::string& buffer = unescaped_[unescaped_used_++];
+  buffer.assign(document_.data() + start, position_ - start);
+  while (!AtEnd()) {
+    char c = document_[position_++];
+    if (c == '"') {
+      *out = buffer;
+      return true;
+    }
+    if (c != '\\') {
+      buffer.push_back(c);
+      continue;
+    }
+    if (AtEnd()) {
+      break;
+    }
+
+    c = document_[position_++];
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        buffer.push_back(c);
+        break;
+      case 'b':
+        buffer.push_back('\b');
+        break;
+      case 'f':
+        buffer.push_back('\f');
+        break;
+      case 'n':
+        buffer.push_back('\n');
+        break;
+      case 'r':
+        buffer.push_back('\r');
+        break;
+      case 't':
+        buffer.push_back('\t');
+        break;
+      case 'u': {
+        uint32_t code_point;
+        if (!ReadHexQuad(&code_point)) {
+          return false;
+        }
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          if (document_.substr(position_, 2) != "\\u") {
+            SetError("Missing the second half of a unicode surrogate pair");
+            return false;
+          }
+          position_ += 2;
+          uint32_t low_surrogate;
+          if (!ReadHexQuad(&low_surrogate)) {
+            return false;
+          }
+          if (low_surrogate < 0xDC00 || low_surrogate > 0xDFFF) {
+            SetError("Invalid second half of a unicode surrogate pair");
+            return false;
+          }
+          code_point =
+              0x10000 + ((code_point & 0x3FF) << 10) + (low_surrogate & 0x3FF);
+        }
+        AppendUtf8(code_point, &buffer);
+        break;
+      }
+      default:
+        SetError("Bad escape sequence in string");
+        return false;
+    }
+  }
+
+  SetError("Missing '\"' at end of string");
+  return false;
+}
+
+bool StreamingReader::ReadNumber(Scalar* out) {
+  const size_t start = position_;
+  const bool negative = Peek() == '-';
+  if (negative) {
+    ++position_;
+  }
+  if (AtEnd() || !IsDigit(Peek())) {
+    SetError("Syntax error: value, object or array expected");
+    return false;
+  }
+
+  uint64_t magnitude = 0;
+  bool overflow = false;
+  if (Peek() == '0') {
+    ++position_;
+  } else {
+    while (!AtEnd() && IsDigit(Peek())) {
+      const uint64_t digit = Peek() - '0';
+      if (magnitude > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+        overflow = true;
+      } else {
+        magnitude = magnitude * 10 + digit;
+      }
+      ++position_;
+    }
+  }
+
+  bool integral = true;
+  if (!AtEnd() && Peek() == '.') {
+    ++position_;
+    if (AtEnd() || !IsDigit(Peek())) {
+      SetError("Missing digits after decimal point");
+      return false;
+    }
+    while (!AtEnd() && IsDigit(Peek())) {
+      ++position_;
+    }
+    integral = false;
+  }
+  if (!AtEnd() && (Peek() == 'e' || Peek() == 'E')) {
+    ++position_;
+    if (!AtEnd() && (Peek() == '+' || Peek() == '-')) {
+      ++position_;
+    }
+    if (AtEnd() || !IsDigit(Peek())) {
+      SetError("Missing digits in exponent");
+      return false;
+    }
+    while (!AtEnd() && IsDigit(Peek())) {
+      ++position_;
+    }
+    integral = false;
+  }
+
+  // Like json::Parse(), integers are kept exact where possible, and anything
+  // else is read as a double.
+  constexpr uint64_t kMaxInt64 = std::numeric_limits<int64_t>::max();
+  if (integral && !overflow) {
+    if (!negative) {
+      *out = magnitude <= kMaxInt64
+                 ? Scalar::FromInt(static_cast<int64_t>(magnitude))
+                 : Scalar::FromUint(magnitude);
+      return true;
+    }
+    if (magnitude <= kMaxInt64) {
+      *out = Scalar::FromInt(-static_cast<int64_t>(magnitude));
+      return true;
+    }
+    if (magnitude == kMaxInt64 + 1) {
+      *out = Scalar::FromInt(std::numeric_limits<int64_t>::min());
+      return true;
+    }
+  }
+
+  double value;
+  if (!absl::SimpleAtod(document_.substr(start, position_ - start), &value) ||
+      !std::isfinite(value)) {
+    SetError("Number is out of range");
+    return false;
+  }
+  *out = Scalar::FromDouble(value);
+  return true;
+}
+
+bool StreamingReader::ReadLiteral(absl::string_view literal) {
+  if (document_.substr(position_, literal.size()) != literal) {
+    SetError("Syntax error: value, object or array expected");
+    return false;
+  }
+  position_ += literal.size();
+  return true;
+}
+
+bool StreamingReader::ReadHexQuad(uint32_t* out) {
+  if (document_.size() - position_ < 4) {
+    SetError("Bad unicode escape sequence in string");
+    return false;
+  }
+  uint32_t value = 0;
+  for (int i = 0; i < 4; ++i) {
+    const char c = document_[position_++];
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value += c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value += c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value += c - 'A' + 10;
+    } else {
+      SetError("Bad unicode escape sequence in string");
+      return false;
+    }
+  }
+  *out = value;
+  return true;
+}
+
+void StreamingReader::SkipWhitespace() {
+  while (!AtEnd()) {
+    const char c = Peek();
+    if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+      return;
+    }
+    ++position_;
+  }
+}
+
+void StreamingReader::SetError(absl::string_view message) {
+  if (error_.ok()) {
+    error_ = Error(Error::Code::kJsonParseError,
+                   absl::StrCat(message, " at offset ", position_));
+  }
+}
+
+}  // namespace json
+}  // namespace openscreen
@@ -0,0 +1,155 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UTIL_JSON_STREAMING_JSON_READER_H_
+#define UTIL_JSON_STREAMING_JSON_READER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "platform/base/error.h"
+#include "platform/base/macros.h"
+#include "util/json/json_scalar.h"
+
+namespace openscreen {
+namespace json {
+
+// Reads a JSON document one value at a time, without building a tree of the
+// whole document: callers walk the document and bind the values they are
+// interested in directly into their own structs, skipping everything else.
+// Strings without escape sequences are returned as views into the document,
+// and the reader's buffers are reused across documents, so reading a message
+// normally doesn't allocate at all.
+//
+// The grammar accepted is the same as json::Parse(): the root must be an object
+// or an array, duplicate keys and trailing content are rejected.  Once an error
+// is found, all reads fail and Finish() returns the error.
+//
+// Example:
+//   reader.Reset(document);
+//   absl::string_view key;
+//   if (reader.BeginObject()) {
+//     while (reader.NextKey(&key)) {
+//       if (key == "index") {
+//         index = reader.ReadScalar();
+//       } else {
+//         reader.SkipValue();
+//       }
+//     }
+//   }
+//   Error error = reader.Finish();
+class StreamingReader {
+ public:
+  StreamingReader();
+  ~StreamingReader();
+
+  // Starts reading |document|, which must outlive the reader's use of it and
+  // all of the Scalars read from it.
+  void Reset(absl::string_view document);
+
+  // Each of the following reads the next value, so must be called at the start
+  // of the document, after NextKey() or after NextElement() returned true.
+
+  // Returns the next value.  Objects and arrays are skipped, and a Scalar
+  // holding only their type is returned.
+  Scalar ReadScalar();
+
+  // If the next value is an object (or array), starts reading its members (or
+  // elements) and returns true.  Otherwise, skips the value and returns false.
+  bool BeginObject();
+  bool BeginArray();
+
+  // Skips the next value.
+  void SkipValue();
+
+  // Returns true if the next value is null, without reading it.
+  bool PeekNull();
+
+  // Reads the key of the next member of the current object, which must then be
+  // followed by reading its value.  Returns false, after leaving the object,
+  // once there are no more members.
+  bool NextKey(absl::string_view* key);
+
+  // Returns true if the current array has another element, which must then be
+  // read.  Returns false, after leaving the array, once there are no more.
+  bool NextElement();
+
+  // Reads (and validates) the rest of the document, including anything the
+  // caller skipped, and returns the first error found.
+  Error Finish();
+
+  bool ok() const { return error_.ok(); }
+
+ private:
+  struct Container {
+    bool is_object;
+    size_t size;
+    // Index in |keys_| of the first key of this object.
+    size_t first_key;
+  };
+
+  // A key of the object at a depth of the stack.  Only one object is being
+  // read at each depth, so this identifies its keys.
+  using DepthAndKey = std::pair<size_t, absl::string_view>;
+
+  // Reads a null, boolean, number or string value, or enters an object or
+  // array.  Returns false on error.
+  bool ReadValueStart(Scalar* value);
+
+  // Reads the next token of whatever is currently being read: a value, or the
+  // next key or element of the current container.
+  void Advance();
+
+  // Skips the rest of a container entered by ReadValueStart(), returning once
+  // |stack_| is back to |depth| containers.
+  void SkipToDepth(size_t depth);
+
+  bool ReadString(absl::string_view* out);
+  bool ReadNumber(Scalar* out);
+  bool ReadLiteral(absl::string_view literal);
+  bool ReadHexQuad(uint32_t* out);
+
+  void SkipWhitespace();
+  bool AtEnd() const { return position_ >= document_.size(); }
+  char Peek() const { return document_[position_]; }
+
+  void SetError(absl::string_view message);
+
+  absl::string_view document_;
+  size_t position_ = 0;
+  Error error_;
+
+  // Whether the root value was started, and whether a value must be read
+  // next.
+  bool root_started_ = false;
+  bool value_expected_ = true;
+
+  std::vector<Container> stack_;
+
+  // The keys of the objects in |stack_|, in order, and those of the larger
+  // objects as a set, for finding duplicates.
+  std::vector<absl::string_view> keys_;
+  std::unordered_set<DepthAndKey, absl::Hash<DepthAndKey>> key_set_;
+
+  // Strings that contained escape sequences, decoded.  A deque is used so that
+  // views of the strings stay valid while more are added, and |unescaped_used_|
+  // of them belong to the current document so the rest can be reused.
+  std::deque<std::string> unescaped_;
+  size_t unescaped_used_ = 0;
+
+  OSP_DISALLOW_COPY_AND_ASSIGN(StreamingReader);
+};
+
+}  // namespace json
+}  // namespace openscreen
+
+#endif  // UTIL_JSON_STREAMING_JSON_READER_H_
@@ -0,0 +1,259 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/json/streaming_json_reader.h"
+
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "platform/base/error.h"
+#include "util/json/json_serialization.h"
+
+namespace openscreen {
+namespace json {
+namespace {
+
+// Reads |document| to the end without looking at any values.
+Error ReadAndDiscard(StreamingReader* reader, absl::string_view document) {
+  reader->Reset(document);
+  return reader->Finish();
+}
+
+}  // namespace
+
+TEST(StreamingJsonReaderTest, ReadsMembersOfAnObject) {
+  StreamingReader reader;
+  reader.Reset(R"({"int": -7, "uint": 18446744073709551615,
+                   "double": 2.5e1, "string": "foo", "bool": true,
+                   "null": null})");
+
+  ASSERT_TRUE(reader.BeginObject());
+  absl::string_view key;
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("int", key);
+  Scalar value = reader.ReadScalar();
+  ASSERT_TRUE(value.IsInt());
+  EXPECT_EQ(-7, value.AsInt());
+  EXPECT_FALSE(value.IsUint());
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("uint", key);
+  value = reader.ReadScalar();
+  EXPECT_EQ(Scalar::Type::kUint, value.type());
+  EXPECT_FALSE(value.IsUint());
+  EXPECT_DOUBLE_EQ(18446744073709551615.0, value.AsDouble());
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("double", key);
+  value = reader.ReadScalar();
+  ASSERT_TRUE(value.IsInt());
+  EXPECT_EQ(25, value.AsInt());
+  EXPECT_DOUBLE_EQ(25.0, value.AsDouble());
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("string", key);
+  value = reader.ReadScalar();
+  ASSERT_TRUE(value.is_string());
+  EXPECT_EQ("foo", value.AsString());
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("bool", key);
+  value = reader.ReadScalar();
+  ASSERT_TRUE(value.is_bool());
+  EXPECT_TRUE(value.AsBool());
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("null", key);
+  EXPECT_TRUE(reader.PeekNull());
+  EXPECT_TRUE(reader.ReadScalar().is_null());
+
+  EXPECT_FALSE(reader.NextKey(&key));
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST(StreamingJsonReaderTest, SkipsUnreadValues) {
+  StreamingReader reader;
+  reader.Reset(R"({"skipped": {"a": [1, {"b": []}], "c": "}"},
+                   "array": [[1, 2], 3, {"d": 4}],
+                   "unread": [5]})");
+
+  ASSERT_TRUE(reader.BeginObject());
+  absl::string_view key;
+  ASSERT_TRUE(reader.NextKey(&key));
+  reader.SkipValue();
+
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_EQ("array", key);
+  ASSERT_TRUE(reader.BeginArray());
+  ASSERT_TRUE(reader.NextElement());
+  EXPECT_TRUE(reader.ReadScalar().is_array());
+  ASSERT_TRUE(reader.NextElement());
+  EXPECT_EQ(3, reader.ReadScalar().AsInt());
+  ASSERT_TRUE(reader.NextElement());
+  EXPECT_FALSE(reader.BeginArray());
+  EXPECT_FALSE(reader.NextElement());
+
+  // The rest of the document is still validated.
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST(StreamingJsonReaderTest, DecodesEscapedStrings) {
+  StreamingReader reader;
+  reader.Reset(R"(["plain", "tab\tquote\"slash\/", "\u00e9\u4E2D",
+                   "\ud83d\ude00"])");
+
+  ASSERT_TRUE(reader.BeginArray());
+  ASSERT_TRUE(reader.NextElement());
+  const Scalar plain = reader.ReadScalar();
+  ASSERT_TRUE(reader.NextElement());
+  const Scalar escaped = reader.ReadScalar();
+  ASSERT_TRUE(reader.NextElement());
+  const Scalar unicode = reader.ReadScalar();
+  ASSERT_TRUE(reader.NextElement());
+  const Scalar surrogate_pair = reader.ReadScalar();
+  EXPECT_FALSE(reader.NextElement());
+  ASSERT_TRUE(reader.Finish().ok());
+
+  // Earlier strings stay valid while later ones are decoded.
+  EXPECT_EQ("plain", plain.AsString());
+  EXPECT_EQ("tab\tquote\"slash/", escaped.AsString());
+  EXPECT_EQ("\xc3\xa9\xe4\xb8\xad", unicode.AsString());
+  EXPECT_EQ("\xf0\x9f\x98\x80", surrogate_pair.AsString());
+}
+
+TEST(StreamingJsonReaderTest, ReadsNumbersLikeJsonCpp) {
+  const std::string kDocument =
+      "[0, -0, 2147483647, -2147483648, 4294967295, 9223372036854775807, "
+      "-9223372036854775808, 1e2, 0.5, -1.25E-2, 100000000000000000000]";
+  const ErrorOr<Json::Value> expected = Parse(kDocument);
+  ASSERT_TRUE(expected.is_value());
+
+  StreamingReader reader;
+  reader.Reset(kDocument);
+  ASSERT_TRUE(reader.BeginArray());
+  for (const Json::Value& expected_value : expected.value()) {
+    ASSERT_TRUE(reader.NextElement());
+    const Scalar value = reader.ReadScalar();
+    EXPECT_EQ(expected_value.isInt(), value.IsInt());
+    EXPECT_EQ(expected_value.isUInt(), value.IsUint());
+    EXPECT_DOUBLE_EQ(expected_value.asDouble(), value.AsDouble());
+  }
+  EXPECT_FALSE(reader.NextElement());
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+TEST(StreamingJsonReaderTest, RejectsMalformedDocuments) {
+  const std::string kMalformedDocuments[] = {
+      "",
+      "   ",
+      "{",
+      "[1,]",
+      "[,1]",
+      "{,}",
+      R"({"a": 1,})",
+      R"({"a" 1})",
+      R"({a: 1})",
+      R"({"foo": "bar", "foo": "baz"})",
+      R"({"a": 01})",
+      R"({"a": 1.})",
+      R"({"a": -})",
+      R"({"a": 1e})",
+      R"({"a": tru})",
+      R"({"a": "\x"})",
+      R"({"a": "\u12"})",
+      R"({"a": "\ud83d"})",
+      R"({"a": "unterminated})",
+      R"({"a": 1e999})",
+      "{} {}",
+      "{} x",
+      "1",
+      R"("string")",
+      "// comment\n{}",
+  };
+
+  StreamingReader reader;
+  for (const std::string& document : kMalformedDocuments) {
+    const Error error = ReadAndDiscard(&reader, document);
+    EXPECT_EQ(Error::Code::kJsonParseError, error.code()) << document;
+  }
+}
+
+TEST(StreamingJsonReaderTest, AcceptsWellFormedDocuments) {
+  const std::string kDocuments[] = {
+      "{}",
+      "[]",
+      " \t\r\n{ } \n",
+      R"({"a": {"a": {"a": []}}})",
+      R"([{"a": 1}, {"a": 1}])",
+      R"({"": "", "a": "a"})",
+  };
+
+  StreamingReader reader;
+  for (const std::string& document : kDocuments) {
+    EXPECT_TRUE(ReadAndDiscard(&reader, document).ok()) << document;
+  }
+}
+
+TEST(StreamingJsonReaderTest, RejectsDuplicateKeysInLargeObjects) {
+  // Builds an object with |num_keys| distinct keys, then |extra_key|, whose
+  // members are objects with the same keys so that nested objects share them.
+  auto make_document = [](int num_keys, const std::string& extra_key) {
+    std::string inner = "{";
+    std::string outer = "{";
+    for (int i = 0; i < num_keys; ++i) {
+      inner += "\"key" + std::to_string(i) + "\": 1,";
+    }
+    inner += "\"" + extra_key + "\": 1}";
+    for (int i = 0; i < num_keys; ++i) {
+      outer += "\"key" + std::to_string(i) + "\": " + inner + ",";
+    }
+    return outer + "\"" + extra_key + "\": " + inner + "}";
+  };
+
+  StreamingReader reader;
+  for (int num_keys : {3, 100}) {
+    const std::string last_key = "key" + std::to_string(num_keys - 1);
+    EXPECT_TRUE(ReadAndDiscard(&reader, make_document(num_keys, "extra")).ok())
+        << num_keys;
+    EXPECT_EQ(Error::Code::kJsonParseError,
+              ReadAndDiscard(&reader, make_document(num_keys, "key1")).code())
+        << num_keys;
+    EXPECT_EQ(Error::Code::kJsonParseError,
+              ReadAndDiscard(&reader, make_document(num_keys, last_key)).code())
+        << num_keys;
+  }
+}
+
+TEST(StreamingJsonReaderTest, LimitsNestingDepth) {
+  StreamingReader reader;
+  EXPECT_TRUE(
+      ReadAndDiscard(&reader, std::string(1000, '[') + std::string(1000, ']'))
+          .ok());
+  EXPECT_EQ(
+      Error::Code::kJsonParseError,
+      ReadAndDiscard(&reader, std::string(1001, '[') + std::string(1001, ']'))
+          .code());
+}
+
+TEST(StreamingJsonReaderTest, AllReadsFailAfterAnError) {
+  StreamingReader reader;
+  reader.Reset(R"({"a": [1 2], "b": 3})");
+
+  ASSERT_TRUE(reader.BeginObject());
+  absl::string_view key;
+  ASSERT_TRUE(reader.NextKey(&key));
+  EXPECT_TRUE(reader.ReadScalar().is_null());
+  EXPECT_FALSE(reader.ok());
+  EXPECT_FALSE(reader.NextKey(&key));
+  EXPECT_EQ(Error::Code::kJsonParseError, reader.Finish().code());
+
+  // Resetting the reader clears the error.
+  reader.Reset("{}");
+  EXPECT_TRUE(reader.Finish().ok());
+}
+
+}  // namespace json
+}  // namespace openscreen
@@ -0,0 +1,168 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/json/streaming_json_writer.h"
+
+#include <stdio.h>
+
+#include <cmath>
+
+#include "absl/strings/str_cat.h"
+#include "util/osp_logging.h"
+
+namespace openscreen {
+namespace json {
+
+StreamingWriter::StreamingWriter(std::string* buffer) : buffer_(buffer) {
+  OSP_DCHECK(buffer_);
+}
+
+StreamingWriter::~StreamingWriter() = default;
+
+void StreamingWriter::BeginObject() {
+  BeginValue();
+  buffer_->push_back('{');
+  stack_.push_back(Container{true, true});
+}
+
+void StreamingWriter::EndObject() {
+  OSP_DCHECK(!stack_.empty() && stack_.back().is_object);
+  OSP_DCHECK(!key_written_);
+  buffer_->push_back('}');
+  stack_.pop_back();
+}
+
+void StreamingWriter::BeginArray() {
+  BeginValue();
+  buffer_->push_back('[');
+  stack_.push_back(Container{false, true});
+}
+
+void StreamingWriter::EndArray() {
+  OSP_DCHECK(!stack_.empty() && !stack_.back().is_object);
+  buffer_->push_back(']');
+  stack_.pop_back();
+}
+
+void StreamingWriter::Key(absl::string_view key) {
+  OSP_DCHECK(!stack_.empty() && stack_.back().is_object);
+  OSP_DCHECK(!key_written_);
+  if (!stack_.back().is_empty) {
+    buffer_->push_back(',');
+  }
+  stack_.back().is_empty = false;
+  AppendEscaped(key);
+  buffer_->push_back(':');
+  key_written_ = true;
+}
+
+void StreamingWriter::String(absl::string_view value) {
+  BeginValue();
+  AppendEscaped(value);
+}
+
+void StreamingWriter::Int(int64_t value) {
+  BeginValue();
+  absl::StrAppend(buffer_, value);
+}
+
+void StreamingWriter::Uint(uint64_t value) {
+  BeginValue();
+  absl::StrAppend(buffer_, value);
+}
+
+void StreamingWriter::Double(double value) {
+  BeginValue();
+  if (!std::isfinite(value)) {
+    buffer_->append("null");
+    return;
+  }
+
+  // Like Json::Value, use enough precision to round trip, and always write a
+  // fraction or exponent so the value reads back as a double.
+  char formatted[32];
+  const int length = snprintf(formatted, sizeof(formatted), "%.17g", value);
+  OSP_DCHECK(length > 0 && length < static_cast<int>(sizeof(formatted)));
+  const absl::string_view text(formatted, length);
+  buffer_->append(text.data(), text.size());
+  if (text.find_first_of(".e") == absl::string_view::npos) {
+    buffer_->append(".0");
+  }
+}
+
+void StreamingWriter::Bool(bool value) {
+  BeginValue();
+  buffer_->append(value ? "true" : "false");
+}
+
+void StreamingWriter::Null() {
+  BeginValue();
+  buffer_->append("null");
+}
+
+void StreamingWriter::BeginValue() {
+  if (stack_.empty()) {
+    return;
+  }
+  Container& container = stack_.back();
+  if (container.is_object) {
+    OSP_DCHECK(key_written_) << "Object values must follow a key";
+    key_written_ = false;
+    return;
+  }
+  if (!container.is_empty) {
+    buffer_->push_back(',');
+  }
+  container.is_empty = false;
+}
+
+void StreamingWriter::AppendEscaped(absl::string_view value) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+
+  buffer_->push_back('"');
+  size_t unescaped_start = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const unsigned char c = value[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+
+    buffer_->append(value.data() + unescaped_start, i - unescaped_start);
+    unescaped_start = i + 1;
+    switch (c) {
+      case '"':
+        buffer_->append("\\\"");
+        break;
+      case '\\':
+        buffer_->append("\\\\");
+        break;
+      case '\b':
+        buffer_->append("\\b");
+        break;
+      case '\f':
+        buffer_->append("\\f");
+        break;
+      case '\n':
+        buffer_->append("\\n");
+        break;
+      case '\r':
+        buffer_->append("\\r");
+        break;
+      case '\t':
+        buffer_->append("\\t");
+        break;
+      default:
+        buffer_->append("\\u00");
+        buffer_->push_back(kHexDigits[c >> 4]);
+        buffer_->push_back(kHexDigits[c & 0xF]);
+        break;
+    }
+  }
+  buffer_->append(value.data() + unescaped_start,
+                  value.size() - unescaped_start);
+  buffer_->push_back('"');
+}
+
+}  // namespace json
+}  // namespace openscreen
@@ -0,0 +1,78 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UTIL_JSON_STREAMING_JSON_WRITER_H_
+#define UTIL_JSON_STREAMING_JSON_WRITER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "platform/base/macros.h"
+
+namespace openscreen {
+namespace json {
+
+// Writes compact JSON directly into a caller-owned buffer, without building a
+// Json::Value first.  Callers that keep the buffer around between messages
+// (clearing it, but not its capacity) avoid allocating for each message.
+//
+// The writer only tracks where commas go: callers are responsible for writing
+// a well-formed document, which is checked in debug builds.
+//
+// Example:
+//   buffer.clear();
+//   StreamingWriter writer(&buffer);
+//   writer.BeginObject();
+//   writer.Key("index");
+//   writer.Int(0);
+//   writer.EndObject();
+class StreamingWriter {
+ public:
+  explicit StreamingWriter(std::string* buffer);
+  ~StreamingWriter();
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  // Writes the key of the next member of the current object, which must be
+  // followed by its value.
+  void Key(absl::string_view key);
+
+  void String(absl::string_view value);
+  void Int(int64_t value);
+  void Uint(uint64_t value);
+  // Non-finite values have no JSON representation, and are written as null.
+  void Double(double value);
+  void Bool(bool value);
+  void Null();
+
+  // Whether every object and array begun has been ended.
+  bool is_complete() const { return stack_.empty(); }
+
+ private:
+  struct Container {
+    bool is_object;
+    bool is_empty;
+  };
+
+  // Writes the separator needed before the next value or key.
+  void BeginValue();
+  void AppendEscaped(absl::string_view value);
+
+  std::string* const buffer_;
+  std::vector<Container> stack_;
+  bool key_written_ = false;
+
+  OSP_DISALLOW_COPY_AND_ASSIGN(StreamingWriter);
+};
+
+}  // namespace json
+}  // namespace openscreen
+
+#endif  // UTIL_JSON_STREAMING_JSON_WRITER_H_
@@ -0,0 +1,92 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/json/streaming_json_writer.h"
+
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "util/json/json_serialization.h"
+
+namespace openscreen {
+namespace json {
+
+TEST(StreamingJsonWriterTest, WritesCompactJson) {
+  std::string buffer;
+  StreamingWriter writer(&buffer);
+  writer.BeginObject();
+  writer.Key("int");
+  writer.Int(-1);
+  writer.Key("uint");
+  writer.Uint(std::numeric_limits<uint64_t>::max());
+  writer.Key("array");
+  writer.BeginArray();
+  writer.Bool(true);
+  writer.Null();
+  writer.BeginObject();
+  writer.EndObject();
+  writer.BeginArray();
+  writer.EndArray();
+  writer.EndArray();
+  writer.Key("string");
+  writer.String("foo");
+  writer.EndObject();
+  EXPECT_TRUE(writer.is_complete());
+
+  EXPECT_EQ(
+      R"({"int":-1,"uint":18446744073709551615,"array":[true,null,{},[]],)"
+      R"("string":"foo"})",
+      buffer);
+}
+
+TEST(StreamingJsonWriterTest, EscapesStrings) {
+  std::string buffer;
+  StreamingWriter writer(&buffer);
+  writer.BeginArray();
+  writer.String("quote\" backslash\\ newline\n tab\t bell\x07 \xc3\xa9");
+  writer.EndArray();
+
+  EXPECT_EQ(
+      R"(["quote\" backslash\\ newline\n tab\t bell\u0007 )"
+      "\xc3\xa9\"]",
+      buffer);
+
+  const ErrorOr<Json::Value> parsed = Parse(buffer);
+  ASSERT_TRUE(parsed.is_value());
+  EXPECT_EQ("quote\" backslash\\ newline\n tab\t bell\x07 \xc3\xa9",
+            parsed.value()[0].asString());
+}
+
+TEST(StreamingJsonWriterTest, WritesDoublesThatReadBackAsDoubles) {
+  std::string buffer;
+  StreamingWriter writer(&buffer);
+  writer.BeginArray();
+  writer.Double(1.0);
+  writer.Double(0.1);
+  writer.Double(-2.5e-20);
+  writer.Double(std::numeric_limits<double>::infinity());
+  writer.EndArray();
+
+  EXPECT_EQ("[1.0,0.10000000000000001,-2.4999999999999999e-20,null]",
+            buffer);
+
+  const ErrorOr<Json::Value> parsed = Parse(buffer);
+  ASSERT_TRUE(parsed.is_value());
+  EXPECT_EQ(1.0, parsed.value()[0].asDouble());
+  EXPECT_EQ(0.1, parsed.value()[1].asDouble());
+  EXPECT_EQ(-2.5e-20, parsed.value()[2].asDouble());
+  EXPECT_TRUE(parsed.value()[3].isNull());
+}
+
+TEST(StreamingJsonWriterTest, AppendsToTheBuffer) {
+  std::string buffer = "prefix:";
+  StreamingWriter writer(&buffer);
+  writer.BeginObject();
+  writer.EndObject();
+  EXPECT_EQ("prefix:{}", buffer);
+}
+
+}  // namespace json
+}  // namespace openscreen
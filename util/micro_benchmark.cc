@@ -0,0 +1,63 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "util/micro_benchmark.h"
+
+#include <stdio.h>
+
+namespace openscreen {
+
+double MicroBenchmarkResult::nanoseconds_per_iteration() const {
+  if (iterations == 0) {
+    return 0;
+  }
+  return static_cast<double>(elapsed.count()) / iterations;
+}
+
+double MicroBenchmarkResult::megabytes_per_second() const {
+  if (elapsed.count() == 0) {
+    return 0;
+  }
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  return static_cast<double>(bytes_per_iteration) * iterations / seconds / 1e6;
+}
+
+MicroBenchmarkResult RunMicroBenchmark(absl::string_view name,
+                                       size_t bytes_per_iteration,
+                                       const std::function<void()>& body,
+                                       std::chrono::milliseconds min_duration) {
+  using Clock = std::chrono::steady_clock;
+
+  // Warm up caches and any lazily-initialized state first.
+  body();
+
+  MicroBenchmarkResult result;
+  result.name = std::string(name);
+  result.bytes_per_iteration = bytes_per_iteration;
+
+  int64_t batch_size = 1;
+  while (result.elapsed < min_duration) {
+    const Clock::time_point start = Clock::now();
+    for (int64_t i = 0; i < batch_size; ++i) {
+      body();
+    }
+    result.elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - start);
+    result.iterations += batch_size;
+    batch_size *= 2;
+  }
+  return result;
+}
+
+void PrintMicroBenchmarkResult(const MicroBenchmarkResult& result) {
+  if (result.bytes_per_iteration > 0) {
+    printf("%-56s %12.1f ns/iter %10.1f MB/s\n", result.name.c_str(),
+           result.nanoseconds_per_iteration(), result.megabytes_per_second());
+  } else {
+    printf("%-56s %12.1f ns/iter\n", result.name.c_str(),
+           result.nanoseconds_per_iteration());
+  }
+}
+
+}  // namespace openscreen
@@ -0,0 +1,53 @@
+// Copyright 2022 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef UTIL_MICRO_BENCHMARK_H_
+#define UTIL_MICRO_BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace openscreen {
+
+struct MicroBenchmarkResult {
+  std::string name;
+  int64_t iterations = 0;
+  std::chrono::nanoseconds elapsed{0};
+
+  // The number of bytes processed by each iteration, or zero if throughput
+  // should not be reported.
+  size_t bytes_per_iteration = 0;
+
+  double nanoseconds_per_iteration() const;
+  double megabytes_per_second() const;
+};
+
+// Runs |body| repeatedly, in growing batches, until at least |min_duration|
+// has been spent in it, and returns the timing.  This is intentionally simple:
+// the benchmark executables are meant for comparing two implementations of the
+// same thing on one machine, not for tracking absolute numbers.
+MicroBenchmarkResult RunMicroBenchmark(
+    absl::string_view name,
+    size_t bytes_per_iteration,
+    const std::function<void()>& body,
+    std::chrono::milliseconds min_duration = std::chrono::milliseconds(500));
+
+// Prints one line describing |result| to stdout.
+void PrintMicroBenchmarkResult(const MicroBenchmarkResult& result);
+
+// Prevents the compiler from optimizing away the computation of |value|.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+}  // namespace openscreen
+
+#endif  // UTIL_MICRO_BENCHMARK_H_